@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+//
+// Counts the heap allocations of the benchmark. The replacement operators are defined here, so the header is
+// included by one file of the benchmark only. The bitmaps allocate through the aligned forms.
+//
+namespace litelockr::AllocationCounter {
+
+inline std::atomic<std::size_t> allocations{0};
+
+inline std::size_t count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace litelockr::AllocationCounter
+
+void *operator new(std::size_t size) {
+    litelockr::AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    litelockr::AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+#endif // ALLOCATION_COUNTER_H
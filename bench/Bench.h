@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+//
+// Times a function a few rounds and reports the fastest and the median round in milliseconds
+//
+namespace litelockr::Bench {
+
+struct Result {
+    double best = 0;   // ms
+    double median = 0; // ms
+};
+
+template<typename Function>
+Result measure(unsigned rounds, Function&& function) {
+    using Clock = std::chrono::steady_clock;
+
+    function(); // warms up the caches and the pools
+
+    std::vector<double> times;
+    times.reserve(rounds);
+    for (unsigned i = 0; i < rounds; i++) {
+        auto started = Clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - started).count());
+    }
+    std::sort(times.begin(), times.end());
+    return {times.front(), times[times.size() / 2]};
+}
+
+inline void report(const char *name, const Result& result) {
+    std::printf("%-48s best %9.3f ms   median %9.3f ms\n", name, result.best, result.median);
+}
+
+} // namespace litelockr::Bench
+
+#endif // BENCH_H
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_RESOURCES_H
+#define BENCH_RESOURCES_H
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "app/FlyoutScene.h"
+#include "gfx/BakedImage.h"
+#include "gfx/Bitmap.h"
+#include "gfx/FrameSet.h"
+
+//
+// The images the resource script embeds into the application, loaded from the baked files by their resource ids
+//
+namespace litelockr::BenchResources {
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// the resource id of every baked file, from Resources.h and Resources.rc
+inline const std::map<int, std::string>& bakedFiles() {
+    static const std::map<int, std::string> files = [] {
+        const std::string header = readFile(std::string(RES_DIR) + "/Resources.h");
+        const std::string script = readFile(std::string(RES_DIR) + "/Resources.rc");
+        const std::regex define(R"(#define\s+(IDB_\w+)\s+(\d+))");
+        const std::regex image(R"((IDB_\w+)\s+RCDATA\s+"baked\\\\(\w+\.llbm)\")");
+
+        std::map<std::string, int> ids;
+        for (auto it = std::sregex_iterator(header.begin(), header.end(), define); it != std::sregex_iterator(); ++it) {
+            ids[(*it)[1]] = std::stoi((*it)[2]);
+        }
+        std::map<int, std::string> result;
+        for (auto it = std::sregex_iterator(script.begin(), script.end(), image); it != std::sregex_iterator(); ++it) {
+            if (auto id = ids.find((*it)[1]); id != ids.end()) {
+                result[id->second] = std::string(RES_DIR) + "/baked/" + (*it)[2].str();
+            }
+        }
+        return result;
+    }();
+    return files;
+}
+
+inline bool load(Bitmap& bitmap, int resourceId, unsigned *numFrames = nullptr) {
+    const auto file = bakedFiles().find(resourceId);
+    if (file == bakedFiles().end()) {
+        return false;
+    }
+    const std::string data = readFile(file->second);
+    return BakedImage::load(bitmap, reinterpret_cast<const uint8_t *>(data.data()), data.size(), numFrames);
+}
+
+inline bool load(FrameSet& frames, int resourceId) {
+    Bitmap strip;
+    unsigned numFrames = 0;
+    if (!load(strip, resourceId, &numFrames)) {
+        return false;
+    }
+    frames.createFromBitmap(strip, numFrames);
+    return true;
+}
+
+// FlyoutView::initializeImages() and initializeScene(), the menu bar planes are plain
+inline bool loadScene(FlyoutScene& scene) {
+    for (Material *mat: FlyoutScene::materials(scene)) {
+        if (mat->resourceId && !load(mat->bitmap, mat->resourceId)) {
+            return false;
+        }
+    }
+    if (!load(scene.progressFull, IDB_PROGRESS_FULL)) {
+        return false;
+    }
+
+    const auto& layout = scene.layout;
+    scene.planeLeftMat.bitmap.create(layout.menuBarWidth / 2, layout.bodyHeight);
+    scene.planeRightMat.bitmap.create(layout.menuBarWidth - layout.menuBarWidth / 2, layout.bodyHeight);
+    for (Material *mat: {&scene.planeLeftMat, &scene.planeRightMat}) {
+        mat->bitmap.clear({35, 35, 38, 245}); // FlyoutModel::menuBarBackground
+    }
+    scene.setUp();
+    return true;
+}
+
+} // namespace litelockr::BenchResources
+
+#endif // BENCH_RESOURCES_H
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gfx/Bitmap.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+//
+// The full-screen bitmap operations of a frame
+//
+int main() {
+    constexpr unsigned WIDTH = 1920;
+    constexpr unsigned HEIGHT = 1080;
+    constexpr unsigned ROUNDS = 20;
+
+    Bitmap dst;
+    Bitmap src;
+    dst.create(WIDTH, HEIGHT);
+    src.create(WIDTH, HEIGHT);
+    src.clear(Color(40, 80, 120, 200));
+
+    Bench::report("create (1920x1080)", Bench::measure(ROUNDS, [] {
+        Bitmap bitmap;
+        bitmap.create(WIDTH, HEIGHT);
+    }));
+    Bench::report("clear", Bench::measure(ROUNDS, [&] { dst.clear(Color(255, 255, 255, 255)); }));
+    Bench::report("fillRect (alpha 128)", Bench::measure(ROUNDS, [&] {
+        dst.fillRect(0, 0, WIDTH, HEIGHT, Color(10, 20, 30, 128));
+    }));
+    Bench::report("copyFrom", Bench::measure(ROUNDS, [&] { dst.copyFrom(src, 0, 0); }));
+    Bench::report("blendFrom", Bench::measure(ROUNDS, [&] { dst.blendFrom(src, 0, 0); }));
+    Bench::report("clone + unshare", Bench::measure(ROUNDS, [&] {
+        Bitmap clone;
+        clone.clone(src);
+        clone.unshare();
+    }));
+    return 0;
+}
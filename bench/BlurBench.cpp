@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <omp.h>
+
+#include "gfx/BoxBlur.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+// a screenshot-like image: flat areas, hard edges and some noise
+void fillDesktop(Bitmap& image) {
+    image.clear({55, 55, 55, 255});
+    uint32_t seed = 1;
+    for (int i = 0; i < 200; i++) {
+        seed = seed * 1664525 + 1013904223;
+        const int x = static_cast<int>(seed % image.width());
+        const int y = static_cast<int>((seed >> 8) % image.height());
+        const auto color = Color(seed >> 24, seed >> 16, seed >> 8, 255);
+        image.fillRect(x, y, std::min(image.width() - x, 300u), std::min(image.height() - y, 200u), color);
+    }
+    for (unsigned y = 0; y < image.height(); y += 3) {
+        uint8_t *p = image.pixFmt().pix_ptr(0, static_cast<int>(y));
+        for (unsigned x = 0; x < image.width(); x += 7) {
+            seed = seed * 1664525 + 1013904223;
+            p[x * 4] = static_cast<uint8_t>(seed >> 24);
+        }
+    }
+}
+
+int maxDifference(const Bitmap& a, const Bitmap& b) {
+    int result = 0;
+    for (unsigned y = 0; y < a.height(); y++) {
+        const uint8_t *p = a.pixFmt().pix_ptr(0, static_cast<int>(y));
+        const uint8_t *q = b.pixFmt().pix_ptr(0, static_cast<int>(y));
+        for (unsigned i = 0; i < a.width() * 4; i++) {
+            result = std::max(result, std::abs(p[i] - q[i]));
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+//
+// The guard background blur: the parallel box passes against the agg::stack_blur they replaced
+//
+int main() {
+    struct {
+        const char *name;
+        unsigned width;
+        unsigned height;
+    } screens[] = {{"1080p", 1920, 1080}, {"1440p", 2560, 1440}, {"4K", 3840, 2160}};
+
+    std::printf("%d threads\n", omp_get_max_threads());
+    for (const auto& screen: screens) {
+        Bitmap source;
+        source.create(screen.width, screen.height);
+        fillDesktop(source);
+
+        for (unsigned radius: {4u, 16u}) {
+            Bitmap boxBlurred;
+            Bitmap stackBlurred;
+            char name[64];
+
+            std::snprintf(name, sizeof(name), "%s radius %u, BoxBlur", screen.name, radius);
+            Bench::report(name, Bench::measure(5, [&] {
+                boxBlurred.clone(source);
+                BoxBlur::blur(boxBlurred, radius);
+            }));
+
+            std::snprintf(name, sizeof(name), "%s radius %u, agg::stack_blur", screen.name, radius);
+            Bench::report(name, Bench::measure(5, [&] {
+                stackBlurred.clone(source);
+                agg::stack_blur<agg::rgba8, agg::stack_blur_calc_rgba<>> blur;
+                blur.blur(stackBlurred.pixFmt(), radius);
+            }));
+
+            std::printf("%s radius %u: max channel difference %d\n", screen.name, radius,
+                        maxDifference(boxBlurred, stackBlurred));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "sys/BaseEvent.h"
+#include "AllocationCounter.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+struct TestEvent: public BaseEvent {
+    AppClock::TimePoint sent;
+
+    explicit TestEvent(int id) : BaseEvent(id), sent(AppClock::now()) {}
+};
+
+// the events are handled as the message loop does: timeout() on the consumer thread
+class TestEvents: public BaseEvents<TestEvent> {
+public:
+    void send(int id) { sendEvent(TestEvent(id)); }
+
+    std::vector<double> latencies; // us
+
+protected:
+    void process(TestEvent event) override {
+        latencies.push_back(std::chrono::duration<double, std::micro>(AppClock::now() - event.sent).count());
+    }
+};
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    auto nth = values.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+// the producers send the events with their own ids, a pause after each one, while the consumer handles them
+void measureLatency(unsigned numProducers) {
+    constexpr unsigned NUM_EVENTS = 2000; // by producer
+
+    TestEvents events;
+    events.latencies.reserve(NUM_EVENTS * numProducers);
+    std::atomic<unsigned> running{numProducers};
+
+    std::thread consumer([&events, &running] {
+        while (running > 0) {
+            events.timeout();
+            std::this_thread::yield();
+        }
+        events.timeout();
+    });
+
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < numProducers; p++) {
+        producers.emplace_back([&events, &running, p] {
+            for (unsigned i = 0; i < NUM_EVENTS; i++) {
+                events.send(static_cast<int>(p));
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            running--;
+        });
+    }
+    for (auto& producer: producers) {
+        producer.join();
+    }
+    consumer.join();
+
+    const auto& stat = events.statistics();
+    std::printf("%u producers: %u handled, %u skipped, latency p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                numProducers, stat.processed, stat.skipped, percentile(events.latencies, 0.5),
+                percentile(events.latencies, 0.99),
+                std::chrono::duration<double, std::micro>(stat.maxLatency).count());
+}
+
+} // namespace
+
+//
+// The cost of sending an event, its heap allocations, and the time from sending to handling with 1 to 4
+// producer threads
+//
+int main() {
+    constexpr unsigned BATCH = 100; // fits into the pool of the nodes
+
+    EventQueue<TestEvent> queue;
+    Bench::report("push + pop, 100 events", Bench::measure(1000, [&queue] {
+        for (unsigned i = 0; i < BATCH; i++) {
+            queue.push(TestEvent(static_cast<int>(i % EventQueue<TestEvent>::MAX_EVENT_ID)));
+        }
+        while (queue.pop()) {
+        }
+    }));
+
+    const auto before = AllocationCounter::count();
+    for (unsigned i = 0; i < BATCH; i++) {
+        queue.push(TestEvent(1));
+    }
+    std::printf("allocations of 100 pushes: %zu, pool misses: %u\n", AllocationCounter::count() - before,
+                queue.poolMisses());
+    while (queue.pop()) {
+    }
+
+    for (unsigned numProducers = 1; numProducers <= 4; numProducers++) {
+        measureLatency(numProducers);
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <omp.h>
+
+#include "app/FlyoutResources.h"
+#include "sys/Rectangle.h"
+#include "Bench.h"
+#include "BenchResources.h"
+
+using namespace litelockr;
+
+namespace {
+
+struct LockStrip {
+    int resourceId;
+    unsigned numFrames;
+};
+
+constexpr LockStrip LOCK_STRIPS[] = {
+        {IDB_ANIM_START_LOCKING, NumberOfFrames::START_LOCKING},
+        {IDB_ANIM_FINISH_LOCKING, NumberOfFrames::FINISH_LOCKING},
+        {IDB_ANIM_CANNOT_UNLOCK, NumberOfFrames::CANNOT_UNLOCK},
+        {IDB_ANIM_UNLOCK, NumberOfFrames::UNLOCK},
+};
+
+// FlyoutAnimation::renderFrames(): a scene of its own for every thread
+template<typename RenderFrame>
+void renderFrames(const FlyoutScene& mainScene, unsigned numFrames, int maxThreads, RenderFrame&& renderFrame) {
+    const int numThreads = std::clamp(static_cast<int>(numFrames), 1, maxThreads);
+    std::vector<std::unique_ptr<FlyoutScene>> scenes(numThreads);
+
+#pragma omp parallel num_threads(numThreads)
+    {
+        auto& scene = scenes[omp_get_thread_num()];
+        scene = std::make_unique<FlyoutScene>();
+        scene->createFrom(mainScene);
+        Bitmap frame;
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(numFrames); i++) {
+            renderFrame(*scene, frame, static_cast<unsigned>(i));
+        }
+    }
+}
+
+// FlyoutAnimation::createLockAnimation(): the strip textures the lock of the scene with the open menu
+void createLockAnimation(const FlyoutScene& mainScene, const FrameSet& strip, FrameSet& result, int maxThreads) {
+    const RECT frame3 = FlyoutScene::lockAnimationFrame();
+    const int fw = Rectangle::width(frame3);
+    const int fh = Rectangle::height(frame3);
+    result.recreate(fw, fh, strip.size());
+
+    FlyoutLayers layers = FlyoutLayers::all();
+    layers.lockUpdateMaterial = false;
+    layers.idleState = true;
+
+    renderFrames(mainScene, strip.size(), maxThreads, [&](FlyoutScene& scene, Bitmap& buf, unsigned i) {
+        scene.lockGeo.setMaterialIndex(0, FlyoutScene::LOCK_BUFFER_MAT);
+        scene.lockBufferMat.create(strip, i);
+        scene.render(1, layers, FlyoutSceneState());
+
+        const auto& rc = scene.viewFrame;
+        if (buf.isNull()) {
+            buf.create(fw, fh);
+        }
+        buf.copyFrom(scene.renderBuffer, 0, 0, rc.left + frame3.left, rc.top + frame3.top, fw, fh);
+        result.addFrame(i, buf);
+    });
+}
+
+bool sameFrames(FrameSet& a, FrameSet& b) {
+    const Bitmap& x = a.bitmap();
+    const Bitmap& y = b.bitmap();
+    if (x.width() != y.width() || x.height() != y.height()) {
+        return false;
+    }
+    for (unsigned row = 0; row < x.height(); row++) {
+        if (std::memcmp(x.pixFmt().row_ptr(static_cast<int>(row)), y.pixFmt().row_ptr(static_cast<int>(row)),
+                        x.width() * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+//
+// FlyoutAnimation::initializeAnimations() without the frame cache: the lock strips are decoded, composed over
+// the body with the closed menu, and rendered into the scene with the open menu on one and on all the threads
+//
+int main() {
+    FlyoutScene scene;
+    if (!BenchResources::loadScene(scene)) {
+        std::fprintf(stderr, "Could not load the images from %s\n", RES_DIR);
+        return 1;
+    }
+
+    const int maxThreads = omp_get_max_threads();
+    std::printf("%d threads\n", maxThreads);
+
+    FrameSet strips[std::size(LOCK_STRIPS)];
+    Bench::report("decode the 4 lock strips", Bench::measure(10, [&] {
+        for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+            BenchResources::load(strips[i], LOCK_STRIPS[i].resourceId);
+        }
+    }));
+
+    Bench::report("createFrom (the scene of a render thread)", Bench::measure(50, [&] {
+        FlyoutScene threadScene;
+        threadScene.createFrom(scene);
+    }));
+
+    // the menu-closed strips are composed over the lock area of the back layers, inside its bounds
+    scene.render(0, FlyoutLayers::all(), FlyoutSceneState());
+    const RECT lockBounds = Renderer::bounds(scene.lock);
+    Bitmap background;
+    background.create(scene.layout.lock.w, scene.layout.lock.h);
+    background.copyFrom(scene.renderBuffer, 0, 0, lockBounds.left + 1, lockBounds.top + 1,
+                        background.width(), background.height());
+    FrameSet menuClosed[std::size(LOCK_STRIPS)];
+    Bench::report("4 lock strips, menu closed (compose + compress)", Bench::measure(10, [&] {
+        for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+            menuClosed[i].createWithBackground(strips[i].bitmap(), strips[i].size(), background);
+            menuClosed[i].compress();
+        }
+    }));
+
+    FrameSet serial[std::size(LOCK_STRIPS)];
+    FrameSet parallel[std::size(LOCK_STRIPS)];
+    Bench::report("4 lock strips, menu open, 1 thread", Bench::measure(5, [&] {
+        for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+            createLockAnimation(scene, strips[i], serial[i], 1);
+        }
+    }));
+    char name[64];
+    std::snprintf(name, sizeof(name), "4 lock strips, menu open, %d threads", maxThreads);
+    Bench::report(name, Bench::measure(5, [&] {
+        for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+            createLockAnimation(scene, strips[i], parallel[i], maxThreads);
+        }
+    }));
+
+    bool same = true;
+    for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+        same = same && sameFrames(serial[i], parallel[i]);
+    }
+    std::printf("menu open strips: %s\n", same ? "byte-exact on all the threads" : "DIFFERENT");
+
+    Bench::report("compress the 4 menu-open strips", Bench::measure(10, [&] {
+        for (size_t i = 0; i < std::size(LOCK_STRIPS); i++) {
+            FrameSet compressed;
+            compressed.clone(parallel[i]);
+            compressed.compress();
+        }
+    }));
+    return same ? 0 : 1;
+}
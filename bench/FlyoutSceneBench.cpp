@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include "gfx/BandRenderer.h"
+#include "gfx/BitmapContext.h"
+#include "gfx/SpanImageBilinear.h"
+#include "Bench.h"
+#include "BenchResources.h"
+
+using namespace litelockr;
+
+namespace {
+
+// the AGG bilinear filter the perspective quads were sampled with before SpanImageBilinear,
+// SpanImageBilinearTest checks that both give the same pixels
+void referencePerspective(Bitmap& buffer, const Bitmap& image, const BitmapContext::QuadDouble& quad,
+                          uint8_t alpha) {
+    using PixFmt = Bitmap::PixFmtType;
+    using Accessor = agg::image_accessor_clone<PixFmt>;
+    using Interpolator = agg::span_interpolator_trans<agg::trans_perspective>;
+    using SpanGen = agg::span_image_filter_rgba_bilinear<Accessor, Interpolator>;
+
+    double quadArr[8];
+    std::copy(quad.begin(), quad.end(), quadArr);
+    agg::trans_perspective tr(quadArr, 0, 0, image.width(), image.height());
+    if (!tr.is_valid()) {
+        return;
+    }
+    BandRenderer::render(buffer, quad, [&](auto& rasterizer, auto& scanline, auto& renderer) {
+        Accessor accessor(image.pixFmt());
+        Interpolator interpolator(tr);
+        SpanGen spanGen(accessor, interpolator);
+        SpanConvAlpha<Accessor> conv(alpha);
+        agg::span_converter<SpanGen, SpanConvAlpha<Accessor>> converter(spanGen, conv);
+        agg::span_allocator<PixFmt::color_type> allocator;
+        agg::render_scanlines_aa(rasterizer, scanline, renderer, allocator, converter);
+    });
+}
+
+} // namespace
+
+//
+// The flyout scene frames, and its perspective quads sampled by SpanImageBilinear and by the AGG filter
+//
+int main() {
+    FlyoutScene scene;
+    if (!BenchResources::loadScene(scene)) {
+        std::fprintf(stderr, "Could not load the images from %s\n", RES_DIR);
+        return 1;
+    }
+
+    const auto layers = FlyoutLayers::all();
+    const FlyoutSceneState state;
+    for (float value: {0.0f, 0.5f, 1.0f}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "scene frame (menu %.1f)", value);
+        Bench::report(name, Bench::measure(200, [&] { scene.render(value, layers, state); }));
+    }
+
+    // the lock turned halfway to the open menu, and a quad of the same size facing the camera
+    const Bitmap& lock = scene.lockOpenMat.bitmap;
+    const BitmapContext::QuadDouble quads[] = {
+            {52.3, 41.6, 131.2, 47.9, 128.4, 125.1, 55.0, 131.3},
+            {54.5, 54.5, 135.5, 54.5, 135.5, 135.5, 54.5, 135.5},
+    };
+    const char *names[] = {"perspective", "affine"};
+
+    Bitmap current;
+    Bitmap reference;
+    current.createAs(scene.renderBuffer);
+    reference.createAs(scene.renderBuffer);
+    for (size_t i = 0; i < std::size(quads); i++) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s quad, SpanImageBilinear", names[i]);
+        Bench::report(name, Bench::measure(2000, [&] { BitmapContext(current).perspective(lock, quads[i], 200); }));
+        std::snprintf(name, sizeof(name), "%s quad, agg bilinear", names[i]);
+        Bench::report(name, Bench::measure(2000, [&] { referencePerspective(reference, lock, quads[i], 200); }));
+    }
+    return 0;
+}
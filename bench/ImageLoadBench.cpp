@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gfx/BakedImage.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+struct Image {
+    std::filesystem::path png;
+    std::filesystem::path baked;
+};
+
+// a cold start reads the resources from the disk, the pages of the file are dropped before
+std::vector<uint8_t> readFile(const std::filesystem::path& path, bool cold) {
+    std::vector<uint8_t> data;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return data;
+    }
+    if (cold) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    data.resize(std::filesystem::file_size(path));
+    size_t done = 0;
+    while (done < data.size()) {
+        const auto n = ::read(fd, data.data() + done, data.size() - done);
+        if (n <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    data.resize(done);
+    return data;
+}
+
+bool loadPng(const std::filesystem::path& path, bool cold) {
+    const auto data = readFile(path, cold);
+    Bitmap bitmap;
+    return bitmap.loadPng(data.data(), data.size());
+}
+
+bool loadBaked(const std::filesystem::path& path, bool cold) {
+    const auto data = readFile(path, cold);
+    Bitmap bitmap;
+    return BakedImage::load(bitmap, data.data(), data.size());
+}
+
+} // namespace
+
+//
+// All the images of the resources loaded one after another, as ImageLoader does on one thread:
+// the PNG files against the baked ones, with the files in the page cache and read from the disk
+//
+int main() {
+    const std::filesystem::path resDir = RES_DIR;
+    std::vector<Image> images;
+    uintmax_t pngBytes = 0;
+    uintmax_t bakedBytes = 0;
+    for (const char *dir: {"png", "animation"}) {
+        for (const auto& entry: std::filesystem::directory_iterator(resDir / dir)) {
+            auto baked = resDir / "baked" / entry.path().stem().replace_extension(".llbm");
+            pngBytes += std::filesystem::file_size(entry.path());
+            bakedBytes += std::filesystem::file_size(baked);
+            images.push_back({entry.path(), baked});
+        }
+    }
+    std::printf("%zu images: PNG %ju bytes, baked %ju bytes\n", images.size(), pngBytes, bakedBytes);
+
+    bool loaded = true;
+    for (bool cold: {false, true}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "PNG, %s", cold ? "cold" : "warm");
+        Bench::report(name, Bench::measure(9, [&] {
+            for (const auto& image: images) {
+                loaded = loadPng(image.png, cold) && loaded;
+            }
+        }));
+        std::snprintf(name, sizeof(name), "baked, %s", cold ? "cold" : "warm");
+        Bench::report(name, Bench::measure(9, [&] {
+            for (const auto& image: images) {
+                loaded = loadBaked(image.baked, cold) && loaded;
+            }
+        }));
+    }
+    return loaded ? 0 : 1;
+}
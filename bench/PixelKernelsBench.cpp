@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "gfx/Bitmap.h"
+#include "gfx/PixelKernels.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+constexpr unsigned ROUNDS = 20;
+
+template<typename RowFunction>
+void measureRows(const std::string& name, unsigned height, RowFunction&& row) {
+    Bench::report(name.c_str(), Bench::measure(ROUNDS, [&] {
+        for (unsigned y = 0; y < height; y++) {
+            row(static_cast<int>(y));
+        }
+    }));
+}
+
+std::string kernelName(const PixelKernelTable& kernels, const char *operation) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s %ls", operation, kernels.name);
+    return name;
+}
+
+//
+// The row kernels of every instruction set next to the AGG pixel format they replace
+//
+void measure(unsigned width, unsigned height) {
+    std::printf("%ux%u\n", width, height);
+
+    Bitmap dst;
+    Bitmap src;
+    dst.create(width, height);
+    src.create(width, height);
+    // semi-transparent source over an opaque destination, no block is skipped
+    src.clear(Color(40, 80, 120, 200));
+    dst.clear(Color(255, 255, 255, 255));
+
+    const auto pixel = premultiplied(Color(10, 20, 30, 128));
+    uint32_t packed;
+    auto p = reinterpret_cast<uint8_t *>(&packed);
+    p[ColorR] = pixel.r;
+    p[ColorG] = pixel.g;
+    p[ColorB] = pixel.b;
+    p[ColorA] = pixel.a;
+
+    auto& dstFmt = dst.pixFmt();
+    const auto& srcFmt = src.pixFmt();
+
+    measureRows("blend AGG blend_from", height, [&](int y) {
+        dstFmt.blend_from(srcFmt, 0, y, 0, y, width, 255);
+    });
+    for (const PixelKernelTable *kernels: PixelKernels::supported()) {
+        measureRows(kernelName(*kernels, "blend"), height, [&](int y) {
+            kernels->blendRow(dstFmt.pix_ptr(0, y), srcFmt.pix_ptr(0, y), width, 255);
+        });
+    }
+
+    measureRows("blend fill AGG blend_hline", height, [&](int y) {
+        dstFmt.blend_hline(0, y, width, pixel, 200);
+    });
+    for (const PixelKernelTable *kernels: PixelKernels::supported()) {
+        measureRows(kernelName(*kernels, "blend fill"), height, [&](int y) {
+            kernels->blendFillRow(dstFmt.pix_ptr(0, y), width, packed, 200);
+        });
+    }
+
+    measureRows("fill AGG copy_hline", height, [&](int y) {
+        dstFmt.copy_hline(0, y, width, pixel);
+    });
+    for (const PixelKernelTable *kernels: PixelKernels::supported()) {
+        measureRows(kernelName(*kernels, "fill"), height, [&](int y) {
+            kernels->fillRow(dstFmt.pix_ptr(0, y), width, packed);
+        });
+    }
+
+    // Bitmap::copyFrom() moves the rows with the CRT, there is no copy kernel
+    measureRows("copy AGG copy_from", height, [&](int y) {
+        dstFmt.copy_from(srcFmt, 0, y, 0, y, width);
+    });
+    measureRows("copy memmove", height, [&](int y) {
+        std::memmove(dstFmt.pix_ptr(0, y), srcFmt.pix_ptr(0, y), width * 4);
+    });
+}
+
+} // namespace
+
+int main() {
+    measure(380, 580);   // the flyout with its margin
+    measure(2560, 1440); // the dimmed screen behind the unlock guard
+    return 0;
+}
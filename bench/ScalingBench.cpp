@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include <omp.h>
+
+#include "gfx/BitmapContext.h"
+#include "gfx/BoxBlur.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+void fillPattern(Bitmap& image) {
+    for (unsigned y = 0; y < image.height(); y++) {
+        uint8_t *p = image.pixFmt().pix_ptr(0, static_cast<int>(y));
+        for (unsigned x = 0; x < image.width(); x++, p += 4) {
+            const auto a = static_cast<uint8_t>(128 + (x + y) % 128);
+            p[0] = static_cast<uint8_t>(x * a / 255 % (a + 1));
+            p[1] = static_cast<uint8_t>(y * a / 255 % (a + 1));
+            p[2] = static_cast<uint8_t>((x ^ y) * a / 255 % (a + 1));
+            p[3] = a;
+        }
+    }
+}
+
+bool sameRows(const Bitmap& a, const Bitmap& b) {
+    for (unsigned y = 0; y < a.height(); y++) {
+        if (std::memcmp(a.pixFmt().row_ptr(static_cast<int>(y)), b.pixFmt().row_ptr(static_cast<int>(y)),
+                        a.width() * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+//
+// The parallel bands of the large perspective and wave images, and the blur passes, on 1..N threads.
+// The threads go up to the number of cores, or to the number given on the command line.
+//
+int main(int argc, char *argv[]) {
+    const int maxThreads = argc > 1 ? std::atoi(argv[1]) : omp_get_num_procs();
+
+    Bitmap image;
+    image.create(1920, 1080);
+    fillPattern(image);
+
+    struct Case {
+        const char *name;
+        std::function<void(Bitmap&)> render;
+    } cases[] = {
+            {"perspective 1920x1080 -> 2560x1440", [&](Bitmap& buffer) {
+                buffer.clear({0, 0, 0, 0});
+                BitmapContext(buffer).perspective(image, {180.5, 60.25, 2400, 120, 2330, 1390.5, 90, 1300}, 230);
+            }},
+            {"wave 1920x1080", [&](Bitmap& buffer) {
+                buffer.clear({0, 0, 0, 0});
+                BitmapContext(buffer).wave<WaveDirection::MoveUp>(image, 0.4f, 200);
+            }},
+            {"BoxBlur 2560x1440 radius 4", [&](Bitmap& buffer) {
+                buffer.clear({0, 0, 0, 255});
+                buffer.copyFrom(image, 100, 100);
+                BoxBlur::blur(buffer, 4);
+            }},
+    };
+
+    for (auto& c: cases) {
+        Bitmap first;
+        Bitmap buffer;
+        buffer.create(2560, 1440);
+        double singleThread = 0;
+
+        for (int threads = 1; threads <= maxThreads; threads++) {
+            omp_set_num_threads(threads);
+            const auto result = Bench::measure(5, [&] { c.render(buffer); });
+
+            char name[96];
+            std::snprintf(name, sizeof(name), "%s, %d thread(s)", c.name, threads);
+            Bench::report(name, result);
+
+            if (threads == 1) {
+                singleThread = result.median;
+                first.clone(buffer);
+                first.unshare();
+            } else {
+                std::printf("    speedup %.2fx, %s\n", singleThread / result.median,
+                            sameRows(first, buffer) ? "the same pixels" : "DIFFERENT PIXELS");
+            }
+        }
+    }
+    return 0;
+}
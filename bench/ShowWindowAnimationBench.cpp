@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+#include <omp.h>
+
+#include "app/animation/TransitionEffects.h"
+#include "gfx/BitmapContext.h"
+#include "AllocationCounter.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+constexpr int TASKBAR_HEIGHT = 48;
+
+// ShowWindowAnimation::create() with the taskbar at the bottom, the frames are played as they are streamed
+void playAnimation(AnimationFrameSet& anim, Bitmap& screen, const Bitmap& img, bool inverted) {
+    const RECT workArea = {0, 0, static_cast<int>(img.width()), static_cast<int>(img.height()) - TASKBAR_HEIGHT};
+    ShowWindowAnimation::create(anim, img, workArea, WaveDirection::MoveDown, inverted);
+    for (anim.begin(); anim.active(); anim.nextFrame()) {
+        anim.drawFrame(screen, 0, 0);
+    }
+}
+
+// the frames of ShowWindowAnimation::create() one after another, without the stream
+void createFrames(Bitmap& frame, const Bitmap& img, int numFrames) {
+    for (int i = 0; i < numFrames; i++) {
+        frame.clear({0, 0, 0, 0});
+        ShowWindowAnimation::createFrame(frame, img, WaveDirection::MoveDown, i, numFrames);
+    }
+}
+
+void createImage(Bitmap& image, unsigned width, unsigned height) {
+    image.create(width, height);
+    image.clear({40, 40, 40, 230});
+    for (unsigned y = 0; y < height; y += 64) {
+        image.fillRect(0, static_cast<int>(y), width, std::min(32u, height - y), {90, 120, 200, 255});
+    }
+}
+
+} // namespace
+
+//
+// The show and the hide animation of the window. The warm rounds find the warp tables in the cache, the cold
+// rounds change the window height every time, so every frame replaces the least recently used tables.
+//
+int main() {
+    constexpr unsigned NUM_SIZES = 8;
+    Bitmap images[NUM_SIZES];
+    for (unsigned i = 0; i < NUM_SIZES; i++) {
+        createImage(images[i], 1920, 1080 - 8 * i);
+    }
+
+    Bitmap screen;
+    screen.createAs(images[0]);
+    AnimationFrameSet hideAnimation;
+    AnimationFrameSet showAnimation;
+    auto showAndHide = [&](const Bitmap& img) {
+        playAnimation(showAnimation, screen, img, true);
+        playAnimation(hideAnimation, screen, img, false);
+    };
+
+    std::printf("%d threads\n", omp_get_max_threads());
+
+    Bitmap frame;
+    frame.createAs(images[0]);
+    Bench::report("1920x1080 16 frames of createFrame", Bench::measure(5, [&] {
+        createFrames(frame, images[0], 16);
+    }));
+
+    Bench::report("1920x1080 show + hide, warm warp tables", Bench::measure(5, [&] {
+        showAndHide(images[0]);
+    }));
+
+    unsigned next = 1;
+    Bench::report("1920x~1060 show + hide, cold warp tables", Bench::measure(5, [&] {
+        showAndHide(images[next++]);
+    }));
+
+    auto before = AllocationCounter::count();
+    showAndHide(images[0]);
+    std::printf("allocations of a warm show + hide: %zu\n", AllocationCounter::count() - before);
+
+    before = AllocationCounter::count();
+    showAndHide(images[next++]);
+    std::printf("allocations of a cold show + hide: %zu\n", AllocationCounter::count() - before);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#include "lock/uia/UIAutomationHelperImpl.h"
+#include "lock/uia/UIAutomationMemoryProvider.h"
+#include "AllocationCounter.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+namespace {
+
+// runs the scan once more and reports what it has done
+void reportScan(const char *name, const UIAutomationHelperImpl& helper, const std::function<void()>& scan) {
+    const auto before = AllocationCounter::count();
+    scan();
+    const auto allocations = AllocationCounter::count() - before;
+
+    const auto& stat = helper.statistics();
+    std::printf("%-48s visited %5u   property reads %5u   strings %5u   allocations %6zu   %8.1f us\n", name,
+                stat.elementsVisited, stat.propertyReads, stat.stringAllocations, allocations,
+                std::chrono::duration<double, std::micro>(stat.elapsed).count());
+}
+
+} // namespace
+
+//
+// The taskbar scans of the locking over synthetic taskbars of 10, 100 and 1000 buttons: the allowed buttons,
+// a button by the start of its name, the active button and a button by its index. The active button and the
+// button by index are the last ones and no name starts with the searched one, so the scans walk the whole toolbar.
+//
+int main() {
+    const UIAutomationHelperImpl::StringSet appNames = {L"SLACK", L"MICROSOFT TEAMS"};
+    const UIAutomationHelperImpl::StringSet exeNames = {L"STEAM.EXE"};
+    const UIAutomationHelperImpl::StringSet autoIds = {L"Microsoft.WindowsTerminal_8wekyb3d8bbwe!App"};
+    const UIAutomationHelperImpl::StringSet searchNames = {L"DOCUMENT 999"};
+
+    for (unsigned numButtons: {10u, 100u, 1000u}) {
+        auto provider = std::make_unique<UIAutomationMemoryProvider>();
+        provider->createTaskbar(numButtons, numButtons - 1);
+        UIAutomationHelperImpl helper(std::move(provider));
+
+        std::printf("%u buttons\n", numButtons);
+        const unsigned rounds = 10000 / numButtons;
+        char name[64];
+
+        UIAutomationHelperImpl::ButtonPropertiesList allowed;
+        auto findAllowed = [&] {
+            allowed.clear();
+            helper.findTaskbarButtons(appNames, exeNames, autoIds, allowed);
+        };
+        std::snprintf(name, sizeof(name), "findTaskbarButtons (%u buttons)", numButtons);
+        Bench::report(name, Bench::measure(rounds, findAllowed));
+        reportScan(name, helper, findAllowed);
+
+        std::snprintf(name, sizeof(name), "findTaskbarButton by name (%u buttons)", numButtons);
+        auto findByName = [&] { helper.findTaskbarButton(PROP_NAME, searchNames, STARTS_WITH); };
+        Bench::report(name, Bench::measure(rounds, findByName));
+        reportScan(name, helper, findByName);
+
+        std::snprintf(name, sizeof(name), "getAutomationIdOfActiveButton (%u buttons)", numButtons);
+        auto findActive = [&] { helper.getAutomationIdOfActiveButton(); };
+        Bench::report(name, Bench::measure(rounds, findActive));
+        reportScan(name, helper, findActive);
+
+        std::snprintf(name, sizeof(name), "getTaskbarButton (%u buttons)", numButtons);
+        auto findLast = [&] { helper.getTaskbarButton(static_cast<int>(numButtons) - 1); };
+        Bench::report(name, Bench::measure(rounds, findLast));
+        reportScan(name, helper, findLast);
+
+        std::printf("allowed buttons: %zu, active: %ls\n", allowed.size(),
+                    helper.getAutomationIdOfActiveButton().c_str());
+    }
+    return 0;
+}
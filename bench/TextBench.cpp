@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include "gfx/BitmapContext.h"
+#include "gfx/FontCache.h"
+#include "Bench.h"
+
+using namespace litelockr;
+
+//
+// The TrueType text of the unlock guard: measuring, the ink bounds and drawing a line into its mask,
+// with the glyphs cached and with the font switched on every call. Windows only, the glyphs come from GDI.
+//
+int main() {
+    constexpr auto TEXT = L"Press Ctrl+Alt+Del to unlock the keyboard and the mouse";
+    constexpr unsigned ROUNDS = 200;
+
+    Bitmap mask;
+    mask.create(1920, 120);
+
+    auto setFont = [](BitmapContext& ctx, float height) {
+        ctx.fontFace = "Segoe UI";
+        ctx.fontHeight = height;
+        ctx.fontWeight = FW_BOLD;
+        ctx.textColor = Color(255, 255, 255);
+    };
+
+    Bench::report("measureText", Bench::measure(ROUNDS, [&] {
+        BitmapContext ctx(mask);
+        setFont(ctx, 48);
+        static_cast<void>(ctx.measureText(TEXT));
+    }));
+    Bench::report("textBounds", Bench::measure(ROUNDS, [&] {
+        BitmapContext ctx(mask);
+        setFont(ctx, 48);
+        static_cast<void>(ctx.textBounds(TEXT, 20, 80));
+    }));
+    Bench::report("drawText", Bench::measure(ROUNDS, [&] {
+        BitmapContext ctx(mask);
+        setFont(ctx, 48);
+        ctx.clear({0, 0, 0, 255});
+        ctx.drawText(TEXT, 20, 80);
+    }));
+
+    // the title and the hint of the guard have different sizes
+    bool large = false;
+    Bench::report("drawText, another font every call", Bench::measure(ROUNDS, [&] {
+        BitmapContext ctx(mask);
+        setFont(ctx, (large = !large) ? 48.0f : 20.0f);
+        ctx.clear({0, 0, 0, 255});
+        ctx.drawText(TEXT, 20, 80);
+    }));
+
+    const auto& stats = FontCache::instance().statistics();
+    std::printf("glyphs requested %llu, rasterized %llu (%u%% cached), font changes %u\n",
+                static_cast<unsigned long long>(stats.lookups), static_cast<unsigned long long>(stats.misses),
+                stats.hitRate(), stats.fontChanges);
+    return 0;
+}
@@ -31,6 +31,7 @@ struct FlyoutLayers {
     bool keyboard = true;
     bool mouse = true;
     bool lockUpdateMaterial = true;
+    bool idleState = false; // the progress and the buttons as they are before any input
 
     void set(bool val) {
         planes =
@@ -21,6 +21,7 @@
 
 #include <cassert>
 
+#include "app/FlyoutSceneLayout.h"
 #include "ren/PlanesGeometry.h"
 #include "sys/Rectangle.h"
 
@@ -43,12 +44,22 @@ void FlyoutModel::initialize() {
     menu.w = 26;
     menu.h = 23;
 
+    // the body and the scene parts are rendered by FlyoutScene with the same sizes
+    const FlyoutSceneLayout layout;
+    auto setSize = [](auto& component, const FlyoutSceneLayout::Part& part) {
+        component.w = part.w;
+        component.h = part.h;
+        component.offset3.x = part.offset3.x;
+        component.offset3.y = part.offset3.y;
+        component.offset3.z = part.offset3.z;
+    };
+
     lockButton.w = 44;
     lockButton.h = 55;
-    body.w = 138;
-    body.h = 132;
+    body.w = layout.bodyWidth;
+    body.h = layout.bodyHeight;
     menuBar.visible = false;
-    menuBar.w = 40;
+    menuBar.w = layout.menuBarWidth;
     menuBar.h = body.h;
 
     settings.w = 40;
@@ -58,32 +69,20 @@ void FlyoutModel::initialize() {
     about.w = 40;
     about.h = 37;
 
-    circle.w = circle.h = 101;
-    circle.offset3.x = 0.5f;
-    circle.offset3.y = 0;
-    circle.offset3.z = -3;
+    setSize(circle, layout.circle);
     circle.x = 39;
     circle.y = 49;
 
-    progressBackground.w = progressBackground.h = 101;
-    progressBackground.offset3.x = 0.5f;
-    progressBackground.offset3.y = 0;
-    progressBackground.offset3.z = -3;
+    setSize(progressBackground, layout.progressBackground);
     progressBackground.x = MARGIN + 19;
     progressBackground.y = MARGIN + 29;
 
     progress = progressBackground;
+    setSize(progress, layout.progress);
 
-    lock.w = lock.h = 81;
-    lock.offset3.x = 0.5f;
-    lock.offset3.y = 0;
-    lock.offset3.z = -2.6f;
-
-    keyboard.w = keyboard.h = 26;
-    mouse.w = mouse.h = 26;
-    keyboard.offset3.x = mouse.offset3.x = 0.5f;
-    keyboard.offset3.y = mouse.offset3.y = -0.3f;
-    keyboard.offset3.z = mouse.offset3.z = -3;
+    setSize(lock, layout.lock);
+    setSize(keyboard, layout.keyboard);
+    setSize(mouse, layout.mouse);
 
     lockButton.r = 44;
     keyboard.r = mouse.r = 13;
@@ -23,18 +23,24 @@
 #include <array>
 #include <vector>
 
+#include "app/FlyoutScene.h"
 #include "app/animation/AnimationFrameSet.h"
 #include "gfx/Bitmap.h"
-#include "ren/Geometry.h"
-#include "ren/Material.h"
-#include "ren/PlanesGeometry.h"
-#include "ren/Renderer.h"
+#include "gfx/FrameCache.h"
+#include "sys/ResourceManager.h"
 
 #include "res/Resources.h"
 
 namespace litelockr {
 
 struct FlyoutResources {
+    //
+    // Everything below is loaded or rendered on its first use
+    //
+    ResourceManager manager;
+    LazyResource imagesResource; // the bitmaps of the title, the menu bar and the scene materials
+    LazyResource sceneResource;  // the scene and its back layers
+
     struct Title {
         Bitmap background;
         Bitmap close;
@@ -48,91 +54,33 @@ struct FlyoutResources {
     } menuBar;
 
     struct Body {
-        Bitmap progressFull;
-
         struct Animations {
             Bitmap backLayers;
-            AnimationFrameSet startLockingAnimation;
-            AnimationFrameSet finishLockingAnimation;
-            AnimationFrameSet cannotUnlockAnimation;
-            AnimationFrameSet unlockAnimation;
+            Lazy<AnimationFrameSet> startLockingAnimation;
+            Lazy<AnimationFrameSet> finishLockingAnimation;
+            Lazy<AnimationFrameSet> cannotUnlockAnimation;
+            Lazy<AnimationFrameSet> unlockAnimation;
         };
         Animations menuClosed;
         Animations menuOpen;
     } body;
 
+    // the lock animations rendered with the open menu, kept between the runs
+    FrameCache animationCache;
+
     AnimationFrameSet hideFlyoutAnimation;
     AnimationFrameSet showFlyoutAnimation;
 
     AnimationFrameSet shakeAnimation;
-    AnimationFrameSet startupAnimation;
+    Lazy<AnimationFrameSet> startupAnimation;
 
-    AnimationFrameSet openMenuAnimation;
-    AnimationFrameSet closeMenuAnimation;
+    Lazy<AnimationFrameSet> openMenuAnimation;
+    Lazy<AnimationFrameSet> closeMenuAnimation;
 
     AnimationFrameSet showMenuAnimation;
     AnimationFrameSet hideMenuAnimation;
 
-    struct FlyoutScene {
-        Bitmap renderBuffer;
-        Renderer renderer{renderBuffer};
-        SceneObjects objects;
-        RECT viewFrame{};
-
-        NullObject nullObj;
-        MeshObject planes;
-        PlanesGeometry planesGeo;
-        Material planeLeftMat;
-        Material planeRightMat;
-        Material planeBodyMat{IDB_BODY};
-
-        PlaneGeometry circleGeo;
-        PlaneGeometry progressBackgroundGeo;
-        PlaneGeometry progressGeo;
-        PlaneGeometry lockGeo;
-        PlaneGeometry keyboardGeo;
-        PlaneGeometry mouseGeo;
-
-        MeshObject circle;
-        MeshObject progressBackground;
-        MeshObject progress;
-        MeshObject lock;
-        MeshObject keyboard;
-        MeshObject mouse;
-
-        Material circleMat{IDB_CIRCLE};
-        Material progressBackgroundMat{IDB_PROGRESS_BACKGROUND};
-        Material progressMat{IDB_PROGRESS_FULL};
-
-        Material lockOpenMat{IDB_LOCK_OPEN};
-        Material lockClosedMat{IDB_LOCK_CLOSED};
-        Material lockDisabledMat{IDB_LOCK_DISABLED};
-        Material lockCancelMat{IDB_LOCK_CANCEL};
-        Material lockBufferMat;
-
-        Material keyboardEnabledMat{IDB_KEYBOARD_ENABLED};
-        Material keyboardDisabledMat{IDB_KEYBOARD_DISABLED};
-        Material mouseEnabledMat{IDB_MOUSE_ENABLED};
-        Material mouseDisabledMat{IDB_MOUSE_DISABLED};
-    } scene;
-
-    enum KeyboardMaterialIndex {
-        KEYBOARD_ENABLED_MAT = 0,
-        KEYBOARD_DISABLED_MAT = 1,
-    };
-
-    enum MouseMaterialIndex {
-        MOUSE_ENABLED_MAT = 0,
-        MOUSE_DISABLED_MAT = 1,
-    };
-
-    enum LockMaterialIndex {
-        LOCK_OPEN_MAT = 0,
-        LOCK_CLOSED_MAT = 1,
-        LOCK_CANCEL_MAT = 2,
-        LOCK_DISABLED_MAT = 3,
-        LOCK_BUFFER_MAT = 4,
-    };
+    FlyoutScene scene;
 
     using MenuAnimationValues = std::array<float, 12>;
     // pre-rendered values
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FlyoutScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#include "gfx/BitmapContext.h"
+#include "gfx/BitmapPool.h"
+#include "gfx/BitmapUtils.h"
+#include "sys/KeyFrames.h"
+#include "sys/Rectangle.h"
+
+namespace litelockr {
+
+void FlyoutScene::setUp() {
+    const auto& m = layout;
+    unsigned maxVal = std::max(m.bodyWidth, m.bodyHeight) + 52;
+    renderBuffer.create(maxVal, maxVal);
+    renderBuffer.clear({0, 0, 0, 0});
+
+    planesGeo.create(static_cast<float>(m.menuBarWidth), static_cast<float>(m.bodyWidth),
+                     static_cast<float>(m.bodyHeight), 0.0f);
+    planes.create(planesGeo, {planeLeftMat, planeRightMat, planeBodyMat});
+    planesGeo.offset(0.0f, 0.0f, -2.9f); // correct Z
+
+    planes.setParent(nullObj);
+    planes.geometry().update();
+
+    planesGeo.setMaterialIndex(0, 0); // planeLeftMat
+    planesGeo.setMaterialIndex(1, 1); // planeRightMat
+    planesGeo.setMaterialIndex(2, 2); // planeBodyMat
+
+    circleGeo.create(m.circle.w, m.circle.h);
+    progressBackgroundGeo.create(m.progressBackground.w, m.progressBackground.h);
+    progressGeo.create(m.progress.w, m.progress.h);
+    lockGeo.create(m.lock.w, m.lock.h);
+    keyboardGeo.create(m.keyboard.w, m.keyboard.h);
+    mouseGeo.create(m.mouse.w, m.mouse.h);
+
+    circle.create(circleGeo, circleMat);
+    progressBackground.create(progressBackgroundGeo, progressBackgroundMat);
+    progress.create(progressGeo, progressMat);
+    lock.create(lockGeo, {lockOpenMat, lockClosedMat, lockCancelMat, lockDisabledMat, lockBufferMat});
+
+    keyboard.create(keyboardGeo, {keyboardEnabledMat, keyboardDisabledMat});
+    mouse.create(mouseGeo, {mouseEnabledMat, mouseDisabledMat});
+
+    circle.setParent(nullObj);
+    progressBackground.setParent(nullObj);
+    progress.setParent(nullObj);
+    lock.setParent(nullObj);
+    keyboard.setParent(nullObj);
+    mouse.setParent(nullObj);
+
+    unsigned centerX = renderBuffer.width() / 2;
+    unsigned centerY = renderBuffer.height() / 2;
+    nullObj.setPosition0(static_cast<float>(centerX), static_cast<float>(centerY) + 0.5f);
+
+    objects.add(nullObj);
+    objects.add(mouse);
+    objects.add(keyboard);
+    objects.add(lock);
+    objects.add(progress);
+    objects.add(progressBackground);
+    objects.add(circle);
+    objects.add(planes);
+
+    unsigned w2 = m.bodyWidth / 2;
+    unsigned h = m.bodyHeight - PlanesGeometry::Y_OFFSET;
+    unsigned h2 = h / 2;
+    viewFrame = Rectangle::create(static_cast<int>(centerX - w2), static_cast<int>(centerY - h2),
+                                  static_cast<int>(m.bodyWidth), static_cast<int>(h));
+}
+
+void FlyoutScene::createFrom(const FlyoutScene& source) {
+    auto sourceMaterials = materials(source);
+    auto targetMaterials = materials(*this);
+    for (size_t i = 0; i < targetMaterials.size(); i++) {
+        if (!sourceMaterials[i]->bitmap.isNull()) {
+            targetMaterials[i]->create(sourceMaterials[i]->bitmap); // shares the pixels
+        }
+        targetMaterials[i]->alpha = sourceMaterials[i]->alpha;
+    }
+    if (!source.progressFull.isNull()) {
+        progressFull.clone(source.progressFull);
+    }
+    layout = source.layout;
+    setUp();
+
+    for (auto [geo, sourceGeo]: {std::pair{&lockGeo, &source.lockGeo},
+                                 std::pair{&keyboardGeo, &source.keyboardGeo},
+                                 std::pair{&mouseGeo, &source.mouseGeo}}) {
+        geo->setMaterialIndex(0, sourceGeo->faces[0].materialIndex);
+    }
+}
+
+void FlyoutScene::render(float value, FlyoutLayers layers, const FlyoutSceneState& state,
+                         const Bitmap *backLayers, int x, int y) {
+    renderBuffer.clear({0, 0, 0, 0});
+
+    if (backLayers) {
+        // skip layers below
+        layers.planes = false;
+        layers.circle = false;
+        layers.progressBackground = false;
+
+        const auto& rc = viewFrame;
+        renderBuffer.copyFrom(*backLayers, rc.left, rc.top, x, y, Rectangle::width(rc), Rectangle::height(rc));
+    }
+
+    place(value, layers, state);
+    renderer.render(objects);
+}
+
+void FlyoutScene::place(float value, FlyoutLayers layers, const FlyoutSceneState& state) {
+    const auto& m = layout;
+    planesGeo.update(value);
+    planesGeo.offset(0, 0, -3); // correct Z position
+
+    planes.visible = layers.planes;
+
+    auto angle = planesGeo.angle();
+    auto center = planesGeo.center();
+    float yValue = -3.0f * value;
+    float zValue = EASY_IN(value) * 1.5f;
+
+    //
+    // Some Z-offset values
+    //
+    float circleZOffset(2),
+            ringZOffset(-5),
+            progressZOffset(-10),
+            lockZOffset(-11);
+
+    circle.visible = layers.circle;
+    if (layers.circle) {
+        circleGeo.setSize(m.circle.w, m.circle.h);
+        circleGeo.offset(0, yValue, circleZOffset * zValue);
+        circleGeo.offset(m.circle.offset3.x, m.circle.offset3.y, m.circle.offset3.z);
+        circle.setRotY(angle);
+        circle.setPosition(center[0], center[1], center[2]);
+    }
+
+    progressBackground.visible = layers.progressBackground;
+    if (layers.progressBackground) {
+        progressBackgroundGeo.setSize(m.progressBackground.w, m.progressBackground.h);
+        progressBackgroundGeo.offset(0, yValue, ringZOffset * zValue);
+        progressBackgroundGeo.offset(m.progressBackground.offset3.x, m.progressBackground.offset3.y,
+                                     m.progressBackground.offset3.z);
+        progressBackground.setRotY(angle);
+        progressBackground.setPosition(center[0], center[1], center[2]);
+
+        int alpha = 255 - std::lround(75.0f * value);
+        alpha = std::clamp(alpha, 0, 255);
+        progressBackgroundMat.alpha = static_cast<std::uint8_t>(alpha);
+    }
+
+    progress.visible = layers.progress;
+    if (layers.progress) {
+        progressGeo.setSize(m.progress.w, m.progress.h);
+        progressGeo.offset(0, yValue, progressZOffset * zValue);
+        progressGeo.offset(m.progress.offset3.x, m.progress.offset3.y, m.progress.offset3.z);
+        progress.setRotY(angle);
+        progress.setPosition(center[0], center[1], center[2]);
+
+        drawProgress(state.progress);
+        progressMat.alpha = state.progressOpacity;
+    }
+
+    lock.visible = layers.lock;
+    if (layers.lock) {
+        lockGeo.setSize(m.lock.w, m.lock.h);
+        lockGeo.offset(0, yValue, lockZOffset * zValue);
+        lockGeo.offset(m.lock.offset3.x, m.lock.offset3.y, m.lock.offset3.z);
+        lock.setRotY(angle);
+        if (layers.lockUpdateMaterial) {
+            lockGeo.setMaterialIndex(0, state.lockMaterial);
+        }
+        lock.setPosition(center[0], center[1], center[2]);
+    }
+
+    keyboard.visible = layers.keyboard;
+    if (layers.keyboard) {
+        keyboardGeo.setSize(m.keyboard.w, m.keyboard.h);
+        keyboardGeo.offset(0, yValue, -18 * zValue);
+        keyboardGeo.offset(m.keyboard.offset3.x, m.keyboard.offset3.y, m.keyboard.offset3.z);
+        keyboard.setRotY(angle);
+        keyboard.setPosition(center[0] - 50.5f, center[1] + 37.8f, center[2]);
+        keyboardEnabledMat.alpha = state.buttonOpacity;
+        keyboardDisabledMat.alpha = state.buttonOpacity;
+    }
+
+    mouse.visible = layers.mouse;
+    if (layers.mouse) {
+        mouseGeo.setSize(m.mouse.w, m.mouse.h);
+        mouseGeo.offset(0, yValue, -18 * zValue);
+        mouseGeo.offset(m.mouse.offset3.x, m.mouse.offset3.y, m.mouse.offset3.z);
+        mouse.setRotY(angle);
+        mouse.setPosition(center[0] + 50.5f, center[1] + 37.8f, center[2]);
+        mouseEnabledMat.alpha = state.buttonOpacity;
+        mouseDisabledMat.alpha = state.buttonOpacity;
+    }
+}
+
+RECT FlyoutScene::lockAnimationFrame() {
+    return Rectangle::create(83, 14, 44, 70);
+}
+
+void FlyoutScene::drawProgress(float value) {
+    auto& buffer = progressMat.bitmap;
+    auto mask = BitmapPool::instance().acquireAs(buffer);
+    if (mask->isNull()) {
+        return;
+    }
+    BitmapContext ctx(*mask);
+    unsigned w = buffer.width();
+    unsigned h = buffer.height();
+    int xc = static_cast<int>(w / 2);
+    int yc = static_cast<int>(h / 2);
+    float r = static_cast<float>(w) / 2.0f;
+    ctx.clear({255, 255, 255, 255});
+    ctx.beginPath();
+    ctx.moveTo(xc, 0);
+    ctx.lineTo(xc, yc);
+
+    float angle = 360.0f * value / 100.0f;
+    const auto PI = static_cast<float>(std::numbers::pi);
+    float a = angle * PI / 180.0f;
+    ctx.lineTo(static_cast<float>(xc) + r * sin(a), static_cast<float>(yc) - r * cos(a));
+
+    if (angle < 90) {
+        ctx.lineTo(w, 0u);
+    }
+    if (angle < 180) {
+        ctx.lineTo(w, h);
+    }
+    if (angle < 270) {
+        ctx.lineTo(0u, h);
+    }
+    ctx.lineTo(0, 0);
+    ctx.closePath();
+    ctx.fillColor = Color(0, 0, 0);
+    ctx.fill();
+
+    buffer.blitFrom(progressFull);
+    BitmapUtils::applyMask(buffer, *mask);
+}
+
+} // namespace litelockr
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLYOUT_SCENE_H
+#define FLYOUT_SCENE_H
+
+#include <array>
+#include <cstdint>
+
+#include "app/FlyoutLayers.h"
+#include "app/FlyoutSceneLayout.h"
+#include "gfx/Bitmap.h"
+#include "ren/Geometry.h"
+#include "ren/Material.h"
+#include "ren/PlanesGeometry.h"
+#include "ren/Renderer.h"
+
+#include "res/Resources.h"
+
+namespace litelockr {
+
+//
+// The parts of the scene that follow the state of the flyout
+//
+struct FlyoutSceneState {
+    float progress = 0;                 // FlyoutProgressBar::progress()
+    std::uint8_t progressOpacity = 0;   // FlyoutProgressBar::opacity()
+    std::uint8_t buttonOpacity = 0;     // FlyoutButtonOpacity::opacity()
+    unsigned lockMaterial = 0;          // FlyoutScene::LockMaterialIndex
+};
+
+//
+// The 3D scene of the flyout body: the menu bar planes, the circle with the progress ring, the lock and the
+// keyboard and mouse buttons. It is built from the Windows independent parts only, the benchmarks render it.
+//
+struct FlyoutScene {
+    Bitmap renderBuffer;
+    Renderer renderer{renderBuffer};
+    SceneObjects objects;
+    RECT viewFrame{};
+    FlyoutSceneLayout layout;
+
+    NullObject nullObj;
+    MeshObject planes;
+    PlanesGeometry planesGeo;
+    Material planeLeftMat;
+    Material planeRightMat;
+    Material planeBodyMat{IDB_BODY};
+
+    PlaneGeometry circleGeo;
+    PlaneGeometry progressBackgroundGeo;
+    PlaneGeometry progressGeo;
+    PlaneGeometry lockGeo;
+    PlaneGeometry keyboardGeo;
+    PlaneGeometry mouseGeo;
+
+    MeshObject circle;
+    MeshObject progressBackground;
+    MeshObject progress;
+    MeshObject lock;
+    MeshObject keyboard;
+    MeshObject mouse;
+
+    Material circleMat{IDB_CIRCLE};
+    Material progressBackgroundMat{IDB_PROGRESS_BACKGROUND};
+    Material progressMat{IDB_PROGRESS_FULL};
+    Bitmap progressFull; // the whole ring, the progress material is drawn from it
+
+    Material lockOpenMat{IDB_LOCK_OPEN};
+    Material lockClosedMat{IDB_LOCK_CLOSED};
+    Material lockDisabledMat{IDB_LOCK_DISABLED};
+    Material lockCancelMat{IDB_LOCK_CANCEL};
+    Material lockBufferMat;
+
+    Material keyboardEnabledMat{IDB_KEYBOARD_ENABLED};
+    Material keyboardDisabledMat{IDB_KEYBOARD_DISABLED};
+    Material mouseEnabledMat{IDB_MOUSE_ENABLED};
+    Material mouseDisabledMat{IDB_MOUSE_DISABLED};
+
+    enum KeyboardMaterialIndex {
+        KEYBOARD_ENABLED_MAT = 0,
+        KEYBOARD_DISABLED_MAT = 1,
+    };
+
+    enum MouseMaterialIndex {
+        MOUSE_ENABLED_MAT = 0,
+        MOUSE_DISABLED_MAT = 1,
+    };
+
+    enum LockMaterialIndex {
+        LOCK_OPEN_MAT = 0,
+        LOCK_CLOSED_MAT = 1,
+        LOCK_CANCEL_MAT = 2,
+        LOCK_DISABLED_MAT = 3,
+        LOCK_BUFFER_MAT = 4,
+    };
+
+    // the same order in every scene
+    template<typename Scene>
+    static auto materials(Scene& scene) {
+        return std::array{&scene.planeLeftMat, &scene.planeRightMat, &scene.planeBodyMat, &scene.circleMat,
+                          &scene.progressBackgroundMat, &scene.progressMat, &scene.lockOpenMat,
+                          &scene.lockClosedMat, &scene.lockDisabledMat, &scene.lockCancelMat, &scene.lockBufferMat,
+                          &scene.keyboardEnabledMat, &scene.keyboardDisabledMat, &scene.mouseEnabledMat,
+                          &scene.mouseDisabledMat};
+    }
+
+    // creates the objects of the scene, the images of the materials are loaded before
+    void setUp();
+
+    // the scene of a render thread, it shares the images with the source scene
+    void createFrom(const FlyoutScene& source);
+
+    // value is the menu position from 0 (closed) to 1 (open), the render buffer is left as it is
+    void place(float value, FlyoutLayers layers, const FlyoutSceneState& state);
+
+    // the back layers drawn before for the menu position are copied from (x, y) instead of being rendered
+    void render(float value, FlyoutLayers layers, const FlyoutSceneState& state,
+                const Bitmap *backLayers = nullptr, int x = 0, int y = 0);
+
+    // the part of the body the lock animations with the open menu cover
+    [[nodiscard]] static RECT lockAnimationFrame();
+
+private:
+    void drawProgress(float value);
+};
+
+} // namespace litelockr
+
+#endif // FLYOUT_SCENE_H
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLYOUT_SCENE_LAYOUT_H
+#define FLYOUT_SCENE_LAYOUT_H
+
+namespace litelockr {
+
+//
+// The sizes of the body and of the parts of the 3D scene, with the offsets of the parts in the scene.
+// FlyoutModel lays the flyout out with them.
+//
+struct FlyoutSceneLayout {
+    struct Offset3 {
+        float x = 0;
+        float y = 0;
+        float z = 0;
+    };
+
+    struct Part {
+        unsigned w = 0;
+        unsigned h = 0;
+        Offset3 offset3;
+    };
+
+    unsigned bodyWidth = 138;
+    unsigned bodyHeight = 132;
+    unsigned menuBarWidth = 40;
+
+    Part circle{101, 101, {0.5f, 0, -3}};
+    Part progressBackground{101, 101, {0.5f, 0, -3}};
+    Part progress{101, 101, {0.5f, 0, -3}};
+    Part lock{81, 81, {0.5f, 0, -2.6f}};
+    Part keyboard{26, 26, {0.5f, -0.3f, -3}};
+    Part mouse{26, 26, {0.5f, -0.3f, -3}};
+};
+
+} // namespace litelockr
+
+#endif // FLYOUT_SCENE_LAYOUT_H
@@ -19,13 +19,15 @@
 
 #include "FlyoutView.h"
 
-#include <numbers>
+#include <utility>
+#include <vector>
 
-#include "gfx/BitmapUtils.h"
+#include "gfx/ImageLoader.h"
 #include "ini/SettingsData.h"
 #include "lock/HookThread.h"
+#include "log/Logger.h"
 #include "sys/Comparison.h"
-#include "sys/KeyFrames.h"
+#include "sys/Rectangle.h"
 
 #include "res/Resources.h"
 
@@ -47,12 +49,18 @@ void FlyoutView::initialize(HWND /*hWnd*/) {
     buffer_.create(size.cx, size.cy);
     buffer_.clear({0, 0, 0, 0});
 
-    initializeImages();
-    initializeScene();
+    auto& res = resources_;
+    res.manager.add(res.imagesResource, L"images", [this] {
+        initializeImages();
+        checkImageSizes();
+    });
+    res.manager.add(res.sceneResource, L"scene", [this] {
+        resources_.imagesResource.require();
+        initializeScene();
+        initializeBackLayers();
+    });
     initializeAnimations();
 
-    checkImageSizes();
-
     HookThread::setLockStateListener([this](bool isLocked) {
         model_.setLocked(isLocked);
     });
@@ -61,27 +69,37 @@ void FlyoutView::initialize(HWND /*hWnd*/) {
 }
 
 void FlyoutView::initializeImages() {
+    ImageLoader loader;
+
     //
     // Title
     //
     auto& title = resources_.title;
-    title.close.loadPng(IDB_CLOSE);
-    title.menu.loadPng(IDB_MENU);
-    title.background.loadPng(IDB_TITLE);
+    loader.add(title.close, IDB_CLOSE);
+    loader.add(title.menu, IDB_MENU);
+    loader.add(title.background, IDB_TITLE);
 
     //
     // Option bar
     //
     auto& opt = resources_.menuBar;
-    opt.settings.loadPng(IDB_SETTINGS);
-    opt.help.loadPng(IDB_HELP);
-    opt.about.loadPng(IDB_ABOUT);
+    loader.add(opt.settings, IDB_SETTINGS);
+    loader.add(opt.help, IDB_HELP);
+    loader.add(opt.about, IDB_ABOUT);
 
     //
-    // Body
+    // Scene materials
     //
-    auto& body = resources_.body;
-    body.progressFull.loadPng(IDB_PROGRESS_FULL);
+    auto& scene = resources_.scene;
+    loader.add(scene.progressFull, IDB_PROGRESS_FULL);
+    for (Material *mat: {&scene.planeBodyMat, &scene.circleMat, &scene.progressBackgroundMat, &scene.progressMat,
+                         &scene.lockOpenMat, &scene.lockClosedMat, &scene.lockDisabledMat, &scene.lockCancelMat,
+                         &scene.keyboardEnabledMat, &scene.keyboardDisabledMat,
+                         &scene.mouseEnabledMat, &scene.mouseDisabledMat}) {
+        loader.add(mat->bitmap, mat->resourceId);
+    }
+
+    loader.load();
 }
 
 void FlyoutView::drawMenuBarMaterials() {
@@ -124,68 +142,62 @@ void FlyoutView::drawMenuBarMaterials() {
 }
 
 void FlyoutView::initializeScene() {
-    auto& m = model_;
-    auto& scene = resources_.scene;
-    unsigned maxVal = std::max(m.body.w, m.body.h) + 52;
-    scene.renderBuffer.create(maxVal, maxVal);
-    scene.renderBuffer.clear({0, 0, 0, 0});
-
-    scene.planesGeo.create(static_cast<float>(m.menuBar.w), static_cast<float>(m.body.w), static_cast<float>(m.body.h),
-                           0.0f);
     drawMenuBarMaterials();
-    scene.planes.create(scene.planesGeo, {scene.planeLeftMat, scene.planeRightMat, scene.planeBodyMat});
-    scene.planesGeo.offset(0.0f, 0.0f, -2.9f); // correct Z
-
-    scene.planes.setParent(scene.nullObj);
-    scene.planes.geometry().update();
-
-    scene.planesGeo.setMaterialIndex(0, 0); // planeLeftMat
-    scene.planesGeo.setMaterialIndex(1, 1); // planeRightMat
-    scene.planesGeo.setMaterialIndex(2, 2); // planeBodyMat
-
-    scene.circleGeo.create(m.circle.w, m.circle.h);
-    scene.progressBackgroundGeo.create(m.progressBackground.w, m.progressBackground.h);
-    scene.progressGeo.create(m.progress.w, m.progress.h);
-    scene.lockGeo.create(m.lock.w, m.lock.h);
-    scene.keyboardGeo.create(m.keyboard.w, m.keyboard.h);
-    scene.mouseGeo.create(m.mouse.w, m.mouse.h);
-
-    scene.circle.create(scene.circleGeo, scene.circleMat);
-    scene.progressBackground.create(scene.progressBackgroundGeo, scene.progressBackgroundMat);
-    scene.progress.create(scene.progressGeo, scene.progressMat);
-    scene.lock.create(scene.lockGeo, {scene.lockOpenMat, scene.lockClosedMat,
-                                      scene.lockCancelMat, scene.lockDisabledMat, scene.lockBufferMat});
-
-    scene.keyboard.create(scene.keyboardGeo, {scene.keyboardEnabledMat,
-                                              scene.keyboardDisabledMat});
-    scene.mouse.create(scene.mouseGeo, {scene.mouseEnabledMat, scene.mouseDisabledMat});
+    resources_.scene.setUp();
     updateButtonMaterial();
+}
 
-    scene.circle.setParent(scene.nullObj);
-    scene.progressBackground.setParent(scene.nullObj);
-    scene.progress.setParent(scene.nullObj);
-    scene.lock.setParent(scene.nullObj);
-    scene.keyboard.setParent(scene.nullObj);
-    scene.mouse.setParent(scene.nullObj);
-
-    unsigned centerX = scene.renderBuffer.width() / 2;
-    unsigned centerY = scene.renderBuffer.height() / 2;
-    scene.nullObj.setPosition0(static_cast<float>(centerX), static_cast<float>(centerY) + 0.5f);
-
-    scene.objects.add(scene.nullObj);
-    scene.objects.add(scene.mouse);
-    scene.objects.add(scene.keyboard);
-    scene.objects.add(scene.lock);
-    scene.objects.add(scene.progress);
-    scene.objects.add(scene.progressBackground);
-    scene.objects.add(scene.circle);
-    scene.objects.add(scene.planes);
-
-    unsigned w2 = m.body.w / 2;
-    unsigned h = m.body.h - PlanesGeometry::Y_OFFSET;
-    unsigned h2 = h / 2;
-    scene.viewFrame = Rectangle::create(static_cast<int>(centerX - w2), static_cast<int>(centerY - h2),
-                                        static_cast<int>(m.body.w), static_cast<int>(h));
+void FlyoutView::initializeBackLayers() {
+    auto& backMC = resources_.body.menuClosed.backLayers;
+    auto& backMO = resources_.body.menuOpen.backLayers;
+    backMC.createAs(buffer_);
+    backMO.createAs(buffer_);
+
+    renderBackground(0, FlyoutLayers::background(), false);
+    drawBackground(backMC);
+
+    renderBackground(1, FlyoutLayers::background(), false);
+    drawBackground(backMO);
+}
+
+void FlyoutView::logResourceUsage() const {
+    resources_.manager.logUsage();
+
+    const auto& res = resources_;
+    const auto& mc = res.body.menuClosed;
+    const auto& mo = res.body.menuOpen;
+    size_t residentBytes = 0, rawBytes = 0;
+    for (const FrameSet *frames: {&mc.startLockingAnimation.peek(), &mc.finishLockingAnimation.peek(),
+                                  &mc.cannotUnlockAnimation.peek(), &mc.unlockAnimation.peek(),
+                                  &mo.startLockingAnimation.peek(), &mo.finishLockingAnimation.peek(),
+                                  &mo.cannotUnlockAnimation.peek(), &mo.unlockAnimation.peek(),
+                                  &res.startupAnimation.peek(), &res.openMenuAnimation.peek(),
+                                  &res.closeMenuAnimation.peek()}) {
+        residentBytes += frames->residentBytes();
+        rawBytes += frames->rawBytes();
+    }
+    LOG_DEBUG(L"[FlyoutView] Animation frames: %zu KB in memory, %zu KB uncompressed",
+              residentBytes / 1024, rawBytes / 1024);
+
+    // startup cold and warm: rendered or read from the animation cache
+    AppClock::Duration lockLoadTime{};
+    unsigned lockLoaded = 0;
+    for (const LazyResource *lock: {&mo.startLockingAnimation, &mo.finishLockingAnimation,
+                                    &mo.cannotUnlockAnimation, &mo.unlockAnimation}) {
+        if (lock->loaded()) {
+            lockLoadTime += lock->loadTime();
+            lockLoaded++;
+        }
+    }
+    LOG_DEBUG(L"[FlyoutView] Lock animations (menu open): %u %s in %.2f ms", lockLoaded,
+              res.animationCache.isMapped() ? L"read from the cache" : L"rendered",
+              std::chrono::duration<double, std::milli>(lockLoadTime).count());
+
+    auto sharing = Bitmap::sharingStatistics();
+    LOG_DEBUG(L"[FlyoutView] Shared pixels: %llu KB, copied on write: %llu KB, saved: %llu KB",
+              static_cast<unsigned long long>(sharing.sharedBytes / 1024),
+              static_cast<unsigned long long>(sharing.copiedBytes / 1024),
+              static_cast<unsigned long long>(sharing.savedBytes() / 1024));
 }
 
 void FlyoutView::checkImageSizes() {
@@ -206,10 +218,8 @@ void FlyoutView::checkImageSizes() {
     assert(checkSize(opt.help, m.help));
     assert(checkSize(opt.about, m.about));
 
-    auto& body = resources_.body;
-    assert(checkSize(body.progressFull, m.progress));
-
     auto& scene = resources_.scene;
+    assert(checkSize(scene.progressFull, m.progress));
     assert(checkSize(scene.planeBodyMat.bitmap, m.body));
     assert(checkSize(scene.circleMat.bitmap, m.circle));
     assert(checkSize(scene.progressBackgroundMat.bitmap, m.progressBackground));
@@ -224,43 +234,6 @@ void FlyoutView::checkImageSizes() {
 #endif // _DEBUG
 }
 
-void FlyoutView::drawProgress(Bitmap& buffer, float progress) const {
-    Bitmap mask;
-    mask.createAs(buffer);
-    BitmapContext ctx(mask);
-    unsigned w = buffer.width();
-    unsigned h = buffer.height();
-    int xc = static_cast<int>(w / 2);
-    int yc = static_cast<int>(h / 2);
-    float r = static_cast<float>(w) / 2.0f;
-    ctx.clear({255, 255, 255, 255});
-    ctx.beginPath();
-    ctx.moveTo(xc, 0);
-    ctx.lineTo(xc, yc);
-
-    float angle = 360.0f * progress / 100.0f;
-    const auto PI = static_cast<float>(std::numbers::pi);
-    float a = angle * PI / 180.0f;
-    ctx.lineTo(static_cast<float>(xc) + r * sin(a), static_cast<float>(yc) - r * cos(a));
-
-    if (angle < 90) {
-        ctx.lineTo(w, 0u);
-    }
-    if (angle < 180) {
-        ctx.lineTo(w, h);
-    }
-    if (angle < 270) {
-        ctx.lineTo(0u, h);
-    }
-    ctx.lineTo(0, 0);
-    ctx.closePath();
-    ctx.fillColor = Color(0, 0, 0);
-    ctx.fill();
-
-    buffer.blitFrom(resources_.body.progressFull);
-    BitmapUtils::applyMask(buffer, mask);
-}
-
 void FlyoutView::checkAction(AnimationAction actionBefore) {
     if (actionBefore == AnimationAction::UNLOCK) {
         model_.guard.appEvent = AppEvent(AppEvent::UNLOCK);
@@ -280,7 +253,156 @@ bool FlyoutView::needsUpdate() {
 }
 
 void FlyoutView::draw() {
-    draw(buffer_, !model_.visible(), isMenuBarVisible() ? 1.0f : 0.0f);
+    bool isHidden = !model_.visible();
+    float menuBar = isMenuBarVisible() ? 1.0f : 0.0f;
+
+    if (isHidden || model_.guard.visible() || !drawState_) {
+        // the guard covers all the parts
+        draw(buffer_, isHidden, menuBar);
+        invalidate();
+        if (!isHidden && !model_.guard.visible()) {
+            drawState_ = currentDrawState(menuBar);
+        }
+        return;
+    }
+
+    auto state = currentDrawState(menuBar);
+
+    if (state.body != drawState_->body && !drawChangedParts(state.body, drawState_->body)) {
+        renderBackground(menuBar, FlyoutLayers::all(), true);
+        drawBackground(buffer_);
+        model_.menuBar.visible = isFloatEquals(menuBar, 1.0f);
+        updateOptButtons(buffer_);
+        dirtyRegion_.add(bodyRect());
+    }
+
+    if (state.title != drawState_->title) {
+        drawTitle(buffer_);
+        dirtyRegion_.add(titleRect());
+    }
+
+    drawState_ = state;
+}
+
+void FlyoutView::invalidate() {
+    dirtyRegion_.addAll();
+    drawState_.reset();
+}
+
+FlyoutView::DrawState FlyoutView::currentDrawState(float menuBar) {
+    auto buttonFlags = [](const PanelComponent& c) {
+        return (c.hover ? 1u : 0u) | (c.pressed ? 2u : 0u);
+    };
+
+    const auto& m = model_;
+    return {
+            .body = {
+                    .menuBar = menuBar,
+                    .progress = progressBar_.progress(),
+                    .progressOpacity = progressBar_.opacity(),
+                    .buttonOpacity = buttonOpacity_.opacity(),
+                    .lockMaterial = getLockMaterialIndex(),
+                    .keyboardChecked = m.keyboard.checked,
+                    .mouseChecked = m.mouse.checked,
+                    .menuButtons = buttonFlags(m.settings) | buttonFlags(m.help) << 2 | buttonFlags(m.about) << 4,
+            },
+            .title = {
+                    .titleButtons = buttonFlags(m.close) | buttonFlags(m.menu) << 2,
+            },
+    };
+}
+
+//
+// Renders again only the parts of the body which have changed: the bounds of the changed meshes of the scene
+// and the changed menu buttons. Inside them the scene is drawn over the cached layers and the menu bar over
+// the scene, the pixels are the same as of the whole body drawn anew. Returns false if the whole body has
+// to be drawn.
+//
+bool FlyoutView::drawChangedParts(const BodyState& state, const BodyState& drawn) {
+    const Bitmap *backLayers = cachedLayers(state.menuBar);
+    if (!backLayers || state.menuBar != drawn.menuBar) {
+        return false;
+    }
+
+    resources_.sceneResource.require();
+    auto& scene = resources_.scene;
+    auto layers = FlyoutLayers::all();
+    layers.planes = layers.circle = layers.progressBackground = false;
+    scene.place(state.menuBar, layers, sceneState(layers));
+    scene.renderer.project(scene.objects);
+
+    // the offset of the render buffer in the buffer, see drawBackground()
+    const int dx = model_.body.x - scene.viewFrame.left;
+    const int dy = model_.body.y - scene.viewFrame.top;
+    const RECT body = bodyRect();
+
+    DirtyRegion damage;
+    damage.setSize(buffer_.width(), buffer_.height());
+    damage.clear();
+    auto addMesh = [&](const MeshObject& mesh) {
+        RECT rc = Renderer::bounds(mesh);
+        Rectangle::offset(rc, dx, dy);
+        damage.add(Rectangle::intersect(rc, body));
+    };
+    if (state.progress != drawn.progress || state.progressOpacity != drawn.progressOpacity) {
+        addMesh(scene.progress);
+    }
+    if (state.lockMaterial != drawn.lockMaterial) {
+        addMesh(scene.lock);
+    }
+    if (state.buttonOpacity != drawn.buttonOpacity || state.keyboardChecked != drawn.keyboardChecked) {
+        addMesh(scene.keyboard);
+    }
+    if (state.buttonOpacity != drawn.buttonOpacity || state.mouseChecked != drawn.mouseChecked) {
+        addMesh(scene.mouse);
+    }
+
+    // the menu buttons and their images, the hover and the pressed flags of each are two bits of the state
+    const std::pair<const PanelButton&, const Bitmap&> buttons[] = {
+            {model_.settings, resources_.menuBar.settings},
+            {model_.help, resources_.menuBar.help},
+            {model_.about, resources_.menuBar.about},
+    };
+    for (unsigned i = 0; i < std::size(buttons); i++) {
+        if (((state.menuButtons ^ drawn.menuButtons) >> (i * 2) & 3u) != 0) {
+            const auto& [button, image] = buttons[i];
+            RECT rc = Rectangle::create(button.x, button.y, static_cast<int>(button.w), static_cast<int>(button.h));
+            rc = Rectangle::unite(rc, Rectangle::create(button.x, button.y, static_cast<int>(image.width()),
+                                                        static_cast<int>(image.height())));
+            damage.add(Rectangle::intersect(rc, body));
+        }
+    }
+
+    std::vector<RECT> clip;
+    clip.reserve(damage.rects().size());
+    auto& buf = scene.renderBuffer;
+    for (RECT rc: damage.rects()) {
+        Rectangle::offset(rc, -dx, -dy);
+        clip.push_back(rc);
+        buf.fillRect(rc, {0, 0, 0, 0});
+        buf.copyFrom(*backLayers, rc.left, rc.top, rc.left + dx, rc.top + dy,
+                     Rectangle::width(rc), Rectangle::height(rc));
+    }
+    scene.renderer.draw(scene.objects, clip);
+
+    for (const auto& rc: damage.rects()) {
+        buffer_.copyFrom(buf, rc.left, rc.top, rc.left - dx, rc.top - dy,
+                         Rectangle::width(rc), Rectangle::height(rc));
+        updateOptButtons(buffer_, rc);
+        dirtyRegion_.add(rc);
+    }
+    return true;
+}
+
+RECT FlyoutView::bodyRect() const {
+    // the body and the menu bar over it
+    auto& rc = resources_.scene.viewFrame;
+    return Rectangle::create(model_.body.x, model_.body.y, Rectangle::width(rc), Rectangle::height(rc));
+}
+
+RECT FlyoutView::titleRect() const {
+    auto& title = model_.titleBar;
+    return Rectangle::create(title.x, title.y, static_cast<int>(title.w), static_cast<int>(title.h));
 }
 
 void FlyoutView::draw(Bitmap& buffer, bool isHidden, float menuBar /*= 0*/, bool showGuard/* = true*/) {
@@ -295,7 +417,19 @@ void FlyoutView::draw(Bitmap& buffer, bool isHidden, float menuBar /*= 0*/, bool
     model_.menuBar.visible = isFloatEquals(menuBar, 1.0f);
     updateOptButtons(buffer);
 
+    drawTitle(buffer);
 
+    if (auto state = currentDrawState(menuBar); state != guardBackground_) {
+        guardBackground_ = state;
+        guard_.invalidateBackground();
+    }
+
+    if (showGuard && model_.guard.visible()) {
+        guard_.draw(buffer);
+    }
+}
+
+void FlyoutView::drawTitle(Bitmap& buffer) const {
     //
     // title
     //
@@ -311,13 +445,14 @@ void FlyoutView::draw(Bitmap& buffer, bool isHidden, float menuBar /*= 0*/, bool
     std::uint8_t settingsAlpha = settings.pressed ? 100 : settings.hover ? 160 : 120;
     buffer.blendFrom(resources_.title.close, close.x, close.y, 0, 0, closeAlpha);
     buffer.blendFrom(resources_.title.menu, settings.x, settings.y, 0, 0, settingsAlpha);
-
-    if (showGuard && model_.guard.visible()) {
-        guard_.draw(buffer);
-    }
 }
 
 void FlyoutView::updateOptButtons(Bitmap& buffer) {
+    updateOptButtons(buffer, Rectangle::create(0, 0, static_cast<int>(buffer.width()),
+                                               static_cast<int>(buffer.height())));
+}
+
+void FlyoutView::updateOptButtons(Bitmap& buffer, const RECT& clip) {
     auto& m = model_;
     auto& opt = m.menuBar;
     m.settings.visible = opt.visible;
@@ -326,9 +461,23 @@ void FlyoutView::updateOptButtons(Bitmap& buffer) {
 
     if (opt.visible) {
         BitmapContext ctx(buffer);
+        auto rect = [&ctx, &clip](int x, int y, unsigned w, unsigned h) {
+            RECT rc = Rectangle::intersect(Rectangle::create(x, y, static_cast<int>(w), static_cast<int>(h)), clip);
+            if (!Rectangle::empty(rc)) {
+                ctx.rect(rc);
+            }
+        };
+        auto blend = [&buffer, &clip](const Bitmap& image, int x, int y, std::uint8_t alpha) {
+            RECT rc = Rectangle::intersect(Rectangle::create(x, y, static_cast<int>(image.width()),
+                                                             static_cast<int>(image.height())), clip);
+            if (!Rectangle::empty(rc)) {
+                buffer.blendFrom(image, rc.left, rc.top, rc.left - x, rc.top - y,
+                                 Rectangle::width(rc), Rectangle::height(rc), alpha);
+            }
+        };
+
         ctx.color = model_.menuBarBackground;
-        ctx.rect(opt.x, opt.y,
-                 static_cast<int>(opt.w), static_cast<int>(opt.h) - PlanesGeometry::Y_OFFSET);
+        rect(opt.x, opt.y, opt.w, opt.h - PlanesGeometry::Y_OFFSET);
 
         ctx.color = Color(50, 50, 50);
 
@@ -344,158 +493,75 @@ void FlyoutView::updateOptButtons(Bitmap& buffer) {
             aboutAlpha = BUTTON_PRESSED;
         } else if (m.settings.hover) {
             settingsAlpha = BUTTON_HOVER;
-            ctx.rect(m.settings.x, m.settings.y,
-                     static_cast<int>(m.settings.w), static_cast<int>(m.settings.h));
+            rect(m.settings.x, m.settings.y, m.settings.w, m.settings.h);
         } else if (m.help.hover) {
             helpAlpha = BUTTON_HOVER;
-            ctx.rect(m.help.x, m.help.y,
-                     static_cast<int>(m.help.w), static_cast<int>(m.help.h));
+            rect(m.help.x, m.help.y, m.help.w, m.help.h);
         } else if (m.about.hover) {
             aboutAlpha = BUTTON_HOVER;
-            ctx.rect(m.about.x, m.about.y,
-                     static_cast<int>(m.about.w), static_cast<int>(m.about.h));
+            rect(m.about.x, m.about.y, m.about.w, m.about.h);
         }
 
         auto& settings = resources_.menuBar.settings;
         auto& help = resources_.menuBar.help;
         auto& about = resources_.menuBar.about;
-        buffer.blendFrom(settings, m.settings.x, m.settings.y, 0, 0, settingsAlpha);
-        buffer.blendFrom(help, m.help.x, m.help.y, 0, 0, helpAlpha);
-        buffer.blendFrom(about, m.about.x, m.about.y, 0, 0, aboutAlpha);
+        blend(settings, m.settings.x, m.settings.y, settingsAlpha);
+        blend(help, m.help.x, m.help.y, helpAlpha);
+        blend(about, m.about.x, m.about.y, aboutAlpha);
     }
 }
 
-unsigned FlyoutView::getLockMaterialIndex() {
+unsigned FlyoutView::getLockMaterialIndex() const {
     switch (model_.lockState()) {
         case LockState::DISABLED:
-            return FlyoutResources::LOCK_DISABLED_MAT;
+            return FlyoutScene::LOCK_DISABLED_MAT;
         case LockState::PRE_LOCKED: // not locked yet
         case LockState::READY:
-            return FlyoutResources::LOCK_OPEN_MAT;
+            return FlyoutScene::LOCK_OPEN_MAT;
         case LockState::PRE_COUNTDOWN: // not counting down yet
         case LockState::COUNTDOWN:
-            return FlyoutResources::LOCK_CANCEL_MAT;
+            return FlyoutScene::LOCK_CANCEL_MAT;
         case LockState::PRE_READY:  // not ready yet
         case LockState::LOCKED:
-            return FlyoutResources::LOCK_CLOSED_MAT;
+            return FlyoutScene::LOCK_CLOSED_MAT;
         default:
             assert(false);
-            return FlyoutResources::LOCK_OPEN_MAT; // default icon
+            return FlyoutScene::LOCK_OPEN_MAT; // default icon
     }
 }
 
 void FlyoutView::renderBackground(float value, FlyoutLayers layers, bool useCache) {
-    auto&& scene = resources_.scene;
-    auto&& buf = scene.renderBuffer;
-    buf.clear({0, 0, 0, 0});
-
-    scene.planesGeo.update(value);
-    scene.planesGeo.offset(0, 0, -3); // correct Z position
-    if (useCache) {
-        Bitmap *drawnLayers = nullptr;
-        if (isFloatEquals(value, 0.0f)) {
-            drawnLayers = &resources_.body.menuClosed.backLayers;
-        } else if (isFloatEquals(value, 1.0f)) {
-            drawnLayers = &resources_.body.menuOpen.backLayers;
-        }
-
-        if (drawnLayers) {
-            // skip layers below
-            layers.planes = false;
-            layers.circle = false;
-            layers.progressBackground = false;
-
-            auto& rc = scene.viewFrame;
-            buf.copyFrom(*drawnLayers, rc.left, rc.top, model_.body.x, model_.body.y,
-                         Rectangle::width(rc), Rectangle::height(rc));
-        }
-    }
-
-    scene.planes.visible = layers.planes;
-
-    auto angle = scene.planesGeo.angle();
-    auto center = scene.planesGeo.center();
-    float yValue = -3.0f * value;
-    float zValue = EASY_IN(value) * 1.5f;
-
-    //
-    // Some Z-offset values
-    //
-    float circleZOffset(2),
-            ringZOffset(-5),
-            progressZOffset(-10),
-            lockZOffset(-11);
-
-    scene.circle.visible = layers.circle;
-    if (layers.circle) {
-        scene.circleGeo.setSize(model_.circle.w, model_.circle.h);
-        scene.circleGeo.offset(0, yValue, circleZOffset * zValue);
-        scene.circleGeo.offset(model_.circle.offset3.x, model_.circle.offset3.y, model_.circle.offset3.z);
-        scene.circle.setRotY(angle);
-        scene.circle.setPosition(center[0], center[1], center[2]);
-    }
-
-    scene.progressBackground.visible = layers.progressBackground;
-    if (layers.progressBackground) {
-        scene.progressBackgroundGeo.setSize(model_.progressBackground.w, model_.progressBackground.h);
-        scene.progressBackgroundGeo.offset(0, yValue, ringZOffset * zValue);
-        scene.progressBackgroundGeo.offset(model_.progressBackground.offset3.x, model_.progressBackground.offset3.y,
-                                           model_.progressBackground.offset3.z);
-        scene.progressBackground.setRotY(angle);
-        scene.progressBackground.setPosition(center[0], center[1], center[2]);
-
-        int alpha = 255 - std::lround(75.0f * value);
-        alpha = std::clamp(alpha, 0, 255);
-        scene.progressBackgroundMat.alpha = static_cast<std::uint8_t>(alpha);
-    }
-
-    scene.progress.visible = layers.progress;
-    if (layers.progress) {
-        scene.progressGeo.setSize(model_.progress.w, model_.progress.h);
-        scene.progressGeo.offset(0, yValue, progressZOffset * zValue);
-        scene.progressGeo.offset(model_.progress.offset3.x, model_.progress.offset3.y, model_.progress.offset3.z);
-        scene.progress.setRotY(angle);
-        scene.progress.setPosition(center[0], center[1], center[2]);
-
-        drawProgress(scene.progressMat.bitmap, progressBar_.progress());
-        scene.progressMat.alpha = progressBar_.opacity();
-    }
+    resources_.sceneResource.require();
+    renderScene(resources_.scene, value, layers, useCache);
+}
 
-    scene.lock.visible = layers.lock;
-    if (layers.lock) {
-        scene.lockGeo.setSize(model_.lock.w, model_.lock.h);
-        scene.lockGeo.offset(0, yValue, lockZOffset * zValue);
-        scene.lockGeo.offset(model_.lock.offset3.x, model_.lock.offset3.y, model_.lock.offset3.z);
-        scene.lock.setRotY(angle);
-        if (layers.lockUpdateMaterial) {
-            scene.lockGeo.setMaterialIndex(0, getLockMaterialIndex());
-        }
-        scene.lock.setPosition(center[0], center[1], center[2]);
-    }
+void FlyoutView::renderScene(FlyoutScene& scene, float value, FlyoutLayers layers, bool useCache) const {
+    const Bitmap *backLayers = useCache ? cachedLayers(value) : nullptr;
+    scene.render(value, layers, sceneState(layers), backLayers, model_.body.x, model_.body.y);
+}
 
-    scene.keyboard.visible = layers.keyboard;
-    if (layers.keyboard) {
-        scene.keyboardGeo.setSize(model_.keyboard.w, model_.keyboard.h);
-        scene.keyboardGeo.offset(0, yValue, -18 * zValue);
-        scene.keyboardGeo.offset(model_.keyboard.offset3.x, model_.keyboard.offset3.y, model_.keyboard.offset3.z);
-        scene.keyboard.setRotY(angle);
-        scene.keyboard.setPosition(center[0] - 50.5f, center[1] + 37.8f, center[2]);
-        scene.keyboardEnabledMat.alpha = buttonOpacity_.opacity();
-        scene.keyboardDisabledMat.alpha = buttonOpacity_.opacity();
+const Bitmap *FlyoutView::cachedLayers(float value) const {
+    if (isFloatEquals(value, 0.0f)) {
+        return &resources_.body.menuClosed.backLayers;
     }
-
-    scene.mouse.visible = layers.mouse;
-    if (layers.mouse) {
-        scene.mouseGeo.setSize(model_.mouse.w, model_.mouse.h);
-        scene.mouseGeo.offset(0, yValue, -18 * zValue);
-        scene.mouseGeo.offset(model_.mouse.offset3.x, model_.mouse.offset3.y, model_.mouse.offset3.z);
-        scene.mouse.setRotY(angle);
-        scene.mouse.setPosition(center[0] + 50.5f, center[1] + 37.8f, center[2]);
-        scene.mouseEnabledMat.alpha = buttonOpacity_.opacity();
-        scene.mouseDisabledMat.alpha = buttonOpacity_.opacity();
+    if (isFloatEquals(value, 1.0f)) {
+        return &resources_.body.menuOpen.backLayers;
     }
+    return nullptr;
+}
 
-    scene.renderer.render(scene.objects);
+FlyoutSceneState FlyoutView::sceneState(FlyoutLayers layers) const {
+    static const FlyoutProgressBar idleProgressBar;
+    static const FlyoutButtonOpacity idleButtonOpacity;
+    const auto& progressBar = layers.idleState ? idleProgressBar : progressBar_;
+    const auto& buttonOpacity = layers.idleState ? idleButtonOpacity : buttonOpacity_;
+
+    return {
+            .progress = progressBar.progress(),
+            .progressOpacity = progressBar.opacity(),
+            .buttonOpacity = buttonOpacity.opacity(),
+            .lockMaterial = layers.lockUpdateMaterial ? getLockMaterialIndex() : 0,
+    };
 }
 
 void FlyoutView::drawBackground(Bitmap& buffer) const {
@@ -512,6 +578,9 @@ void FlyoutView::setForeground(HWND hWnd) {
 
 void FlyoutView::setGuardActiveState(UnlockGuardActiveState state) {
     model_.guard.setActiveState(state);
+    if (state == UnlockGuardActiveState::INACTIVE) {
+        guard_.close(); // the hide animation has its frames already
+    }
 }
 
 void FlyoutView::resetGuard() {
@@ -524,11 +593,14 @@ void FlyoutView::resetGuard() {
 }
 
 void FlyoutView::updateButtonMaterial() {
+    if (!resources_.sceneResource.loaded()) {
+        return; // initializeScene() sets the materials up
+    }
     auto& sc = resources_.scene;
     sc.keyboardGeo.setMaterialIndex(0, model_.keyboard.checked ?
-                                       FlyoutResources::KEYBOARD_ENABLED_MAT : FlyoutResources::KEYBOARD_DISABLED_MAT);
+                                       FlyoutScene::KEYBOARD_ENABLED_MAT : FlyoutScene::KEYBOARD_DISABLED_MAT);
     sc.mouseGeo.setMaterialIndex(0, model_.mouse.checked ?
-                                    FlyoutResources::MOUSE_ENABLED_MAT : FlyoutResources::MOUSE_DISABLED_MAT);
+                                    FlyoutScene::MOUSE_ENABLED_MAT : FlyoutScene::MOUSE_DISABLED_MAT);
 }
 
 bool FlyoutView::updateButtonOpacity() {
@@ -21,6 +21,7 @@
 #define FLYOUT_VIEW_H
 
 #include <functional>
+#include <optional>
 
 #include "app/FlyoutButtonOpacity.h"
 #include "app/FlyoutLayers.h"
@@ -29,13 +30,15 @@
 #include "app/FlyoutResources.h"
 #include "app/animation/FlyoutAnimation.h"
 #include "app/guard/UnlockGuardView.h"
+#include "gfx/DirtyRegion.h"
 
 namespace litelockr {
 
 class FlyoutView: public FlyoutAnimation<FlyoutView> {
 public:
-    FlyoutView(Bitmap& buffer, FlyoutModel& model)
+    FlyoutView(Bitmap& buffer, DirtyRegion& dirtyRegion, FlyoutModel& model)
             : buffer_(buffer),
+              dirtyRegion_(dirtyRegion),
               model_(model),
               guard_(buffer, model.guard) {}
 
@@ -46,18 +49,25 @@ public:
     void initialize(HWND hWnd);
 
     void setScenePlaneLockVisible(bool visible);
-    void drawProgress(Bitmap& buffer, float progress) const;
     void checkAction(AnimationAction actionBefore);
 
     bool needsUpdate();
 
+    // redraws the changed parts of the buffer and marks them dirty
     void draw();
     void draw(Bitmap& buffer, bool isHidden, float menuBar = 0, bool showGuard = true);
 
+    // the whole buffer has been changed, e.g. by an animation frame
+    void invalidate();
+
     void updateOptButtons(Bitmap& buffer);
-    unsigned getLockMaterialIndex();
+    // draws the menu bar over the pixels inside the clip rectangle only
+    void updateOptButtons(Bitmap& buffer, const RECT& clip);
+    [[nodiscard]] unsigned getLockMaterialIndex() const;
 
     void renderBackground(float value, FlyoutLayers layers, bool useCache);
+    // renders into the given scene, one per thread, see FlyoutScene::createFrom()
+    void renderScene(FlyoutScene& scene, float value, FlyoutLayers layers, bool useCache) const;
     void drawBackground(Bitmap& buffer) const;
     static void setForeground(HWND hWnd);
 
@@ -76,16 +86,63 @@ public:
 
     const FlyoutResources& resources() const { return resources_; }
 
+    // loads one more resource ahead of its use, returns false when everything has been loaded
+    bool warmUpResources() { return resources_.manager.warmUpNext(); }
+    void logResourceUsage() const;
+
 private:
     void initializeImages();
     void initializeScene();
+    void initializeBackLayers();
     void checkImageSizes();
     void drawMenuBarMaterials();
+    void drawTitle(Bitmap& buffer) const;
+    // the progress, the button opacity and the lock icon the scene is rendered with
+    [[nodiscard]] FlyoutSceneState sceneState(FlyoutLayers layers) const;
+    // the planes, the circle and the ring behind the rest of the scene, rendered once for the menu position
+    [[nodiscard]] const Bitmap *cachedLayers(float value) const;
+
+    //
+    // Everything the parts of the flyout are drawn from
+    //
+    struct BodyState {
+        float menuBar;
+        float progress;
+        std::uint8_t progressOpacity;
+        std::uint8_t buttonOpacity;
+        unsigned lockMaterial;
+        bool keyboardChecked;
+        bool mouseChecked;
+        unsigned menuButtons;
+
+        bool operator==(const BodyState&) const = default;
+    };
+
+    struct TitleState {
+        unsigned titleButtons;
+
+        bool operator==(const TitleState&) const = default;
+    };
+
+    struct DrawState {
+        BodyState body;
+        TitleState title;
+
+        bool operator==(const DrawState&) const = default;
+    };
+
+    DrawState currentDrawState(float menuBar);
+    bool drawChangedParts(const BodyState& state, const BodyState& drawn);
+    [[nodiscard]] RECT bodyRect() const;
+    [[nodiscard]] RECT titleRect() const;
 
     bool hasInitialized_ = false;
     bool needsUpdate_ = false;
 
     Bitmap& buffer_;
+    DirtyRegion& dirtyRegion_;
+    std::optional<DrawState> drawState_; // the state of the buffer content
+    std::optional<DrawState> guardBackground_; // the state of the flyout the guard has blurred
     FlyoutModel& model_;
     UnlockGuardView guard_;
 
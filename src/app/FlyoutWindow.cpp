@@ -37,7 +37,7 @@
 
 namespace litelockr {
 
-FlyoutWindow::FlyoutWindow() : view_(buffer_, model_) {
+FlyoutWindow::FlyoutWindow() : view_(buffer_, dirtyRegion_, model_) {
     onCommand(IDM_EXIT, []() { AppEvents::send(AppEvent::EXIT); });
     onCommand(IDM_LOCK, []() { AppEvents::send(AppEvent::LOCK); });
     onCommand(IDM_UNLOCK, []() { AppEvents::send(AppEvent::UNLOCK); });
@@ -94,29 +94,14 @@ void FlyoutWindow::create(HWND hWndParent /*= nullptr*/) {
 
 void FlyoutWindow::dispose() {
     assert(hWnd);
+    warmUpTimer_.setEnabled(false);
+    view_.logResourceUsage();
     WTSUnRegisterSessionNotification(hWnd);
 }
 
 void FlyoutWindow::tick() {
     inputLocker_.tick();
 
-    if (hideWindowTimer_.timeout()) {
-        hideWindowTimer_.setEnabled(false);
-        AppEvents::send(AppEvent::HIDE);
-    }
-    if (hideTrayIconTimer_.timeout()) {
-        hideTrayIconTimer_.setEnabled(false);
-        NotificationArea::deleteIcon();
-    }
-    if (displayChangeDelay_.timeout()) {
-        displayChangeDelay_.setEnabled(false);
-        onDisplayChange();
-    }
-    if (model_.locked() && inactivityTimer_.timeout()) {
-        inactivityTimer_.setEnabled(false);
-        AppEvents::send(AppEvent::HIDE);
-    }
-
     //
     // Updates the systray icon
     //
@@ -146,6 +131,32 @@ void FlyoutWindow::tick() {
     doAfterWindowUpdate();
 }
 
+AppClock::Duration FlyoutWindow::nextTimeout() const {
+    //
+    // Hidden in the tray and unlocked, nothing to poll until a message or a timer comes
+    //
+    if (!model_.visible() && !model_.locked() && model_.lockState() == LockState::READY &&
+        !markedForUpdate_ && !AppTimer::isAnimationActive() && !view_.hasAnimation()) {
+        return AppTimerListener::IDLE_PERIOD;
+    }
+    return AppTimerListener::FRAME_PERIOD;
+}
+
+void FlyoutWindow::onInactivity() {
+    if (model_.locked()) {
+        AppEvents::send(AppEvent::HIDE);
+    } else {
+        inactivityTimer_.setEnabled(true);
+    }
+}
+
+void FlyoutWindow::warmUpResources() {
+    // one resource at a time and only between the animations
+    if (AppTimer::isAnimationActive() || view_.hasAnimation() || view_.warmUpResources()) {
+        warmUpTimer_.setEnabled(true);
+    }
+}
+
 void FlyoutWindow::update() {
     if (!view_.hasInitialized()) {
         return;
@@ -153,7 +164,7 @@ void FlyoutWindow::update() {
 
     if (markedForUpdate_) {
         markedForUpdate_ = false;
-        updateWindow();
+        updateDirtyRegion();
     }
 }
 
@@ -202,12 +213,17 @@ void FlyoutWindow::startup() {
     model_.setVisible(true);
 
     show(false, {.animation = false});
-    doAfterAnimation(view_.resources().startupAnimation, false);
+    doAfterAnimation(view_.resources().startupAnimation.peek(), false);
+
+    if (SettingsData::instance().warmUpResources.value()) {
+        warmUpTimer_.setEnabled(true);
+    }
 }
 
 void FlyoutWindow::redraw() {
     view_.draw();
     markedForUpdate_ = true;
+    AppTimer::wakeUp();
 }
 
 
@@ -559,7 +575,7 @@ void FlyoutWindow::onMouseMove(WPARAM /*wParam*/, LPARAM lParam) {
 
     if (markedForUpdate_) {
         markedForUpdate_ = false;
-        updateWindow();
+        updateDirtyRegion();
     }
 }
 
@@ -49,6 +49,7 @@ public:
     void create(HWND hWndParent = nullptr);
     void dispose();
     void tick();
+    [[nodiscard]] AppClock::Duration nextTimeout() const;
     void update();
 
     struct ShowOptions {
@@ -91,6 +92,8 @@ private:
     void onTrayIconContextMenu();
     void onSettingChange() const;
     void onDisplayChange() const;
+    void onInactivity();
+    void warmUpResources();
     void updateLightMode() const;
 
     void doAfterWindowUpdate();
@@ -101,10 +104,17 @@ private:
     bool fireGuardHideAnimation_ = false;
     bool fireGuardExitCommand_ = false;
 
-    TimeCounter hideWindowTimer_{std::chrono::milliseconds(GetDoubleClickTime()), false};
-    TimeCounter hideTrayIconTimer_{std::chrono::milliseconds(1500), false};
-    TimeCounter displayChangeDelay_{std::chrono::milliseconds(1500), false};
-    TimeCounter inactivityTimer_{std::chrono::seconds(15), false};
+    DelayTimer hideWindowTimer_{std::chrono::milliseconds(GetDoubleClickTime()), [] {
+        AppEvents::send(AppEvent::HIDE);
+    }};
+    DelayTimer hideTrayIconTimer_{std::chrono::milliseconds(1500), [] {
+        NotificationArea::deleteIcon();
+    }};
+    DelayTimer displayChangeDelay_{std::chrono::milliseconds(1500), [this] {
+        onDisplayChange();
+    }};
+    DelayTimer inactivityTimer_{std::chrono::seconds(15), [this] { onInactivity(); }};
+    DelayTimer warmUpTimer_{std::chrono::seconds(1), [this] { warmUpResources(); }};
 
     bool markedForUpdate_ = false;
     bool mouseInside_ = false;
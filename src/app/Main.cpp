@@ -23,10 +23,13 @@
 #include <VersionHelpers.h>
 #include "app/AppMessages.h"
 #include "app/HotkeyHandler.h"
+#include "app/Sounds.h"
 #include "app/event/AppEventHandler.h"
 #include "gui/WindowUtils.h"
+#include "lock/HookThread.h"
 #include "log/Logger.h"
 #include "sys/BinaryResource.h"
+#include "sys/FrameScheduler.h"
 #include "sys/MiniDump.h"
 
 namespace litelockr {
@@ -34,15 +37,17 @@ namespace litelockr {
 void doMessageLoop(AppTimer& appTimer) {
     using namespace std::chrono_literals;
 
-    TimeCounter counter(32ms);
-
-    constexpr UINT MESSAGE_LOOP_WAKEUP_TIMER = 1000;
-    SetTimer(nullptr, MESSAGE_LOOP_WAKEUP_TIMER, 150, nullptr);
+    FrameScheduler scheduler(AppTimerListener::FRAME_PERIOD, AppTimerListener::IDLE_PERIOD);
 
     for (;;) {
         MSG msg;
         while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            AppTimer::wakeUp(); // the message may change the state of any listener
+
             if (msg.message == WM_QUIT) {
+                if (scheduler.highResolution()) {
+                    timeEndPeriod(1);
+                }
                 return;
             }
 
@@ -52,15 +57,28 @@ void doMessageLoop(AppTimer& appTimer) {
             }
         }
 
-        if (counter.timeout()) {
+        if (scheduler.tickDue()) {
             appTimer.fireTimeout();
+            scheduler.tickFired();
+        }
+
+        bool animationActive = AppTimer::isAnimationActive();
+        if (scheduler.updateHighResolution(animationActive)) {
+            // the 1 ms timer resolution is needed for smooth animation only
+            if (animationActive) {
+                timeBeginPeriod(1);
+            } else {
+                timeEndPeriod(1);
+            }
         }
 
-        if (AppTimer::isAnimationActive()) {
-            // use PeekMessage for smooth animation
-            Sleep(1); // sleeps for the smallest time interval to avoid high CPU usage
-        } else {
-            WaitMessage();
+        //
+        // sleeps until a message arrives, the next frame is due or a timer expires
+        //
+        auto waitTime = scheduler.waitTime(animationActive, AppTimer::nextDeadline());
+        if (waitTime > 0ms) {
+            MsgWaitForMultipleObjectsEx(0, nullptr, static_cast<DWORD>(waitTime.count()),
+                                        QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         }
     }
 }
@@ -176,6 +194,9 @@ int winMain() {
     appTimer.addListener(AppEvents::instance());
     appTimer.addListener(appEventHandler);
 
+    HookThread::prepareThreads();
+    Sounds::initialize();
+
     flyoutAppTimerListener.window().startup();
 
     //
@@ -183,11 +204,10 @@ int winMain() {
     //
     HotkeyHandler::instance().initialize(SettingsData::instance().hotkey.value());
 
-    timeBeginPeriod(1);
-
     doMessageLoop(appTimer);
 
-    timeEndPeriod(1);
+    Sounds::shutdown();
+    HookThread::destroyThreads();
 
     if (hDigitFont) {
         RemoveFontMemResourceEx(hDigitFont);
@@ -19,32 +19,51 @@
 
 #include "Sounds.h"
 
-#include <thread>
+#include <cassert>
+#include <memory>
 
 #include "ini/SettingsData.h"
+#include "res/Resources.h"
 #include "sys/BinaryResource.h"
-#include "sys/Process.h"
+#include "sys/audio/AudioEngine.h"
+#include "sys/audio/WaveAudioOutput.h"
 
 namespace litelockr {
 
+namespace {
+
+std::unique_ptr<AudioEngine> engine;
+
+} // namespace
+
+void Sounds::initialize() {
+    assert(!engine);
+    engine = std::make_unique<AudioEngine>(std::make_unique<WaveAudioOutput>());
+
+    //
+    // The .WAV resources are parsed once
+    //
+    for (int resourceId: {IDB_SND_START_LOCKING, IDB_SND_FINISH_LOCKING, IDB_SND_UNLOCK,
+                          IDB_SND_CANCEL, IDB_SND_SHAKE, IDB_SND_WRONG}) {
+        engine->addSound(resourceId, Bin::data(resourceId), Bin::size(resourceId));
+    }
+    engine->start();
+}
+
+void Sounds::shutdown() {
+    engine.reset();
+}
+
 void Sounds::play(int resourceId) {
     if (!SettingsData::instance().playSounds.value()) {
         // All sounds are disabled
         return;
     }
 
-    //
-    // .WAV data pointer
-    //
-    auto soundData = reinterpret_cast<LPCWSTR>(Bin::data(resourceId));
-
-    //
-    // Play the sound on a separate independent thread
-    //
-    std::thread thd([soundData]() {
-        PlaySound(soundData, Process::moduleInstance(), SND_MEMORY);
-    });
-    thd.detach();
+    if (engine) {
+        engine->setOverlap(static_cast<SoundOverlap>(SettingsData::instance().soundOverlap.value()));
+        engine->play(resourceId);
+    }
 }
 
 } // namespace litelockr
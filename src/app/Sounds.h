@@ -24,6 +24,9 @@ namespace litelockr {
 
 class Sounds {
 public:
+    static void initialize();
+    static void shutdown();
+
     static void play(int resourceId);
 };
 
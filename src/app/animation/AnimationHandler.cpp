@@ -29,6 +29,7 @@ void AnimationHandler::runAnimation(AnimationFrameSet& animation, DWORD delayBef
     animation_ = animation;
     delay_.destroy();
     delay_.create(std::chrono::microseconds(delayBeforeRun));
+    AppTimer::wakeUp();
 }
 
 bool AnimationHandler::ready() {
@@ -20,6 +20,12 @@
 #ifndef FLYOUT_ANIMATION_H
 #define FLYOUT_ANIMATION_H
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <omp.h>
+
 #include "AnimationFrameSet.h"
 #include "AnimationHandler.h"
 #include "app/FlyoutLayers.h"
@@ -27,8 +33,15 @@
 #include "app/FlyoutResources.h"
 #include "app/LockState.h"
 #include "app/Sounds.h"
+#include "app/Version.h"
+#include "gfx/BitmapContext.h"
+#include "gfx/BitmapPool.h"
+#include "gui/WindowUtils.h"
+#include "log/Logger.h"
 #include "TransitionEffects.h"
 #include "ren/Material.h"
+#include "sys/AppClock.h"
+#include "sys/Process.h"
 #include "sys/Rectangle.h"
 
 #include "res/Resources.h"
@@ -46,93 +59,131 @@ public:
 
     void initializeAnimations() {
         auto& res = view().resources_;
-        const auto& model = view().model_;
-
-        // startup animation
-        res.startupAnimation.loadPng(IDB_ANIM_STARTUP, NumberOfFrames::STARTUP);
-        res.startupAnimation.setId(AnimationId::STARTUP);
-        res.startupAnimation.setPosition(FlyoutModel::MARGIN, FlyoutModel::MARGIN);
-
-        res.openMenuAnimation.loadPng(IDB_ANIM_OPEN_MENU, NumberOfFrames::OPEN_MENU);
-
-        res.closeMenuAnimation.loadPng(IDB_ANIM_CLOSE_MENU, NumberOfFrames::CLOSE_MENU);
-
-        auto& backMC = res.body.menuClosed.backLayers;
-        auto& backMO = res.body.menuOpen.backLayers;
-        backMC.createAs(view().buffer_);
-        backMO.createAs(view().buffer_);
-
-        view().renderBackground(0, FlyoutLayers::background(), false);
-        view().drawBackground(backMC);
-
-        view().renderBackground(1, FlyoutLayers::background(), false);
-        view().drawBackground(backMO);
+        auto& manager = res.manager;
+
+        // the id is passed on after the startup, the frames are not played
+        res.startupAnimation.peek().setId(AnimationId::STARTUP);
+        res.startupAnimation.peek().setPosition(FlyoutModel::MARGIN, FlyoutModel::MARGIN);
+        manager.add(res.startupAnimation, L"startupAnimation", [&res] {
+            res.startupAnimation.peek().loadResource(IDB_ANIM_STARTUP, NumberOfFrames::STARTUP);
+            res.startupAnimation.peek().compress();
+        }, false);
+
+        auto& menuClosed = res.body.menuClosed;
+        auto& menuOpen = res.body.menuOpen;
+        addLockAnimation(menuClosed.startLockingAnimation, L"startLockingAnimation",
+                         AnimationId::START_LOCKING, IDB_ANIM_START_LOCKING, NumberOfFrames::START_LOCKING, false);
+        addLockAnimation(menuClosed.finishLockingAnimation, L"finishLockingAnimation",
+                         AnimationId::FINISH_LOCKING, IDB_ANIM_FINISH_LOCKING, NumberOfFrames::FINISH_LOCKING, false);
+        addLockAnimation(menuClosed.unlockAnimation, L"unlockAnimation",
+                         AnimationId::UNLOCK, IDB_ANIM_UNLOCK, NumberOfFrames::UNLOCK, false);
+        addLockAnimation(menuClosed.cannotUnlockAnimation, L"cannotUnlockAnimation",
+                         AnimationId::CANNOT_UNLOCK, IDB_ANIM_CANNOT_UNLOCK, NumberOfFrames::CANNOT_UNLOCK, false);
+
+        manager.add(res.openMenuAnimation, L"openMenuAnimation", [&res] {
+            res.openMenuAnimation.peek().loadResource(IDB_ANIM_OPEN_MENU, NumberOfFrames::OPEN_MENU);
+            res.openMenuAnimation.peek().compress();
+        });
+        manager.add(res.closeMenuAnimation, L"closeMenuAnimation", [&res] {
+            res.closeMenuAnimation.peek().loadResource(IDB_ANIM_CLOSE_MENU, NumberOfFrames::CLOSE_MENU);
+            res.closeMenuAnimation.peek().compress();
+        });
+
+        addLockAnimation(menuOpen.startLockingAnimation, L"startLockingAnimation (menu open)",
+                         AnimationId::START_LOCKING, IDB_ANIM_START_LOCKING, NumberOfFrames::START_LOCKING, true);
+        addLockAnimation(menuOpen.finishLockingAnimation, L"finishLockingAnimation (menu open)",
+                         AnimationId::FINISH_LOCKING, IDB_ANIM_FINISH_LOCKING, NumberOfFrames::FINISH_LOCKING, true);
+        addLockAnimation(menuOpen.unlockAnimation, L"unlockAnimation (menu open)",
+                         AnimationId::UNLOCK, IDB_ANIM_UNLOCK, NumberOfFrames::UNLOCK, true);
+        addLockAnimation(menuOpen.cannotUnlockAnimation, L"cannotUnlockAnimation (menu open)",
+                         AnimationId::CANNOT_UNLOCK, IDB_ANIM_CANNOT_UNLOCK, NumberOfFrames::CANNOT_UNLOCK, true);
+    }
 
-        {
-            //
-            //get background
-            //
-            Bitmap bg;
-            bg.create(model.lock.w, model.lock.h);
-            unsigned w = bg.width();
-            unsigned h = bg.height();
-            bg.copyFrom(backMC, 0, 0, model.lock.x, model.lock.y, w, h);
-
-            {
-                AnimationFrameSet startLockingAnimation;
-                startLockingAnimation.loadPng(IDB_ANIM_START_LOCKING, NumberOfFrames::START_LOCKING);
-
-                auto& animMC = res.body.menuClosed.startLockingAnimation;
-                animMC.createWithBackground(startLockingAnimation.bitmap(), startLockingAnimation.size(), bg);
-                animMC.setPosition(model.lock.x, model.lock.y);
-                animMC.setId(AnimationId::START_LOCKING);
-
-                auto& animMO = res.body.menuOpen.startLockingAnimation;
-                createLockAnimation(startLockingAnimation, animMO);
-                animMO.setId(AnimationId::START_LOCKING);
+    // the lock strip is composed over the back layers, or over the scene rendered with the open menu
+    void addLockAnimation(Lazy<AnimationFrameSet>& animation, const wchar_t *name,
+                          AnimationId id, int resourceId, unsigned numFrames, bool menuOpen) {
+        view().resources_.manager.add(animation, name, [this, &animation, id, resourceId, numFrames, menuOpen] {
+            auto& res = view().resources_;
+            const auto& model = view().model_;
+            res.sceneResource.require();
+
+            auto& anim = animation.peek();
+            bool rendered = false;
+            if (menuOpen) {
+                if (!animationCache().load(resourceId, anim)) {
+                    AnimationFrameSet strip;
+                    strip.loadResource(resourceId, numFrames);
+                    createLockAnimation(strip, anim);
+                    rendered = true;
+                }
+                auto frame = FlyoutScene::lockAnimationFrame();
+                anim.setPosition(model.body.x + frame.left, model.body.y + frame.top);
+            } else {
+                AnimationFrameSet strip;
+                strip.loadResource(resourceId, numFrames);
+
+                Bitmap bg;
+                bg.create(model.lock.w, model.lock.h);
+                bg.copyFrom(res.body.menuClosed.backLayers, 0, 0, model.lock.x, model.lock.y,
+                            bg.width(), bg.height());
+
+                anim.createWithBackground(strip.bitmap(), strip.size(), bg);
+                anim.setPosition(model.lock.x, model.lock.y);
             }
+            anim.setId(id);
+            anim.compress(); // kept for the whole session
 
-            {
-                AnimationFrameSet finishLockingAnimation;
-                finishLockingAnimation.loadPng(IDB_ANIM_FINISH_LOCKING, NumberOfFrames::FINISH_LOCKING);
-
-                auto& animMC = res.body.menuClosed.finishLockingAnimation;
-                animMC.createWithBackground(finishLockingAnimation.bitmap(), finishLockingAnimation.size(), bg);
-                animMC.setPosition(model.lock.x, model.lock.y);
-                animMC.setId(AnimationId::FINISH_LOCKING);
-
-                auto& animMO = res.body.menuOpen.finishLockingAnimation;
-                createLockAnimation(finishLockingAnimation, animMO);
-                animMO.setId(AnimationId::FINISH_LOCKING);
+            if (rendered) {
+                storeLockAnimation(resourceId, anim);
             }
+        });
+    }
 
-            {
-                AnimationFrameSet cannotUnlockAnimation;
-                cannotUnlockAnimation.loadPng(IDB_ANIM_CANNOT_UNLOCK, NumberOfFrames::CANNOT_UNLOCK);
-
-                auto& animMC = res.body.menuClosed.cannotUnlockAnimation;
-                animMC.createWithBackground(cannotUnlockAnimation.bitmap(), cannotUnlockAnimation.size(), bg);
-                animMC.setPosition(model.lock.x, model.lock.y);
-                animMC.setId(AnimationId::CANNOT_UNLOCK);
-
-                auto& animMO = res.body.menuOpen.cannotUnlockAnimation;
-                createLockAnimation(cannotUnlockAnimation, animMO);
-                animMO.setId(AnimationId::CANNOT_UNLOCK);
-            }
+    //
+    // The cache file of the lock animations with the open menu, next to the settings. The frames depend on the
+    // resources and the code of the executable, the layout of the flyout and the state of its buttons.
+    // The flyout is not scaled with the DPI and has no theme, so neither is a part of the key.
+    //
+    constexpr static size_t NUMBER_OF_LOCK_ANIMATIONS = 4;
 
-            {
-                AnimationFrameSet unlockAnimation;
-                unlockAnimation.loadPng(IDB_ANIM_UNLOCK, NumberOfFrames::UNLOCK);
+    [[nodiscard]] uint64_t lockAnimationKey() {
+        const auto& res = view().resources_;
+        const auto& model = view().model_;
+        wchar_t exePath[MAX_PATH] = {0};
+        GetModuleFileName(nullptr, exePath, MAX_PATH);
+
+        FrameCache::Key key;
+        key.add(std::wstring_view(APP_VERSION)).addFile(exePath);
+        auto addBounds = [&key](const auto& c) { key.add(c.x).add(c.y).add(c.w).add(c.h); };
+        addBounds(model.body);
+        addBounds(model.lock);
+        addBounds(model.keyboard);
+        addBounds(model.mouse);
+        key.add(model.keyboard.checked).add(model.mouse.checked);
+        key.add(res.scene.renderBuffer.width()).add(res.scene.renderBuffer.height()).add(res.scene.viewFrame);
+        return key.value();
+    }
 
-                auto& animMC = res.body.menuClosed.unlockAnimation;
-                animMC.createWithBackground(unlockAnimation.bitmap(), unlockAnimation.size(), bg);
-                animMC.setPosition(model.lock.x, model.lock.y);
-                animMC.setId(AnimationId::UNLOCK);
+    // reopened when the buttons have been toggled since, the frames of the old state are dropped
+    FrameCache& animationCache() {
+        auto& cache = view().resources_.animationCache;
+        const auto key = lockAnimationKey();
+        if (!cache.isOpen() || cache.key() != key) {
+            cache.open(Process::modulePath() + APP_NAME + L".cache", key);
+        }
+        return cache;
+    }
 
-                auto& animMO = res.body.menuOpen.unlockAnimation;
-                createLockAnimation(unlockAnimation, animMO);
-                animMO.setId(AnimationId::UNLOCK);
-            }
+    // the key is checked again, the frames are not stored if the buttons have been toggled while rendering
+    void storeLockAnimation(int resourceId, const AnimationFrameSet& anim) {
+        auto& cache = view().resources_.animationCache;
+        if (!cache.isOpen() || cache.key() != lockAnimationKey()) {
+            LOG_DEBUG(L"[FlyoutAnimation] The state has changed, frames %d are not cached", resourceId);
+            return;
+        }
+        cache.store(resourceId, anim);
+        if (cache.numStored() == NUMBER_OF_LOCK_ANIMATIONS) {
+            cache.save();
         }
     }
 
@@ -146,6 +197,7 @@ public:
             }
 
             ah.drawLastFrame(view().buffer_);
+            view().invalidate();
             ah.free();
             afterAnimation_(animation, true);
 
@@ -178,6 +230,7 @@ public:
             }
 
             bool finished = ah.draw(view().buffer_);
+            view().invalidate();
 
             if (finished) {
                 ah.free();
@@ -193,46 +246,39 @@ public:
         return animationHandler_.active();
     }
 
+    // the animation is running or waiting for its start
+    [[nodiscard]] bool hasAnimation() const {
+        return !animationHandler_.empty();
+    }
+
     void createLockAnimation(AnimationFrameSet& animPlane, AnimationFrameSet& result) {
-        auto& res = view().resources_;
-        const auto& model = view().model_;
+        assert(!animPlane.isCompressed()); // the frames are viewed by the render threads at once
 
-        auto&& scene = res.scene;
-        auto frame3 = Rectangle::create(83, 14, 44, 70);
+        auto frame3 = FlyoutScene::lockAnimationFrame();
         int fw = Rectangle::width(frame3);
         int fh = Rectangle::height(frame3);
 
-        unsigned w = animPlane.width();
-        unsigned h = animPlane.height();
         unsigned frames = animPlane.size();
-
-        Bitmap buf, tex;
-        buf.create(fw, fh);
-        tex.create(w, h);
         result.recreate(fw, fh, frames);
 
         FlyoutLayers layers = FlyoutLayers::all();
         layers.lockUpdateMaterial = false;
-
-        auto& mat = scene.lock.material(FlyoutResources::LOCK_BUFFER_MAT);
-        scene.lockGeo.setMaterialIndex(0, FlyoutResources::LOCK_BUFFER_MAT);
-
-        animPlane.begin();
-        for (unsigned i = 0; i < frames; i++) {
-            animPlane.drawFrame(tex, 0, 0);
-
-            mat.create(tex);
-            view().renderBackground(1, layers, true);
-
-            auto& rc = res.scene.viewFrame;
-            buf.copyFrom(res.scene.renderBuffer, 0, 0, rc.left + frame3.left, rc.top + frame3.top,
-                         fw, fh);
+        layers.idleState = true;
+
+        renderFrames(frames, [this, &animPlane, &result, &layers, frame3, fw, fh](auto& scene, Bitmap& buf,
+                                                                                 unsigned i) {
+            auto& mat = scene.lock.material(FlyoutScene::LOCK_BUFFER_MAT);
+            scene.lockGeo.setMaterialIndex(0, FlyoutScene::LOCK_BUFFER_MAT);
+            mat.create(animPlane, i); // textures the plane with the frame in place
+            view().renderScene(scene, 1, layers, true);
+
+            auto& rc = scene.viewFrame;
+            if (buf.isNull()) {
+                buf.create(fw, fh);
+            }
+            buf.copyFrom(scene.renderBuffer, 0, 0, rc.left + frame3.left, rc.top + frame3.top, fw, fh);
             result.addFrame(i, buf);
-
-            animPlane.nextFrame();
-        }
-
-        result.setPosition(model.body.x + frame3.left, model.body.y + frame3.top);
+        });
     }
 
     void createMenuAnimation(AnimationFrameSet& result, const AnimationFrameSet& baseAnimation,
@@ -250,30 +296,59 @@ public:
         const int width = Rectangle::width(viewFrame);
         const int height = Rectangle::height(viewFrame);
 
-        Bitmap frame;
-        frame.create(width, height);
         FrameSet anim;
         anim.recreate(width, height, values.size());
 
-        for (unsigned i = 0; i < values.size(); i++) {
-            float v = values[i];
-
-            view().renderBackground(v, layers, false);
-            frame.copyFrom(res.scene.renderBuffer, 0, 0, viewFrame.left, viewFrame.top,
-                           width, height);
+        renderFrames(values.size(), [this, &values, &anim, &layers, width, height](auto& scene, Bitmap& frame,
+                                                                                  unsigned i) {
+            view().renderScene(scene, values[i], layers, false);
 
+            auto& rc = scene.viewFrame;
+            if (frame.isNull()) {
+                frame.create(width, height);
+            }
+            frame.copyFrom(scene.renderBuffer, 0, 0, rc.left, rc.top, width, height);
             anim.addFrame(i, frame);
-        }
+        });
 
         result.bitmap().blendFrom(anim.bitmap(), 0, 0);
         result.begin();
     }
 
+    //
+    // Renders the frames on all the cores. Every thread renders into a scene of its own, and the frames are
+    // put into their places in the strip, so the result does not depend on the number of threads.
+    //
+    template<typename RenderFrame>
+    void renderFrames(unsigned numFrames, RenderFrame&& renderFrame) {
+        view().resources_.sceneResource.require(); // the scenes share its images
+
+        const auto started = AppClock::now();
+        const int numThreads = std::clamp(static_cast<int>(numFrames), 1, omp_get_max_threads());
+        std::vector<std::unique_ptr<FlyoutScene>> scenes(numThreads);
+
+#pragma omp parallel num_threads(numThreads)
+        {
+            auto& scene = scenes[omp_get_thread_num()];
+            scene = std::make_unique<FlyoutScene>();
+            scene->createFrom(view().resources_.scene);
+            Bitmap frame;
+
+#pragma omp for schedule(dynamic)
+            for (int i = 0; i < static_cast<int>(numFrames); i++) {
+                renderFrame(*scene, frame, static_cast<unsigned>(i));
+            }
+        }
+
+        LOG_VERBOSE(L"[FlyoutAnimation] %u frames in %.2f ms on %d threads", numFrames,
+                    std::chrono::duration<double, std::milli>(AppClock::now() - started).count(), numThreads);
+    }
+
     void createShowMenuAnimation() {
         auto& res = view().resources_;
         const auto& model = view().model_;
         auto&& anim = res.showMenuAnimation;
-        createMenuAnimation(anim, res.openMenuAnimation, res.openMenuValues);
+        createMenuAnimation(anim, res.openMenuAnimation.get(), res.openMenuValues);
         anim.setId(AnimationId::SHOW_MENU);
         anim.setPosition(model.body.x, model.body.y);
         runAnimation(anim);
@@ -283,22 +358,39 @@ public:
         auto& res = view().resources_;
         const auto& model = view().model_;
         auto&& anim = res.hideMenuAnimation;
-        createMenuAnimation(anim, res.closeMenuAnimation, res.closeMenuValues);
+        createMenuAnimation(anim, res.closeMenuAnimation.get(), res.closeMenuValues);
         anim.setId(AnimationId::HIDE_MENU);
         anim.setPosition(model.body.x, model.body.y);
         runAnimation(anim);
     }
 
+    // the edges of the screen are in the order of the directions
+    static WaveDirection taskbarDirection() {
+        static_assert(static_cast<int>(WaveDirection::MoveLeft) == ABE_LEFT &&
+                      static_cast<int>(WaveDirection::MoveUp) == ABE_TOP &&
+                      static_cast<int>(WaveDirection::MoveRight) == ABE_RIGHT &&
+                      static_cast<int>(WaveDirection::MoveDown) == ABE_BOTTOM);
+        int position = WindowUtils::getTaskbarPosition();
+        return position >= ABE_LEFT && position <= ABE_BOTTOM ? static_cast<WaveDirection>(position)
+                                                              : WaveDirection::MoveDown;
+    }
+
+    // the whole flyout into a leased buffer, the margin around the body and the title keeps the pixels of
+    // the previous lease unless it is cleared
+    void drawFlyout(Bitmap& buffer, bool showGuard) {
+        buffer.clear({0, 0, 0, 0});
+        view().draw(buffer, false, view().isMenuBarVisible() ? 1.0f : 0.0f, showGuard);
+    }
+
     void createShowFlyoutAnimation(AnimationAction actionBefore, AnimationAction actionAfter) {
         auto& res = view().resources_;
         const auto& model = view().model_;
 
-        Bitmap buf;
-        buf.createAs(view().buffer_);
-        view().draw(buf, false, view().isMenuBarVisible() ? 1.0f : 0.0f);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        drawFlyout(*buf, true);
 
         auto&& anim = res.showFlyoutAnimation;
-        ShowWindowAnimation::create(anim, buf, model.workArea(), true);
+        ShowWindowAnimation::create(anim, *buf, model.workArea(), taskbarDirection(), true);
 
         anim.setId(AnimationId::SHOW_MAIN_WINDOW);
         anim.setActionBefore(actionBefore);
@@ -311,11 +403,11 @@ public:
         auto& res = view().resources_;
         const auto& model = view().model_;
 
-        Bitmap buf;
-        buf.clone(view().buffer_);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        buf->blitFrom(view().buffer_);
 
         auto&& anim = res.hideFlyoutAnimation;
-        ShowWindowAnimation::create(anim, buf, model.workArea(), false);
+        ShowWindowAnimation::create(anim, *buf, model.workArea(), taskbarDirection(), false);
 
         anim.setId(AnimationId::HIDE_MAIN_WINDOW);
         anim.setActionBefore(actionBefore);
@@ -328,12 +420,11 @@ public:
         auto& res = view().resources_;
         const auto& model = view().model_;
 
-        Bitmap buf;
-        buf.createAs(view().buffer_);
-        view().draw(buf, false, view().isMenuBarVisible() ? 1.0f : 0.0f);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        drawFlyout(*buf, true);
 
         auto&& anim = res.shakeAnimation;
-        ShakeAnimation::create(anim, buf, model.workArea());
+        ShakeAnimation::create(anim, *buf, model.workArea());
         anim.setId(AnimationId::SHAKE);
         runAnimation(anim);
 
@@ -341,36 +432,31 @@ public:
     }
 
     void createShowGuardAnimation() {
-        Bitmap buf;
-        buf.createAs(view().buffer_);
-        view().draw(buf, false, view().isMenuBarVisible() ? 1.0f : 0.0f, false);
-        auto& anim = view().guard_.createShowAnimation(buf);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        drawFlyout(*buf, false);
+        auto& anim = view().guard_.createShowAnimation(*buf);
         anim.setId(AnimationId::SHOW_GUARD);
         runAnimation(anim);
     }
 
     void createHideGuardAnimation() {
-        Bitmap buf;
-        buf.createAs(view().buffer_);
-
-        view().draw(buf, false, view().isMenuBarVisible() ? 1.0f : 0.0f, false);
-        auto& anim = view().guard_.createHideAnimation(buf);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        drawFlyout(*buf, false);
+        auto& anim = view().guard_.createHideAnimation(*buf);
         anim.setId(AnimationId::HIDE_GUARD);
         runAnimation(anim);
     }
 
     void createGuardWrongAnimation() {
-        Bitmap buf;
-        buf.createAs(view().buffer_);
-
-        view().draw(buf, false, view().isMenuBarVisible() ? 1.0f : 0.0f, false);
-        auto& anim = view().guard_.createWrongAnimation(buf);
+        auto buf = BitmapPool::instance().acquireAs(view().buffer_);
+        drawFlyout(*buf, false);
+        auto& anim = view().guard_.createWrongAnimation(*buf);
         anim.setId(AnimationId::GUARD_WRONG);
         runAnimation(anim);
     }
 
     void runStartupAnimation() {
-        auto&& anim = view().resources_.startupAnimation;
+        auto& anim = view().resources_.startupAnimation.get();
         anim.begin();
         runAnimation(anim);
     }
@@ -388,11 +474,11 @@ public:
 
         Sounds::play(IDB_SND_START_LOCKING);
         if (view().isMenuBarVisible()) {
-            auto&& anim = res.body.menuOpen.startLockingAnimation;
+            auto& anim = res.body.menuOpen.startLockingAnimation.get();
             anim.begin();
             runAnimation(anim);
         } else {
-            auto&& anim = res.body.menuClosed.startLockingAnimation;
+            auto& anim = res.body.menuClosed.startLockingAnimation.get();
             anim.begin();
             runAnimation(anim);
         }
@@ -418,11 +504,11 @@ public:
         Sounds::play(IDB_SND_FINISH_LOCKING);
         DWORD delay = 50;
         if (view().isMenuBarVisible()) {
-            auto&& anim = res.body.menuOpen.finishLockingAnimation;
+            auto& anim = res.body.menuOpen.finishLockingAnimation.get();
             anim.begin();
             runAnimation(anim, delay);
         } else {
-            auto&& anim = res.body.menuClosed.finishLockingAnimation;
+            auto& anim = res.body.menuClosed.finishLockingAnimation.get();
             anim.begin();
             runAnimation(anim, delay);
         }
@@ -441,11 +527,11 @@ public:
 
         Sounds::play(IDB_SND_WRONG);
         if (view().isMenuBarVisible()) {
-            auto&& anim = res.body.menuOpen.cannotUnlockAnimation;
+            auto& anim = res.body.menuOpen.cannotUnlockAnimation.get();
             anim.begin();
             runAnimation(anim);
         } else {
-            auto&& anim = res.body.menuClosed.cannotUnlockAnimation;
+            auto& anim = res.body.menuClosed.cannotUnlockAnimation.get();
             anim.begin();
             runAnimation(anim);
         }
@@ -466,11 +552,11 @@ public:
 
         Sounds::play(IDB_SND_UNLOCK);
         if (view().isMenuBarVisible()) {
-            auto&& anim = res.body.menuOpen.unlockAnimation;
+            auto& anim = res.body.menuOpen.unlockAnimation.get();
             anim.begin();
             runAnimation(anim);
         } else {
-            auto&& anim = res.body.menuClosed.unlockAnimation;
+            auto& anim = res.body.menuClosed.unlockAnimation.get();
             anim.begin();
             runAnimation(anim);
         }
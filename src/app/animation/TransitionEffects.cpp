@@ -20,32 +20,31 @@
 #include "TransitionEffects.h"
 
 #include <cmath>
-#include <omp.h>
-#include <gfx/BitmapContext.h>
+#include <memory>
 
+#include "gfx/BitmapContext.h"
+#include "gfx/BitmapPool.h"
 #include "gfx/BitmapUtils.h"
-#include "gui/WindowUtils.h"
 #include "sys/Rectangle.h"
 #include "sys/KeyFrames.h"
 
 namespace litelockr {
 
-void ShowWindowAnimation::create(AnimationFrameSet& result, const Bitmap& img, RECT workArea, bool inverted) {
+void ShowWindowAnimation::create(AnimationFrameSet& result, const Bitmap& img, RECT workArea, WaveDirection taskbar,
+                                 bool inverted) {
     const int numFrames = inverted ? 18 : 16;
     const int width = static_cast<int>(img.width());
     const int height = static_cast<int>(img.height());
-    result.recreate(width, height, numFrames);
 
     RECT rcMargin;
-    int taskbarPosition = WindowUtils::getTaskbarPosition();
-    switch (taskbarPosition) {
-        case ABE_TOP:
+    switch (taskbar) {
+        case WaveDirection::MoveUp:
             rcMargin = {0, 0, width, workArea.top}; // left, top, right, bottom
             break;
-        case ABE_LEFT:
+        case WaveDirection::MoveLeft:
             rcMargin = {0, 0, workArea.left, height};
             break;
-        case ABE_RIGHT:
+        case WaveDirection::MoveRight:
             rcMargin = {workArea.right, 0, width, height};
             break;
         default:
@@ -54,29 +53,21 @@ void ShowWindowAnimation::create(AnimationFrameSet& result, const Bitmap& img, R
             break;
     }
 
-#pragma omp parallel
-    {
-        Bitmap frame;
-        frame.create(width, height);
-
-#pragma omp for ordered schedule(dynamic)
-        for (int i = 0; i < numFrames; i++) {
-            frame.clear({0, 0, 0, 0});
-
-            int frameIdx = inverted ? numFrames - i - 1 : i;
-            createFrame(frame, img, taskbarPosition, frameIdx, numFrames);
-            frame.fillRect(rcMargin, {0, 0, 0, 0}); // the margin area should remain transparent
-
-#pragma omp ordered
-            result.addFrame(i, frame);
-        }
-    }
-
-    result.begin();
+    // the workers render from a clone sharing the pixels, the pool does not recycle a leased buffer while
+    // the clone holds it
+    auto source = std::make_shared<Bitmap>();
+    source->clone(img);
+
+    result.stream(width, height, numFrames,
+                  [source, rcMargin, taskbar, numFrames, inverted](Bitmap& frame, unsigned i) {
+                      int frameIdx = inverted ? numFrames - static_cast<int>(i) - 1 : static_cast<int>(i);
+                      createFrame(frame, *source, taskbar, frameIdx, numFrames);
+                      frame.fillRect(rcMargin, {0, 0, 0, 0}); // the margin area should remain transparent
+                  });
 }
 
-void
-ShowWindowAnimation::createFrame(Bitmap& dst, const Bitmap& src, int taskbarPosition, int index, int len) noexcept {
+void ShowWindowAnimation::createFrame(Bitmap& dst, const Bitmap& src, WaveDirection taskbar, int index,
+                                      int len) noexcept {
     float v = static_cast<float>(index) / static_cast<float>(len - 1);
     float value = EASY_IN(v);
     const int N = 2;
@@ -85,21 +76,19 @@ ShowWindowAnimation::createFrame(Bitmap& dst, const Bitmap& src, int taskbarPosi
 
     BitmapContext ctx(dst);
 
-    switch (taskbarPosition) {
-        case ABE_LEFT:
+    switch (taskbar) {
+        case WaveDirection::MoveLeft:
             ctx.wave<WaveDirection::MoveLeft>(src, value, opacity);
             break;
-        case ABE_TOP:
+        case WaveDirection::MoveUp:
             ctx.wave<WaveDirection::MoveUp>(src, value, opacity);
             break;
-        case ABE_RIGHT:
+        case WaveDirection::MoveRight:
             ctx.wave<WaveDirection::MoveRight>(src, value, opacity);
             break;
-        case ABE_BOTTOM:
+        case WaveDirection::MoveDown:
             ctx.wave<WaveDirection::MoveDown>(src, value, opacity);
             break;
-        default:
-            break;
     }
 }
 
@@ -125,8 +114,7 @@ void ShakeAnimation::create(AnimationFrameSet& result, const Bitmap& img, RECT w
     const unsigned height = img.height();
     result.recreate(width, height, numFrames);
 
-    Bitmap frame;
-    frame.create(width, height);
+    auto frame = BitmapPool::instance().acquire(width, height);
 
     for (int i = 0; i < numFrames; i++) {
         float val = static_cast<float>(i) / static_cast<float>(numFrames - 1);
@@ -136,11 +124,11 @@ void ShakeAnimation::create(AnimationFrameSet& result, const Bitmap& img, RECT w
         Rectangle::offset(rc, offsetX, 0);
         assert(rc.left >= 0);
 
-        frame.clear({0, 0, 0, 0});
-        frame.copyFrom(img, rc.left, rc.top, workArea.left, workArea.top,
-                       Rectangle::width(rc), Rectangle::height(rc));
+        frame->clear({0, 0, 0, 0});
+        frame->copyFrom(img, rc.left, rc.top, workArea.left, workArea.top,
+                        Rectangle::width(rc), Rectangle::height(rc));
 
-        result.addFrame(i, frame);
+        result.addFrame(i, *frame);
     }
 
     result.begin();
@@ -25,12 +25,16 @@
 
 namespace litelockr {
 
+enum class WaveDirection;
+
 class ShowWindowAnimation {
 public:
-    static void create(AnimationFrameSet& result, const Bitmap& img, RECT workArea, bool inverted);
+    // the frames are rendered while the animation plays, see FrameStream; the window moves to the taskbar
+    static void create(AnimationFrameSet& result, const Bitmap& img, RECT workArea, WaveDirection taskbar,
+                       bool inverted);
 
-protected:
-    static void createFrame(Bitmap& dst, const Bitmap& src, int taskbarPosition, int index, int len) noexcept;
+    // renders the frame into the cleared bitmap
+    static void createFrame(Bitmap& dst, const Bitmap& src, WaveDirection taskbar, int index, int len) noexcept;
 };
 
 class ShakeAnimation {
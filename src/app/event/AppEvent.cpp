@@ -19,9 +19,11 @@
 
 #include "AppEvent.h"
 
+#include "log/Logger.h"
+
 namespace litelockr {
 
-unsigned int AppEvent::genId_(0);
+std::atomic<unsigned int> AppEvent::genId_(0);
 
 std::wstring AppEvent::toString() const {
     std::wstring str{L"{AppEvent.id="};
@@ -38,4 +40,14 @@ std::wstring AppEvent::toString() const {
     return str;
 }
 
+void AppEvents::process(AppEvent event) {
+    LOG_VERBOSE(L"[AppEvents] %s latency=%lld us",
+                event.toString().c_str(),
+                std::chrono::duration_cast<std::chrono::microseconds>(statistics().lastLatency).count());
+
+    if (processPtr_) {
+        processPtr_(event);
+    }
+}
+
 } // namespace litelockr
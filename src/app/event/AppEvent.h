@@ -20,6 +20,7 @@
 #ifndef APP_EVENT_H
 #define APP_EVENT_H
 
+#include <atomic>
 #include <string>
 #include <functional>
 
@@ -74,7 +75,7 @@ public:
     [[nodiscard]] std::wstring toString() const;
 
 private:
-    static unsigned int genId_;
+    static std::atomic<unsigned int> genId_;
 };
 
 class AppEvents: public BaseEvents<AppEvent> {
@@ -96,11 +97,7 @@ public:
     }
 
 protected:
-    void process(AppEvent event) override {
-        if (processPtr_) {
-            processPtr_(event);
-        }
-    }
+    void process(AppEvent event) override;
 
 private:
     std::function<void(const AppEvent&)> processPtr_;
@@ -19,6 +19,8 @@
 
 #include "AppEventHandler.h"
 
+#include "lock/HookThread.h"
+
 namespace litelockr {
 
 void AppEventHandler::initialize() {
@@ -192,6 +194,7 @@ void AppEventHandler::lock(const AppEvent& /*event*/) {
         if (appSettings().delayBeforeLocking.value() > 0) {
             window().show(true, {.actionAfter = AnimationAction::LOCK, .animation = true});
         } else {
+            HookThread::markLockRequested();
             window().changeLockState(LockState::LOCKED);
         }
         return;
@@ -225,6 +228,7 @@ void AppEventHandler::lockNow(const AppEvent& event) {
         if (lockState() != LockState::READY) {
             return;
         }
+        HookThread::markLockRequested();
         window().changeLockState(LockState::LOCKED);
         return;
     }
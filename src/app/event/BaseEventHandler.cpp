@@ -108,11 +108,21 @@ void BaseEventHandler::timeout() {
 
         if (locking.done()) {
             locking.reset();
+            HookThread::markLockRequested(); // the time to locked starts after the countdown
             view().runFinishLockingAnimation(false);
         }
     }
 }
 
+AppClock::Duration BaseEventHandler::nextTimeout() const {
+    const auto& locking = view().getProgressBar();
+    if (HookThread::isLocked() || model().visible() || AppTimer::isAnimationActive() ||
+        locking.enabled() || locking.stopping()) {
+        return FRAME_PERIOD;
+    }
+    return checkInterval_.period(); // LockWhenIdle option
+}
+
 bool BaseEventHandler::isCheckRequired(int appEventId) const {
     bool checkRequired = appSettings().preventUnlockingInput.value();
     if (checkRequired && (appEventId == AppEvent::EXIT || appEventId == AppEvent::SETTINGS)) {
@@ -233,6 +243,7 @@ void BaseEventHandler::stopLocking(bool needRedraw/* = true*/) {
     if (locking.enabled()) {
         //stop locking
         m.setLockState(LockState::READY);
+        HookThread::clearLockRequested();
 
         Sounds::play(IDB_SND_CANCEL);
         m.lockCancel = false;
@@ -252,6 +263,7 @@ void BaseEventHandler::startLocking(bool lockNow) {
 
     if (lockNow) {
         // lock immediately
+        HookThread::markLockRequested();
         view().runFinishLockingAnimation(lockNow);
     } else {
         view().runStartLockingAnimation();
@@ -33,6 +33,7 @@ public:
     void appExit() const;
     void closeApplication() const;
     void timeout() override;
+    [[nodiscard]] AppClock::Duration nextTimeout() const override;
     [[nodiscard]] bool isCheckRequired(int appEventId) const;
     bool checkAccess(const AppEvent& event);
 
@@ -22,7 +22,11 @@
 #include <cassert>
 
 #include "gfx/BitmapContext.h"
+#include "gfx/BitmapPool.h"
 #include "gfx/BitmapUtils.h"
+#include "gfx/BoxBlur.h"
+#include "gfx/ImageLoader.h"
+#include "log/Logger.h"
 #include "sys/Rectangle.h"
 
 #include "res/Resources.h"
@@ -35,19 +39,29 @@ void UnlockGuardPainter::initialize(const RECT& workArea, const Bitmap& bgBuffer
     unsigned h = Rectangle::height(workArea);
     buffer_.create(w, h);
 
-    gradientBackground_.loadPng(IDB_GRADIENT_DARK);
+    ImageLoader loader;
+    loader.add(gradientBackground_, IDB_GRADIENT_DARK);
+    loader.add(gradientText_, IDB_GRADIENT_TEXT);
+    loader.load();
+
     assert(!gradientBackground_.isNull());
     assert(gradientBackground_.width() == w);
     assert(gradientBackground_.height() == h);
 
-    gradientText_.loadPng(IDB_GRADIENT_TEXT);
     assert(!gradientText_.isNull());
     assert(gradientText_.width() == w);
     assert(gradientText_.height() == h);
 
-    bgBuffer_.createAs(bgBuffer);
+    // only the part the blur of the work area reads
+    auto extent = static_cast<int>(BoxBlur::extent(BACKGROUND_BLUR_RADIUS));
+    RECT& rc = bgRect_;
+    rc = workArea;
+    Rectangle::inflate(rc, {extent, extent});
+    Rectangle::clamp(rc, 0, 0, static_cast<int>(bgBuffer.width()), static_cast<int>(bgBuffer.height()));
+
+    bgBuffer_.create(Rectangle::width(rc), Rectangle::height(rc));
     bgBuffer_.clear({55, 55, 55, 255}); // main background color
-    bgBuffer_.blendFrom(bgBuffer, 0, 0);
+    bgBuffer_.blendFrom(bgBuffer, 0, 0, rc.left, rc.top, bgBuffer_.width(), bgBuffer_.height());
 }
 
 void UnlockGuardPainter::drawTopText(const std::wstring& text, bool useCache /*= false*/) {
@@ -60,39 +74,21 @@ void UnlockGuardPainter::drawTopText(const std::wstring& text, bool useCache /*=
         cacheBuffer_.free();
     }
 
-    Bitmap mask;
-    mask.createAs(buffer_);
-
-    const TextSettings& ts = pinEnabled_ ? pinTopTextSettings_ : mathTopTextSettings_;
-
-    BitmapContext ctx(mask);
-    ctx.textColor = Color(255, 255, 255);
-    ctx.fontFace = ts.fontFace;
-    ctx.fontHeight = ts.fontHeight;
-    ctx.fontLetterSpacing = ts.fontLetterSpacing;
-    ctx.fontWeight = FW_BOLD;
-    unsigned w = buffer_.width();
-    unsigned h = buffer_.height();
-    float tw = static_cast<float>(ctx.measureText(text.c_str()).cx) - ts.fontLetterSpacing;
-    float tx = static_cast<float>(w) / 2.0f - tw / 2.0f;
-
-    ctx.clear({0, 0, 0, 255});
-    ctx.drawText(text.c_str(), tx, static_cast<float>(ts.positionY) + offsetText0Y);
-
-    Bitmap textBuf;
-    textBuf.clone(gradientText_);
-    BitmapUtils::applyMask(textBuf, mask);
-
+    const Bitmap *background = &bgBuffer_;
+    std::shared_ptr<const Bitmap> blurred;
     if (backgroundBlurRadius) {
-        BitmapContext ctxBlur(bgBuffer_);
-        ctxBlur.blur(backgroundBlurRadius);
+        blurred = blurredBackground(backgroundBlurRadius);
+        background = blurred.get();
     }
 
     auto&& wa = workArea_;
-    buffer_.copyFrom(bgBuffer_, 0, 0, wa.left, wa.top, w, h);
+    buffer_.copyFrom(*background, 0, 0, wa.left - bgRect_.left, wa.top - bgRect_.top,
+                     buffer_.width(), buffer_.height());
 
     buffer_.blendFrom(gradientBackground_, 0, 0);
-    buffer_.blendFrom(textBuf, 0, 0, 0, 0, textOpacity);
+
+    const TextSettings& ts = pinEnabled_ ? pinTopTextSettings_ : mathTopTextSettings_;
+    drawText(text, ts, 0, offsetText0Y);
 
     if (useCache && cacheBuffer_.isNull()) {
         cacheBuffer_.clone(buffer_);
@@ -104,28 +100,122 @@ void UnlockGuardPainter::drawBottomText(const std::wstring& text) {
         return;
     }
 
-    Bitmap mask;
-    mask.createAs(buffer_);
-
     const TextSettings& ts = pinEnabled_ ? pinBottomTextSettings_ : mathBottomTextSettings_;
+    drawText(text, ts, offsetText1X, offsetText1Y);
+}
+
+void UnlockGuardPainter::drawText(const std::wstring& text, const TextSettings& ts, float offsetX, float offsetY) {
+    auto mask = textMask({text, ts.fontFace, ts.fontHeight, ts.fontLetterSpacing, ts.positionY,
+                          offsetX, offsetY, buffer_.width(), buffer_.height()});
+
+    const RECT& rc = mask->rect;
+    if (Rectangle::empty(rc)) {
+        return;
+    }
+
+    // the gradient is masked within the text box only
+    auto w = static_cast<unsigned>(Rectangle::width(rc));
+    auto h = static_cast<unsigned>(Rectangle::height(rc));
+    auto textBuf = BitmapPool::instance().acquire(w, h);
+    if (textBuf->isNull()) {
+        return;
+    }
+    textBuf->copyFrom(gradientText_, 0, 0, rc.left, rc.top, w, h);
+    BitmapUtils::applyMask(*textBuf, mask->bitmap);
+    buffer_.blendFrom(*textBuf, rc.left, rc.top, 0, 0, w, h, textOpacity);
+}
 
-    BitmapContext ctx(mask);
-    ctx.textColor = Color(255, 255, 255);
-    ctx.fontFace = ts.fontFace;
-    ctx.fontHeight = ts.fontHeight;
-    ctx.fontLetterSpacing = ts.fontLetterSpacing;
-    ctx.fontWeight = FW_BOLD;
-    unsigned w = buffer_.width();
-    float tw = static_cast<float>(ctx.measureText(text.c_str()).cx) - ts.fontLetterSpacing;
-    float tx = static_cast<float>(w) / 2.0f - tw / 2.0f;
-
-    ctx.clear({0, 0, 0, 255});
-    ctx.drawText(text.c_str(), tx + offsetText1X, static_cast<float>(ts.positionY) + offsetText1Y);
-
-    Bitmap textBuf;
-    textBuf.clone(gradientText_);
-    BitmapUtils::applyMask(textBuf, mask);
-    buffer_.blendFrom(textBuf, 0, 0, 0, 0, textOpacity);
+std::shared_ptr<const Bitmap> UnlockGuardPainter::blurredBackground(int radius) const {
+    assert(radius <= BACKGROUND_BLUR_RADIUS); // bgBuffer_ has the margin for this radius
+
+    std::lock_guard lock(cache_.blurMtx_);
+
+    // the owner of the cache invalidates it when the background changes, only the work area is checked here
+    if (!Rectangle::equals(cache_.blurRect_, bgRect_)) {
+        cache_.blurRect_ = bgRect_;
+        cache_.blurredBackgrounds_.clear();
+    }
+
+    if (auto it = cache_.blurredBackgrounds_.find(radius); it != cache_.blurredBackgrounds_.end()) {
+        return it->second;
+    }
+
+    auto blurred = std::make_shared<Bitmap>();
+    blurred->clone(bgBuffer_);
+    BoxBlur::blur(*blurred, radius);
+    cache_.blurredBackgrounds_.emplace(radius, blurred);
+    LOG_VERBOSE(L"[UnlockGuardPainter] Background %ux%u blurred, radius=%d",
+                blurred->width(), blurred->height(), radius);
+    return blurred;
+}
+
+std::shared_ptr<const UnlockGuardPainter::TextMask> UnlockGuardPainter::textMask(const TextMaskKey& key) const {
+    {
+        std::lock_guard lock(cache_.textMasksMtx_);
+        if (auto it = cache_.textMasks_.find(key); it != cache_.textMasks_.end()) {
+            cache_.textMaskHits_++;
+            return it->second;
+        }
+    }
+
+    auto mask = std::make_shared<TextMask>();
+
+    auto setFont = [&key](BitmapContext& ctx) {
+        ctx.fontFace = key.fontFace.c_str();
+        ctx.fontHeight = key.fontHeight;
+        ctx.fontLetterSpacing = key.fontLetterSpacing;
+        ctx.fontWeight = FW_BOLD;
+    };
+
+    // the renderers clip to the size the bitmap has at the first drawing, so the measuring gets its own context
+    BitmapContext measureCtx(mask->bitmap);
+    setFont(measureCtx);
+    float tw = static_cast<float>(measureCtx.measureText(key.text.c_str()).cx) - key.fontLetterSpacing;
+    float tx = static_cast<float>(key.width) / 2.0f - tw / 2.0f + key.offsetX;
+    float ty = static_cast<float>(key.positionY) + key.offsetY;
+
+    RECT& rc = mask->rect;
+    rc = measureCtx.textBounds(key.text.c_str(), tx, ty);
+    Rectangle::clamp(rc, 0, 0, static_cast<int>(key.width), static_cast<int>(key.height));
+
+    if (!Rectangle::empty(rc)) {
+        mask->bitmap.create(Rectangle::width(rc), Rectangle::height(rc));
+
+        BitmapContext ctx(mask->bitmap);
+        setFont(ctx);
+        ctx.textColor = Color(255, 255, 255);
+        ctx.clear({0, 0, 0, 255});
+        ctx.drawText(key.text.c_str(), tx - static_cast<float>(rc.left), ty - static_cast<float>(rc.top));
+    }
+
+    std::lock_guard lock(cache_.textMasksMtx_);
+    if (cache_.textMasks_.size() >= MAX_TEXT_MASKS) {
+        cache_.textMasks_.clear();
+    }
+    cache_.textMasks_.emplace(key, mask);
+    cache_.textMaskMisses_++;
+    LOG_VERBOSE(L"[UnlockGuardPainter] Text mask %dx%d rendered, %u hits, %u misses",
+                Rectangle::width(rc), Rectangle::height(rc), cache_.textMaskHits_, cache_.textMaskMisses_);
+    return mask;
+}
+
+void UnlockGuardPainter::Cache::invalidateBackground() {
+    std::lock_guard lock(blurMtx_);
+    blurredBackgrounds_.clear();
+}
+
+void UnlockGuardPainter::Cache::clear() {
+    {
+        std::lock_guard lock(blurMtx_);
+        blurRect_ = {};
+        blurredBackgrounds_.clear();
+    }
+    std::lock_guard lock(textMasksMtx_);
+    LOG_VERBOSE(L"[UnlockGuardPainter] Cache cleared, %u text masks, %u hits, %u misses",
+                static_cast<unsigned>(textMasks_.size()), textMaskHits_, textMaskMisses_);
+    textMasks_.clear();
+    textMaskHits_ = 0;
+    textMaskMisses_ = 0;
 }
 
 } // namespace litelockr
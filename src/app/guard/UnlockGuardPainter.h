@@ -20,6 +20,9 @@
 #ifndef UNLOCK_GUARD_PAINTER_H
 #define UNLOCK_GUARD_PAINTER_H
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "app/guard/UnlockGuardModel.h"
@@ -39,7 +42,9 @@ public:
     float offsetText1X = 0;
     float offsetText1Y = 0;
 
-    explicit UnlockGuardPainter(bool usePinCode) : pinEnabled_(usePinCode) {}
+    class Cache;
+
+    UnlockGuardPainter(bool usePinCode, Cache& cache) : pinEnabled_(usePinCode), cache_(cache) {}
 
     void initialize(const RECT& workArea, const Bitmap& bgBuffer);
 
@@ -52,7 +57,8 @@ public:
 
 private:
     Bitmap buffer_;
-    Bitmap bgBuffer_;
+    Bitmap bgBuffer_; // the work area with the blur margin
+    RECT bgRect_{};   // bgBuffer_ within the source buffer
     RECT workArea_{};
     Bitmap cacheBuffer_;
 
@@ -60,6 +66,7 @@ private:
     Bitmap gradientText_;
 
     bool pinEnabled_ = false;
+    Cache& cache_;
 
     struct TextSettings {
         const char *fontFace;
@@ -73,6 +80,63 @@ private:
 
     TextSettings pinTopTextSettings_{"fontello", 25, 0, 47};
     TextSettings pinBottomTextSettings_{"fontello", 19, 12, 87};
+
+    void drawText(const std::wstring& text, const TextSettings& ts, float offsetX, float offsetY);
+
+    // blurred once by the session for every radius
+    [[nodiscard]] std::shared_ptr<const Bitmap> blurredBackground(int radius) const;
+
+    struct TextMaskKey {
+        std::wstring text;
+        std::string fontFace;
+        float fontHeight;
+        float fontLetterSpacing;
+        int positionY;
+        float offsetX;
+        float offsetY;
+        unsigned width;
+        unsigned height;
+
+        auto operator<=>(const TextMaskKey&) const = default;
+    };
+
+    struct TextMask {
+        Bitmap bitmap; // white text on black, cropped to rect
+        RECT rect{};   // the text box within the buffer
+    };
+
+    constexpr static size_t MAX_TEXT_MASKS = 64;
+
+    [[nodiscard]] std::shared_ptr<const TextMask> textMask(const TextMaskKey& key) const;
+};
+
+//
+// The blurred backgrounds and the text masks of a guard session, shared by the painters of the animation
+// frames. The guard redraws the same strings over the same background on every keypress and animation frame.
+//
+class UnlockGuardPainter::Cache {
+public:
+    Cache() = default;
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    // the background under the guard is drawn with another state
+    void invalidateBackground();
+
+    // the guard is closed
+    void clear();
+
+private:
+    friend class UnlockGuardPainter;
+
+    std::mutex blurMtx_;
+    RECT blurRect_{};
+    std::map<int, std::shared_ptr<const Bitmap>> blurredBackgrounds_; // by the radius
+
+    std::mutex textMasksMtx_;
+    std::map<TextMaskKey, std::shared_ptr<const TextMask>> textMasks_;
+    unsigned int textMaskHits_ = 0;
+    unsigned int textMaskMisses_ = 0;
 };
 
 } // namespace litelockr
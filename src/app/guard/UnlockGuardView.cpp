@@ -28,7 +28,8 @@
 namespace litelockr {
 
 void UnlockGuardShowAnimation::create(AnimationFrameSet& result, Bitmap& buffer, const RECT& workArea,
-                                      const std::wstring& line0, const std::wstring& line1, bool hide) {
+                                      const std::wstring& line0, const std::wstring& line1, bool hide,
+                                      UnlockGuardPainter::Cache& cache) {
     const int numFrames = hide ? 8 : 15;
     result.recreate(buffer.width(), buffer.height(), numFrames);
 
@@ -37,7 +38,7 @@ void UnlockGuardShowAnimation::create(AnimationFrameSet& result, Bitmap& buffer,
     auto pinEnabled = SettingsData::instance().pinEnabled();
 
     if (hide) {
-        UnlockGuardPainter painter(pinEnabled);
+        UnlockGuardPainter painter(pinEnabled, cache);
         painter.initialize(wa, buffer);
         painter.drawTopText(line0);
         painter.drawBottomText(line1);
@@ -62,7 +63,7 @@ void UnlockGuardShowAnimation::create(AnimationFrameSet& result, Bitmap& buffer,
             float val = EASY_IN(i / (float) (numFrames - 1));
             float invVal = EASY_OUT(1.0f - i / (float) (numFrames - 1));
 
-            UnlockGuardPainter painter(pinEnabled);
+            UnlockGuardPainter painter(pinEnabled, cache);
             painter.initialize(wa, buffer);
             painter.offsetText0Y = painter.offsetText1Y = -8.0f * invVal;
             painter.backgroundBlurRadius = std::lround(UnlockGuardPainter::BACKGROUND_BLUR_RADIUS * val);
@@ -82,7 +83,8 @@ void UnlockGuardShowAnimation::create(AnimationFrameSet& result, Bitmap& buffer,
 }
 
 void UnlockGuardWrongAnimation::create(AnimationFrameSet& result, Bitmap& buffer, const RECT& workArea,
-                                       const std::wstring& line0, const std::wstring& line1) {
+                                       const std::wstring& line0, const std::wstring& line1,
+                                       UnlockGuardPainter::Cache& cache) {
     const int numFrames = 21;
     result.recreate(buffer.width(), buffer.height(), numFrames);
 
@@ -105,7 +107,7 @@ void UnlockGuardWrongAnimation::create(AnimationFrameSet& result, Bitmap& buffer
 
     auto pinEnabled = SettingsData::instance().pinEnabled();
 
-    UnlockGuardPainter painter(pinEnabled);
+    UnlockGuardPainter painter(pinEnabled, cache);
     painter.initialize(wa, buffer);
 
     for (int i = 0; i < numFrames; i++) {
@@ -130,7 +132,7 @@ void UnlockGuardView::draw(Bitmap& buffer) {
 
     auto pinEnabled = SettingsData::instance().pinEnabled();
 
-    UnlockGuardPainter painter(pinEnabled);
+    UnlockGuardPainter painter(pinEnabled, painterCache_);
     painter.initialize(wa, buffer);
     painter.drawTopText(model_.getTopText());
     painter.drawBottomText(model_.getBottomText());
@@ -141,19 +143,19 @@ void UnlockGuardView::draw(Bitmap& buffer) {
 
 AnimationFrameSet& UnlockGuardView::createShowAnimation(Bitmap& buf) {
     UnlockGuardShowAnimation::create(showAnimation_, buf, model_.workArea(),
-                                     model_.getTopText(), model_.getBottomText(), false);
+                                     model_.getTopText(), model_.getBottomText(), false, painterCache_);
     return showAnimation_;
 }
 
 AnimationFrameSet& UnlockGuardView::createHideAnimation(Bitmap& buf) {
     UnlockGuardShowAnimation::create(hideAnimation_, buf, model_.workArea(),
-                                     model_.getTopText(), model_.getBottomText(), true);
+                                     model_.getTopText(), model_.getBottomText(), true, painterCache_);
     return hideAnimation_;
 }
 
 AnimationFrameSet& UnlockGuardView::createWrongAnimation(Bitmap& buf) {
     UnlockGuardWrongAnimation::create(wrongAnimation_, buf, model_.workArea(),
-                                      model_.getTopText(), model_.getBottomText());
+                                      model_.getTopText(), model_.getBottomText(), painterCache_);
     return wrongAnimation_;
 }
 
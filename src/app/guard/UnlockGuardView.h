@@ -24,6 +24,7 @@
 
 #include "app/animation/AnimationFrameSet.h"
 #include "app/guard/UnlockGuardModel.h"
+#include "app/guard/UnlockGuardPainter.h"
 #include "gfx/Bitmap.h"
 #include "gfx/BitmapContext.h"
 
@@ -32,13 +33,13 @@ namespace litelockr {
 class UnlockGuardShowAnimation {
 public:
     static void create(AnimationFrameSet& result, Bitmap& buffer, const RECT& workArea, const std::wstring& line0,
-                       const std::wstring& line1, bool hide);
+                       const std::wstring& line1, bool hide, UnlockGuardPainter::Cache& cache);
 };
 
 class UnlockGuardWrongAnimation {
 public:
     static void create(AnimationFrameSet& result, Bitmap& buffer, const RECT& workArea,
-                       const std::wstring& line0, const std::wstring& line1);
+                       const std::wstring& line0, const std::wstring& line1, UnlockGuardPainter::Cache& cache);
 };
 
 class UnlockGuardView {
@@ -58,6 +59,12 @@ public:
 
     void draw(Bitmap& buffer);
 
+    // the flyout under the guard is drawn with another state
+    void invalidateBackground() { painterCache_.invalidateBackground(); }
+
+    // frees the blurred backgrounds and the text masks of the session
+    void close() { painterCache_.clear(); }
+
     AnimationFrameSet& createShowAnimation(Bitmap& buf);
     AnimationFrameSet& createHideAnimation(Bitmap& buf);
     AnimationFrameSet& createWrongAnimation(Bitmap& buf);
@@ -66,6 +73,7 @@ private:
     Bitmap& buffer_;
     UnlockGuardModel& model_;
     BitmapContext ctx_;
+    UnlockGuardPainter::Cache painterCache_;
 
     AnimationFrameSet showAnimation_;
     AnimationFrameSet hideAnimation_;
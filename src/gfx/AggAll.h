@@ -43,7 +43,11 @@
 #include <agg_rasterizer_scanline_aa.h>
 #include <agg_scanline_p.h>
 #include <agg_conv_stroke.h>
+#include <agg_conv_curve.h>
+#include <agg_conv_transform.h>
+#ifdef _WIN32
 #include <agg_font_win32_tt.h>
+#endif
 #include <agg_blur.h>
 #include <agg_image_accessors.h>
 #include <agg_trans_perspective.h>
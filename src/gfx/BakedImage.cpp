@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BakedImage.h"
+
+#include <cstring>
+
+#include "gfx/Lz4.h"
+#include "log/Logger.h"
+
+namespace litelockr {
+
+bool BakedImage::isBaked(const uint8_t *data, size_t size) {
+    uint32_t magic;
+    if (!data || size < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == MAGIC;
+}
+
+bool BakedImage::load(Bitmap& bitmap, const uint8_t *data, size_t size, unsigned *numFrames) {
+    if (!isBaked(data, size)) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    const size_t widthBytes = static_cast<size_t>(header.width) * BitmapStorage::PIXEL_SIZE;
+    if (header.version != VERSION || header.width == 0 || header.height == 0
+        || header.frames == 0 || header.height % header.frames != 0
+        || header.rawSize != widthBytes * header.height || header.dataSize > size - sizeof(header)) {
+        LOG_ERROR(L"[BakedImage] Invalid header (version=%d, size=%dx%d, frames=%d)",
+                  header.version, header.width, header.height, header.frames);
+        return false;
+    }
+
+    if (!bitmap.create(header.width, header.height)) {
+        return false;
+    }
+
+    // the rows are unpacked straight into their places, a bottom-up bitmap has a negative stride
+    auto& pixf = bitmap.pixFmt();
+    const auto height = static_cast<int>(header.height);
+    if (!unpack(header, data + sizeof(header), pixf.row_ptr(0), pixf.stride())) {
+        return false;
+    }
+
+    if (!(header.flags & PREMULTIPLIED)) {
+        using Multiplier = agg::multiplier_rgba<Color, agg::order_bgra>;
+        for (int y = 0; y < height; y++) {
+            auto p = pixf.row_ptr(y);
+            for (size_t i = 0; i < widthBytes; i += BitmapStorage::PIXEL_SIZE) {
+                Multiplier::premultiply(p + i);
+            }
+        }
+    }
+
+    if (numFrames) {
+        *numFrames = header.frames;
+    }
+    return true;
+}
+
+bool BakedImage::unpack(const Header& header, const uint8_t *data, uint8_t *firstRow, ptrdiff_t stride) {
+    const size_t widthBytes = static_cast<size_t>(header.width) * BitmapStorage::PIXEL_SIZE;
+    if (header.flags & LZ4) {
+        if (!Lz4::decompress(data, header.dataSize, firstRow, stride, widthBytes, header.height)) {
+            LOG_ERROR(L"[BakedImage] Corrupted data (size=%dx%d)", header.width, header.height);
+            return false;
+        }
+        return true;
+    }
+
+    if (header.dataSize != header.rawSize) {
+        LOG_ERROR(L"[BakedImage] Truncated data (size=%dx%d)", header.width, header.height);
+        return false;
+    }
+    for (uint32_t y = 0; y < header.height; y++) {
+        std::memcpy(firstRow + static_cast<ptrdiff_t>(y) * stride, data + y * widthBytes, widthBytes);
+    }
+    return true;
+}
+
+} // namespace litelockr
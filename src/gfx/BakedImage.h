@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BAKED_IMAGE_H
+#define BAKED_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gfx/Bitmap.h"
+
+namespace litelockr {
+
+//
+// The images tools/bake_images.py bakes from the PNG resources: the header and the BGRA rows top-down,
+// premultiplied and compressed with LZ4 unless the flags say otherwise
+//
+class BakedImage {
+public:
+    constexpr static uint32_t MAGIC = 'L' | ('L' << 8) | ('B' << 16) | ('M' << 24);
+    constexpr static uint16_t VERSION = 1;
+
+    enum Flags: uint16_t {
+        PREMULTIPLIED = 1,
+        LZ4 = 2,
+    };
+
+#pragma pack(push, 1)
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        uint32_t width;
+        uint32_t height;    // all the frames
+        uint32_t frames;
+        uint32_t rawSize;   // width * height * 4
+        uint32_t dataSize;  // the bytes after the header
+    };
+#pragma pack(pop)
+    static_assert(sizeof(Header) == 28);
+
+    [[nodiscard]] static bool isBaked(const uint8_t *data, size_t size);
+
+    // unpacks the pixels straight into the bitmap memory, numFrames receives the frames of a strip
+    static bool load(Bitmap& bitmap, const uint8_t *data, size_t size, unsigned *numFrames = nullptr);
+
+private:
+    // the rows go stride bytes apart from the first one
+    static bool unpack(const Header& header, const uint8_t *data, uint8_t *firstRow, ptrdiff_t stride);
+};
+
+} // namespace litelockr
+
+#endif // BAKED_IMAGE_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BAND_RENDERER_H
+#define BAND_RENDERER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <omp.h>
+
+#include "gfx/Bitmap.h"
+
+namespace litelockr {
+
+//
+// Renders a quad in horizontal bands in parallel. Every band gets its own rasterizer, scanline and renderer,
+// renderBand(rasterizer, scanline, renderer) creates the span generators and calls agg::render_scanlines_aa.
+//
+class BandRenderer {
+public:
+    using BaseRenderer = agg::renderer_base<Bitmap::PixFmtType>;
+    using Scanline = agg::scanline_p8;
+
+    //
+    // Sweeps only the scanlines of one band. The cells are the same as of the whole quad (clipping the
+    // rasterizer itself splits the edges and changes the coverage), so the bands join without seams.
+    //
+    class Rasterizer: public agg::rasterizer_scanline_aa<> {
+    public:
+        Rasterizer(int y1, int y2) : y1_(y1), y2_(y2) {}
+
+        bool rewind_scanlines() {
+            if (!agg::rasterizer_scanline_aa<>::rewind_scanlines()) {
+                return false;
+            }
+            return y1_ <= min_y() || navigate_scanline(y1_);
+        }
+
+        template<class Scanline>
+        bool sweep_scanline(Scanline& sl) {
+            return agg::rasterizer_scanline_aa<>::sweep_scanline(sl) && sl.y() < y2_;
+        }
+
+    private:
+        int y1_;
+        int y2_;
+    };
+
+    constexpr static unsigned MIN_BAND_ROWS = 32;
+    constexpr static unsigned MIN_PARALLEL_PIXELS = 256 * 256;
+
+    template<class RenderBand>
+    static void render(Bitmap& buffer, const std::array<double, 8>& quad, RenderBand&& renderBand);
+
+    // one band inside a parallel region already, such as the frames an animation renders in parallel
+    static int bandCount(unsigned width, unsigned rows) {
+        if (omp_in_parallel() || static_cast<unsigned long long>(width) * rows < MIN_PARALLEL_PIXELS) {
+            return 1;
+        }
+        return std::clamp(static_cast<int>(rows / MIN_BAND_ROWS), 1, omp_get_max_threads());
+    }
+};
+
+template<class RenderBand>
+inline
+void BandRenderer::render(Bitmap& buffer, const std::array<double, 8>& quad, RenderBand&& renderBand) {
+    const auto width = static_cast<int>(buffer.width());
+    const auto height = static_cast<int>(buffer.height());
+
+    auto [minY, maxY] = std::minmax({quad[1], quad[3], quad[5], quad[7]});
+    const int top = std::max(static_cast<int>(std::floor(minY)), 0);
+    const int bottom = std::min(static_cast<int>(std::ceil(maxY)) + 1, height);
+    if (top >= bottom || width == 0) {
+        return;
+    }
+
+    const int numBands = bandCount(width, bottom - top);
+    const int bandRows = (bottom - top + numBands - 1) / numBands;
+    auto& pixFmt = buffer.pixFmt(); // copies the shared pixels once, before the bands
+
+#pragma omp parallel for if (numBands > 1)
+    for (int i = 0; i < numBands; i++) {
+        const int y1 = top + i * bandRows;
+        const int y2 = std::min(y1 + bandRows, bottom);
+        if (y1 >= y2) {
+            continue;
+        }
+
+        Rasterizer rasterizer(y1, y2);
+        rasterizer.move_to_d(quad[0], quad[1]);
+        rasterizer.line_to_d(quad[2], quad[3]);
+        rasterizer.line_to_d(quad[4], quad[5]);
+        rasterizer.line_to_d(quad[6], quad[7]);
+
+        Scanline scanline;
+        BaseRenderer renderer(pixFmt);
+
+        renderBand(rasterizer, scanline, renderer);
+    }
+}
+
+} // namespace litelockr
+
+#endif // BAND_RENDERER_H
@@ -19,60 +19,105 @@
 
 #include "Bitmap.h"
 
+#include <atomic>
+#include <cstdlib>
+
 #include <lodepng/lodepng.h>
+#include "gfx/BakedImage.h"
+#include "gfx/PixelKernels.h"
 #include "log/Logger.h"
 #include "sys/BinaryResource.h"
 
 namespace litelockr {
 
-void Bitmap::free() {
-    if (hBitmap_) {
-        DeleteObject(hBitmap_);
-        hBitmap_ = nullptr;
+namespace {
+
+uint32_t toPixel(Color color) {
+    color.premultiply();
+
+    uint32_t pixel;
+    auto p = reinterpret_cast<uint8_t *>(&pixel);
+    p[ColorR] = color.r;
+    p[ColorG] = color.g;
+    p[ColorB] = color.b;
+    p[ColorA] = color.a;
+    return pixel;
+}
+
+// RGBA to premultiplied BGRA, the swizzle loop runs without branches
+void toPremultipliedBgra(uint8_t *dst, const uint8_t *src, unsigned width) {
+    static_assert(ColorR == 2 && ColorG == 1 && ColorB == 0 && ColorA == 3);
+
+    uint32_t opaque = 0xFF000000;
+    for (unsigned x = 0; x < width; x++) {
+        uint32_t pixel;
+        std::memcpy(&pixel, src + x * 4, sizeof(pixel));
+        pixel = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+        std::memcpy(dst + x * 4, &pixel, sizeof(pixel));
+        opaque &= pixel;
+    }
+
+    if (opaque != 0xFF000000) {
+        using Multiplier = agg::multiplier_rgba<Color, agg::order_bgra>;
+        for (unsigned x = 0; x < width; x++) {
+            if (dst[x * 4 + ColorA] != 255) {
+                Multiplier::premultiply(dst + x * 4);
+            }
+        }
     }
 }
 
-bool Bitmap::attach(HBITMAP hBitmap) {
-    assert(hBitmap);
+std::atomic<uint64_t> sharedBytes{0};
+std::atomic<uint64_t> copiedBytes{0};
 
-    if (GetObject(hBitmap, sizeof(bitmap_), &bitmap_)) {
-        assert(bitmap_.bmBitsPixel == PixFmtType::pix_width << 3);
+} // namespace
 
-        hBitmap_ = hBitmap;
-        renderingBuffer_.attach(reinterpret_cast<unsigned char *>(bitmap_.bmBits), bitmap_.bmWidth,
-                                bitmap_.bmHeight, -bitmap_.bmWidthBytes);
-        pixFmt_.attach(renderingBuffer_);
-        return true;
-    }
-    return false;
+void Bitmap::free() {
+    detach();
+}
+
+bool Bitmap::attach(std::shared_ptr<BitmapStorage> storage) {
+    assert(storage);
+    static_assert(PixFmtType::pix_width == BitmapStorage::PIXEL_SIZE);
+
+    const unsigned height = storage->height();
+    attachRows(std::move(storage), 0, height);
+    return true;
+}
+
+std::shared_ptr<BitmapStorage> Bitmap::detach() {
+    renderingBuffer_.attach(nullptr, 0, 0, 0);
+    pixFmt_.attach(renderingBuffer_);
+    top_ = 0;
+    height_ = 0;
+    return std::move(storage_);
+}
+
+void Bitmap::attachRows(std::shared_ptr<BitmapStorage> storage, unsigned top, unsigned height) {
+    assert(top + height <= storage->height());
+
+    // the lowest address of the rows, the last row comes first if the rows are stored bottom-up
+    const int stride = storage->stride();
+    const unsigned lowestRow = stride < 0 ? storage->height() - top - height : top;
+    auto bits = storage->bits() + static_cast<size_t>(lowestRow) * std::abs(stride);
+
+    renderingBuffer_.attach(bits, storage->width(), height, stride);
+    pixFmt_.attach(renderingBuffer_);
+    storage_ = std::move(storage);
+    top_ = top;
+    height_ = height;
 }
 
 bool Bitmap::create(unsigned width, unsigned height) {
     assert(width > 0);
     assert(height > 0);
 
-    if (hBitmap_) {
-        if (this->width() == width && this->height() == height) {
-            return true;
-        }
+    if (storage_ && !isShared() && top_ == 0 && storage_->height() == height && storage_->width() == width) {
+        return true;
     }
 
-    HDC hMemDC = CreateCompatibleDC(nullptr);
-    if (hMemDC) {
-        BITMAPINFOHEADER bih{sizeof(bih)};
-        bih.biWidth = static_cast<long>(width);
-        bih.biHeight = static_cast<long>(height);
-        bih.biPlanes = 1;
-        bih.biBitCount = PixFmtType::pix_width << 3;
-        bih.biCompression = BI_RGB;
-
-        void *bits;
-        HBITMAP hDib = CreateDIBSection(hMemDC, reinterpret_cast<BITMAPINFO *>(&bih),
-                                        DIB_RGB_COLORS, &bits, nullptr, 0);
-        DeleteDC(hMemDC);
-        if (hDib) {
-            return attach(hDib);
-        }
+    if (auto storage = BitmapStorage::create(width, height)) {
+        return attach(std::move(storage));
     }
 
     LOG_ERROR(L"Could not create an image (size=%dx%d)", width, height);
@@ -85,11 +130,14 @@ bool Bitmap::createAs(const Bitmap& another) {
 }
 
 bool Bitmap::loadPng(const uint8_t *data, size_t size) {
-    std::vector<unsigned char> image;
+    // the decoder's own buffer, lodepng::decode() would copy it once more into a vector
+    unsigned char *decoded = nullptr;
     unsigned width;
     unsigned height;
-    unsigned error = lodepng::decode(image, width, height, data, size);
+    unsigned error = lodepng_decode32(&decoded, &width, &height, data, size);
+    std::unique_ptr<unsigned char, void (*)(void *)> image(decoded, std::free);
     if (error) {
+        LOG_ERROR(L"Could not decode an image: %hs", lodepng_error_text(error));
         assert(false);
         return false;
     }
@@ -99,27 +147,21 @@ bool Bitmap::loadPng(const uint8_t *data, size_t size) {
         return false;
     }
 
-    auto src = image.data();
-    auto dst = reinterpret_cast<uint8_t *>(bitmap().bmBits) + bitmap().bmWidthBytes * (height - 1);
-
+    auto src = image.get();
     const unsigned widthBytes = width * PixFmtType::pix_width;
 
+    // premultiplied once here, so that neither the blending nor the presenting has to
     for (unsigned y = 0; y < height; y++) {
-        for (unsigned i = 0; i < widthBytes; i += PixFmtType::pix_width) {
-            dst[i + 0] = src[i + ColorR];
-            dst[i + 1] = src[i + ColorG];
-            dst[i + 2] = src[i + ColorB];
-            dst[i + 3] = src[i + ColorA];
-        }
-
+        toPremultipliedBgra(pixFmt().pix_ptr(0, static_cast<int>(y)), src, width);
         src += widthBytes;
-        dst -= bitmap().bmWidthBytes;
     }
     return true;
 }
 
-bool Bitmap::loadPng(int resourceId) {
-    bool result = loadPng(Bin::data(resourceId), Bin::size(resourceId));
+bool Bitmap::loadResource(int resourceId) {
+    auto data = Bin::data(resourceId);
+    auto size = Bin::size(resourceId);
+    bool result = BakedImage::isBaked(data, size) ? BakedImage::load(*this, data, size) : loadPng(data, size);
     if (!result) {
         LOG_ERROR(L"Could not load an image from resource (id=0x%04x)", resourceId);
     }
@@ -127,16 +169,53 @@ bool Bitmap::loadPng(int resourceId) {
 }
 
 bool Bitmap::clone(const Bitmap& another) {
-    if (createAs(another)) {
-        blitFrom(another);
+    assert(!another.isNull());
+    return view(another, 0, another.height());
+}
+
+bool Bitmap::view(const Bitmap& another, unsigned top, unsigned height) {
+    assert(!another.isNull());
+    assert(top + height <= another.height());
+
+    if (another.isNull() || height == 0) {
+        return false;
+    }
+
+    sharedBytes += static_cast<uint64_t>(another.width()) * PixFmtType::pix_width * height;
+    attachRows(another.storage_, another.top_ + top, height);
+    return true;
+}
+
+bool Bitmap::unshare() {
+    if (!isShared()) {
         return true;
     }
-    return false;
+
+    auto storage = BitmapStorage::create(width(), height());
+    if (!storage) {
+        LOG_ERROR(L"Could not copy an image (size=%dx%d)", width(), height());
+        assert(false);
+        return false;
+    }
+
+    const size_t widthBytes = width() * PixFmtType::pix_width;
+    agg::rendering_buffer rows(storage->bits(), storage->width(), storage->height(), storage->stride());
+    for (unsigned y = 0; y < height(); y++) {
+        std::memcpy(rows.row_ptr(static_cast<int>(y)), renderingBuffer_.row_ptr(static_cast<int>(y)), widthBytes);
+    }
+    copiedBytes += widthBytes * height();
+
+    attach(std::move(storage));
+    return true;
+}
+
+Bitmap::SharingStatistics Bitmap::sharingStatistics() {
+    return {sharedBytes.load(), copiedBytes.load()};
 }
 
 void Bitmap::clear(Color color) {
     agg::renderer_base rb(pixFmt());
-    rb.clear(color);
+    rb.clear(premultiplied(color));
 }
 
 void Bitmap::copyFrom(const Bitmap& src, int dstX, int dstY, int srcX, int srcY) {
@@ -144,6 +223,16 @@ void Bitmap::copyFrom(const Bitmap& src, int dstX, int dstY, int srcX, int srcY)
 }
 
 void Bitmap::copyFrom(const Bitmap& src, int dstX, int dstY, int srcX, int srcY, unsigned width, unsigned height) {
+    unshare();
+
+    if (height > 0 && dstX == 0 && srcX == 0 && width == this->width()
+        && renderingBuffer_.stride() == src.renderingBuffer_.stride()) {
+        // whole rows are contiguous
+        std::memmove(rowsBegin(dstY, height), src.rowsBegin(srcY, height),
+                     static_cast<size_t>(renderingBuffer_.stride_abs()) * height);
+        return;
+    }
+
     for (unsigned i = 0; i < height; i++) {
         pixFmt().copy_from(src.pixFmt(), dstX, dstY + i, srcX, srcY + i, width);
     }
@@ -155,22 +244,39 @@ void Bitmap::blendFrom(const Bitmap& src, int dstX, int dstY, int srcX, int srcY
 
 void Bitmap::blendFrom(const Bitmap& src, int dstX, int dstY, int srcX, int srcY,
                        unsigned width, unsigned height, std::uint8_t cover) {
+    if (&src == this) {
+        // the rows may overlap, AGG handles the direction
+        for (unsigned i = 0; i < height; i++) {
+            pixFmt().blend_from(src.pixFmt(), dstX, dstY + i, srcX, srcY + i, width, cover);
+        }
+        return;
+    }
+
     for (unsigned i = 0; i < height; i++) {
-        pixFmt().blend_from(src.pixFmt(), dstX, dstY + i, srcX, srcY + i, width, cover);
+        PixelKernels::blendRow(pixFmt().pix_ptr(dstX, dstY + i),
+                               src.pixFmt().pix_ptr(srcX, srcY + i), width, cover);
     }
 }
 
 void Bitmap::blitFrom(const Bitmap& from) {
-    assert(bitmap_.bmBitsPixel == from.bitmap_.bmBitsPixel);
-    assert(bitmap_.bmWidthBytes == from.bitmap_.bmWidthBytes);
-    assert(bitmap_.bmHeight == from.bitmap_.bmHeight);
+    assert(width() == from.width());
+    assert(height() == from.height());
 
-    const auto src = from.bitmap_.bmBits;
-    auto dst = bitmap_.bmBits;
-    size_t size = bitmap_.bmWidthBytes * bitmap_.bmHeight;
+    if (isNull() || from.isNull() || (storage_ == from.storage_ && top_ == from.top_)) {
+        return;
+    }
+    unshare();
 
-    if (dst && src) {
-        std::memmove(dst, src, size);
+    if (renderingBuffer_.stride() == from.renderingBuffer_.stride()) {
+        std::memmove(rowsBegin(0, height()), from.rowsBegin(0, from.height()),
+                     static_cast<size_t>(renderingBuffer_.stride_abs()) * height());
+    } else {
+        // different layouts, e.g. a DIB section and heap memory
+        const size_t widthBytes = width() * PixFmtType::pix_width;
+        for (unsigned y = 0; y < height(); y++) {
+            std::memmove(pixFmt().pix_ptr(0, static_cast<int>(y)), from.pixFmt().pix_ptr(0, static_cast<int>(y)),
+                         widthBytes);
+        }
     }
 }
 
@@ -179,15 +285,21 @@ void Bitmap::fillRect(const RECT& rect, Color color, uint8_t cover) {
 }
 
 void Bitmap::fillRect(int x, int y, unsigned width, unsigned height, Color color, uint8_t cover) {
+    uint32_t pixel = toPixel(color);
     if (cover == 255) {
         for (unsigned i = 0; i < height; i++) {
-            pixFmt().copy_hline(x, y + i, width, color);
+            PixelKernels::fillRow(pixFmt().pix_ptr(x, y + i), width, pixel);
         }
     } else {
         for (unsigned i = 0; i < height; i++) {
-            pixFmt().blend_hline(x, y + i, width, color, cover);
+            PixelKernels::blendFillRow(pixFmt().pix_ptr(x, y + i), width, pixel, cover);
         }
     }
 }
 
+uint8_t *Bitmap::rowsBegin(int y, unsigned height) const {
+    int firstRow = storage_->stride() < 0 ? y + static_cast<int>(height) - 1 : y;
+    return const_cast<uint8_t *>(pixFmt().pix_ptr(0, firstRow));
+}
+
 } // namespace litelockr
@@ -22,15 +22,24 @@
 
 #include <cassert>
 #include <cstring>
+#include <memory>
 
-#include <windows.h>
+#include "gfx/BitmapStorage.h"
 #include "gfx/Color.h"
+#include "sys/WinTypes.h"
 
 namespace litelockr {
 
+//
+// The pixels are premultiplied BGRA, the format UpdateLayeredWindow presents as is.
+// The Color arguments are straight and get premultiplied on the way in.
+//
+// The clones and the views (a range of rows, e.g. one frame of a strip) share the pixels until one of them
+// writes. The non-const pixFmt() and the methods below copy the shared pixels first.
+//
 class Bitmap {
 public:
-    using PixFmtType = agg::pixfmt_alpha_blend_rgba<agg::blender_rgba_plain<agg::rgba8, agg::order_bgra>,
+    using PixFmtType = agg::pixfmt_alpha_blend_rgba<agg::blender_rgba_pre<agg::rgba8, agg::order_bgra>,
             agg::rendering_buffer>;
 
     Bitmap() : pixFmt_(renderingBuffer_) {}
@@ -38,31 +47,55 @@ public:
     Bitmap(const Bitmap&) = delete;
     const Bitmap& operator=(const Bitmap&) = delete;
 
-    ~Bitmap() {
-        free();
-    }
+    ~Bitmap() = default;
+
+    [[nodiscard]] bool isNull() const { return storage_ == nullptr; }
 
-    [[nodiscard]] bool isNull() const { return hBitmap_ == nullptr; }
+    struct SharingStatistics {
+        uint64_t sharedBytes = 0; // the bytes the clones and the views share instead of copying
+        uint64_t copiedBytes = 0; // the shared bytes copied on writing
 
-    [[nodiscard]] PixFmtType& pixFmt() { return pixFmt_; }
+        [[nodiscard]] uint64_t savedBytes() const {
+            return sharedBytes > copiedBytes ? sharedBytes - copiedBytes : 0;
+        }
+    };
+
+    [[nodiscard]] PixFmtType& pixFmt() {
+        unshare();
+        return pixFmt_;
+    }
     [[nodiscard]] const PixFmtType& pixFmt() const { return pixFmt_; }
 
-    explicit operator HBITMAP() const { return hBitmap_; }
-    [[nodiscard]] const BITMAP& bitmap() const { return bitmap_; }
-    [[nodiscard]] BITMAP& bitmap() { return bitmap_; }
+#ifdef _WIN32
+    // call unshare() before drawing on it
+    explicit operator HBITMAP() const {
+        assert(!storage_ || (top_ == 0 && height_ == storage_->height())); // not a view
+        return storage_ ? static_cast<HBITMAP>(storage_->nativeHandle()) : nullptr;
+    }
+#endif
 
-    [[nodiscard]] unsigned width() const { return bitmap_.bmWidth; }
-    [[nodiscard]] unsigned height() const { return bitmap_.bmHeight; }
+    [[nodiscard]] unsigned width() const { return storage_ ? storage_->width() : 0; }
+    [[nodiscard]] unsigned height() const { return storage_ ? height_ : 0; }
     [[nodiscard]] SIZE size() const {
-        return {bitmap_.bmWidth, bitmap_.bmHeight};
+        return {static_cast<long>(width()), static_cast<long>(height())};
     }
 
     void free();
     bool create(unsigned width, unsigned height);
+    bool attach(std::shared_ptr<BitmapStorage> storage);
+    std::shared_ptr<BitmapStorage> detach();
     bool createAs(const Bitmap& another);
     bool loadPng(const uint8_t *data, size_t size);
-    bool loadPng(int resourceId);
+    // a baked image or a PNG
+    bool loadResource(int resourceId);
     bool clone(const Bitmap& another);
+    bool view(const Bitmap& another, unsigned top, unsigned height);
+
+    // copies the pixels if another bitmap shares them
+    bool unshare();
+    [[nodiscard]] bool isShared() const { return storage_ && storage_.use_count() > 1; }
+
+    [[nodiscard]] static SharingStatistics sharingStatistics();
 
     //
     // Some convenient methods
@@ -78,10 +111,14 @@ public:
     void fillRect(int x, int y, unsigned width, unsigned height, Color color, uint8_t cover = 255);
 
 private:
-    bool attach(HBITMAP hBitmap);
+    void attachRows(std::shared_ptr<BitmapStorage> storage, unsigned top, unsigned height);
+
+    // the lowest address of the given rows
+    [[nodiscard]] uint8_t *rowsBegin(int y, unsigned height) const;
 
-    BITMAP bitmap_{};
-    HBITMAP hBitmap_ = nullptr;
+    std::shared_ptr<BitmapStorage> storage_;
+    unsigned top_ = 0;    // the first storage row of the bitmap
+    unsigned height_ = 0;
     agg::rendering_buffer renderingBuffer_;
     PixFmtType pixFmt_;
 };
@@ -21,6 +21,11 @@
 
 #include <cmath>
 
+#include "gfx/BoxBlur.h"
+#ifdef _WIN32
+#include "gfx/FontCache.h"
+#endif
+#include "gfx/SpanImageBilinear.h"
 #include "sys/Rectangle.h"
 
 namespace litelockr {
@@ -39,7 +44,7 @@ void BitmapContext::stroke() {
     p.width(lineWidth);
     ao.rasterizer.add_path(p);
 
-    ao.solidRenderer.color(strokeColor);
+    ao.solidRenderer.color(premultiplied(strokeColor));
     agg::render_scanlines(ao.rasterizer, ao.scanline, ao.solidRenderer);
 }
 
@@ -51,16 +56,21 @@ void BitmapContext::fill() {
     agg::conv_curve curve(trans);
     ao.rasterizer.add_path(curve);
 
-    ao.solidRenderer.color(fillColor);
+    ao.solidRenderer.color(premultiplied(fillColor));
     agg::render_scanlines(ao.rasterizer, ao.scanline, ao.solidRenderer);
 }
 
-void BitmapContext::drawTTF(const wchar_t *text, float tx, float ty, SIZE& textSize, bool draw) {
+#ifdef _WIN32
+void BitmapContext::drawTTF(const wchar_t *text, float tx, float ty, SIZE& textSize, bool draw, RECT *bounds) {
+    auto& fontCache = FontCache::instance();
+    std::lock_guard lock(fontCache.mutex());
 
-    using FontEngineType = agg::font_engine_win32_tt_int16;
-    using FontManagerType = agg::font_cache_manager<FontEngineType>;
-    FontEngineType fontEngine(GetDC(nullptr));
-    FontManagerType fontManager(fontEngine);
+    if (!fontCache.select({fontFace, fontHeight, fontWeight, fontItalic})) {
+        return;
+    }
+
+    auto& fontManager = fontCache.fontManager();
+    fontManager.reset_last_glyph(); // no kerning against the previous text
 
     auto& ao = aggObjects;
     ao.initialize(buffer);
@@ -72,32 +82,29 @@ void BitmapContext::drawTTF(const wchar_t *text, float tx, float ty, SIZE& textS
     agg::conv_curve fcurves(trans);
     fcurves.approximation_scale(2.0);
 
-    fontEngine.height(fontHeight);
-    fontEngine.flip_y(true);
-    fontEngine.weight(fontWeight);
-    fontEngine.italic(fontItalic);
-
-    if (!fontEngine.create_font(fontFace, agg::glyph_ren_outline)) {
-        return;
-    }
-
     double x = 0;
     double y = 0;
+    agg::rect_d inkBounds(1, 1, 0, 0);
     const wchar_t *p = text;
 
     while (*p) {
-        const agg::glyph_cache *glyph = fontManager.glyph(*p);
+        const agg::glyph_cache *glyph = fontCache.glyph(*p);
         if (glyph) {
             fontManager.add_kerning(&x, &y);
-            fontManager.init_embedded_adaptors(glyph, x, y);
 
             if (draw && glyph->data_type == agg::glyph_data_outline) {
+                fontManager.init_embedded_adaptors(glyph, x, y);
                 ao.rasterizer.reset();
                 ao.rasterizer.add_path(fcurves);
-                ao.solidRenderer.color(textColor);
+                ao.solidRenderer.color(premultiplied(textColor));
                 agg::render_scanlines(ao.rasterizer, ao.scanline, ao.solidRenderer);
             }
 
+            if (bounds && glyph->bounds.is_valid()) {
+                agg::rect_d rc(x + glyph->bounds.x1, y + glyph->bounds.y1, x + glyph->bounds.x2, y + glyph->bounds.y2);
+                inkBounds = inkBounds.is_valid() ? agg::unite_rectangles(inkBounds, rc) : rc;
+            }
+
             x += glyph->advance_x + fontLetterSpacing;
             y += glyph->advance_y;
         }
@@ -106,7 +113,19 @@ void BitmapContext::drawTTF(const wchar_t *text, float tx, float ty, SIZE& textS
 
     textSize.cx = std::lround(x);
     textSize.cy = std::lround(fontHeight);
+
+    if (bounds) {
+        *bounds = {};
+        if (inkBounds.is_valid()) {
+            // one more pixel around for the anti-aliasing
+            *bounds = {static_cast<long>(std::floor(tx + inkBounds.x1)) - 1,
+                       static_cast<long>(std::floor(ty + inkBounds.y1)) - 1,
+                       static_cast<long>(std::ceil(tx + inkBounds.x2)) + 1,
+                       static_cast<long>(std::ceil(ty + inkBounds.y2)) + 1};
+        }
+    }
 }
+#endif // _WIN32
 
 void BitmapContext::beginPath() {
     auto& ao = aggObjects;
@@ -118,6 +137,7 @@ void BitmapContext::closePath() {
     aggObjects.path.end_poly();
 }
 
+#ifdef _WIN32
 void BitmapContext::drawText(const wchar_t *text, float x, float y) {
     SIZE size{};
     drawTTF(text, x, y, size, true);
@@ -129,51 +149,40 @@ SIZE BitmapContext::measureText(const wchar_t *text) {
     return size;
 }
 
+RECT BitmapContext::textBounds(const wchar_t *text, float x, float y) {
+    SIZE size{};
+    RECT bounds{};
+    drawTTF(text, x, y, size, false, &bounds);
+    return bounds;
+}
+#endif // _WIN32
+
 void BitmapContext::blur(unsigned int radius) {
-    agg::stack_blur<agg::rgba8, agg::stack_blur_calc_rgba<>> blur;
-    blur.blur(buffer.pixFmt(), radius);
+    BoxBlur::blur(buffer, radius);
 }
 
 void BitmapContext::perspective(const Bitmap& image, const BitmapContext::QuadDouble& quad, std::uint8_t alpha) {
     using PixFmt = Bitmap::PixFmtType;
-    using ImgAccessorType = agg::image_accessor_clone<PixFmt>;
-    ImgAccessorType ia(image.pixFmt());
-
-    auto& ao = aggObjects;
-    ao.initialize(buffer);
-
-    ao.rasterizer.reset();
-    ao.rasterizer.move_to_d(quad[0], quad[1]);
-    ao.rasterizer.line_to_d(quad[2], quad[3]);
-    ao.rasterizer.line_to_d(quad[4], quad[5]);
-    ao.rasterizer.line_to_d(quad[6], quad[7]);
-
-    agg::span_allocator<PixFmt::color_type> sa;
-    agg::image_filter_bilinear filterKernel;
-    agg::image_filter_lut filter(filterKernel, false);
 
     double quadArr[8]; // C-style array is required by agg::trans_perspective constructor
     std::copy(std::begin(quad), std::end(quad), std::begin(quadArr));
 
     agg::trans_perspective tr(quadArr, 0, 0, image.width(), image.height());
-    if (tr.is_valid()) {
-        using InterpolatorType = agg::span_interpolator_trans<agg::trans_perspective>;
-        InterpolatorType interpolator(tr);
-
-        using SpanGenType = agg::span_image_filter_rgba_bilinear<ImgAccessorType, InterpolatorType>;
-        SpanGenType sg(ia, interpolator);
-
-        using SpanConv = agg::span_converter<SpanGenType, SpanConvAlpha<ImgAccessorType>>;
-
-        SpanConvAlpha<ImgAccessorType> scAlpha(alpha);
-        SpanConv sc(sg, scAlpha);
-        agg::render_scanlines_aa(ao.rasterizer, ao.scanline, ao.baseRenderer, sa, sc);
+    if (!tr.is_valid()) {
+        return;
     }
+
+    BandRenderer::render(buffer, quad, [&](auto& rasterizer, auto& scanline, auto& renderer) {
+        agg::span_allocator<PixFmt::color_type> sa;
+        SpanImageBilinear sg(image, tr, alpha);
+        agg::render_scanlines_aa(rasterizer, scanline, renderer, sa, sg);
+    });
 }
 
+#ifdef _WIN32
 void BitmapContext::textOut(const wchar_t *text, int x, int y) {
     SIZE size = textSize(text);
-    if (size.cx == 0 || size.cy == 0) {
+    if (size.cx == 0 || size.cy == 0 || !buffer.unshare()) { // GDI draws on the pixels directly
         return;
     }
 
@@ -216,6 +225,7 @@ SIZE BitmapContext::textSize(const wchar_t *text, HFONT hFont, HWND hWnd) {
     }
     return size;
 }
+#endif // _WIN32
 
 void BitmapContext::rect(int x, int y, int width, int height) {
     buffer.fillRect(x, y, width, height, color, cover);
@@ -22,9 +22,14 @@
 
 #include <array>
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include <numbers>
+#include <span>
 #include <string>
+#include <vector>
 
+#include "gfx/BandRenderer.h"
 #include "gfx/Bitmap.h"
 #include "gfx/BitmapUtils.h"
 #include "sys/KeyFrames.h"
@@ -54,9 +59,11 @@ public:
     Color strokeColor{0, 0, 0};
     Color textColor{0, 0, 0};
     float lineWidth = 1;
-    HFONT font = nullptr;
     unsigned char cover = 255;
 
+#ifdef _WIN32
+    HFONT font = nullptr;
+
     //
     // True type font properties
     //
@@ -65,6 +72,7 @@ public:
     int fontWeight = FW_REGULAR;
     float fontHeight = 16;
     float fontLetterSpacing = 0;
+#endif
 
     explicit BitmapContext(Bitmap& buffer) : buffer(buffer) {}
 
@@ -107,6 +115,8 @@ public:
     void stroke();
     void fill();
 
+#ifdef _WIN32
+    // the text is drawn by GDI and the Windows font engine
     void textOut(const wchar_t *text, int x, int y);
 
     void textOut(const std::wstring& text, int x, int y) {
@@ -120,6 +130,7 @@ public:
     }
 
     static SIZE textSize(const wchar_t *text, HFONT hFont, HWND hWnd);
+#endif
 
     //
     // Primitives
@@ -131,6 +142,7 @@ public:
     void rect(int x, int y, int width, int height);
     void rect(RECT rc);
 
+#ifdef _WIN32
     //
     // True type drawTopText text
     //
@@ -138,6 +150,10 @@ public:
 
     SIZE measureText(const wchar_t *text);
 
+    // the pixels drawText(text, x, y) may touch, empty for a blank text
+    RECT textBounds(const wchar_t *text, float x, float y);
+#endif
+
     void blur(unsigned radius);
 
     void perspective(const Bitmap& image, const QuadDouble& quad, std::uint8_t alpha);
@@ -145,7 +161,9 @@ public:
     template<WaveDirection direction>
     void wave(const Bitmap& image, float value, std::uint8_t alpha);
 
-    void drawTTF(const wchar_t *text, float tx, float ty, SIZE& textSize, bool draw);
+#ifdef _WIN32
+    void drawTTF(const wchar_t *text, float tx, float ty, SIZE& textSize, bool draw, RECT *bounds = nullptr);
+#endif
 
     struct {
         using BaseRenderer = agg::renderer_base<Bitmap::PixFmtType>;
@@ -161,6 +179,8 @@ public:
         agg::trans_affine transAffine;
 
         void initialize(Bitmap& buf) {
+            buf.unshare(); // the renderers write to the pixels directly
+
             if (!hasInitialized) {
                 hasInitialized = true;
 
@@ -190,43 +210,78 @@ private:
 template<WaveDirection direction>
 class TransWave {
 public:
-    using AxisWarp = std::vector<std::pair<float, float>>;
+    using Warp = std::pair<float, float>; // the scale and the offset
+    using AxisWarp = std::span<const Warp>;
 
-    TransWave(unsigned width, unsigned height, float value, float shift) {
-        initializeXAxisWarp(width, height, value, shift);
-        initializeYAxisWarp(width, height, value, shift);
-    }
+    TransWave(unsigned width, unsigned height, float value, float shift)
+            : warp_(warpTables({width, height, value, shift})) {}
 
     void transform(double *px, double *py) const;
 
 private:
-    void initializeXAxisWarp(unsigned width, unsigned height, float value, float shift);
-    void initializeYAxisWarp(unsigned width, unsigned height, float value, float shift);
+    //
+    // The warp tables are the same for every show/hide animation of the window, so they are shared between
+    // the frames and the animations. The cache has a fixed number of slots, the least recently used one is
+    // replaced and its storage is reused when no TransWave holds the old tables any more.
+    //
+    struct WarpKey {
+        unsigned width;
+        unsigned height;
+        float value;
+        float shift;
 
-    [[nodiscard]] constexpr float applyTransform(float value, const AxisWarp::value_type& warp) const {
+        auto operator<=>(const WarpKey&) const = default;
+    };
+
+    struct WarpTables {
+        std::vector<Warp> storage; // the rows, then the columns
+        AxisWarp xAxisWarp; // by the row
+        AxisWarp yAxisWarp; // by the column
+    };
+
+    struct WarpSlot {
+        WarpKey key{};
+        std::shared_ptr<WarpTables> tables;
+        std::uint64_t lastUse = 0;
+    };
+
+    // the show animation has 18 frames and the hide animation 16, both stay cached
+    constexpr static size_t MAX_WARP_TABLES = 40;
+
+    static std::shared_ptr<const WarpTables> warpTables(const WarpKey& key);
+
+    static void initializeXAxisWarp(std::span<Warp> xAxisWarp, const WarpKey& key);
+    static void initializeYAxisWarp(std::span<Warp> yAxisWarp, const WarpKey& key);
+
+    [[nodiscard]] constexpr static float applyTransform(float value, const Warp& warp) {
         float scale = warp.first;
         float offset = warp.second;
         return value * scale - offset + 0.5f;
     }
 
-    [[nodiscard]] constexpr float toStart(unsigned /*size*/, float /*scale*/) const {
+    [[nodiscard]] constexpr static float toStart(unsigned /*size*/, float /*scale*/) {
         return 0;
     }
 
-    [[nodiscard]] constexpr float toCenter(unsigned size, float scale) const {
+    [[nodiscard]] constexpr static float toCenter(unsigned size, float scale) {
         return toEnd(size, scale) / 2.0f;
     }
 
-    [[nodiscard]] constexpr float toEnd(unsigned size, float scale) const {
+    [[nodiscard]] constexpr static float toEnd(unsigned size, float scale) {
         float scaledSize = static_cast<float>(size) / scale;
         return (static_cast<float>(size) - scaledSize) * scale;
     }
 
-    [[nodiscard]] float interpolateCurveU(int size, int x, float val) const;
-    [[nodiscard]] float interpolateCurveS(int size, int x, float val) const;
+    [[nodiscard]] constexpr static float interpolateCurveU(int size, int x, float val);
+    [[nodiscard]] constexpr static float interpolateCurveS(int size, int x, float val);
 
-    AxisWarp xAxisWarp_;
-    AxisWarp yAxisWarp_;
+    inline static std::mutex warpTablesMtx_;
+    inline static std::array<WarpSlot, MAX_WARP_TABLES> warpTables_;
+    inline static std::uint64_t warpTablesClock_ = 0;
+
+    const std::shared_ptr<const WarpTables> warp_;
+    const AxisWarp xAxisWarp_ = warp_->xAxisWarp;
+    const AxisWarp yAxisWarp_ = warp_->yAxisWarp;
 };
 
 template<WaveDirection direction>
@@ -242,72 +297,113 @@ void TransWave<direction>::transform(double *px, double *py) const {
 
 template<WaveDirection direction>
 inline
-void TransWave<direction>::initializeXAxisWarp(unsigned int width, unsigned int height, float value, float shift) {
-    xAxisWarp_.resize(height);
+std::shared_ptr<const typename TransWave<direction>::WarpTables>
+TransWave<direction>::warpTables(const WarpKey& key) {
+    std::lock_guard lock(warpTablesMtx_);
+    const auto now = ++warpTablesClock_;
+
+    WarpSlot *victim = &warpTables_.front();
+    for (auto& slot: warpTables_) {
+        if (slot.tables && slot.key == key) {
+            slot.lastUse = now;
+            return slot.tables;
+        }
+        if (slot.lastUse < victim->lastUse) {
+            victim = &slot; // an empty slot has never been used
+        }
+    }
+
+    if (!victim->tables || victim->tables.use_count() > 1) {
+        victim->tables = std::make_shared<WarpTables>();
+    }
+
+    auto& tables = *victim->tables;
+    tables.storage.resize(key.height + key.width); // no allocation when the slot had tables of the same size
+    std::span<Warp> storage(tables.storage);
+    initializeXAxisWarp(storage.first(key.height), key);
+    initializeYAxisWarp(storage.subspan(key.height), key);
+    tables.xAxisWarp = storage.first(key.height);
+    tables.yAxisWarp = storage.subspan(key.height);
+
+    victim->key = key;
+    victim->lastUse = now;
+    return victim->tables;
+}
+
+template<WaveDirection direction>
+inline
+void TransWave<direction>::initializeXAxisWarp(std::span<Warp> xAxisWarp, const WarpKey& key) {
+    const auto [width, height, value, shift] = key;
 
     for (unsigned y = 0; y < height; y++) {
         if constexpr (direction == WaveDirection::MoveDown) {
             float scale = interpolateCurveS(height, y, value);
-            xAxisWarp_[y] = std::make_pair(scale, toCenter(width, scale));
+            xAxisWarp[y] = std::make_pair(scale, toCenter(width, scale));
         } else if constexpr (direction == WaveDirection::MoveUp) {
             float scale = interpolateCurveS(height, height - y, value);
-            xAxisWarp_[y] = std::make_pair(scale, toCenter(width, scale));
+            xAxisWarp[y] = std::make_pair(scale, toCenter(width, scale));
         } else if constexpr (direction == WaveDirection::MoveLeft) {
             float scale = interpolateCurveU(height, height - y, value);
-            xAxisWarp_[y] = std::make_pair(scale, toStart(width, scale) - shift);
+            xAxisWarp[y] = std::make_pair(scale, toStart(width, scale) - shift);
         } else if constexpr (direction == WaveDirection::MoveRight) {
             float scale = interpolateCurveU(height, y, value);
-            xAxisWarp_[y] = std::make_pair(scale, toEnd(width, scale) + shift);
+            xAxisWarp[y] = std::make_pair(scale, toEnd(width, scale) + shift);
         }
     }
 }
 
 template<WaveDirection direction>
 inline
-void TransWave<direction>::initializeYAxisWarp(unsigned int width, unsigned int height, float value, float shift) {
-    yAxisWarp_.resize(width);
+void TransWave<direction>::initializeYAxisWarp(std::span<Warp> yAxisWarp, const WarpKey& key) {
+    const auto [width, height, value, shift] = key;
 
     for (unsigned x = 0; x < width; x++) {
         if constexpr (direction == WaveDirection::MoveDown) {
             float scale = interpolateCurveU(width, x, value);
-            yAxisWarp_[x] = std::make_pair(scale, toEnd(height, scale) + shift);
+            yAxisWarp[x] = std::make_pair(scale, toEnd(height, scale) + shift);
         } else if constexpr (direction == WaveDirection::MoveUp) {
             float scale = interpolateCurveU(width, x, value);
-            yAxisWarp_[x] = std::make_pair(scale, toStart(height, scale) - shift);
+            yAxisWarp[x] = std::make_pair(scale, toStart(height, scale) - shift);
         } else if constexpr (direction == WaveDirection::MoveLeft) {
             float scale = interpolateCurveS(width, width - x, value);
-            yAxisWarp_[x] = std::make_pair(scale, toCenter(height, scale));
+            yAxisWarp[x] = std::make_pair(scale, toCenter(height, scale));
         } else if constexpr (direction == WaveDirection::MoveRight) {
             float scale = interpolateCurveS(width, x, value);
-            yAxisWarp_[x] = std::make_pair(scale, toCenter(height, scale));
+            yAxisWarp[x] = std::make_pair(scale, toCenter(height, scale));
         }
     }
 }
 
 template<WaveDirection direction>
-inline
-float TransWave<direction>::interpolateCurveU(int size, int x, float val) const {
-    KeyFrames kf;
-    kf.addStopPoint(0, 1, Interpolator::EASY_OUT);
-    kf.addStopPoint(0.5f, 1 + 0.25f * val, Interpolator::EASY_IN);
-    kf.addStopPoint(1, 1);
+constexpr
+float TransWave<direction>::interpolateCurveU(int size, int x, float val) {
+    const StaticKeyFrames<3> kf({
+            {0, 1, Interpolator::EASY_OUT},
+            {0.5f, 1 + 0.25f * val, Interpolator::EASY_IN},
+            {1, 1},
+    });
     return kf.interpolate(static_cast<float>(x) / static_cast<float>(size));
 }
 
 template<WaveDirection direction>
-inline
-float TransWave<direction>::interpolateCurveS(int size, int x, float val) const {
-    KeyFrames kf;
-    kf.addStopPoint(0, 1 + 0.3875f * val, Interpolator::EASY_OUT);
-    kf.addStopPoint(0.1f, 1 + 0.35f * val, Interpolator::EASY_BOTH);
-    kf.addStopPoint(1, 1 + 3 * val);
+constexpr
+float TransWave<direction>::interpolateCurveS(int size, int x, float val) {
+    const StaticKeyFrames<3> kf({
+            {0, 1 + 0.3875f * val, Interpolator::EASY_OUT},
+            {0.1f, 1 + 0.35f * val, Interpolator::EASY_BOTH},
+            {1, 1 + 3 * val},
+    });
     return kf.interpolate(static_cast<float>(x) / static_cast<float>(size));
 }
 
 template<class Source>
 inline
 void SpanConvAlpha<Source>::generate(ColorType *span, int, int, unsigned len) const {
+    // the span is premultiplied, so the color fades along with the alpha
     do {
+        span->r = span->r * alpha_ >> 8;
+        span->g = span->g * alpha_ >> 8;
+        span->b = span->b * alpha_ >> 8;
         span->a = span->a * alpha_ >> 8;
         ++span;
     } while (--len);
@@ -318,38 +414,30 @@ inline
 void BitmapContext::wave(const Bitmap& image, float value, std::uint8_t alpha) {
     using PixFmt = Bitmap::PixFmtType;
     using ImgAccessorType = agg::image_accessor_clone<PixFmt>;
-    ImgAccessorType ia(image.pixFmt());
-
-    auto& ao = aggObjects;
-    ao.initialize(buffer);
 
     unsigned width = image.width();
     unsigned height = image.height();
 
-    ao.rasterizer.reset();
-    ao.rasterizer.move_to_d(0, 0);
-    ao.rasterizer.line_to_d(width, 0);
-    ao.rasterizer.line_to_d(width, height);
-    ao.rasterizer.line_to_d(0, height);
-
-    agg::span_allocator<PixFmt::color_type> sa;
-    agg::image_filter_bilinear filterKernel;
-    agg::image_filter_lut filter(filterKernel, false);
-
     const float shift = static_cast<float>(width) * value * 0.7f;
-    TransWave<direction> tr(width, height, value, shift);
+    const TransWave<direction> tr(width, height, value, shift); // shared by the bands, transform() is const
+
+    const QuadDouble quad{0, 0, double(width), 0, double(width), double(height), 0, double(height)};
+    BandRenderer::render(buffer, quad, [&](auto& rasterizer, auto& scanline, auto& renderer) {
+        ImgAccessorType ia(image.pixFmt());
+        agg::span_allocator<PixFmt::color_type> sa;
 
-    using InterpolatorType = agg::span_interpolator_trans<TransWave<direction>>;
-    InterpolatorType interpolator(tr);
+        using InterpolatorType = agg::span_interpolator_trans<const TransWave<direction>>;
+        InterpolatorType interpolator(tr);
 
-    using SpanGenType = agg::span_image_filter_rgba_bilinear<ImgAccessorType, InterpolatorType>;
-    SpanGenType sg(ia, interpolator);
+        using SpanGenType = agg::span_image_filter_rgba_bilinear<ImgAccessorType, InterpolatorType>;
+        SpanGenType sg(ia, interpolator);
 
-    using SpanConv = agg::span_converter<SpanGenType, SpanConvAlpha<ImgAccessorType>>;
+        using SpanConv = agg::span_converter<SpanGenType, SpanConvAlpha<ImgAccessorType>>;
 
-    SpanConvAlpha<ImgAccessorType> scAlpha(alpha);
-    SpanConv sc(sg, scAlpha);
-    agg::render_scanlines_aa(ao.rasterizer, ao.scanline, ao.baseRenderer, sa, sc);
+        SpanConvAlpha<ImgAccessorType> scAlpha(alpha);
+        SpanConv sc(sg, scAlpha);
+        agg::render_scanlines_aa(rasterizer, scanline, renderer, sa, sc);
+    });
 }
 
 } // namespace litelockr
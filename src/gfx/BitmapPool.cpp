@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitmapPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+//
+// BitmapPool::Lease
+//
+BitmapPool::Lease::Lease(std::shared_ptr<BitmapStorage> storage) {
+    if (storage) {
+        bytes_ = sizeInBytes(*storage);
+        bitmap_.attach(std::move(storage));
+    }
+}
+
+BitmapPool::Lease::~Lease() {
+    if (bytes_) {
+        BitmapPool::instance().release(bitmap_.detach(), bytes_);
+    }
+}
+
+//
+// BitmapPool
+//
+BitmapPool::Lease BitmapPool::acquire(unsigned width, unsigned height) {
+    assert(width > 0);
+    assert(height > 0);
+
+    {
+        std::lock_guard lock(mtx_);
+
+        auto it = std::find_if(idle_.begin(), idle_.end(), [width, height](const auto& storage) {
+            return storage->width() == width && storage->height() == height;
+        });
+        if (it != idle_.end()) {
+            auto storage = std::move(*it);
+            idle_.erase(it);
+
+            auto bytes = sizeInBytes(*storage);
+            stats_.idleBytes -= bytes;
+            stats_.leasedBytes += bytes;
+            stats_.hits++;
+            return Lease(std::move(storage));
+        }
+        stats_.misses++;
+    }
+
+    auto storage = BitmapStorage::create(width, height);
+    if (!storage) {
+        LOG_ERROR(L"[BitmapPool] Could not create an image (size=%dx%d)", width, height);
+        return Lease(nullptr);
+    }
+
+    std::lock_guard lock(mtx_);
+    stats_.leasedBytes += sizeInBytes(*storage);
+    stats_.peakBytes = std::max(stats_.peakBytes, stats_.leasedBytes + stats_.idleBytes);
+    LOG_VERBOSE(L"[BitmapPool] New %dx%d: %llu hits, %llu misses, %zu bytes leased, %zu idle, %zu peak",
+                width, height, static_cast<unsigned long long>(stats_.hits),
+                static_cast<unsigned long long>(stats_.misses),
+                stats_.leasedBytes, stats_.idleBytes, stats_.peakBytes);
+    return Lease(std::move(storage));
+}
+
+void BitmapPool::release(std::shared_ptr<BitmapStorage> storage, size_t leasedBytes) {
+    std::lock_guard lock(mtx_);
+    assert(stats_.leasedBytes >= leasedBytes);
+    stats_.leasedBytes -= leasedBytes;
+
+    if (!storage || storage.use_count() > 1) {
+        return;
+    }
+
+    auto bytes = sizeInBytes(*storage);
+    if (bytes > MAX_IDLE_BYTES) {
+        return;
+    }
+
+    idle_.push_front(std::move(storage));
+    stats_.idleBytes += bytes;
+
+    // the least recently used go first
+    while (stats_.idleBytes > MAX_IDLE_BYTES) {
+        stats_.idleBytes -= sizeInBytes(*idle_.back());
+        idle_.pop_back();
+    }
+}
+
+BitmapPool::Statistics BitmapPool::statistics() {
+    std::lock_guard lock(mtx_);
+    return stats_;
+}
+
+void BitmapPool::clear() {
+    std::lock_guard lock(mtx_);
+    idle_.clear();
+    stats_.idleBytes = 0;
+}
+
+size_t BitmapPool::sizeInBytes(const BitmapStorage& storage) {
+    return static_cast<size_t>(std::abs(storage.stride())) * storage.height();
+}
+
+} // namespace litelockr
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITMAP_POOL_H
+#define BITMAP_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "gfx/Bitmap.h"
+
+namespace litelockr {
+
+//
+// Recycles the pixel storage of the temporary bitmaps by size. A lease returns its storage to the pool
+// when it goes out of scope. A recycled bitmap keeps the pixels of its previous lease.
+//
+class BitmapPool {
+public:
+    constexpr static size_t MAX_IDLE_BYTES = 64 * 1024 * 1024;
+
+    struct Statistics {
+        uint64_t hits = 0;      // the leases served with an idle storage
+        uint64_t misses = 0;    // the leases that created a new storage
+        size_t leasedBytes = 0;
+        size_t idleBytes = 0;
+        size_t peakBytes = 0;   // the most leased and idle bytes at once
+
+        [[nodiscard]] unsigned int hitRate() const {
+            auto leases = hits + misses;
+            return leases ? static_cast<unsigned int>(hits * 100 / leases) : 0;
+        }
+    };
+
+    class Lease {
+    public:
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease();
+
+        [[nodiscard]] Bitmap& bitmap() { return bitmap_; }
+        [[nodiscard]] Bitmap& operator*() { return bitmap_; }
+        [[nodiscard]] Bitmap *operator->() { return &bitmap_; }
+
+    private:
+        friend class BitmapPool;
+
+        explicit Lease(std::shared_ptr<BitmapStorage> storage);
+
+        Bitmap bitmap_;
+        size_t bytes_ = 0;
+    };
+
+    // the bitmap is null if the storage could not be created
+    [[nodiscard]] Lease acquire(unsigned width, unsigned height);
+    [[nodiscard]] Lease acquireAs(const Bitmap& another) {
+        return acquire(another.width(), another.height());
+    }
+
+    [[nodiscard]] Statistics statistics();
+
+    // frees the idle storage
+    void clear();
+
+private:
+    // the storage is recycled unless another bitmap shares it
+    void release(std::shared_ptr<BitmapStorage> storage, size_t leasedBytes);
+
+    static size_t sizeInBytes(const BitmapStorage& storage);
+
+    std::list<std::shared_ptr<BitmapStorage>> idle_; // the most recently released first
+    Statistics stats_;
+    std::mutex mtx_;
+
+//
+// Singleton implementation
+//
+public:
+    //
+    // Returns the object instance
+    //
+    static BitmapPool& instance() {
+        static BitmapPool instance_;
+        return instance_;
+    }
+
+    BitmapPool(const BitmapPool&) = delete;
+    BitmapPool& operator=(const BitmapPool&) = delete;
+
+private:
+    BitmapPool() = default;
+    ~BitmapPool() = default;
+};
+
+} // namespace litelockr
+
+#endif // BITMAP_POOL_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitmapStorage.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace litelockr {
+
+std::unique_ptr<BitmapStorage> BitmapStorage::create(unsigned width, unsigned height) {
+#ifdef _WIN32
+    return DibBitmapStorage::create(width, height);
+#else
+    return HeapBitmapStorage::create(width, height);
+#endif
+}
+
+//
+// HeapBitmapStorage
+//
+std::unique_ptr<HeapBitmapStorage> HeapBitmapStorage::create(unsigned width, unsigned height) {
+    assert(width > 0);
+    assert(height > 0);
+
+    size_t stride = (static_cast<size_t>(width) * PIXEL_SIZE + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    size_t size = stride * height;
+
+    auto bits = static_cast<uint8_t *>(::operator new(size, std::align_val_t(ALIGNMENT), std::nothrow));
+    if (!bits) {
+        return nullptr;
+    }
+    std::memset(bits, 0, size);
+    return std::unique_ptr<HeapBitmapStorage>(
+            new HeapBitmapStorage(bits, width, height, static_cast<int>(stride)));
+}
+
+HeapBitmapStorage::~HeapBitmapStorage() {
+    ::operator delete(bits_, std::align_val_t(ALIGNMENT));
+}
+
+#ifdef _WIN32
+//
+// DibBitmapStorage
+//
+std::unique_ptr<DibBitmapStorage> DibBitmapStorage::create(unsigned width, unsigned height) {
+    assert(width > 0);
+    assert(height > 0);
+
+    HDC hMemDC = CreateCompatibleDC(nullptr);
+    if (!hMemDC) {
+        return nullptr;
+    }
+
+    BITMAPINFOHEADER bih{sizeof(bih)};
+    bih.biWidth = static_cast<long>(width);
+    bih.biHeight = static_cast<long>(height);
+    bih.biPlanes = 1;
+    bih.biBitCount = PIXEL_SIZE << 3;
+    bih.biCompression = BI_RGB;
+
+    void *bits;
+    HBITMAP hDib = CreateDIBSection(hMemDC, reinterpret_cast<BITMAPINFO *>(&bih),
+                                    DIB_RGB_COLORS, &bits, nullptr, 0);
+    DeleteDC(hMemDC);
+    if (!hDib) {
+        return nullptr;
+    }
+
+    BITMAP bitmap;
+    if (!GetObject(hDib, sizeof(bitmap), &bitmap)) {
+        DeleteObject(hDib);
+        return nullptr;
+    }
+    assert(bitmap.bmBitsPixel == PIXEL_SIZE << 3);
+    return std::unique_ptr<DibBitmapStorage>(new DibBitmapStorage(hDib, bitmap));
+}
+
+DibBitmapStorage::~DibBitmapStorage() {
+    DeleteObject(hBitmap_);
+}
+#endif // _WIN32
+
+} // namespace litelockr
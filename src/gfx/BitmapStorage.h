@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITMAP_STORAGE_H
+#define BITMAP_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace litelockr {
+
+//
+// The pixel memory of a Bitmap, 32 bits per pixel
+//
+class BitmapStorage {
+public:
+    constexpr static unsigned PIXEL_SIZE = 4;
+
+    virtual ~BitmapStorage() = default;
+
+    // the lowest address of the pixel memory
+    [[nodiscard]] virtual uint8_t *bits() const = 0;
+    [[nodiscard]] virtual unsigned width() const = 0;
+    [[nodiscard]] virtual unsigned height() const = 0;
+
+    // the distance between the rows in bytes, negative if the rows are stored bottom-up
+    [[nodiscard]] virtual int stride() const = 0;
+
+    // HBITMAP of the DIB section
+    [[nodiscard]] virtual void *nativeHandle() const { return nullptr; }
+
+    // a DIB section on Windows, the heap memory elsewhere
+    static std::unique_ptr<BitmapStorage> create(unsigned width, unsigned height);
+};
+
+//
+// 64-byte-aligned zero-initialized heap memory, the rows are stored top-down
+//
+class HeapBitmapStorage: public BitmapStorage {
+public:
+    constexpr static size_t ALIGNMENT = 64;
+
+    static std::unique_ptr<HeapBitmapStorage> create(unsigned width, unsigned height);
+
+    HeapBitmapStorage(const HeapBitmapStorage&) = delete;
+    HeapBitmapStorage& operator=(const HeapBitmapStorage&) = delete;
+    ~HeapBitmapStorage() override;
+
+    [[nodiscard]] uint8_t *bits() const override { return bits_; }
+    [[nodiscard]] unsigned width() const override { return width_; }
+    [[nodiscard]] unsigned height() const override { return height_; }
+    [[nodiscard]] int stride() const override { return stride_; }
+
+private:
+    HeapBitmapStorage(uint8_t *bits, unsigned width, unsigned height, int stride)
+            : bits_(bits), width_(width), height_(height), stride_(stride) {}
+
+    uint8_t *bits_;
+    unsigned width_;
+    unsigned height_;
+    int stride_;
+};
+
+#ifdef _WIN32
+//
+// Bottom-up DIB section, can be selected into a device context
+//
+class DibBitmapStorage: public BitmapStorage {
+public:
+    static std::unique_ptr<DibBitmapStorage> create(unsigned width, unsigned height);
+
+    DibBitmapStorage(const DibBitmapStorage&) = delete;
+    DibBitmapStorage& operator=(const DibBitmapStorage&) = delete;
+    ~DibBitmapStorage() override;
+
+    [[nodiscard]] uint8_t *bits() const override { return reinterpret_cast<uint8_t *>(bitmap_.bmBits); }
+    [[nodiscard]] unsigned width() const override { return bitmap_.bmWidth; }
+    [[nodiscard]] unsigned height() const override { return bitmap_.bmHeight; }
+    [[nodiscard]] int stride() const override { return -bitmap_.bmWidthBytes; }
+    [[nodiscard]] void *nativeHandle() const override { return hBitmap_; }
+
+private:
+    DibBitmapStorage(HBITMAP hBitmap, const BITMAP& bitmap) : hBitmap_(hBitmap), bitmap_(bitmap) {}
+
+    HBITMAP hBitmap_;
+    BITMAP bitmap_;
+};
+#endif // _WIN32
+
+} // namespace litelockr
+
+#endif // BITMAP_STORAGE_H
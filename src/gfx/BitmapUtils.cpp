@@ -20,6 +20,7 @@
 #include "BitmapUtils.h"
 
 #include <cstdlib>
+#include <cstring>
 
 namespace litelockr {
 
@@ -29,15 +30,17 @@ void BitmapUtils::applyMask(Bitmap& image, const Bitmap& mask) {
     assert(width == mask.width());
     assert(height == mask.height());
 
+    // the image is premultiplied, so all the channels are scaled
     for (unsigned i = 0; i < height; i++) {
         auto dst = image.pixFmt().row_ptr(i);
         auto src = mask.pixFmt().row_ptr(i);
 
-        dst += 3; // shift to the alpha channel
-
         unsigned j = width;
         do {
-            *dst = (((*dst) * (*src)) >> 8);
+            dst[0] = ((dst[0] * (*src)) >> 8);
+            dst[1] = ((dst[1] * (*src)) >> 8);
+            dst[2] = ((dst[2] * (*src)) >> 8);
+            dst[3] = ((dst[3] * (*src)) >> 8);
             dst += 4;
             src += 4;
         } while (--j);
@@ -45,18 +48,33 @@ void BitmapUtils::applyMask(Bitmap& image, const Bitmap& mask) {
 }
 
 void BitmapUtils::fillAlpha(Bitmap& image, int x, int y, unsigned width, unsigned height, std::uint8_t alpha) {
+    using Multiplier = agg::multiplier_rgba<Color, agg::order_bgra>;
+
+    // GDI leaves a straight color, it gets the alpha and is premultiplied by it
     for (unsigned i = 0; i < height; i++) {
         auto ptr = image.pixFmt().pix_ptr(x, y + i);
 
-        ptr += 3; // shift to the alpha channel
-
         unsigned j = width;
         do {
-            *ptr = alpha;
+            ptr[ColorA] = alpha;
+            Multiplier::premultiply(ptr);
             ptr += 4;
         } while (--j);
     }
 }
 
+bool BitmapUtils::equals(const Bitmap& a, const Bitmap& b) {
+    if (a.isNull() || b.isNull() || a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+
+    const size_t widthBytes = a.width() * Bitmap::PixFmtType::pix_width;
+    for (unsigned y = 0; y < a.height(); y++) {
+        if (std::memcmp(a.pixFmt().row_ptr(y), b.pixFmt().row_ptr(y), widthBytes) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
 
 } // namespace litelockr
@@ -29,6 +29,7 @@ class BitmapUtils {
 public:
     static void applyMask(Bitmap& image, const Bitmap& mask);
     static void fillAlpha(Bitmap& image, int x, int y, unsigned width, unsigned height, std::uint8_t alpha);
+    static bool equals(const Bitmap& a, const Bitmap& b);
 };
 
 } // namespace litelockr
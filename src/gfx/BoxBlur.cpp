@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BoxBlur.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "gfx/PixelKernels.h"
+
+#ifdef PIXEL_KERNELS_X86
+#include <emmintrin.h>
+#endif
+
+namespace litelockr {
+
+namespace {
+
+constexpr unsigned MAX_BOX_RADIUS = 127; // the 16-bit sums hold 255 * (2 * 127 + 1) with the rounding
+constexpr unsigned STRIP_BYTES = 64;     // the columns a vertical pass walks down, a cache line
+
+struct Box {
+    unsigned radius;
+    unsigned multiplier; // 65536 / the window, the average is (sum + bias) * multiplier >> 16
+    unsigned bias;
+};
+
+Box makeBox(unsigned radius) {
+    unsigned window = 2 * radius + 1;
+    return {radius, 65536 / window, window / 2};
+}
+
+// the box sizes for a gaussian with the variance of the stack blur kernel
+std::array<Box, 3> makeBoxes(unsigned radius) {
+    const double variance = radius * (radius + 2) / 6.0;
+    const int n = 3;
+
+    auto lower = static_cast<int>(std::floor(std::sqrt(12 * variance / n + 1)));
+    if (lower % 2 == 0) {
+        lower--;
+    }
+    const int upper = lower + 2;
+    auto m = static_cast<int>(std::lround((12 * variance - n * lower * lower - 4 * n * lower - 3 * n) / (-4 * lower - 4)));
+
+    std::array<Box, 3> boxes{};
+    for (int i = 0; i < n; i++) {
+        auto size = static_cast<unsigned>(i < m ? lower : upper);
+        boxes[i] = makeBox(std::min((size - 1) / 2, MAX_BOX_RADIUS));
+    }
+    return boxes;
+}
+
+inline uint8_t average(unsigned sum, const Box& box) {
+    return static_cast<uint8_t>(((sum + box.bias) * box.multiplier) >> 16);
+}
+
+//
+// A box pass over count elements of the given bytes, from first on by step. The elements are replaced
+// by the averages, the ring keeps the (radius + 1) originals the window still needs.
+//
+void boxPassScalar(uint8_t *first, ptrdiff_t step, unsigned count, unsigned bytes, const Box& box,
+                   uint8_t *ring) {
+    const unsigned r = box.radius;
+    const unsigned last = count - 1;
+    auto element = [first, step](unsigned i) { return first + step * static_cast<ptrdiff_t>(i); };
+
+    unsigned sums[STRIP_BYTES];
+    for (unsigned k = 0; k < bytes; k++) {
+        sums[k] = element(0)[k] * (r + 1);
+    }
+    for (unsigned i = 1; i <= r; i++) {
+        const uint8_t *p = element(std::min(i, last));
+        for (unsigned k = 0; k < bytes; k++) {
+            sums[k] += p[k];
+        }
+    }
+
+    unsigned slot = 0;
+    for (unsigned x = 0; x <= last; x++) {
+        uint8_t *p = element(x);
+        std::memcpy(ring + slot * bytes, p, bytes);
+        for (unsigned k = 0; k < bytes; k++) {
+            p[k] = average(sums[k], box);
+        }
+        if (x == last) {
+            break;
+        }
+
+        const uint8_t *added = element(std::min(x + r + 1, last));
+        const uint8_t *removed = ring + (x >= r ? (slot == r ? 0 : slot + 1) : 0) * bytes;
+        for (unsigned k = 0; k < bytes; k++) {
+            sums[k] += added[k] - removed[k];
+        }
+        slot = slot == r ? 0 : slot + 1;
+    }
+}
+
+#ifdef PIXEL_KERNELS_X86
+//
+// The same pass with 16-bit sums, one pixel per register for the rows
+//
+void boxRowSse2(uint8_t *row, unsigned count, const Box& box, uint32_t *ring) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(box.bias));
+    const __m128i multiplier = _mm_set1_epi16(static_cast<short>(box.multiplier));
+    const unsigned r = box.radius;
+    const unsigned last = count - 1;
+
+    auto load = [zero](uint32_t pixel) { return _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixel)), zero); };
+    auto pixels = reinterpret_cast<uint32_t *>(row);
+
+    __m128i sum = _mm_mullo_epi16(load(pixels[0]), _mm_set1_epi16(static_cast<short>(r + 1)));
+    for (unsigned i = 1; i <= r; i++) {
+        sum = _mm_add_epi16(sum, load(pixels[std::min(i, last)]));
+    }
+
+    unsigned slot = 0;
+    for (unsigned x = 0; x <= last; x++) {
+        ring[slot] = pixels[x];
+        __m128i avg = _mm_mulhi_epu16(_mm_add_epi16(sum, bias), multiplier);
+        pixels[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(avg, avg)));
+        if (x == last) {
+            break;
+        }
+
+        uint32_t removed = ring[x >= r ? (slot == r ? 0 : slot + 1) : 0];
+        sum = _mm_sub_epi16(_mm_add_epi16(sum, load(pixels[std::min(x + r + 1, last)])), load(removed));
+        slot = slot == r ? 0 : slot + 1;
+    }
+}
+
+// a vertical pass over chunks of 16 bytes each, 8 channels per register
+void boxStripSse2(uint8_t *first, ptrdiff_t stride, unsigned count, unsigned chunks, const Box& box,
+                  uint8_t *ring) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(box.bias));
+    const __m128i multiplier = _mm_set1_epi16(static_cast<short>(box.multiplier));
+    const unsigned r = box.radius;
+    const unsigned last = count - 1;
+    const unsigned bytes = chunks * 16;
+
+    auto element = [first, stride](unsigned i) {
+        return reinterpret_cast<__m128i *>(first + stride * static_cast<ptrdiff_t>(i));
+    };
+
+    __m128i sums[STRIP_BYTES / 8];
+    const __m128i firstWeight = _mm_set1_epi16(static_cast<short>(r + 1));
+    for (unsigned c = 0; c < chunks; c++) {
+        __m128i v = _mm_loadu_si128(element(0) + c);
+        sums[2 * c] = _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), firstWeight);
+        sums[2 * c + 1] = _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), firstWeight);
+    }
+    for (unsigned i = 1; i <= r; i++) {
+        const __m128i *p = element(std::min(i, last));
+        for (unsigned c = 0; c < chunks; c++) {
+            __m128i v = _mm_loadu_si128(p + c);
+            sums[2 * c] = _mm_add_epi16(sums[2 * c], _mm_unpacklo_epi8(v, zero));
+            sums[2 * c + 1] = _mm_add_epi16(sums[2 * c + 1], _mm_unpackhi_epi8(v, zero));
+        }
+    }
+
+    unsigned slot = 0;
+    for (unsigned y = 0; y <= last; y++) {
+        __m128i *p = element(y);
+        auto saved = reinterpret_cast<__m128i *>(ring + slot * bytes);
+        for (unsigned c = 0; c < chunks; c++) {
+            _mm_storeu_si128(saved + c, _mm_loadu_si128(p + c));
+            __m128i lo = _mm_mulhi_epu16(_mm_add_epi16(sums[2 * c], bias), multiplier);
+            __m128i hi = _mm_mulhi_epu16(_mm_add_epi16(sums[2 * c + 1], bias), multiplier);
+            _mm_storeu_si128(p + c, _mm_packus_epi16(lo, hi));
+        }
+        if (y == last) {
+            break;
+        }
+
+        const __m128i *added = element(std::min(y + r + 1, last));
+        auto removed = reinterpret_cast<const __m128i *>(ring + (y >= r ? (slot == r ? 0 : slot + 1) : 0) * bytes);
+        for (unsigned c = 0; c < chunks; c++) {
+            __m128i a = _mm_loadu_si128(added + c);
+            __m128i s = _mm_loadu_si128(removed + c);
+            sums[2 * c] = _mm_sub_epi16(_mm_add_epi16(sums[2 * c], _mm_unpacklo_epi8(a, zero)),
+                                        _mm_unpacklo_epi8(s, zero));
+            sums[2 * c + 1] = _mm_sub_epi16(_mm_add_epi16(sums[2 * c + 1], _mm_unpackhi_epi8(a, zero)),
+                                            _mm_unpackhi_epi8(s, zero));
+        }
+        slot = slot == r ? 0 : slot + 1;
+    }
+}
+#endif // PIXEL_KERNELS_X86
+
+void blurRow(uint8_t *row, unsigned width, const std::array<Box, 3>& boxes) {
+    alignas(16) uint8_t ring[(MAX_BOX_RADIUS + 1) * 4];
+
+    for (const auto& box: boxes) {
+        if (box.radius == 0) {
+            continue;
+        }
+#ifdef PIXEL_KERNELS_X86
+        boxRowSse2(row, width, box, reinterpret_cast<uint32_t *>(ring));
+#else
+        boxPassScalar(row, 4, width, 4, box, ring);
+#endif
+    }
+}
+
+void blurStrip(uint8_t *first, ptrdiff_t stride, unsigned height, unsigned bytes, const std::array<Box, 3>& boxes) {
+    alignas(16) uint8_t ring[(MAX_BOX_RADIUS + 1) * STRIP_BYTES];
+
+    for (const auto& box: boxes) {
+        if (box.radius == 0) {
+            continue;
+        }
+#ifdef PIXEL_KERNELS_X86
+        unsigned chunks = bytes / 16;
+        if (chunks) {
+            boxStripSse2(first, stride, height, chunks, box, ring);
+        }
+        if (unsigned tail = bytes % 16) {
+            boxPassScalar(first + chunks * 16, stride, height, tail, box, ring);
+        }
+#else
+        boxPassScalar(first, stride, height, bytes, box, ring);
+#endif
+    }
+}
+
+} // namespace
+
+void BoxBlur::blur(Bitmap& image, unsigned radius) {
+    blur(image, radius, {0, 0, static_cast<long>(image.width()), static_cast<long>(image.height())});
+}
+
+void BoxBlur::blur(Bitmap& image, unsigned radius, const RECT& rect) {
+    RECT rc = rect;
+    rc.left = std::max(rc.left, 0L);
+    rc.top = std::max(rc.top, 0L);
+    rc.right = std::min(rc.right, static_cast<long>(image.width()));
+    rc.bottom = std::min(rc.bottom, static_cast<long>(image.height()));
+    if (radius == 0 || rc.right <= rc.left || rc.bottom <= rc.top) {
+        return;
+    }
+
+    const auto boxes = makeBoxes(std::min(radius, MAX_RADIUS));
+    const auto width = static_cast<unsigned>(rc.right - rc.left);
+    const auto height = static_cast<unsigned>(rc.bottom - rc.top);
+    auto& pixf = image.pixFmt();
+
+#pragma omp parallel for
+    for (int y = rc.top; y < rc.bottom; y++) {
+        blurRow(pixf.pix_ptr(rc.left, y), width, boxes);
+    }
+
+    const unsigned widthBytes = width * 4;
+    const int strips = static_cast<int>((widthBytes + STRIP_BYTES - 1) / STRIP_BYTES);
+    const ptrdiff_t stride = pixf.stride();
+
+#pragma omp parallel for
+    for (int i = 0; i < strips; i++) {
+        unsigned offset = i * STRIP_BYTES;
+        blurStrip(pixf.pix_ptr(rc.left, rc.top) + offset, stride, height,
+                  std::min(STRIP_BYTES, widthBytes - offset), boxes);
+    }
+}
+
+unsigned BoxBlur::extent(unsigned radius) {
+    if (radius == 0) {
+        return 0;
+    }
+    unsigned sum = 0;
+    for (const auto& box: makeBoxes(std::min(radius, MAX_RADIUS))) {
+        sum += box.radius;
+    }
+    return sum;
+}
+
+} // namespace litelockr
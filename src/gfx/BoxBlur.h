@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOX_BLUR_H
+#define BOX_BLUR_H
+
+#include "gfx/Bitmap.h"
+
+namespace litelockr {
+
+//
+// Approximates agg::stack_blur of the same radius with three box passes in each direction. The passes
+// work in place, the rows and the column strips are split across the cores.
+//
+class BoxBlur {
+public:
+    constexpr static unsigned MAX_RADIUS = 254;
+
+    static void blur(Bitmap& image, unsigned radius);
+    // blurs the pixels of rect only, as if the image ended at its edges
+    static void blur(Bitmap& image, unsigned radius, const RECT& rect);
+
+    // how far the blur reaches, the pixels inside rect farther than that from its edges are the same
+    // as if the whole image was blurred
+    static unsigned extent(unsigned radius);
+};
+
+} // namespace litelockr
+
+#endif // BOX_BLUR_H
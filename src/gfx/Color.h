@@ -32,6 +32,11 @@ constexpr static auto ColorG = agg::order_bgra::G;
 constexpr static auto ColorB = agg::order_bgra::B;
 constexpr static auto ColorA = agg::order_bgra::A;
 
+// the form the bitmaps and their renderers store
+inline Color premultiplied(Color color) {
+    return color.premultiply();
+}
+
 } // namespace litelockr
 
 #endif // COLOR_H
\ No newline at end of file
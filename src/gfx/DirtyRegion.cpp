@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DirtyRegion.h"
+
+#include <algorithm>
+
+#include "sys/Rectangle.h"
+
+namespace litelockr {
+
+void DirtyRegion::setSize(unsigned width, unsigned height) {
+    if (width_ != static_cast<long>(width) || height_ != static_cast<long>(height)) {
+        width_ = static_cast<long>(width);
+        height_ = static_cast<long>(height);
+        addAll();
+    }
+}
+
+void DirtyRegion::add(const RECT& rect) {
+    RECT rc = {std::max(rect.left, 0L), std::max(rect.top, 0L),
+               std::min(rect.right, width_), std::min(rect.bottom, height_)};
+    if (rc.left >= rc.right || rc.top >= rc.bottom) {
+        return;
+    }
+
+    for (const auto& r: rects_) {
+        if (Rectangle::contains(r, rc)) {
+            return;
+        }
+    }
+
+    // merges all the overlapped rectangles, the union may overlap some more
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (auto it = rects_.begin(); it != rects_.end(); ++it) {
+            if (Rectangle::intersects(*it, rc)) {
+                rc = Rectangle::unite(*it, rc);
+                rects_.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    rects_.push_back(rc);
+    if (rects_.size() > MAX_RECTS) {
+        collapse();
+    }
+}
+
+void DirtyRegion::addAll() {
+    rects_.clear();
+    if (width_ > 0 && height_ > 0) {
+        rects_.push_back({0, 0, width_, height_});
+    }
+}
+
+void DirtyRegion::clear() {
+    rects_.clear();
+}
+
+RECT DirtyRegion::bounds() const {
+    if (rects_.empty()) {
+        return {};
+    }
+    RECT rc = rects_.front();
+    for (const auto& r: rects_) {
+        rc = Rectangle::unite(rc, r);
+    }
+    return rc;
+}
+
+size_t DirtyRegion::area() const {
+    size_t result = 0;
+    for (const auto& r: rects_) {
+        result += static_cast<size_t>(r.right - r.left) * (r.bottom - r.top);
+    }
+    return result;
+}
+
+void DirtyRegion::collapse() {
+    RECT rc = bounds();
+    rects_.clear();
+    rects_.push_back(rc);
+}
+
+} // namespace litelockr
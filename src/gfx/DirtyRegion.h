@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIRTY_REGION_H
+#define DIRTY_REGION_H
+
+#include <cstddef>
+#include <vector>
+
+#include "sys/WinTypes.h"
+
+namespace litelockr {
+
+//
+// The changed areas of a buffer. Overlapping rectangles are merged, too many rectangles
+// are collapsed into their bounding box.
+//
+class DirtyRegion {
+public:
+    constexpr static size_t MAX_RECTS = 8;
+
+    // the buffer size, the rectangles are clipped to it
+    void setSize(unsigned width, unsigned height);
+
+    void add(const RECT& rect);
+    void addAll();
+    void clear();
+
+    [[nodiscard]] bool empty() const { return rects_.empty(); }
+    [[nodiscard]] const std::vector<RECT>& rects() const { return rects_; }
+    [[nodiscard]] RECT bounds() const;
+    [[nodiscard]] size_t area() const;
+
+private:
+    void collapse();
+
+    long width_ = 0;
+    long height_ = 0;
+    std::vector<RECT> rects_;
+};
+
+} // namespace litelockr
+
+#endif // DIRTY_REGION_H
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FontCache.h"
+
+#include <cassert>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+FontCache::FontCache() : fontEngine_(dc_.hDC, stats_), fontManager_(fontEngine_) {
+    assert(dc_.hDC);
+    fontEngine_.flip_y(true);
+}
+
+bool FontCache::select(const Font& font) {
+    if (hasFont_ && font == font_) {
+        // create_font() would drop the kerning pairs even for a font it has already
+        return true;
+    }
+
+    fontEngine_.height(font.height);
+    fontEngine_.weight(font.weight);
+    fontEngine_.italic(font.italic);
+
+    hasFont_ = fontEngine_.create_font(font.face.c_str(), agg::glyph_ren_outline);
+    if (!hasFont_) {
+        LOG_ERROR(L"[FontCache] Could not create the font '%hs'", font.face.c_str());
+        return false;
+    }
+    font_ = font;
+
+    stats_.fontChanges++;
+    LOG_DEBUG(L"[FontCache] Font '%hs' %.1f %d%s: %llu glyphs requested, %u%% cached",
+              font.face.c_str(), font.height, font.weight, font.italic ? L" italic" : L"",
+              static_cast<unsigned long long>(stats_.lookups), stats_.hitRate());
+    return true;
+}
+
+} // namespace litelockr
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FONT_CACHE_H
+#define FONT_CACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "gfx/AggAll.h"
+
+namespace litelockr {
+
+//
+// Process-wide TrueType font engine and glyph cache for BitmapContext. The fonts and the glyph
+// outlines with their advances stay cached between the calls. Lock mutex() while using it.
+//
+class FontCache {
+public:
+    struct Font {
+        std::string face;
+        float height = 0;
+        int weight = 0;
+        bool italic = false;
+
+        bool operator==(const Font&) const = default;
+    };
+
+    struct Statistics {
+        uint64_t lookups = 0;   // the glyphs requested
+        uint64_t misses = 0;    // the glyphs rasterized by the engine
+        unsigned int fontChanges = 0; // the times another font was selected
+
+        [[nodiscard]] unsigned int hitRate() const {
+            return lookups ? static_cast<unsigned int>((lookups - misses) * 100 / lookups) : 0;
+        }
+    };
+
+    // counts the glyphs the cache manager asks to rasterize
+    class FontEngine: public agg::font_engine_win32_tt_int16 {
+    public:
+        FontEngine(HDC hDC, Statistics& stats) : font_engine_win32_tt_int16(hDC), stats_(stats) {}
+
+        bool prepare_glyph(unsigned glyphCode) {
+            stats_.misses++;
+            return font_engine_win32_tt_int16::prepare_glyph(glyphCode);
+        }
+
+    private:
+        Statistics& stats_;
+    };
+
+    using FontManager = agg::font_cache_manager<FontEngine>;
+
+    [[nodiscard]] std::mutex& mutex() { return mtx_; }
+
+    // makes the font current, the font is created once
+    bool select(const Font& font);
+
+    const agg::glyph_cache *glyph(wchar_t ch) {
+        stats_.lookups++;
+        return fontManager_.glyph(ch);
+    }
+
+    [[nodiscard]] FontManager& fontManager() { return fontManager_; }
+
+    [[nodiscard]] const Statistics& statistics() const { return stats_; }
+
+private:
+    // outlives the font engine, which restores the DC on destruction
+    struct DeviceContext {
+        HDC hDC = CreateCompatibleDC(nullptr);
+
+        ~DeviceContext() {
+            if (hDC) {
+                DeleteDC(hDC);
+            }
+        }
+    };
+
+    DeviceContext dc_;
+    Statistics stats_;
+    FontEngine fontEngine_;
+    FontManager fontManager_;
+
+    bool hasFont_ = false;
+    Font font_;
+    std::mutex mtx_;
+
+//
+// Singleton implementation
+//
+public:
+    //
+    // Returns the object instance
+    //
+    static FontCache& instance() {
+        static FontCache instance_;
+        return instance_;
+    }
+
+    FontCache(const FontCache&) = delete;
+    FontCache& operator=(const FontCache&) = delete;
+
+private:
+    FontCache();
+    ~FontCache() = default;
+};
+
+} // namespace litelockr
+
+#endif // FONT_CACHE_H
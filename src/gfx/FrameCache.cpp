@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameCache.h"
+
+#include <cassert>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "log/Logger.h"
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+FrameCache::Key& FrameCache::Key::addBytes(const void *data, size_t size) {
+    auto bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash_ ^= bytes[i];
+        hash_ *= 1099511628211ull;
+    }
+    return *this;
+}
+
+FrameCache::Key& FrameCache::Key::addFile(const std::wstring& path) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes{};
+    if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attributes)) {
+        LOG_ERROR(L"[FrameCache] Cannot read the attributes of '%s'", path.c_str());
+    }
+    add(attributes.nFileSizeHigh);
+    add(attributes.nFileSizeLow);
+    add(attributes.ftLastWriteTime.dwHighDateTime);
+    return add(attributes.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat attributes{};
+    if (stat(std::filesystem::path(path).c_str(), &attributes) != 0) {
+        LOG_ERROR(L"[FrameCache] Cannot read the attributes of '%s'", path.c_str());
+    }
+    add(static_cast<int64_t>(attributes.st_size));
+    add(static_cast<int64_t>(attributes.st_mtim.tv_sec));
+    return add(static_cast<int64_t>(attributes.st_mtim.tv_nsec));
+#endif
+}
+
+bool FrameCache::open(const std::wstring& path, uint64_t key) {
+    const auto start = AppClock::now();
+    path_ = path;
+    key_ = key;
+    opened_ = true;
+    mapping_.reset();
+    entries_.clear();
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        LOG_DEBUG(L"[FrameCache] No cache file '%s'", path.c_str());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    HANDLE hMapping = nullptr;
+    if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(Header))) {
+        hMapping = CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(hFile); // the mapping keeps the file open
+    if (!hMapping) {
+        LOG_DEBUG(L"[FrameCache] Cannot map '%s'", path.c_str());
+        return false;
+    }
+
+    const void *view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping); // the view keeps the mapping
+    if (!view) {
+        LOG_ERROR(L"[FrameCache] Cannot map '%s', error %lu", path.c_str(), GetLastError());
+        return false;
+    }
+    std::shared_ptr<const void> mapping(view, [](const void *p) { UnmapViewOfFile(p); });
+    const auto size = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(std::filesystem::path(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_DEBUG(L"[FrameCache] No cache file '%s'", path.c_str());
+        return false;
+    }
+
+    struct stat attributes{};
+    void *view = MAP_FAILED;
+    if (fstat(fd, &attributes) == 0 && attributes.st_size >= static_cast<off_t>(sizeof(Header))) {
+        view = mmap(nullptr, static_cast<size_t>(attributes.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // the mapping keeps the file open
+    if (view == MAP_FAILED) {
+        LOG_DEBUG(L"[FrameCache] Cannot map '%s'", path.c_str());
+        return false;
+    }
+    const auto size = static_cast<uint64_t>(attributes.st_size);
+    std::shared_ptr<const void> mapping(view, [size](const void *p) {
+        munmap(const_cast<void *>(p), static_cast<size_t>(size));
+    });
+#endif
+
+    if (!readEntries(mapping, size)) {
+        entries_.clear();
+        return false; // unmaps the file, save() replaces it
+    }
+    mapping_ = std::move(mapping);
+
+    LOG_DEBUG(L"[FrameCache] Mapped '%s': %zu frame sets, %llu KB in %.2f ms", path.c_str(), entries_.size(),
+              static_cast<unsigned long long>(size / 1024),
+              std::chrono::duration<double, std::milli>(AppClock::now() - start).count());
+    return true;
+}
+
+bool FrameCache::readEntries(const std::shared_ptr<const void>& mapping, uint64_t size) {
+    auto data = static_cast<const uint8_t *>(mapping.get());
+    const auto& header = *reinterpret_cast<const Header *>(data);
+    if (header.magic != MAGIC || header.version != VERSION || header.key != key_) {
+        LOG_DEBUG(L"[FrameCache] The cache file is stale");
+        return false;
+    }
+    if (header.numEntries > (size - sizeof(Header)) / sizeof(Entry)) {
+        LOG_ERROR(L"[FrameCache] The cache file is damaged");
+        return false;
+    }
+
+    auto entries = reinterpret_cast<const Entry *>(data + sizeof(Header));
+    for (uint32_t i = 0; i < header.numEntries; i++) {
+        const Entry& entry = entries[i];
+        const bool fits = entry.offset % sizeof(uint32_t) == 0 && entry.offset <= size &&
+                          entry.numWords <= (size - entry.offset) / sizeof(uint32_t);
+
+        // the codec keeps the file mapped
+        auto codec = std::make_shared<FrameCodec>();
+        if (!fits || !codec->attach(entry.width, entry.height, entry.numFrames,
+                                    reinterpret_cast<const uint32_t *>(data + entry.offset),
+                                    static_cast<size_t>(entry.numWords), mapping)) {
+            LOG_ERROR(L"[FrameCache] The frame set %u of the cache file is damaged", entry.id);
+            return false;
+        }
+        entries_[entry.id] = std::move(codec);
+    }
+    return true;
+}
+
+bool FrameCache::load(uint32_t id, FrameSet& frames) const {
+    assert(opened_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return false;
+    }
+    frames.createFromFrames(it->second);
+    return true;
+}
+
+void FrameCache::store(uint32_t id, const FrameSet& frames) {
+    assert(opened_);
+
+    if (auto codec = frames.encodedFrames()) {
+        stored_[id] = std::move(codec);
+    }
+}
+
+bool FrameCache::save() {
+    assert(opened_);
+
+    if (mapping_ || stored_.empty()) {
+        return false; // the mapped file cannot be replaced, it is up to date anyway
+    }
+
+    Header header{MAGIC, VERSION, key_, static_cast<uint32_t>(stored_.size()), 0};
+    std::vector<Entry> entries;
+    uint64_t offset = sizeof(Header) + sizeof(Entry) * stored_.size();
+    for (const auto& [id, codec]: stored_) {
+        entries.push_back({id, codec->width(), codec->height(), codec->size(), offset, codec->numWords()});
+        offset += codec->numWords() * sizeof(uint32_t);
+    }
+
+    // the file appears complete or not at all
+    const std::wstring tempPath = path_ + L".tmp";
+#ifdef _WIN32
+    HANDLE hFile = CreateFile(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(L"[FrameCache] Cannot create '%s', error %lu", tempPath.c_str(), GetLastError());
+        return false;
+    }
+
+    auto write = [hFile](const void *data, size_t size) {
+        DWORD written = 0;
+        return WriteFile(hFile, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+    };
+#else
+    std::ofstream file(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR(L"[FrameCache] Cannot create '%s'", tempPath.c_str());
+        return false;
+    }
+
+    auto write = [&file](const void *data, size_t size) {
+        return static_cast<bool>(file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size)));
+    };
+#endif
+    bool ok = write(&header, sizeof(header)) && write(entries.data(), sizeof(Entry) * entries.size());
+    for (auto it = stored_.begin(); ok && it != stored_.end(); ++it) {
+        ok = write(it->second->words(), it->second->numWords() * sizeof(uint32_t));
+    }
+#ifdef _WIN32
+    CloseHandle(hFile);
+
+    if (!ok || !MoveFileEx(tempPath.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        LOG_ERROR(L"[FrameCache] Cannot write '%s', error %lu", path_.c_str(), GetLastError());
+        DeleteFile(tempPath.c_str());
+        return false;
+    }
+#else
+    file.close();
+    std::error_code error;
+    if (ok && !file.fail()) {
+        std::filesystem::rename(tempPath, path_, error);
+    }
+    if (!ok || file.fail() || error) {
+        LOG_ERROR(L"[FrameCache] Cannot write '%s'", path_.c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+#endif
+
+    LOG_DEBUG(L"[FrameCache] Saved %zu frame sets to '%s', %llu KB", stored_.size(), path_.c_str(), offset / 1024);
+    return true;
+}
+
+} // namespace litelockr
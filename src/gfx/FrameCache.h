@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "gfx/FrameCodec.h"
+#include "gfx/FrameSet.h"
+
+namespace litelockr {
+
+//
+// The pre-rendered frames kept in a file between the runs. The file is mapped into memory, and the frame sets
+// decode their frames right from it. The file holds the key of everything the frames have been rendered from,
+// it is ignored and written anew when the key does not match.
+//
+class FrameCache {
+public:
+    // the frames are rendered differently by another version of the file format
+    constexpr static uint32_t VERSION = 1;
+
+    //
+    // FNV-1a hash of the inputs of the frames
+    //
+    class Key {
+    public:
+        template<typename T>
+        Key& add(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return addBytes(&value, sizeof(value));
+        }
+
+        Key& add(std::wstring_view str) {
+            return addBytes(str.data(), str.size() * sizeof(wchar_t));
+        }
+
+        // the size and the last write time of the file, e.g. of the executable with the resources
+        Key& addFile(const std::wstring& path);
+
+        [[nodiscard]] uint64_t value() const { return hash_; }
+
+    private:
+        Key& addBytes(const void *data, size_t size);
+
+        uint64_t hash_ = 14695981039346656037ull;
+    };
+
+    FrameCache() = default;
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    // maps the file, returns false if it is missing, stale or damaged
+    bool open(const std::wstring& path, uint64_t key);
+    [[nodiscard]] bool isOpen() const { return opened_; }
+    [[nodiscard]] uint64_t key() const { return key_; }
+    // the file is up to date and its frames are used
+    [[nodiscard]] bool isMapped() const { return mapping_ != nullptr; }
+
+    // the frames with the id from the file
+    bool load(uint32_t id, FrameSet& frames) const;
+
+    // the frames rendered in this run, save() writes them unless the file is up to date
+    void store(uint32_t id, const FrameSet& frames);
+    [[nodiscard]] size_t numStored() const { return stored_.size(); }
+    bool save();
+
+private:
+    bool readEntries(const std::shared_ptr<const void>& mapping, uint64_t size);
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t numEntries;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        uint32_t id;
+        uint32_t width;
+        uint32_t height;
+        uint32_t numFrames;
+        uint64_t offset; // of the words from the start of the file
+        uint64_t numWords;
+    };
+
+    constexpr static uint32_t MAGIC = 0x43464c4c; // "LLFC"
+
+    std::wstring path_;
+    uint64_t key_ = 0;
+    bool opened_ = false;
+
+    std::shared_ptr<const void> mapping_;
+    std::map<uint32_t, std::shared_ptr<const FrameCodec>> entries_;
+    std::map<uint32_t, std::shared_ptr<const FrameCodec>> stored_;
+};
+
+} // namespace litelockr
+
+#endif // FRAME_CACHE_H
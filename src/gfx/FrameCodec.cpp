@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameCodec.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace litelockr {
+
+namespace {
+
+using PixFmt = Bitmap::PixFmtType;
+
+const uint32_t *pixelRow(const Bitmap& bitmap, unsigned y) {
+    return reinterpret_cast<const uint32_t *>(bitmap.pixFmt().row_ptr(static_cast<int>(y)));
+}
+
+} // namespace
+
+bool FrameCodec::encode(const Bitmap& strip, unsigned numFrames) {
+    assert(!strip.isNull());
+    assert(numFrames > 0 && strip.height() % numFrames == 0);
+
+    if (strip.isNull() || numFrames == 0 || strip.height() % numFrames != 0) {
+        return false;
+    }
+
+    width_ = strip.width();
+    height_ = strip.height() / numFrames;
+    numFrames_ = numFrames;
+    data_.clear();
+    frameOffsets_.clear();
+    frameOffsets_.reserve(numFrames);
+    storage_.reset();
+
+    for (unsigned frame = 0; frame < numFrames; frame++) {
+        frameOffsets_.push_back(data_.size());
+        encodeFrame(strip, frame);
+    }
+    data_.shrink_to_fit();
+    words_ = data_.data();
+    numWords_ = data_.size();
+    return true;
+}
+
+bool FrameCodec::attach(unsigned width, unsigned height, unsigned numFrames, const uint32_t *words,
+                        size_t numWords, std::shared_ptr<const void> storage) {
+    assert(words || numWords == 0);
+
+    width_ = width;
+    height_ = height;
+    numFrames_ = numFrames;
+    data_.clear();
+    data_.shrink_to_fit();
+    frameOffsets_.clear();
+    frameOffsets_.reserve(numFrames);
+    words_ = nullptr;
+    numWords_ = 0;
+    storage_.reset();
+
+    size_t offset = 0;
+    for (unsigned frame = 0; frame < numFrames; frame++) {
+        size_t frameWords = checkFrame(words + offset, numWords - offset);
+        if (frameWords == 0) {
+            frameOffsets_.clear();
+            numFrames_ = 0;
+            return false;
+        }
+        frameOffsets_.push_back(offset);
+        offset += frameWords;
+    }
+    if (numFrames == 0 || offset != numWords) {
+        frameOffsets_.clear();
+        numFrames_ = 0;
+        return false;
+    }
+
+    words_ = words;
+    numWords_ = numWords;
+    storage_ = std::move(storage);
+    return true;
+}
+
+size_t FrameCodec::checkFrame(const uint32_t *p, size_t wordsLeft) const {
+    if (wordsLeft < 4) {
+        return 0;
+    }
+    const uint32_t left = p[0], top = p[1], right = p[2], bottom = p[3];
+    if (left > right || right > width_ || top > bottom || bottom > height_) {
+        return 0;
+    }
+
+    size_t size = 4;
+    for (unsigned y = top; y < bottom; y++) {
+        if (size >= wordsLeft) {
+            return 0;
+        }
+        uint32_t x = left;
+        for (uint32_t count = p[size++]; count > 0; count--) {
+            if (wordsLeft - size < 2) {
+                return 0;
+            }
+            const uint32_t skip = p[size], len = p[size + 1];
+            if (skip > right - x || len > right - x - skip || len > wordsLeft - size - 2) {
+                return 0;
+            }
+            x += skip + len;
+            size += 2 + len;
+        }
+    }
+    return size;
+}
+
+void FrameCodec::encodeFrame(const Bitmap& strip, unsigned frame) {
+    const std::vector<uint32_t> transparent(frame == 0 ? width_ : 0, 0);
+    auto previousRow = [&](unsigned y) {
+        return frame == 0 ? transparent.data() : pixelRow(strip, (frame - 1) * height_ + y);
+    };
+    auto currentRow = [&](unsigned y) {
+        return pixelRow(strip, frame * height_ + y);
+    };
+
+    //
+    // Bounding box of the changes
+    //
+    unsigned left = width_, top = height_, right = 0, bottom = 0;
+    for (unsigned y = 0; y < height_; y++) {
+        const uint32_t *prev = previousRow(y);
+        const uint32_t *cur = currentRow(y);
+
+        unsigned x0 = 0;
+        while (x0 < width_ && cur[x0] == prev[x0]) {
+            x0++;
+        }
+        if (x0 == width_) {
+            continue;
+        }
+        unsigned x1 = width_;
+        while (cur[x1 - 1] == prev[x1 - 1]) {
+            x1--;
+        }
+
+        left = std::min(left, x0);
+        right = std::max(right, x1);
+        top = std::min(top, y);
+        bottom = y + 1;
+    }
+    if (left >= right) {
+        left = top = right = bottom = 0; // the same as the previous frame
+    }
+    data_.insert(data_.end(), {left, top, right, bottom});
+
+    //
+    // Runs of the changed pixels
+    //
+    for (unsigned y = top; y < bottom; y++) {
+        const uint32_t *prev = previousRow(y);
+        const uint32_t *cur = currentRow(y);
+
+        const size_t countIndex = data_.size();
+        data_.push_back(0);
+
+        unsigned x = left;
+        unsigned end = left; // of the last run
+        while (true) {
+            while (x < right && cur[x] == prev[x]) {
+                x++;
+            }
+            if (x == right) {
+                break;
+            }
+
+            unsigned runEnd = x + 1;
+            for (unsigned skip = 0; runEnd + skip < right;) {
+                if (cur[runEnd + skip] != prev[runEnd + skip]) {
+                    runEnd += skip + 1;
+                    skip = 0;
+                } else if (++skip == MIN_SKIP) {
+                    break;
+                }
+            }
+
+            data_.push_back(x - end);
+            data_.push_back(runEnd - x);
+            data_.insert(data_.end(), cur + x, cur + runEnd);
+            data_[countIndex]++;
+            x = end = runEnd;
+        }
+    }
+}
+
+void FrameCodec::decode(unsigned frame, Bitmap& dst) const {
+    assert(frame < numFrames_);
+    assert(dst.width() == width_ && dst.height() == height_);
+
+    const uint32_t *p = words_ + frameOffsets_[frame];
+    const unsigned left = p[0], top = p[1], bottom = p[3];
+    p += 4;
+
+    PixFmt& pixFmt = dst.pixFmt();
+    for (unsigned y = top; y < bottom; y++) {
+        auto row = reinterpret_cast<uint32_t *>(pixFmt.row_ptr(static_cast<int>(y)));
+        unsigned x = left;
+
+        for (uint32_t count = *p++; count > 0; count--) {
+            x += p[0];
+            const uint32_t len = p[1];
+            std::memcpy(row + x, p + 2, len * sizeof(uint32_t));
+            x += len;
+            p += 2 + len;
+        }
+    }
+}
+
+} // namespace litelockr
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gfx/Bitmap.h"
+
+namespace litelockr {
+
+//
+// Compressed frames of a strip. Every frame keeps only the pixels that differ from the previous frame, the first
+// one (the key frame) the pixels that differ from a transparent frame: the bounding box of the changes and, row
+// by row, the runs of the changed pixels with the lengths of the unchanged ones between them.
+//
+class FrameCodec {
+public:
+    FrameCodec() = default;
+    FrameCodec(const FrameCodec&) = delete; // words_ may point into data_
+    FrameCodec& operator=(const FrameCodec&) = delete;
+
+    // the strip is height * numFrames tall
+    bool encode(const Bitmap& strip, unsigned numFrames);
+
+    // uses the encoded words kept alive by the storage, e.g. a mapped file, the words are checked first
+    bool attach(unsigned width, unsigned height, unsigned numFrames, const uint32_t *words, size_t numWords,
+                std::shared_ptr<const void> storage);
+
+    // turns the previous frame in dst into the given one, dst is transparent before the first frame
+    void decode(unsigned frame, Bitmap& dst) const;
+
+    [[nodiscard]] const uint32_t *words() const { return words_; }
+    [[nodiscard]] size_t numWords() const { return numWords_; }
+
+    [[nodiscard]] unsigned width() const { return width_; }
+    [[nodiscard]] unsigned height() const { return height_; }
+    [[nodiscard]] unsigned size() const { return numFrames_; }
+
+    [[nodiscard]] size_t byteSize() const {
+        return numWords_ * sizeof(uint32_t) + frameOffsets_.size() * sizeof(size_t);
+    }
+
+private:
+    // the unchanged pixels shorter than this are stored along with the changed ones, a run takes two words
+    constexpr static unsigned MIN_SKIP = 3;
+
+    void encodeFrame(const Bitmap& strip, unsigned frame);
+    // the size of the frame in words, zero if it does not fit into the words left or into the frame
+    [[nodiscard]] size_t checkFrame(const uint32_t *p, size_t wordsLeft) const;
+
+    //
+    // By frame: left, top, right, bottom of the changes. Then by row of the box: the number of runs,
+    // and the runs, each one is the unchanged pixels to skip, the number of pixels and the pixels.
+    //
+    std::vector<uint32_t> data_;
+    std::vector<size_t> frameOffsets_;
+
+    // data_, or the attached words
+    const uint32_t *words_ = nullptr;
+    size_t numWords_ = 0;
+    std::shared_ptr<const void> storage_;
+
+    unsigned width_ = 0;
+    unsigned height_ = 0;
+    unsigned numFrames_ = 0;
+};
+
+} // namespace litelockr
+
+#endif // FRAME_CODEC_H
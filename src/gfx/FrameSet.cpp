@@ -19,13 +19,13 @@
 
 #include "FrameSet.h"
 
-#include "sys/BinaryResource.h"
+#include "log/Logger.h"
 #include "sys/Rectangle.h"
 
 namespace litelockr {
 
 bool FrameSet::isNull() const {
-    return bufferBitmap_.isNull();
+    return bufferBitmap_.isNull() && !codec_ && !stream_;
 }
 
 void FrameSet::recreate(unsigned width, unsigned height, unsigned numFrames) {
@@ -35,6 +35,9 @@ void FrameSet::recreate(unsigned width, unsigned height, unsigned numFrames) {
     currentFrame_ = 0;
     ready_ = false;
     finished_ = false;
+    codec_.reset();
+    decoded_.free();
+    stream_.reset();
     bufferBitmap_.create(width, height * numFrames);
     assert(!bufferBitmap_.isNull());
 }
@@ -43,21 +46,39 @@ void FrameSet::createFromBitmap(const Bitmap& buf, unsigned numFrames) {
     width_ = buf.width();
     height_ = buf.height() / numFrames;
     numFrames_ = numFrames;
+    codec_.reset();
+    decoded_.free();
+    stream_.reset();
     bufferBitmap_.clone(buf);
     begin();
 }
 
-bool FrameSet::loadPng(int resourceId, unsigned numFrames) {
+bool FrameSet::loadResource(int resourceId, unsigned numFrames) {
     Bitmap buf;
-    if (buf.loadPng(Bin::data(resourceId), Bin::size(resourceId))) {
+    if (buf.loadResource(resourceId)) {
+        assert(buf.height() % numFrames == 0);
         createFromBitmap(buf, numFrames);
         return true;
     }
     return false;
 }
 
+void FrameSet::createFromFrames(std::shared_ptr<const FrameCodec> frames) {
+    assert(frames);
+    width_ = frames->width();
+    height_ = frames->height();
+    numFrames_ = frames->size();
+    codec_ = std::move(frames);
+    decoded_.free();
+    decodedFrame_ = NO_FRAME;
+    stream_.reset();
+    bufferBitmap_.free();
+    begin();
+}
+
 bool FrameSet::addFrame(unsigned frame, const Bitmap& image) noexcept {
     assert(!image.isNull());
+    decompress();
     assert(!bufferBitmap_.isNull());
 
     if (frame < numFrames_) {
@@ -68,9 +89,33 @@ bool FrameSet::addFrame(unsigned frame, const Bitmap& image) noexcept {
     return false;
 }
 
+bool FrameSet::frameView(unsigned frame, Bitmap& view) const {
+    assert(!isNull());
+
+    if (frame < numFrames_) {
+        if (codec_) {
+            return view.clone(decodeFrame(frame)); // decoding the next frame copies the shared pixels
+        }
+        if (stream_) {
+            const Bitmap& streamed = stream_->frame(frame); // the workers write into it
+            view.create(width_, height_);
+            view.copyFrom(streamed, 0, 0);
+            return true;
+        }
+        return view.view(bufferBitmap_, frame * height_, height_);
+    }
+    return false;
+}
+
 void FrameSet::drawFrame(Bitmap& buffer, int x, int y) {
-    const int offset = static_cast<int>(currentFrame_ * height_);
-    buffer.copyFrom(bufferBitmap_, x, y, 0, offset, width_, height_);
+    if (codec_) {
+        buffer.copyFrom(decodeFrame(currentFrame_), x, y, 0, 0, width_, height_);
+    } else if (stream_) {
+        buffer.copyFrom(stream_->frame(currentFrame_), x, y, 0, 0, width_, height_);
+    } else {
+        const int offset = static_cast<int>(currentFrame_ * height_);
+        buffer.copyFrom(bufferBitmap_, x, y, 0, offset, width_, height_);
+    }
 
     if (isLastFrame()) {
         finished_ = true;
@@ -103,7 +148,20 @@ void FrameSet::clone(const FrameSet& another) {
     height_ = another.height_;
     numFrames_ = another.numFrames_;
     currentFrame_ = 0;
-    bufferBitmap_.clone(another.bufferBitmap_);
+    codec_ = another.codec_;
+    decoded_.free();
+    decodedFrame_ = NO_FRAME;
+    stream_.reset();
+    if (another.stream_) {
+        bufferBitmap_.create(width_, height_ * numFrames_);
+        for (unsigned i = 0; i < numFrames_; i++) {
+            bufferBitmap_.copyFrom(another.stream_->frame(i), 0, static_cast<int>(i * height_));
+        }
+    } else if (another.bufferBitmap_.isNull()) {
+        bufferBitmap_.free();
+    } else {
+        bufferBitmap_.clone(another.bufferBitmap_);
+    }
 }
 
 void FrameSet::createWithBackground(const Bitmap& frames, unsigned numFrames, const Bitmap& backgroundFrame) {
@@ -114,4 +172,108 @@ void FrameSet::createWithBackground(const Bitmap& frames, unsigned numFrames, co
     bufferBitmap_.blendFrom(frames, 0, 0);
 }
 
+Bitmap& FrameSet::bitmap() {
+    decompress();
+    return bufferBitmap_;
+}
+
+void FrameSet::stream(unsigned width, unsigned height, unsigned numFrames, FrameStream::RenderFrame renderFrame) {
+    width_ = width;
+    height_ = height;
+    numFrames_ = numFrames;
+    bufferBitmap_.free();
+    codec_.reset();
+    decoded_.free();
+    decodedFrame_ = NO_FRAME;
+    stream_.reset(); // waits for the workers of the previous frames
+    stream_ = std::make_unique<FrameStream>(width, height, numFrames, std::move(renderFrame));
+    begin();
+}
+
+void FrameSet::compress() {
+    if (codec_ || bufferBitmap_.isNull()) {
+        return;
+    }
+
+    auto codec = std::make_shared<FrameCodec>();
+    if (!codec->encode(bufferBitmap_, numFrames_)) {
+        return;
+    }
+
+    // the frames that change all over are kept as they are
+    const size_t compressedBytes = codec->byteSize() + static_cast<size_t>(width_) * height_ * 4;
+    LOG_VERBOSE(L"[FrameSet] %ux%u, %u frames: %zu KB, compressed %zu KB",
+                width_, height_, numFrames_, rawBytes() / 1024, compressedBytes / 1024);
+    if (compressedBytes >= rawBytes()) {
+        return;
+    }
+
+    codec_ = std::move(codec);
+    bufferBitmap_.free();
+    decoded_.free();
+    decodedFrame_ = NO_FRAME;
+}
+
+std::shared_ptr<const FrameCodec> FrameSet::encodedFrames() const {
+    if (codec_ || bufferBitmap_.isNull()) {
+        return codec_;
+    }
+
+    auto codec = std::make_shared<FrameCodec>();
+    if (!codec->encode(bufferBitmap_, numFrames_)) {
+        return nullptr;
+    }
+    return codec;
+}
+
+void FrameSet::decompress() {
+    if (!codec_ && !stream_) {
+        return;
+    }
+
+    Bitmap strip;
+    strip.create(width_, height_ * numFrames_);
+    for (unsigned i = 0; i < numFrames_; i++) {
+        strip.copyFrom(codec_ ? decodeFrame(i) : stream_->frame(i), 0, static_cast<int>(i * height_));
+    }
+
+    codec_.reset();
+    stream_.reset();
+    decoded_.free();
+    decodedFrame_ = NO_FRAME;
+    bufferBitmap_.clone(strip);
+}
+
+const Bitmap& FrameSet::decodeFrame(unsigned frame) const {
+    assert(codec_ && frame < numFrames_);
+
+    unsigned next = decodedFrame_ + 1;
+    if (decoded_.isNull() || decodedFrame_ == NO_FRAME || frame < decodedFrame_) {
+        if (decoded_.isNull()) {
+            decoded_.create(width_, height_);
+        }
+        decoded_.clear({0, 0, 0, 0});
+        next = 0;
+    }
+
+    // the deltas up to the frame, playing forward decodes just one
+    for (unsigned i = next; i <= frame; i++) {
+        codec_->decode(i, decoded_);
+    }
+    decodedFrame_ = frame;
+    return decoded_;
+}
+
+size_t FrameSet::residentBytes() const {
+    auto bitmapBytes = [](const Bitmap& bitmap) {
+        return static_cast<size_t>(bitmap.width()) * bitmap.height() * 4;
+    };
+    return (codec_ ? codec_->byteSize() : 0) + (stream_ ? stream_->byteSize() : 0) +
+           bitmapBytes(bufferBitmap_) + bitmapBytes(decoded_);
+}
+
+size_t FrameSet::rawBytes() const {
+    return static_cast<size_t>(width_) * height_ * numFrames_ * 4;
+}
+
 } // namespace litelockr
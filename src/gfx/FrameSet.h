@@ -20,7 +20,11 @@
 #ifndef FRAME_SET_H
 #define FRAME_SET_H
 
+#include <memory>
+
 #include "gfx/Bitmap.h"
+#include "gfx/FrameCodec.h"
+#include "gfx/FrameStream.h"
 
 namespace litelockr {
 
@@ -34,9 +38,26 @@ public:
     bool isNull() const;
     void recreate(unsigned width, unsigned height, unsigned numFrames);
     void createFromBitmap(const Bitmap& buf, unsigned numFrames);
-    bool loadPng(int resourceId, unsigned numFrames);
+    bool loadResource(int resourceId, unsigned numFrames);
+    // the frames are decoded as they are drawn, see compress()
+    void createFromFrames(std::shared_ptr<const FrameCodec> frames);
     bool addFrame(unsigned frame, const Bitmap& image) noexcept;
+    // shares the pixels of the frame with the view
+    bool frameView(unsigned frame, Bitmap& view) const;
     void drawFrame(Bitmap& buffer, int x, int y);
+
+    // the frames are rendered ahead on the worker threads while they are played, instead of the strip
+    void stream(unsigned width, unsigned height, unsigned numFrames, FrameStream::RenderFrame renderFrame);
+
+    // encodes the frames and frees the strip, drawFrame() decodes them one by one
+    void compress();
+    [[nodiscard]] bool isCompressed() const { return codec_ != nullptr; }
+    // the compressed frames, the strip is encoded if compress() has kept it; null for the streamed frames
+    [[nodiscard]] std::shared_ptr<const FrameCodec> encodedFrames() const;
+    // the bytes the frames take in memory, and the bytes of the uncompressed strip
+    [[nodiscard]] size_t residentBytes() const;
+    [[nodiscard]] size_t rawBytes() const;
+
     void begin();
     void end();
     void nextFrame();
@@ -50,13 +71,28 @@ public:
     [[nodiscard]] unsigned height() const { return height_; }
     [[nodiscard]] unsigned size() const { return numFrames_; };
 
-    Bitmap& bitmap() { return bufferBitmap_; }
+    // the strip, the compressed or streamed frames are copied into it first
+    Bitmap& bitmap();
 
     void createWithBackground(const Bitmap& frames, unsigned numFrames, const Bitmap& backgroundFrame);
 
 private:
+    void decompress();
+    const Bitmap& decodeFrame(unsigned frame) const;
+
     Bitmap bufferBitmap_;
 
+    //
+    // The compressed frames are shared by the clones, decoded_ holds the last decoded one
+    //
+    constexpr static unsigned NO_FRAME = ~0u;
+
+    std::shared_ptr<const FrameCodec> codec_;
+    mutable Bitmap decoded_;
+    mutable unsigned decodedFrame_ = NO_FRAME;
+
+    std::unique_ptr<FrameStream> stream_;
+
     unsigned width_ = 0;
     unsigned height_ = 0;
     unsigned numFrames_ = 0;
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameStream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <omp.h>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+FrameStream::FrameStream(unsigned width, unsigned height, unsigned numFrames, RenderFrame renderFrame,
+                         unsigned lookAhead)
+        : width_(width),
+          height_(height),
+          numFrames_(numFrames),
+          lookAhead_(std::max(lookAhead, 1u)),
+          renderFrame_(std::move(renderFrame)),
+          slots_(lookAhead_ + 1) {
+    assert(numFrames > 0);
+    for (auto& s: slots_) {
+        s.bitmap.create(width, height);
+    }
+
+    // one worker on a single core, the frames are rendered in bands then
+    const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    numWorkers_ = std::clamp(cores - 1, 1u, std::min(lookAhead_, numFrames));
+    startWorkers();
+}
+
+FrameStream::~FrameStream() {
+    {
+        std::lock_guard lock(mtx_);
+        stopping_ = true;
+    }
+    condVar_.notify_all();
+    for (auto& w: workers_) {
+        w.join();
+    }
+
+    LOG_VERBOSE(L"[FrameStream] %ux%u, %u frames: waited for %u of them", width_, height_, numFrames_, waits_);
+}
+
+void FrameStream::startWorkers() {
+    for (auto& w: workers_) {
+        w.join(); // they have left the loop
+    }
+    workers_.clear();
+
+    activeWorkers_ = numWorkers_;
+    for (unsigned i = 0; i < numWorkers_; i++) {
+        workers_.emplace_back(&FrameStream::work, this);
+    }
+}
+
+void FrameStream::work() {
+    // the workers share the cores, so a frame is one band unless there is a single worker
+    if (numWorkers_ > 1) {
+        omp_set_num_threads(1);
+    }
+
+    std::unique_lock lock(mtx_);
+    while (!stopping_) {
+        // skips the frames left in their slots, e.g. after the playing has started over
+        while (next_ < numFrames_ && slot(next_).frame == next_ && slot(next_).ready) {
+            next_++;
+        }
+        if (next_ >= numFrames_) {
+            break; // every frame is rendered, or being rendered by another worker
+        }
+        if (next_ > current_ + lookAhead_ || slot(next_).rendering) {
+            condVar_.wait(lock);
+            continue;
+        }
+
+        const unsigned index = next_++;
+        Slot& s = slot(index);
+        s.frame = index;
+        s.ready = false;
+        s.rendering = true;
+
+        lock.unlock();
+        s.bitmap.clear({0, 0, 0, 0});
+        renderFrame_(s.bitmap, index);
+        lock.lock();
+
+        s.rendering = false;
+        s.ready = s.frame == index;
+        condVar_.notify_all();
+    }
+    activeWorkers_--;
+}
+
+const Bitmap& FrameStream::frame(unsigned index) {
+    assert(index < numFrames_);
+
+    std::unique_lock lock(mtx_);
+    if (index < current_ || index > next_) {
+        next_ = index; // seeking
+    }
+    current_ = index;
+    if (activeWorkers_ == 0 && next_ < numFrames_) {
+        startWorkers(); // playing again
+    }
+    condVar_.notify_all();
+
+    Slot& s = slot(index);
+    if (!(s.frame == index && s.ready)) {
+        waits_++;
+        condVar_.wait(lock, [&s, index] { return s.frame == index && s.ready; });
+    }
+
+    if (!firstFrameShown_) {
+        firstFrameShown_ = true;
+        LOG_VERBOSE(L"[FrameStream] The first frame after %.2f ms",
+                    std::chrono::duration<double, std::milli>(AppClock::now() - startTime_).count());
+    }
+    return s.bitmap;
+}
+
+size_t FrameStream::byteSize() const {
+    return slots_.size() * width_ * height_ * 4;
+}
+
+} // namespace litelockr
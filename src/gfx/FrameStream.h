@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gfx/Bitmap.h"
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+//
+// Frames rendered on worker threads while they are played. The workers keep up to lookAhead frames after the
+// current one, so the first frame is shown as soon as it is rendered instead of after the whole set.
+//
+class FrameStream {
+public:
+    // renders the frame into a cleared bitmap, it is called on the workers concurrently
+    using RenderFrame = std::function<void(Bitmap& frame, unsigned index)>;
+
+    constexpr static unsigned LOOK_AHEAD = 4;
+
+    FrameStream(unsigned width, unsigned height, unsigned numFrames, RenderFrame renderFrame,
+                unsigned lookAhead = LOOK_AHEAD);
+    ~FrameStream();
+
+    FrameStream(const FrameStream&) = delete;
+    FrameStream& operator=(const FrameStream&) = delete;
+
+    // waits until the frame is rendered, the frames before it are dropped
+    const Bitmap& frame(unsigned index);
+
+    [[nodiscard]] size_t byteSize() const;
+
+private:
+    struct Slot {
+        Bitmap bitmap;
+        unsigned frame = NO_FRAME;
+        bool ready = false;
+        bool rendering = false;
+    };
+
+    constexpr static unsigned NO_FRAME = ~0u;
+
+    void startWorkers();
+    void work();
+    Slot& slot(unsigned index) { return slots_[index % slots_.size()]; }
+
+    const unsigned width_;
+    const unsigned height_;
+    const unsigned numFrames_;
+    const unsigned lookAhead_;
+    const RenderFrame renderFrame_;
+
+    std::mutex mtx_;
+    std::condition_variable condVar_;
+    std::vector<Slot> slots_; // lookAhead + 1, the frame by index % size
+    unsigned current_ = 0;    // the frame played
+    unsigned next_ = 0;       // the next frame to render
+    bool stopping_ = false;
+
+    // time to the first frame and the frames the playing waited for
+    AppClock::TimePoint startTime_ = AppClock::now();
+    bool firstFrameShown_ = false;
+    unsigned waits_ = 0;
+
+    unsigned numWorkers_ = 0;
+    unsigned activeWorkers_ = 0; // the workers leave when there are no frames left to render
+    std::vector<std::thread> workers_;
+};
+
+} // namespace litelockr
+
+#endif // FRAME_STREAM_H
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <omp.h>
+
+#include "log/Logger.h"
+#include "sys/AppClock.h"
+#include "sys/BinaryResource.h"
+
+namespace litelockr {
+
+void ImageLoader::add(Bitmap& bitmap, int resourceId) {
+    jobs_.push_back({.resourceId = resourceId, .size = Bin::size(resourceId), .bitmap = &bitmap});
+}
+
+void ImageLoader::add(FrameSet& frames, int resourceId, unsigned numFrames) {
+    jobs_.push_back({.resourceId = resourceId, .size = Bin::size(resourceId), .frames = &frames,
+                     .numFrames = numFrames});
+}
+
+bool ImageLoader::load() {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::stable_sort(jobs_.begin(), jobs_.end(), [](const Job& a, const Job& b) {
+        return a.size > b.size;
+    });
+
+    const auto started = AppClock::now();
+    const auto numJobs = static_cast<int>(jobs_.size());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numJobs; i++) {
+        auto& job = jobs_[i];
+        const auto jobStarted = AppClock::now();
+
+        job.loaded = job.frames ? job.frames->loadResource(job.resourceId, job.numFrames)
+                                : job.bitmap->loadResource(job.resourceId);
+
+        job.elapsedMs = Milliseconds(AppClock::now() - jobStarted).count();
+    }
+
+    const double elapsedMs = Milliseconds(AppClock::now() - started).count();
+
+    bool result = true;
+    double totalMs = 0;
+    for (const auto& job: jobs_) {
+        totalMs += job.elapsedMs;
+        result = result && job.loaded;
+
+        const Bitmap& bitmap = job.frames ? job.frames->bitmap() : *job.bitmap;
+        LOG_DEBUG(L"[ImageLoader] 0x%04x: %ux%u from %lu bytes in %.2f ms%s", job.resourceId,
+                  bitmap.width(), bitmap.height(), job.size, job.elapsedMs, job.loaded ? L"" : L" (failed)");
+    }
+    LOG_DEBUG(L"[ImageLoader] %d images in %.2f ms (%.2f ms decoding on %d threads)",
+              numJobs, elapsedMs, totalMs, omp_get_max_threads());
+
+    jobs_.clear();
+    return result;
+}
+
+} // namespace litelockr
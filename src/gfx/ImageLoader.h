@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <vector>
+
+#include "gfx/Bitmap.h"
+#include "gfx/FrameSet.h"
+
+namespace litelockr {
+
+//
+// Loads a batch of image resources (baked or PNG) in parallel, each straight into its own bitmap.
+// The largest resources start first, the time of each one is logged.
+//
+class ImageLoader {
+public:
+    void add(Bitmap& bitmap, int resourceId);
+    void add(FrameSet& frames, int resourceId, unsigned numFrames);
+
+    // returns false if any of the resources could not be loaded
+    bool load();
+
+private:
+    struct Job {
+        int resourceId = 0;
+        unsigned long size = 0; // the compressed size
+        Bitmap *bitmap = nullptr;
+        FrameSet *frames = nullptr;
+        unsigned numFrames = 0;
+        double elapsedMs = 0;
+        bool loaded = false;
+    };
+
+    std::vector<Job> jobs_;
+};
+
+} // namespace litelockr
+
+#endif // IMAGE_LOADER_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace litelockr {
+
+namespace {
+
+// the length continues in the following bytes while they are 255
+bool readLength(const uint8_t *& ip, const uint8_t *ipEnd, size_t& length) {
+    uint8_t b;
+    do {
+        if (ip == ipEnd) {
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+//
+// The decompressed bytes in the rows one after another. The matches refer to the earlier bytes by their
+// position in the output, the position is mapped to its row when the match starts in another row.
+//
+class RowOutput {
+public:
+    RowOutput(uint8_t *firstRow, ptrdiff_t stride, size_t rowBytes, size_t numRows)
+            : firstRow_(firstRow), stride_(stride), rowBytes_(rowBytes), size_(rowBytes * numRows),
+              row_(firstRow) {}
+
+    [[nodiscard]] size_t written() const { return pos_; }
+
+    [[nodiscard]] size_t left() const { return size_ - pos_; }
+
+    void copy(const uint8_t *src, size_t length) {
+        while (length > 0) {
+            const size_t n = std::min(length, rowBytes_ - x_);
+            std::memcpy(row_ + x_, src, n);
+            src += n;
+            length -= n;
+            advance(n);
+        }
+    }
+
+    // the match overlaps the output if offset < length, e.g. a repeated pixel; the bytes repeated so far
+    // are a run of the same period, so the copies grow with it
+    void repeat(size_t offset, size_t length) {
+        size_t period = offset;
+        size_t copied = 0;
+        while (length > 0) {
+            const size_t pos = pos_ - period;
+            const size_t matchX = pos % rowBytes_;
+            const uint8_t *match = period <= x_ ? row_ + x_ - period // in the same row
+                                                : firstRow_ + static_cast<ptrdiff_t>(pos / rowBytes_) * stride_
+                                                  + static_cast<ptrdiff_t>(matchX);
+            const size_t n = std::min({length, period, rowBytes_ - x_, rowBytes_ - matchX});
+            std::memcpy(row_ + x_, match, n);
+            length -= n;
+            copied += n;
+            advance(n);
+            period = (copied + offset) / offset * offset;
+        }
+    }
+
+private:
+    void advance(size_t n) {
+        x_ += n;
+        pos_ += n;
+        if (x_ == rowBytes_ && pos_ < size_) {
+            x_ = 0;
+            row_ += stride_;
+        }
+    }
+
+    uint8_t *const firstRow_;
+    const ptrdiff_t stride_;
+    const size_t rowBytes_;
+    const size_t size_;
+    uint8_t *row_;
+    size_t x_ = 0;   // in the current row
+    size_t pos_ = 0; // in the whole output
+};
+
+} // namespace
+
+bool Lz4::decompress(const uint8_t *src, size_t srcSize, uint8_t *firstRow, ptrdiff_t stride, size_t rowBytes,
+                     size_t numRows) {
+    constexpr unsigned MIN_MATCH = 4;
+
+    if (rowBytes == 0 || numRows == 0) {
+        return srcSize == 0;
+    }
+
+    const uint8_t *ip = src;
+    const uint8_t *const ipEnd = src + srcSize;
+    RowOutput out(firstRow, stride, rowBytes, numRows);
+
+    while (ip < ipEnd) {
+        const unsigned token = *ip++;
+
+        size_t length = token >> 4;
+        if (length == 15 && !readLength(ip, ipEnd, length)) {
+            return false;
+        }
+        if (length > static_cast<size_t>(ipEnd - ip) || length > out.left()) {
+            return false;
+        }
+        out.copy(ip, length);
+        ip += length;
+
+        if (ip == ipEnd) {
+            break; // the last sequence has the literals only
+        }
+
+        if (ipEnd - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > out.written()) {
+            return false;
+        }
+
+        length = token & 15;
+        if (length == 15 && !readLength(ip, ipEnd, length)) {
+            return false;
+        }
+        length += MIN_MATCH;
+        if (length > out.left()) {
+            return false;
+        }
+        out.repeat(offset, length);
+    }
+    return out.left() == 0;
+}
+
+bool Lz4::decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize) {
+    return decompress(src, srcSize, dst, static_cast<ptrdiff_t>(dstSize), dstSize, 1);
+}
+
+} // namespace litelockr
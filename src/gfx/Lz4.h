@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace litelockr {
+
+//
+// Decompresses the LZ4 block format, e.g. the images tools/bake_images.py bakes
+//
+class Lz4 {
+public:
+    // false if the data is malformed or does not fill dst exactly
+    static bool decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+
+    // the output goes into numRows rows of rowBytes, each one stride bytes after the previous one,
+    // e.g. the rows of a bottom-up bitmap from the last one with a negative stride
+    static bool decompress(const uint8_t *src, size_t srcSize, uint8_t *firstRow, ptrdiff_t stride,
+                           size_t rowBytes, size_t numRows);
+};
+
+} // namespace litelockr
+
+#endif // LZ4_H
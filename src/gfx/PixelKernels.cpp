@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PixelKernels.h"
+
+#ifdef PIXEL_KERNELS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include "gfx/Color.h"
+#include "log/Logger.h"
+
+namespace litelockr {
+
+namespace {
+
+using Blender = agg::blender_rgba_pre<agg::rgba8, agg::order_bgra>;
+
+void fillRowScalar(uint8_t *dst, unsigned width, uint32_t pixel) {
+    auto p = reinterpret_cast<uint32_t *>(dst);
+    for (unsigned i = 0; i < width; i++) {
+        p[i] = pixel;
+    }
+}
+
+#ifdef PIXEL_KERNELS_X86
+bool cpuSupportsAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    __cpuid(info, 1);
+    constexpr int OSXSAVE = 1 << 27;
+    constexpr int AVX = 1 << 28;
+    if ((info[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX)) {
+        return false;
+    }
+    // the OS saves the YMM registers
+    if ((_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    constexpr int AVX2 = 1 << 5;
+    return (info[1] & AVX2) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+const PixelKernelTable& selectKernels() {
+#ifdef PIXEL_KERNELS_X86
+    const PixelKernelTable& table = cpuSupportsAvx2() ? AVX2_PIXEL_KERNELS : SSE2_PIXEL_KERNELS;
+#else
+    const PixelKernelTable& table = SCALAR_PIXEL_KERNELS;
+#endif
+    LOG_DEBUG(L"[PixelKernels] Using %s kernels", table.name);
+    return table;
+}
+
+} // namespace
+
+const PixelKernelTable SCALAR_PIXEL_KERNELS = {
+        PixelKernels::blendPixels,
+        fillRowScalar,
+        PixelKernels::blendFillPixels,
+        PixelKernels::sampleBilinearPixels,
+        L"scalar",
+};
+
+const PixelKernelTable& PixelKernels::instance() {
+    static const PixelKernelTable& table = selectKernels();
+    return table;
+}
+
+std::vector<const PixelKernelTable *> PixelKernels::supported() {
+    std::vector<const PixelKernelTable *> tables{&SCALAR_PIXEL_KERNELS};
+#ifdef PIXEL_KERNELS_X86
+    tables.push_back(&SSE2_PIXEL_KERNELS);
+    if (cpuSupportsAvx2()) {
+        tables.push_back(&AVX2_PIXEL_KERNELS);
+    }
+#endif
+    return tables;
+}
+
+void PixelKernels::blendPixels(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover) {
+    for (unsigned i = 0; i < width; i++, dst += 4, src += 4) {
+        uint8_t alpha = src[ColorA];
+        if (alpha == 0) {
+            continue;
+        }
+        if (alpha == 255 && cover == 255) {
+            *reinterpret_cast<uint32_t *>(dst) = *reinterpret_cast<const uint32_t *>(src);
+        } else {
+            Blender::blend_pix(dst, src[ColorR], src[ColorG], src[ColorB], alpha, cover);
+        }
+    }
+}
+
+void PixelKernels::blendFillPixels(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover) {
+    auto src = reinterpret_cast<const uint8_t *>(&pixel);
+    uint8_t alpha = src[ColorA];
+    if (alpha == 0) {
+        return;
+    }
+    if (alpha == 255 && cover == 255) {
+        fillRowScalar(dst, width, pixel);
+        return;
+    }
+    for (unsigned i = 0; i < width; i++, dst += 4) {
+        Blender::blend_pix(dst, src[ColorR], src[ColorG], src[ColorB], alpha, cover);
+    }
+}
+
+void PixelKernels::sampleBilinearPixels(uint8_t *dst, const BilinearSample *samples, unsigned width,
+                                        uint8_t alpha) {
+    for (unsigned i = 0; i < width; i++, dst += 4) {
+        const auto& s = samples[i];
+        const unsigned w00 = (256 - s.fx) * (256 - s.fy);
+        const unsigned w01 = s.fx * (256 - s.fy);
+        const unsigned w10 = (256 - s.fx) * s.fy;
+        const unsigned w11 = s.fx * s.fy;
+
+        unsigned c[4];
+        for (int k = 0; k < 4; k++) {
+            unsigned v = (w00 * s.row0[k] + w01 * s.row0[s.next + k] +
+                          w10 * s.row1[k] + w11 * s.row1[s.next + k] + 32768) >> 16;
+            c[k] = v * alpha >> 8;
+        }
+        dst[0] = static_cast<uint8_t>(c[ColorR]);
+        dst[1] = static_cast<uint8_t>(c[ColorG]);
+        dst[2] = static_cast<uint8_t>(c[ColorB]);
+        dst[3] = static_cast<uint8_t>(c[ColorA]);
+    }
+}
+
+} // namespace litelockr
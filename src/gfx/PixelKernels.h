@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define PIXEL_KERNELS_X86
+#endif
+
+namespace litelockr {
+
+//
+// One pixel of the bilinear filter, the four taps are clamped to the image
+//
+struct BilinearSample {
+    const uint8_t *row0; // the pixel (x, y)
+    const uint8_t *row1; // the pixel (x, y + 1)
+    uint32_t next;       // the offset of the pixel x + 1 in bytes, zero at the image edges
+    uint16_t fx;         // the subpixel position, 0..255
+    uint16_t fy;
+};
+
+//
+// Premultiplied BGRA row kernels. The blending matches agg::blender_rgba_pre (premultiplied source-over).
+// The sampling matches agg::span_image_filter_rgba_bilinear followed by SpanConvAlpha, its output is
+// agg::rgba8 (RGBA order).
+//
+struct PixelKernelTable {
+    void (*blendRow)(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover);
+    void (*fillRow)(uint8_t *dst, unsigned width, uint32_t pixel);
+    void (*blendFillRow)(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover);
+    void (*sampleBilinearRow)(uint8_t *dst, const BilinearSample *samples, unsigned width, uint8_t alpha);
+    const wchar_t *name;
+};
+
+extern const PixelKernelTable SCALAR_PIXEL_KERNELS;
+#ifdef PIXEL_KERNELS_X86
+extern const PixelKernelTable SSE2_PIXEL_KERNELS;
+extern const PixelKernelTable AVX2_PIXEL_KERNELS;
+#endif
+
+class PixelKernels {
+public:
+    // the fastest kernels supported by the CPU, selected on the first use
+    static const PixelKernelTable& instance();
+    // every table the CPU can run, the scalar one first and the selected one last
+    static std::vector<const PixelKernelTable *> supported();
+
+    static void blendRow(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover) {
+        instance().blendRow(dst, src, width, cover);
+    }
+
+    static void fillRow(uint8_t *dst, unsigned width, uint32_t pixel) {
+        instance().fillRow(dst, width, pixel);
+    }
+
+    static void blendFillRow(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover) {
+        instance().blendFillRow(dst, width, pixel, cover);
+    }
+
+    static void sampleBilinearRow(uint8_t *dst, const BilinearSample *samples, unsigned width, uint8_t alpha) {
+        instance().sampleBilinearRow(dst, samples, width, alpha);
+    }
+
+    //
+    // Scalar versions, used for the row tails by the SIMD kernels
+    //
+    static void blendPixels(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover);
+    static void blendFillPixels(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover);
+    static void sampleBilinearPixels(uint8_t *dst, const BilinearSample *samples, unsigned width, uint8_t alpha);
+};
+
+} // namespace litelockr
+
+#endif // PIXEL_KERNELS_H
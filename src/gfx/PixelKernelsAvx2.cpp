@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PixelKernels.h"
+
+#ifdef PIXEL_KERNELS_X86
+
+#include <immintrin.h>
+
+#include "gfx/Color.h"
+
+namespace litelockr {
+
+namespace {
+
+//
+// The helpers work on 16-bit lanes holding four BGRA pixels, two in every 128-bit lane
+//
+
+// agg::rgba8::multiply
+inline __m256i multiply(__m256i a, __m256i b) {
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(a, b), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_srli_epi16(t, 8), t), 8);
+}
+
+inline __m256i broadcastAlpha(__m256i v) {
+    static_assert(ColorA == 3);
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// agg::blender_rgba_pre::blend_pix: d + s - d * sa, truncated to 8 bits as AGG does
+inline __m256i blend4(__m256i d, __m256i s) {
+    __m256i res = _mm256_sub_epi16(_mm256_add_epi16(d, s), multiply(d, broadcastAlpha(s)));
+    return _mm256_and_si256(res, _mm256_set1_epi16(0xFF));
+}
+
+inline __m256i blend8(__m256i dst, __m256i src, __m256i cover, bool fullCover) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i sLo = _mm256_unpacklo_epi8(src, zero);
+    __m256i sHi = _mm256_unpackhi_epi8(src, zero);
+
+    // the pixels with zero alpha are left untouched
+    __m256i keep = _mm256_packs_epi16(_mm256_cmpeq_epi16(broadcastAlpha(sLo), zero),
+                                      _mm256_cmpeq_epi16(broadcastAlpha(sHi), zero));
+    if (!fullCover) {
+        sLo = multiply(sLo, cover);
+        sHi = multiply(sHi, cover);
+    }
+
+    __m256i resLo = blend4(_mm256_unpacklo_epi8(dst, zero), sLo);
+    __m256i resHi = blend4(_mm256_unpackhi_epi8(dst, zero), sHi);
+    __m256i res = _mm256_packus_epi16(resLo, resHi);
+    return _mm256_or_si256(_mm256_andnot_si256(keep, res), _mm256_and_si256(keep, dst));
+}
+
+constexpr int ALPHA_BYTES = static_cast<int>(0x88888888);
+
+void blendRow(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(-1);
+    const __m256i coverVec = _mm256_set1_epi16(cover);
+    const bool fullCover = cover == 255;
+
+    unsigned i = 0;
+    for (; i + 8 <= width; i += 8, dst += 32, src += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+
+        if ((_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, zero)) & ALPHA_BYTES) == ALPHA_BYTES) {
+            continue; // transparent
+        }
+        if (fullCover && (_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, ones)) & ALPHA_BYTES) == ALPHA_BYTES) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), s); // opaque
+            continue;
+        }
+
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), blend8(d, s, coverVec, fullCover));
+    }
+    PixelKernels::blendPixels(dst, src, width - i, cover);
+}
+
+void fillRow(uint8_t *dst, unsigned width, uint32_t pixel) {
+    const __m256i p = _mm256_set1_epi32(static_cast<int>(pixel));
+
+    unsigned i = 0;
+    for (; i + 8 <= width; i += 8, dst += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), p);
+    }
+    for (; i < width; i++, dst += 4) {
+        *reinterpret_cast<uint32_t *>(dst) = pixel;
+    }
+}
+
+void blendFillRow(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover) {
+    auto alpha = reinterpret_cast<const uint8_t *>(&pixel)[ColorA];
+    if (alpha == 0) {
+        return;
+    }
+    if (alpha == 255 && cover == 255) {
+        fillRow(dst, width, pixel);
+        return;
+    }
+
+    const __m256i s = _mm256_set1_epi32(static_cast<int>(pixel));
+    const __m256i coverVec = _mm256_set1_epi16(cover);
+    const bool fullCover = cover == 255;
+
+    unsigned i = 0;
+    for (; i + 8 <= width; i += 8, dst += 32) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), blend8(d, s, coverVec, fullCover));
+    }
+    PixelKernels::blendFillPixels(dst, width - i, pixel, cover);
+}
+
+//
+// Bilinear sampling, one pixel in every 128-bit lane. The filter is separable in exact integers as in the SSE2
+// kernel: the horizontal pass fits 16 bits, the vertical one is done in 32 bits.
+//
+inline __m128i loadTaps(const uint8_t *p, uint32_t next) {
+    __m128i a = _mm_cvtsi32_si128(*reinterpret_cast<const int *>(p));
+    __m128i b = _mm_cvtsi32_si128(*reinterpret_cast<const int *>(p + next));
+    return _mm_unpacklo_epi32(a, b);
+}
+
+inline __m128i weights(uint16_t f) {
+    return _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<short>(256 - f)), _mm_set1_epi16(static_cast<short>(f)));
+}
+
+inline __m256i combine(__m128i lo, __m128i hi) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// the filtered pixels in the 32-bit lanes, B G R A
+inline __m256i filter2(const BilinearSample& a, const BilinearSample& b) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i wx = combine(weights(a.fx), weights(b.fx));
+    const __m256i wy = combine(weights(a.fy), weights(b.fy));
+
+    __m256i top = _mm256_unpacklo_epi8(combine(loadTaps(a.row0, a.next), loadTaps(b.row0, b.next)), zero);
+    __m256i bottom = _mm256_unpacklo_epi8(combine(loadTaps(a.row1, a.next), loadTaps(b.row1, b.next)), zero);
+    top = _mm256_mullo_epi16(top, wx);
+    bottom = _mm256_mullo_epi16(bottom, wx);
+    top = _mm256_add_epi16(top, _mm256_srli_si256(top, 8));
+    bottom = _mm256_add_epi16(bottom, _mm256_srli_si256(bottom, 8));
+
+    __m256i v = _mm256_unpacklo_epi64(top, bottom);
+    __m256i lo = _mm256_mullo_epi16(v, wy);
+    __m256i hi = _mm256_mulhi_epu16(v, wy);
+    __m256i sum = _mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), _mm256_unpackhi_epi16(lo, hi));
+    return _mm256_srli_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(32768)), 16);
+}
+
+void sampleBilinearRow(uint8_t *dst, const BilinearSample *samples, unsigned width, uint8_t alpha) {
+    static_assert(ColorB == 0 && ColorG == 1 && ColorR == 2 && ColorA == 3);
+    const __m256i alphaVec = _mm256_set1_epi16(alpha);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    unsigned i = 0;
+    for (; i + 4 <= width; i += 4, dst += 16) {
+        // the pixels 0 and 2 in the low lane, 1 and 3 in the high one
+        __m256i c = _mm256_packs_epi32(filter2(samples[i], samples[i + 1]), filter2(samples[i + 2], samples[i + 3]));
+        c = _mm256_srli_epi16(_mm256_mullo_epi16(c, alphaVec), 8);
+        // BGRA to RGBA
+        c = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+        c = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(c, c), order);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(c));
+    }
+    PixelKernels::sampleBilinearPixels(dst, samples + i, width - i, alpha);
+}
+
+} // namespace
+
+const PixelKernelTable AVX2_PIXEL_KERNELS = {
+        blendRow,
+        fillRow,
+        blendFillRow,
+        sampleBilinearRow,
+        L"AVX2",
+};
+
+} // namespace litelockr
+
+#endif // PIXEL_KERNELS_X86
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PixelKernels.h"
+
+#ifdef PIXEL_KERNELS_X86
+
+#include <emmintrin.h>
+
+#include "gfx/Color.h"
+
+namespace litelockr {
+
+namespace {
+
+//
+// The helpers work on 16-bit lanes holding two BGRA pixels: B G R A B G R A
+//
+
+// agg::rgba8::multiply
+inline __m128i multiply(__m128i a, __m128i b) {
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(t, 8), t), 8);
+}
+
+inline __m128i broadcastAlpha(__m128i v) {
+    static_assert(ColorA == 3);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// agg::blender_rgba_pre::blend_pix: d + s - d * sa, truncated to 8 bits as AGG does
+inline __m128i blend2(__m128i d, __m128i s) {
+    __m128i res = _mm_sub_epi16(_mm_add_epi16(d, s), multiply(d, broadcastAlpha(s)));
+    return _mm_and_si128(res, _mm_set1_epi16(0xFF));
+}
+
+inline __m128i blend4(__m128i dst, __m128i src, __m128i cover, bool fullCover) {
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i sLo = _mm_unpacklo_epi8(src, zero);
+    __m128i sHi = _mm_unpackhi_epi8(src, zero);
+
+    // the pixels with zero alpha are left untouched
+    __m128i keep = _mm_packs_epi16(_mm_cmpeq_epi16(broadcastAlpha(sLo), zero),
+                                   _mm_cmpeq_epi16(broadcastAlpha(sHi), zero));
+    if (!fullCover) {
+        sLo = multiply(sLo, cover);
+        sHi = multiply(sHi, cover);
+    }
+
+    __m128i resLo = blend2(_mm_unpacklo_epi8(dst, zero), sLo);
+    __m128i resHi = blend2(_mm_unpackhi_epi8(dst, zero), sHi);
+    __m128i res = _mm_packus_epi16(resLo, resHi);
+    return _mm_or_si128(_mm_andnot_si128(keep, res), _mm_and_si128(keep, dst));
+}
+
+constexpr int ALPHA_BYTES = 0x8888;
+
+void blendRow(uint8_t *dst, const uint8_t *src, unsigned width, uint8_t cover) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8(-1);
+    const __m128i coverVec = _mm_set1_epi16(cover);
+    const bool fullCover = cover == 255;
+
+    unsigned i = 0;
+    for (; i + 4 <= width; i += 4, dst += 16, src += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+        if ((_mm_movemask_epi8(_mm_cmpeq_epi8(s, zero)) & ALPHA_BYTES) == ALPHA_BYTES) {
+            continue; // transparent
+        }
+        if (fullCover && (_mm_movemask_epi8(_mm_cmpeq_epi8(s, ones)) & ALPHA_BYTES) == ALPHA_BYTES) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), s); // opaque
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), blend4(d, s, coverVec, fullCover));
+    }
+    PixelKernels::blendPixels(dst, src, width - i, cover);
+}
+
+void fillRow(uint8_t *dst, unsigned width, uint32_t pixel) {
+    const __m128i p = _mm_set1_epi32(static_cast<int>(pixel));
+
+    unsigned i = 0;
+    for (; i + 4 <= width; i += 4, dst += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), p);
+    }
+    for (; i < width; i++, dst += 4) {
+        *reinterpret_cast<uint32_t *>(dst) = pixel;
+    }
+}
+
+void blendFillRow(uint8_t *dst, unsigned width, uint32_t pixel, uint8_t cover) {
+    auto alpha = reinterpret_cast<const uint8_t *>(&pixel)[ColorA];
+    if (alpha == 0) {
+        return;
+    }
+    if (alpha == 255 && cover == 255) {
+        fillRow(dst, width, pixel);
+        return;
+    }
+
+    const __m128i s = _mm_set1_epi32(static_cast<int>(pixel));
+    const __m128i coverVec = _mm_set1_epi16(cover);
+    const bool fullCover = cover == 255;
+
+    unsigned i = 0;
+    for (; i + 4 <= width; i += 4, dst += 16) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), blend4(d, s, coverVec, fullCover));
+    }
+    PixelKernels::blendFillPixels(dst, width - i, pixel, cover);
+}
+
+//
+// Bilinear sampling. The filter is separable in exact integers: the horizontal pass of two taps fits 16 bits
+// (256 * 255), the vertical one is done in 32 bits, so the sums are the same as of the four 16-bit weights.
+//
+inline __m128i loadTaps(const uint8_t *p, uint32_t next) {
+    __m128i a = _mm_cvtsi32_si128(*reinterpret_cast<const int *>(p));
+    __m128i b = _mm_cvtsi32_si128(*reinterpret_cast<const int *>(p + next));
+    return _mm_unpacklo_epi8(_mm_unpacklo_epi32(a, b), _mm_setzero_si128());
+}
+
+// the filtered pixel in the 32-bit lanes, B G R A
+inline __m128i filter(const BilinearSample& s) {
+    const __m128i wx = _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<short>(256 - s.fx)),
+                                          _mm_set1_epi16(static_cast<short>(s.fx)));
+    const __m128i wy = _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<short>(256 - s.fy)),
+                                          _mm_set1_epi16(static_cast<short>(s.fy)));
+
+    __m128i top = _mm_mullo_epi16(loadTaps(s.row0, s.next), wx);
+    __m128i bottom = _mm_mullo_epi16(loadTaps(s.row1, s.next), wx);
+    top = _mm_add_epi16(top, _mm_srli_si128(top, 8));
+    bottom = _mm_add_epi16(bottom, _mm_srli_si128(bottom, 8));
+
+    __m128i v = _mm_unpacklo_epi64(top, bottom);
+    __m128i lo = _mm_mullo_epi16(v, wy);
+    __m128i hi = _mm_mulhi_epu16(v, wy);
+    __m128i sum = _mm_add_epi32(_mm_unpacklo_epi16(lo, hi), _mm_unpackhi_epi16(lo, hi));
+    return _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(32768)), 16);
+}
+
+void sampleBilinearRow(uint8_t *dst, const BilinearSample *samples, unsigned width, uint8_t alpha) {
+    static_assert(ColorB == 0 && ColorG == 1 && ColorR == 2 && ColorA == 3);
+    const __m128i alphaVec = _mm_set1_epi16(alpha);
+
+    unsigned i = 0;
+    for (; i + 2 <= width; i += 2, dst += 8) {
+        __m128i c = _mm_packs_epi32(filter(samples[i]), filter(samples[i + 1]));
+        c = _mm_srli_epi16(_mm_mullo_epi16(c, alphaVec), 8);
+        // BGRA to RGBA
+        c = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(c, c));
+    }
+    PixelKernels::sampleBilinearPixels(dst, samples + i, width - i, alpha);
+}
+
+} // namespace
+
+const PixelKernelTable SSE2_PIXEL_KERNELS = {
+        blendRow,
+        fillRow,
+        blendFillRow,
+        sampleBilinearRow,
+        L"SSE2",
+};
+
+} // namespace litelockr
+
+#endif // PIXEL_KERNELS_X86
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpanImageBilinear.h"
+
+#include <algorithm>
+
+namespace litelockr {
+
+SpanImageBilinear::SpanImageBilinear(const Bitmap& image, const agg::trans_perspective& tr, std::uint8_t alpha)
+        : image_(image.pixFmt()),
+          tr_(tr),
+          affine_(isAffine(tr)),
+          scale_(1.0 / tr.w2),
+          alpha_(alpha) {
+}
+
+void SpanImageBilinear::generate(color_type *span, int x, int y, unsigned len) {
+    static_assert(sizeof(color_type) == 4);
+    if (samples_.size() < len) {
+        samples_.resize(len);
+    }
+
+    const int width = static_cast<int>(image_.width());
+    const int height = static_cast<int>(image_.height());
+    constexpr int SHIFT = agg::image_subpixel_shift;
+    constexpr int MASK = agg::image_subpixel_mask;
+    constexpr int HALF = agg::image_subpixel_scale / 2;
+    constexpr auto SCALE = static_cast<double>(agg::image_subpixel_scale);
+
+    // the same expressions as trans_perspective::transform() evaluates, so the pixels match bit for bit
+    const double srcY = y + 0.5;
+    const double ySx = srcY * tr_.shx;
+    const double ySy = srcY * tr_.sy;
+    const double yW = srcY * tr_.w1;
+    double srcX = x + 0.5;
+
+    for (unsigned i = 0; i < len; i++, srcX += 1.0) {
+        const double m = affine_ ? scale_ : 1.0 / (srcX * tr_.w0 + yW + tr_.w2);
+        int xHr = agg::iround(m * (srcX * tr_.sx + ySx + tr_.tx) * SCALE) - HALF;
+        int yHr = agg::iround(m * (srcX * tr_.shy + ySy + tr_.ty) * SCALE) - HALF;
+        int xLr = xHr >> SHIFT;
+        int yLr = yHr >> SHIFT;
+
+        // agg::image_accessor_clone
+        int x0 = std::clamp(xLr, 0, width - 1);
+        int y0 = std::clamp(yLr, 0, height - 1);
+        int y1 = std::clamp(yLr + 1, 0, height - 1);
+
+        auto& s = samples_[i];
+        s.row0 = image_.pix_ptr(x0, y0);
+        s.row1 = image_.pix_ptr(x0, y1);
+        s.next = (xLr >= 0 && xLr < width - 1) ? 4 : 0;
+        s.fx = static_cast<uint16_t>(xHr & MASK);
+        s.fy = static_cast<uint16_t>(yHr & MASK);
+    }
+
+    PixelKernels::sampleBilinearRow(reinterpret_cast<uint8_t *>(span), samples_.data(), len, alpha_);
+}
+
+} // namespace litelockr
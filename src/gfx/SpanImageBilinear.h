@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPAN_IMAGE_BILINEAR_H
+#define SPAN_IMAGE_BILINEAR_H
+
+#include <vector>
+
+#include "gfx/AggAll.h"
+#include "gfx/Bitmap.h"
+#include "gfx/PixelKernels.h"
+
+namespace litelockr {
+
+//
+// Bilinear image span generator for the perspective transform, the alpha is applied as well. It yields the same
+// pixels as agg::span_image_filter_rgba_bilinear over agg::span_interpolator_trans followed by SpanConvAlpha,
+// but the filter runs in the SIMD kernels. The affine transforms also skip the division per pixel.
+//
+class SpanImageBilinear {
+public:
+    using color_type = agg::rgba8;
+
+    SpanImageBilinear(const Bitmap& image, const agg::trans_perspective& tr, std::uint8_t alpha);
+
+    // the perspective part of the transform is zero, e.g. the quad is a parallelogram
+    static bool isAffine(const agg::trans_perspective& tr) {
+        return tr.w0 == 0.0 && tr.w1 == 0.0;
+    }
+
+    void prepare() const { /* Nothing to do. This method is required by agg::render_scanlines_aa. */ }
+
+    void generate(color_type *span, int x, int y, unsigned len);
+
+private:
+    const Bitmap::PixFmtType& image_;
+    const agg::trans_perspective& tr_;
+    const bool affine_;
+    const double scale_; // 1 / w2, what trans_perspective::transform() divides by when the transform is affine
+    const std::uint8_t alpha_;
+
+    std::vector<BilinearSample> samples_;
+};
+
+} // namespace litelockr
+
+#endif // SPAN_IMAGE_BILINEAR_H
@@ -19,17 +19,50 @@
 
 #include "LayeredWindow.h"
 
+#include "log/Logger.h"
 #include "sys/Process.h"
+#include "sys/Rectangle.h"
 
 namespace litelockr {
 
 void LayeredWindow::updateWindow() {
+    dirtyRegion_.setSize(buffer_.width(), buffer_.height());
+    dirtyRegion_.addAll();
+    updateDirtyRegion();
+}
+
+void LayeredWindow::updateDirtyRegion() {
     const unsigned int w = buffer_.width();
     const unsigned int h = buffer_.height();
-    bufferPre_.create(w, h);
-    bufferPre_.blitFrom(buffer_);
-    bufferPre_.pixFmt().premultiply();
-    updateLayeredWindow(hWnd, position_, bufferPre_.operator HBITMAP(), w, h);
+    dirtyRegion_.setSize(w, h);
+
+    // the window keeps the pixels outside of the dirty rectangle only if its size and position are the same
+    bool full = !presentedPosition_ || presentedSize_.cx != static_cast<long>(w)
+                || presentedSize_.cy != static_cast<long>(h)
+                || presentedPosition_->x != position_.x || presentedPosition_->y != position_.y;
+    if (full) {
+        dirtyRegion_.addAll();
+    }
+    if (dirtyRegion_.empty()) {
+        return;
+    }
+
+    // buffer_ is premultiplied already and is presented as is
+    RECT dirty = dirtyRegion_.bounds();
+    updateLayeredWindow(hWnd, position_, buffer_.operator HBITMAP(), w, h, full ? nullptr : &dirty);
+    presentedPosition_ = position_;
+    presentedSize_ = buffer_.size();
+
+    auto pixels = static_cast<unsigned int>(Rectangle::width(dirty) * Rectangle::height(dirty));
+    stats_.frames++;
+    stats_.lastPixels = pixels;
+    stats_.pixels += pixels;
+    stats_.fullPixels += static_cast<uint64_t>(w) * h;
+    LOG_VERBOSE(L"[LayeredWindow] Frame %u: %u of %u pixels, %llu%% of all pixels so far",
+                stats_.frames, pixels, w * h,
+                static_cast<unsigned long long>(stats_.pixels * 100 / stats_.fullPixels));
+
+    dirtyRegion_.clear();
 }
 
 void LayeredWindow::createWindow(HWND hWndParent) {
@@ -40,7 +73,8 @@ void LayeredWindow::createWindow(HWND hWndParent) {
     onCreate();
 }
 
-void LayeredWindow::updateLayeredWindow(HWND hWnd, POINT position, HBITMAP hBitmap, int width, int height) {
+void LayeredWindow::updateLayeredWindow(HWND hWnd, POINT position, HBITMAP hBitmap, int width, int height,
+                                        const RECT *dirty) {
     HDC hWndDC = GetDC(hWnd);
     HDC hMemDC = CreateCompatibleDC(hWndDC);
     if (hMemDC) {
@@ -55,7 +89,16 @@ void LayeredWindow::updateLayeredWindow(HWND hWnd, POINT position, HBITMAP hBitm
         SIZE size{width, height};
         POINT src{};
 
-        if (!UpdateLayeredWindow(hWnd, nullptr, &position, &size, hMemDC, &src, 0, &blendFunc, ULW_ALPHA)) {
+        UPDATELAYEREDWINDOWINFO info = {sizeof(info)};
+        info.pptDst = &position;
+        info.psize = &size;
+        info.hdcSrc = hMemDC;
+        info.pptSrc = &src;
+        info.pblend = &blendFunc;
+        info.dwFlags = ULW_ALPHA;
+        info.prcDirty = dirty; // only this part of the window is updated
+
+        if (!UpdateLayeredWindowIndirect(hWnd, &info)) {
             assert(false);
         }
 
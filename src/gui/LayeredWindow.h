@@ -20,7 +20,11 @@
 #ifndef LAYERED_WINDOW_H
 #define LAYERED_WINDOW_H
 
+#include <cstdint>
+#include <optional>
+
 #include "gfx/Bitmap.h"
+#include "gfx/DirtyRegion.h"
 #include "gui/Window.h"
 
 namespace litelockr {
@@ -37,20 +41,38 @@ public:
 
     void createWindow(HWND hWndParent);
 
+    struct PresentStatistics {
+        unsigned int frames = 0;
+        unsigned int lastPixels = 0;  // the pixels uploaded by the last frame
+        uint64_t pixels = 0;          // the pixels uploaded by all frames
+        uint64_t fullPixels = 0;      // the pixels all frames would upload without the dirty regions
+    };
+
+    [[nodiscard]] const PresentStatistics& presentStatistics() const { return stats_; }
+
 protected:
+    // presents the whole buffer
     void updateWindow();
+    // presents the rectangles of dirtyRegion_ only
+    void updateDirtyRegion();
 
     virtual void onCreate() {}
 
-    static void updateLayeredWindow(HWND hWnd, POINT position, HBITMAP hBitmap, int width, int height);
+    static void updateLayeredWindow(HWND hWnd, POINT position, HBITMAP hBitmap, int width, int height,
+                                    const RECT *dirty = nullptr);
 
     Bitmap buffer_;
-    Bitmap bufferPre_;
+    DirtyRegion dirtyRegion_;
     POINT position_{};
     DWORD style_ = WS_POPUP | WS_VISIBLE;
     DWORD exStyle_ = WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TOOLWINDOW;
     const wchar_t *className_ = DEFAULT_CLASS;
     const wchar_t *windowName_ = L"";
+
+private:
+    std::optional<POINT> presentedPosition_;
+    SIZE presentedSize_{};
+    PresentStatistics stats_;
 };
 
 } // namespace litelockr
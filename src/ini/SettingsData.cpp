@@ -57,8 +57,10 @@ SettingsData::SettingsData() : allProperties_{
         eventInterception,
         allowMouseMovement,
         playSounds,
+        soundOverlap,
         lightMode,
         language,
+        warmUpResources,
         minimizeByDoubleClick,
         minimizeByCtrlDoubleClick,
         minimizeByCaptionButton,
@@ -164,6 +166,14 @@ void SettingsData::validate() {
     int delay = delayBeforeLocking.value();
     delayBeforeLocking.setValue(std::clamp(delay, MIN_DELAY_BEFORE_LOCKING, MAX_DELAY_BEFORE_LOCKING));
 
+    //
+    // SoundOverlap
+    //
+    int overlap = soundOverlap.value();
+    if (overlap < SoundOverlap::CUT || overlap > SoundOverlap::QUEUE) {
+        soundOverlap.reset();
+    }
+
     //
     // LockKeyboard & LockMouse
     //
@@ -62,8 +62,10 @@ public:
                                     EventInterception::GLOBAL_WINDOWS_HOOK}};
     BoolProperty allowMouseMovement{{SETTINGS, L"AllowMouseMovement", true}};           // default: ON
     BoolProperty playSounds{{SETTINGS, L"PlaySounds", true}};                           // default: ON
+    LongProperty soundOverlap{{SETTINGS, L"SoundOverlap", 0}};                          // default: cut
     LongProperty lightMode{{SETTINGS, L"LightMode", 0}};                                // default: auto
     StringProperty language{{SETTINGS, L"Language", Languages::AUTODETECT}};            // default: auto
+    BoolProperty warmUpResources{{SETTINGS, L"WarmUpResources", true}};                 // default: ON
 
     //
     // [LockedApp] section
@@ -97,6 +99,14 @@ public:
     constexpr static int MIN_LOCK_WHEN_IDLE = 0;        // 0 - off
     constexpr static int MAX_LOCK_WHEN_IDLE = 3 * 60;   // 3 hours
 
+    struct SoundOverlap {
+        enum {
+            CUT = 0,
+            MIX = 1,
+            QUEUE = 2,
+        };
+    };
+
     struct LightMode {
         enum {
             AUTO = 0,
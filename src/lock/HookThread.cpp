@@ -38,57 +38,133 @@ namespace litelockr {
 
 std::mutex HookThread::mtx_;
 std::condition_variable HookThread::condVar_;
+bool HookThread::createdFlag_{false};
+bool HookThread::startFlag_{false};
+bool HookThread::exitFlag_{false};
 bool HookThread::readyFlag_{false};
 
+HookOptions HookThread::startOptions_;
 thread_local HookOptions HookThread::options_;
 std::unique_ptr<AbstractHook> HookThread::hook_;
 
 std::function<void(bool isLocked)> HookThread::onLockStateChangedFunc_;
 
+std::optional<AppClock::TimePoint> HookThread::lockRequestedTime_;
+AppClock::TimePoint HookThread::hookInstalledTime_;
 
-void HookThread::threadProc(HookOptions opt) {
-    Process::setHookThreadId(GetCurrentThreadId());
-    options_ = opt;
 
-    WorkerThread::startThread();
-    WinEventThread::startThread();
+void HookThread::prepareThreads() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+    assert(Process::hookThreadId() == 0);
 
-    assert(!hook_);
-    hook_ = HookFactory::create(SettingsData::instance().eventInterception.value());
-    hook_->initialize(options_);
+    //
+    // The threads are created in parallel, startLocking() waits for them
+    //
+    WorkerThread::createThread();
+    WinEventThread::createThread();
 
-    MSG msg;
-    PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    std::thread thr(HookThread::threadProc);
+    thr.detach();
+}
+
+void HookThread::waitUntilCreated() {
+    WorkerThread::waitUntilCreated();
+    WinEventThread::waitUntilCreated();
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return createdFlag_; });
+}
+
+void HookThread::destroyThreads() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+
+    stopLocking();
 
-    // HookThread is ready now
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        readyFlag_ = true;
+        if (createdFlag_) {
+            exitFlag_ = true;
+        }
     }
-    if (onLockStateChangedFunc_) {
-        onLockStateChangedFunc_(readyFlag_);
+    condVar_.notify_all();
+
+    // wait for the HookThread
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        condVar_.wait(lk, [] { return !createdFlag_; });
     }
-    condVar_.notify_one();
-    //
+    LOG_DEBUG(L"[HookThread] The thread has exited");
 
-    hook_->start();
-    hook_->dispose();
-    hook_.reset();
+    WinEventThread::destroyThread();
+    WorkerThread::destroyThread();
+}
 
-    WinEventThread::stopThread();
-    WorkerThread::stopThread();
+bool HookThread::waitForStart() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return startFlag_ || exitFlag_; });
+    if (exitFlag_) {
+        return false;
+    }
 
-    // reset the ready flag
+    startFlag_ = false;
+    options_ = startOptions_;
+    return true;
+}
+
+void HookThread::threadProc() {
+    Process::setHookThreadId(GetCurrentThreadId());
+
+    MSG msg;
+    PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    // HookThread is parked now
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        assert(readyFlag_);
-        readyFlag_ = false;
+        createdFlag_ = true;
     }
-    if (onLockStateChangedFunc_) {
-        onLockStateChangedFunc_(readyFlag_);
+    condVar_.notify_all();
+    //
+
+    while (waitForStart()) {
+        assert(!hook_);
+        hook_ = HookFactory::create(SettingsData::instance().eventInterception.value());
+        hook_->initialize(options_);
+
+        // HookThread is ready now
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            readyFlag_ = true;
+            hookInstalledTime_ = AppClock::now();
+        }
+        if (onLockStateChangedFunc_) {
+            onLockStateChangedFunc_(true);
+        }
+        condVar_.notify_all();
+        //
+
+        hook_->start();
+        hook_->dispose();
+        hook_.reset();
+
+        // reset the ready flag
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            assert(readyFlag_);
+            readyFlag_ = false;
+        }
+        if (onLockStateChangedFunc_) {
+            onLockStateChangedFunc_(false);
+        }
+        condVar_.notify_all();
     }
-    condVar_.notify_one();
+
     Process::setHookThreadId(0);
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        createdFlag_ = false;
+        exitFlag_ = false;
+    }
+    condVar_.notify_all();
 }
 
 void HookThread::startLocking() {
@@ -97,6 +173,15 @@ void HookThread::startLocking() {
         return;
     }
 
+    auto startTime = AppClock::now();
+    waitUntilCreated();
+
+    //
+    // The worker threads do not depend on the current app, they get ready in the meantime
+    //
+    WorkerThread::startThread();
+    WinEventThread::startThread();
+
     auto& settings = SettingsData::instance();
     auto& validator = HookData::windowValidator();
     const auto& appConfigSet = validator.getAppConfigSet();
@@ -143,9 +228,17 @@ void HookThread::startLocking() {
         MouseFilter::updatePositionValidator(MousePositionValidatorTimer::UPDATE_IMMEDIATELY);
     }
 
-    assert(!readyFlag_);
-    assert(Process::hookThreadId() == 0);
-    std::thread thr(HookThread::threadProc, options);
+    WorkerThread::waitUntilReady();
+    WinEventThread::waitUntilReady();
+
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        assert(createdFlag_);
+        assert(!readyFlag_ && !startFlag_);
+        startOptions_ = options;
+        startFlag_ = true;
+    }
+    condVar_.notify_all();
 
     // wait for the HookThread
     {
@@ -154,7 +247,18 @@ void HookThread::startLocking() {
     }
 
     LOG_DEBUG(L"[HookThread] The thread has started work");
-    thr.detach();
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    if (lockRequestedTime_) {
+        LOG_DEBUG(L"[HookThread] Time to locked: %lld ms (lock setup: %lld ms)",
+                  duration_cast<milliseconds>(hookInstalledTime_ - *lockRequestedTime_).count(),
+                  duration_cast<milliseconds>(hookInstalledTime_ - startTime).count());
+    } else {
+        LOG_DEBUG(L"[HookThread] Lock setup: %lld ms",
+                  duration_cast<milliseconds>(hookInstalledTime_ - startTime).count());
+    }
+    clearLockRequested();
 }
 
 void HookThread::stopLocking() {
@@ -177,6 +281,9 @@ void HookThread::stopLocking() {
 
         LOG_DEBUG(L"[HookThread] The thread has stopped");
     }
+
+    WinEventThread::stopThread();
+    WorkerThread::stopThread();
 }
 
 bool HookThread::isLocked() {
@@ -188,8 +295,6 @@ void HookThread::initializeCurrentApp(HWND hwndActive) {
     Process::setCurrentAppAutomationId(L""); // reset id
 
     if (hwndActive) {
-        currentAppSelection().show(hwndActive); // shows blue corners
-
         //
         // get an automation id of the current app
         //
@@ -197,9 +302,24 @@ void HookThread::initializeCurrentApp(HWND hwndActive) {
             UIAutomationHelper uia;
             return uia.getAutomationIdOfActiveButton();
         });
+
+        currentAppSelection().show(hwndActive); // shows blue corners, while UIA is scanning the taskbar
+
         Process::setCurrentAppAutomationId(automationIdFuture.get());
         LOG_DEBUG(L"[CurrentApp] AutomationId = %s", Process::currentAppAutomationId().c_str());
     }
 }
 
+void HookThread::markLockRequested() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+    if (!lockRequestedTime_) {
+        lockRequestedTime_ = AppClock::now();
+    }
+}
+
+void HookThread::clearLockRequested() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+    lockRequestedTime_.reset();
+}
+
 } // namespace litelockr
@@ -23,9 +23,11 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <optional>
 
 #include "lock/hook/AbstractHook.h"
 #include "lock/ui/AppSelection.h"
+#include "sys/AppClock.h"
 
 namespace litelockr {
 
@@ -33,6 +35,12 @@ class HookThread {
 public:
     HookThread() = delete;
 
+    //
+    // The hook, worker and WinEvent threads are created once and reused by every lock session
+    //
+    static void prepareThreads();
+    static void destroyThreads();
+
     static void startLocking();
     static void stopLocking();
     static bool isLocked();
@@ -45,22 +53,35 @@ public:
 
     static void initializeCurrentApp(HWND hwndActive);
 
+    // the starting point of the time-to-locked metric
+    static void markLockRequested();
+    static void clearLockRequested();
+
     static AppSelection& currentAppSelection() {
         static AppSelection currentAppSelection_;
         return currentAppSelection_;
     }
 
 private:
-    static void threadProc(HookOptions opt);
+    static void threadProc();
+    static bool waitForStart();
+    static void waitUntilCreated();
 
     static std::mutex mtx_;
     static std::condition_variable condVar_;
+    static bool createdFlag_;
+    static bool startFlag_;
+    static bool exitFlag_;
     static bool readyFlag_;
 
+    static HookOptions startOptions_;
     thread_local static HookOptions options_;
     static std::unique_ptr<AbstractHook> hook_;
 
     static LockStateChangedFunc onLockStateChangedFunc_;
+
+    static std::optional<AppClock::TimePoint> lockRequestedTime_;
+    static AppClock::TimePoint hookInstalledTime_;
 };
 
 } // namespace litelockr
@@ -31,19 +31,65 @@ namespace litelockr {
 
 std::mutex WinEventThread::mtx_;
 std::condition_variable WinEventThread::condVar_;
+bool WinEventThread::createdFlag_{false};
+bool WinEventThread::startFlag_{false};
+bool WinEventThread::exitFlag_{false};
 bool WinEventThread::readyFlag_{false};
 
 std::atomic<bool> WinEventThread::taskbarChanged_{false};
 
 thread_local HWINEVENTHOOK WinEventThread::winEventHook_{nullptr};
 
-void WinEventThread::startThread() {
-    assert(GetCurrentThreadId() == Process::hookThreadId());
+void WinEventThread::createThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+    assert(Process::winEventThreadId() == 0);
 
+    std::thread thr(WinEventThread::threadProc);
+    thr.detach();
+}
+
+void WinEventThread::waitUntilCreated() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return createdFlag_; });
+}
+
+void WinEventThread::destroyThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
     assert(!readyFlag_);
-    assert(Process::winEventThreadId() == 0);
+
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        if (!createdFlag_) {
+            return;
+        }
+        exitFlag_ = true;
+    }
+    condVar_.notify_all();
+
+    // wait for the WinEventThread
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        condVar_.wait(lk, [] { return !createdFlag_; });
+    }
+
+    LOG_DEBUG(L"[WinEventThread] The thread has exited");
+}
+
+void WinEventThread::startThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+
     resetTaskbarChanged();
-    std::thread thr(WinEventThread::threadProc);
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        assert(createdFlag_);
+        assert(!readyFlag_ && !startFlag_);
+        startFlag_ = true;
+    }
+    condVar_.notify_all();
+}
+
+void WinEventThread::waitUntilReady() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
 
     // wait for the WinEventThread
     {
@@ -52,11 +98,10 @@ void WinEventThread::startThread() {
     }
 
     LOG_DEBUG(L"[WinEventThread] The thread has started work");
-    thr.detach();
 }
 
 void WinEventThread::stopThread() {
-    assert(GetCurrentThreadId() == Process::hookThreadId());
+    assert(GetCurrentThreadId() == Process::mainThreadId());
     assert(Process::winEventThreadId());
 
     if (Process::winEventThreadId()) {
@@ -73,6 +118,17 @@ void WinEventThread::stopThread() {
     }
 }
 
+bool WinEventThread::waitForStart() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return startFlag_ || exitFlag_; });
+    if (exitFlag_) {
+        return false;
+    }
+
+    startFlag_ = false;
+    return true;
+}
+
 void WinEventThread::threadProc() {
     Process::setWinEventThreadId(GetCurrentThreadId());
 
@@ -82,49 +138,66 @@ void WinEventThread::threadProc() {
     MSG msg;
     PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
 
-    //
-    // Set WinEventHook
-    //
-    assert(winEventHook_ == nullptr);
-    winEventHook_ = User32::setWinEventHook(
-            EVENT_OBJECT_CREATE, EVENT_OBJECT_DESTROY,
-            nullptr,
-            winEventProc,
-            0, 0,
-            WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
-
-    // WinEventThread is ready now
+    // WinEventThread is parked now
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        readyFlag_ = true;
+        createdFlag_ = true;
     }
-    condVar_.notify_one();
+    condVar_.notify_all();
     //
 
-    //
-    // message loop
-    //
-    while (GetMessage(&msg, nullptr, 0, 0) != 0) {
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
+    while (waitForStart()) {
+        //
+        // Set WinEventHook
+        //
+        assert(winEventHook_ == nullptr);
+        winEventHook_ = User32::setWinEventHook(
+                EVENT_OBJECT_CREATE, EVENT_OBJECT_DESTROY,
+                nullptr,
+                winEventProc,
+                0, 0,
+                WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+
+        // WinEventThread is ready now
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            readyFlag_ = true;
+        }
+        condVar_.notify_all();
+        //
+
+        //
+        // message loop
+        //
+        while (GetMessage(&msg, nullptr, 0, 0) != 0) {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+
+        //
+        // Unset WinEventHook
+        //
+        assert(winEventHook_);
+        User32::unhookWinEvent(winEventHook_);
+        winEventHook_ = nullptr;
+
+        // reset the ready flag
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            assert(readyFlag_);
+            readyFlag_ = false;
+        }
+        condVar_.notify_all();
     }
 
-    //
-    // Unset WinEventHook
-    //
-    assert(winEventHook_);
-    User32::unhookWinEvent(winEventHook_);
-    winEventHook_ = nullptr;
     CoUninitialize();
-
-    // reset the ready flag
+    Process::setWinEventThreadId(0);
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        assert(readyFlag_);
-        readyFlag_ = false;
+        createdFlag_ = false;
+        exitFlag_ = false;
     }
-    condVar_.notify_one();
-    Process::setWinEventThreadId(0);
+    condVar_.notify_all();
 }
 
 
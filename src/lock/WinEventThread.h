@@ -28,9 +28,17 @@
 
 namespace litelockr {
 
+//
+// The thread is created once and parked between the lock sessions
+//
 class WinEventThread {
 public:
+    static void createThread();
+    static void waitUntilCreated();
+    static void destroyThread();
+
     static void startThread();
+    static void waitUntilReady();
     static void stopThread();
 
     static bool isTaskbarChanged();
@@ -38,9 +46,13 @@ public:
 
 private:
     static void threadProc();
+    static bool waitForStart();
 
     static std::mutex mtx_;
     static std::condition_variable condVar_;
+    static bool createdFlag_;
+    static bool startFlag_;
+    static bool exitFlag_;
     static bool readyFlag_;
 
     static std::atomic<bool> taskbarChanged_;
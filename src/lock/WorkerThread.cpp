@@ -34,15 +34,51 @@ namespace litelockr {
 
 std::mutex WorkerThread::mtx_;
 std::condition_variable WorkerThread::condVar_;
+bool WorkerThread::createdFlag_{false};
+bool WorkerThread::startFlag_{false};
+bool WorkerThread::exitFlag_{false};
 bool WorkerThread::readyFlag_{false};
 
+WorkerThreadOptions WorkerThread::startOptions_;
 thread_local WorkerThreadOptions WorkerThread::options_;
 
-void WorkerThread::startThread() {
-    assert(GetCurrentThreadId() == Process::hookThreadId());
+void WorkerThread::createThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
+    assert(Process::workerThreadId() == 0);
+
+    std::thread thr(WorkerThread::threadProc);
+    thr.detach();
+}
+
+void WorkerThread::waitUntilCreated() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return createdFlag_; });
+}
 
+void WorkerThread::destroyThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
     assert(!readyFlag_);
-    assert(Process::workerThreadId() == 0);
+
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        if (!createdFlag_) {
+            return;
+        }
+        exitFlag_ = true;
+    }
+    condVar_.notify_all();
+
+    // wait for the WorkerThread
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        condVar_.wait(lk, [] { return !createdFlag_; });
+    }
+
+    LOG_DEBUG(L"[WorkerThread] The thread has exited");
+}
+
+void WorkerThread::startThread() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
 
     const auto& settings = SettingsData::instance();
 
@@ -51,7 +87,18 @@ void WorkerThread::startThread() {
     options.minimizeByCtrlDoubleClick = settings.minimizeByCtrlDoubleClick.value();
     options.minimizeByCaptionButton = settings.minimizeByCaptionButton.value();
 
-    std::thread thr(WorkerThread::threadProc, options);
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        assert(createdFlag_);
+        assert(!readyFlag_ && !startFlag_);
+        startOptions_ = options;
+        startFlag_ = true;
+    }
+    condVar_.notify_all();
+}
+
+void WorkerThread::waitUntilReady() {
+    assert(GetCurrentThreadId() == Process::mainThreadId());
 
     // wait for the WorkerThread
     {
@@ -60,11 +107,10 @@ void WorkerThread::startThread() {
     }
 
     LOG_DEBUG(L"[WorkerThread] The thread has started work");
-    thr.detach();
 }
 
 void WorkerThread::stopThread() {
-    assert(GetCurrentThreadId() == Process::hookThreadId());
+    assert(GetCurrentThreadId() == Process::mainThreadId());
     assert(Process::workerThreadId());
 
     if (Process::workerThreadId()) {
@@ -81,46 +127,74 @@ void WorkerThread::stopThread() {
     }
 }
 
-void WorkerThread::threadProc(WorkerThreadOptions opt) {
+bool WorkerThread::waitForStart() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    condVar_.wait(lk, [] { return startFlag_ || exitFlag_; });
+    if (exitFlag_) {
+        return false;
+    }
+
+    startFlag_ = false;
+    options_ = startOptions_;
+    return true;
+}
+
+void WorkerThread::threadProc() {
     Process::setWorkerThreadId(GetCurrentThreadId());
-    options_ = opt;
 
     MSG msg;
     PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
 
-    // WorkerThread is ready now
+    // WorkerThread is parked now
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        readyFlag_ = true;
+        createdFlag_ = true;
     }
-    condVar_.notify_one();
+    condVar_.notify_all();
     //
 
-    //
-    // message loop
-    //
-    while (GetMessage(&msg, nullptr, 0, 0) != 0) {
-        if (msg.message == WMU_WT_PROCESS_CAPTION_BUTTON) {
-            bool dblClick = (msg.wParam & PCB_DBL_CLICK) > 0;
-            bool ctrlPressed = (msg.wParam & PCB_CTRL_PRESSED) > 0;
-            POINT pt{GET_X_LPARAM(msg.lParam), GET_Y_LPARAM(msg.lParam)};
-            processCaptionButton(pt, dblClick, ctrlPressed);
-        } else if (msg.message == WMU_WT_PROCESS_SYSTRAY_ICON) {
-            processSystemTrayIcon(msg.wParam, msg.lParam);
+    while (waitForStart()) {
+        // WorkerThread is ready now
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            readyFlag_ = true;
         }
+        condVar_.notify_all();
+        //
+
+        //
+        // message loop
+        //
+        while (GetMessage(&msg, nullptr, 0, 0) != 0) {
+            if (msg.message == WMU_WT_PROCESS_CAPTION_BUTTON) {
+                bool dblClick = (msg.wParam & PCB_DBL_CLICK) > 0;
+                bool ctrlPressed = (msg.wParam & PCB_CTRL_PRESSED) > 0;
+                POINT pt{GET_X_LPARAM(msg.lParam), GET_Y_LPARAM(msg.lParam)};
+                processCaptionButton(pt, dblClick, ctrlPressed);
+            } else if (msg.message == WMU_WT_PROCESS_SYSTRAY_ICON) {
+                processSystemTrayIcon(msg.wParam, msg.lParam);
+            }
 
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+
+        // reset the ready flag
+        {
+            std::scoped_lock<std::mutex> lock{mtx_};
+            assert(readyFlag_);
+            readyFlag_ = false;
+        }
+        condVar_.notify_all();
     }
 
-    // reset the ready flag
+    Process::setWorkerThreadId(0);
     {
         std::scoped_lock<std::mutex> lock{mtx_};
-        assert(readyFlag_);
-        readyFlag_ = false;
+        createdFlag_ = false;
+        exitFlag_ = false;
     }
-    condVar_.notify_one();
-    Process::setWorkerThreadId(0);
+    condVar_.notify_all();
 }
 
 
@@ -37,16 +37,25 @@ struct WorkerThreadOptions {
     bool minimizeByCaptionButton = false;
 };
 
+//
+// The thread is created once and parked between the lock sessions
+//
 class WorkerThread {
 public:
+    static void createThread();
+    static void waitUntilCreated();
+    static void destroyThread();
+
     static void startThread();
+    static void waitUntilReady();
     static void stopThread();
 
     constexpr static auto PCB_DBL_CLICK = 1;
     constexpr static auto PCB_CTRL_PRESSED = 2;
 
 private:
-    static void threadProc(WorkerThreadOptions opt);
+    static void threadProc();
+    static bool waitForStart();
 
     static void processCaptionButton(POINT pt, bool dblClick, bool ctrlPressed);
     static void processSystemTrayIcon(WPARAM wParam, LPARAM lParam);
@@ -56,8 +65,12 @@ private:
 
     static std::mutex mtx_;
     static std::condition_variable condVar_;
+    static bool createdFlag_;
+    static bool startFlag_;
+    static bool exitFlag_;
     static bool readyFlag_;
 
+    static WorkerThreadOptions startOptions_;
     static thread_local WorkerThreadOptions options_;
 };
 
@@ -181,7 +181,7 @@ void LockPreviewWnd::findAllTopLevelWindows(std::function<bool(HWND)> func) cons
 
 void LockPreviewWnd::drawLockedBackground(Bitmap& buffer) const {
     Bitmap locked;
-    locked.loadPng(IDB_LOCKED_AREA);
+    locked.loadResource(IDB_LOCKED_AREA);
     assert(!locked.isNull());
 
     Bitmap row;
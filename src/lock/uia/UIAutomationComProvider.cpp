@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UIAutomationComProvider.h"
+
+#include <cassert>
+
+#ifdef __MINGW32__
+
+namespace litelockr {
+
+UIAutomationComProvider::UIAutomationComProvider() = default;
+
+UIAutomationComProvider::~UIAutomationComProvider() = default;
+
+UIAutomationTreeProvider::ElementList UIAutomationComProvider::rootElements() { return {}; }
+
+UIAutomationTreeProvider::Element UIAutomationComProvider::firstChild(Element /*parent*/) { return nullptr; }
+
+UIAutomationTreeProvider::Element UIAutomationComProvider::nextSibling(Element /*element*/) { return nullptr; }
+
+void UIAutomationComProvider::release(Element /*element*/) {}
+
+void UIAutomationComProvider::getElementProperties(Element /*element*/, ElementProperties& prop,
+                                                   unsigned /*loadProp*/) {
+    prop = {};
+}
+
+} // namespace litelockr
+
+#else
+
+#include <oleauto.h>
+#include <UIAutomation.h>
+#include "gui/WindowUtils.h"
+#include "sys/Executable.h"
+
+namespace litelockr {
+
+static_assert(CONTROL_TYPE_BUTTON == UIA_ButtonControlTypeId);
+static_assert(CONTROL_TYPE_MENU_ITEM == UIA_MenuItemControlTypeId);
+static_assert(CONTROL_TYPE_TOOL_BAR == UIA_ToolBarControlTypeId);
+static_assert(CONTROL_TYPE_PANE == UIA_PaneControlTypeId);
+
+UIAutomationComProvider::UIAutomationComProvider() {
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    assert(SUCCEEDED(hr));
+
+    hr = CoCreateInstance(__uuidof(CUIAutomation), nullptr, CLSCTX_INPROC_SERVER, __uuidof(IUIAutomation),
+                          (void **) &uiaPtr_);
+    if (SUCCEEDED(hr)) {
+        assert(uiaPtr_);
+
+        hr = uiaPtr_->get_ControlViewWalker(&walker_);
+        assert(SUCCEEDED(hr) && walker_);
+    } else {
+        assert(false);
+    }
+}
+
+UIAutomationComProvider::~UIAutomationComProvider() {
+    assert(uiaPtr_);
+
+    safeRelease(walker_);
+    safeRelease(uiaPtr_);
+
+    CoUninitialize();
+}
+
+UIAutomationTreeProvider::ElementList UIAutomationComProvider::rootElements() {
+    ElementList result;
+    if (!uiaPtr_ || !walker_) {
+        return result;
+    }
+
+    //
+    // The running app buttons on the taskbar
+    //
+    WindowUtils::findRunningApplicationsToolBars([this, &result](HWND hWnd) {
+        IUIAutomationElement *pElement = nullptr;
+
+        HRESULT hr = uiaPtr_->ElementFromHandle(hWnd, &pElement);
+        if (SUCCEEDED(hr) && pElement) {
+            result.push_back(pElement);
+        } else {
+            assert(false);
+        }
+    });
+    assert(!result.empty());
+    return result;
+}
+
+UIAutomationTreeProvider::Element UIAutomationComProvider::firstChild(Element parent) {
+    assert(parent);
+
+    IUIAutomationElement *pNode = nullptr;
+    HRESULT hr = walker_->GetFirstChildElement(static_cast<IUIAutomationElement *>(parent), &pNode);
+    if (SUCCEEDED(hr) && pNode) {
+        statistics_.elementsVisited++;
+        return pNode;
+    }
+    return nullptr;
+}
+
+UIAutomationTreeProvider::Element UIAutomationComProvider::nextSibling(Element element) {
+    assert(element);
+
+    IUIAutomationElement *pNext = nullptr;
+    HRESULT hr = walker_->GetNextSiblingElement(static_cast<IUIAutomationElement *>(element), &pNext);
+    if (SUCCEEDED(hr) && pNext) {
+        statistics_.elementsVisited++;
+        return pNext;
+    }
+    return nullptr;
+}
+
+void UIAutomationComProvider::release(Element element) {
+    if (element) {
+        static_cast<IUIAutomationElement *>(element)->Release();
+    }
+}
+
+void UIAutomationComProvider::getElementProperties(Element element, ElementProperties& prop, unsigned loadProp) {
+    BSTR str;
+    prop = {};
+
+    auto pElement = static_cast<IUIAutomationElement *>(element);
+    assert(pElement);
+    if (!pElement) {
+        return;
+    }
+
+    statistics_.propertyReads++;
+
+    HRESULT hr;
+    if (loadProp & PROP_NAME) {
+        //
+        // Current Name
+        //
+        hr = pElement->get_CurrentName(&str);
+        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
+            prop.name = std::wstring(str, SysStringLen(str));
+            SysFreeString(str);
+            statistics_.stringAllocations++;
+        }
+    }
+
+    if (loadProp & PROP_CLASS_NAME) {
+        //
+        // Current Class Name
+        //
+        hr = pElement->get_CurrentClassName(&str);
+        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
+            prop.className = std::wstring(str, SysStringLen(str));
+            SysFreeString(str);
+            statistics_.stringAllocations++;
+        }
+    }
+
+    if (loadProp & PROP_CONTROL_TYPE) {
+        //
+        // Current Control Type
+        //
+        CONTROLTYPEID typeId;
+        hr = pElement->get_CurrentControlType(&typeId);
+        if (SUCCEEDED(hr)) {
+            prop.controlType = typeId;
+        }
+    }
+
+    if (loadProp & PROP_BOUNDING_RECTANGLE) {
+        //
+        // Current Bounding Rectangle
+        //
+        RECT rc = {0};
+        hr = pElement->get_CurrentBoundingRectangle(&rc);
+        if (SUCCEEDED(hr)) {
+            prop.boundingRectangle = rc;
+        }
+    }
+
+    if (loadProp & PROP_ACC_STATE) {
+        //
+        // Current LegacyIAccessibleState
+        //
+        VARIANT val;
+        hr = pElement->GetCurrentPropertyValue(UIA_LegacyIAccessibleStatePropertyId, &val);
+        if (SUCCEEDED(hr) && val.vt == VT_I4) {
+            prop.accState = val.lVal;
+        }
+    }
+
+    if (loadProp & PROP_AUTOMATION_ID) {
+        //
+        // Current AutomationId
+        //
+        hr = pElement->get_CurrentAutomationId(&str);
+        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
+            prop.automationId = std::wstring(str, SysStringLen(str));
+            SysFreeString(str);
+            statistics_.stringAllocations++;
+        }
+    }
+
+    if (loadProp & PROP_PROCESS_ID) {
+        //
+        // Current ProcessId
+        //
+        int val;
+        hr = pElement->get_CurrentProcessId(&val);
+        if (SUCCEEDED(hr)) {
+            prop.processId = val;
+        }
+    }
+}
+
+} // namespace litelockr
+
+#endif // __MINGW32__
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UIAUTOMATION_COM_PROVIDER_H
+#define UIAUTOMATION_COM_PROVIDER_H
+
+#include "UIAutomationTreeProvider.h"
+
+struct IUIAutomation;
+struct IUIAutomationTreeWalker;
+
+namespace litelockr {
+
+//
+// Walks the running applications toolbars of the taskbar with the UI Automation COM API
+//
+class UIAutomationComProvider: public UIAutomationTreeProvider {
+public:
+    UIAutomationComProvider();
+    UIAutomationComProvider(const UIAutomationComProvider&) = delete;
+    UIAutomationComProvider& operator=(const UIAutomationComProvider&) = delete;
+    ~UIAutomationComProvider() override;
+
+    ElementList rootElements() override;
+    Element firstChild(Element parent) override;
+    Element nextSibling(Element element) override;
+    void release(Element element) override;
+    void getElementProperties(Element element, ElementProperties& prop, unsigned loadProp) override;
+
+private:
+    IUIAutomation *uiaPtr_ = nullptr;
+    IUIAutomationTreeWalker *walker_ = nullptr;
+};
+
+} // namespace litelockr
+
+#endif // UIAUTOMATION_COM_PROVIDER_H
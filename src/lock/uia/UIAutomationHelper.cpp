@@ -19,18 +19,21 @@
 
 #include "UIAutomationHelper.h"
 
+#include "UIAutomationComProvider.h"
 #include "UIAutomationHelperImpl.h"
 
 namespace litelockr {
 
-UIAutomationHelper::UIAutomationHelper() : pImpl{std::make_unique<UIAutomationHelperImpl>()} {
-    pImpl->initialize();
+UIAutomationHelper::UIAutomationHelper()
+        : UIAutomationHelper(std::make_unique<UIAutomationComProvider>()) {
 }
 
-UIAutomationHelper::~UIAutomationHelper() {
-    pImpl->dispose();
+UIAutomationHelper::UIAutomationHelper(std::unique_ptr<UIAutomationTreeProvider> provider)
+        : pImpl{std::make_unique<UIAutomationHelperImpl>(std::move(provider))} {
 }
 
+UIAutomationHelper::~UIAutomationHelper() = default;
+
 std::wstring UIAutomationHelper::getAutomationIdOfActiveButton() const {
     return pImpl->getAutomationIdOfActiveButton();
 }
@@ -52,4 +55,8 @@ void UIAutomationHelper::findTaskbarButtons(const StringSet& appNames,
     return pImpl->findTaskbarButtons(appNames, exeNames, autoIds, result);
 }
 
+const ScanStatistics& UIAutomationHelper::statistics() const {
+    return pImpl->statistics();
+}
+
 } // namespace litelockr
@@ -30,6 +30,8 @@
 namespace litelockr {
 
 class UIAutomationHelperImpl;
+class UIAutomationTreeProvider;
+struct ScanStatistics;
 
 class UIAutomationHelper {
 public:
@@ -38,6 +40,7 @@ public:
     using ButtonPropertiesList = std::vector<ButtonProperties>;
 
     UIAutomationHelper();
+    explicit UIAutomationHelper(std::unique_ptr<UIAutomationTreeProvider> provider);
     UIAutomationHelper(const UIAutomationHelper&) = delete;
     UIAutomationHelper& operator=(const UIAutomationHelper&) = delete;
     ~UIAutomationHelper();
@@ -51,6 +54,8 @@ public:
                             const StringSet& autoIds,
                             ButtonPropertiesList& result) const;
 
+    [[nodiscard]] const ScanStatistics& statistics() const;
+
 private:
     std::unique_ptr<UIAutomationHelperImpl> pImpl;
 };
@@ -19,145 +19,94 @@
 
 #include "UIAutomationHelperImpl.h"
 
-#ifndef __MINGW32__
-
 #include <cassert>
+#include <chrono>
 
-#include <oleauto.h>
-#include "gui/WindowUtils.h"
 #include "log/Logger.h"
 #include "sys/Executable.h"
 #include "sys/StringUtils.h"
 
 namespace litelockr {
 
-void UIAutomationHelperImpl::initialize() {
-    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    assert(SUCCEEDED(hr));
-
-    assert(uiaPtr_ == nullptr);
-    hr = CoCreateInstance(__uuidof(CUIAutomation), nullptr, CLSCTX_INPROC_SERVER, __uuidof(IUIAutomation),
-                          (void **) &uiaPtr_);
-    if (SUCCEEDED(hr)) {
-        assert(uiaPtr_);
-    } else {
-        assert(false);
-    }
+UIAutomationHelperImpl::UIAutomationHelperImpl(std::unique_ptr<UIAutomationTreeProvider> provider)
+        : provider_(std::move(provider)) {
+    assert(provider_);
 }
 
-void UIAutomationHelperImpl::dispose() {
-    assert(uiaPtr_);
+void UIAutomationHelperImpl::scanToolBars(const std::function<void(Element)>& func) {
+    auto& stat = provider_->statistics();
+    stat.reset();
+    auto started = std::chrono::steady_clock::now();
 
-    if (uiaPtr_) {
-        uiaPtr_->Release();
-        uiaPtr_ = nullptr;
+    //
+    // Process the running app buttons on the taskbar
+    //
+    for (auto root: provider_->rootElements()) {
+        func(root);
+        provider_->release(root);
     }
 
-    CoUninitialize();
+    stat.elapsed += std::chrono::steady_clock::now() - started;
+
+    LOG_VERBOSE(L"[UIAutomation] Scan: visited=%u, propertyReads=%u, stringAllocations=%u, time=%lld us",
+                stat.elementsVisited, stat.propertyReads, stat.stringAllocations,
+                std::chrono::duration_cast<std::chrono::microseconds>(stat.elapsed).count());
 }
 
 std::wstring UIAutomationHelperImpl::getAutomationIdOfActiveButton() {
     std::wstring result;
 
-    //
-    // Process the running app buttons on the taskbar
-    //
-    auto toolbars = findRunningApplicationsToolBars();
-    assert(!toolbars.empty());
-
-    for (auto hWnd: toolbars) {
-        IUIAutomationElement *pElement = nullptr;
-        IUIAutomationTreeWalker *pWalk = nullptr;
-
-        HRESULT hr = uiaPtr_->ElementFromHandle(hWnd, &pElement);
-        if (SUCCEEDED(hr) && pElement) {
-            uiaPtr_->get_ControlViewWalker(&pWalk);
-            if (SUCCEEDED(hr) && pWalk) {
-                findActiveButton(pWalk, pElement, result);
-            } else {
-                assert(false);
-            }
-        } else {
-            assert(false);
-        }
-
-        safeRelease(pWalk);
-        safeRelease(pElement);
-    }
+    scanToolBars([this, &result](Element root) {
+        findActiveButton(root, result);
+    });
     return result;
 }
 
-void UIAutomationHelperImpl::findActiveButton(IUIAutomationTreeWalker *pWalk, IUIAutomationElement *pParent,
-                                              std::wstring& result) {
-    assert(pWalk);
-    assert(pParent);
-    if (pWalk == nullptr || pParent == nullptr) {
-        return;
+bool UIAutomationHelperImpl::findActiveButton(Element parent, std::wstring& result) {
+    assert(parent);
+    if (parent == nullptr) {
+        return false;
     }
 
-    int loadProp = PROP_CONTROL_TYPE | PROP_AUTOMATION_ID | PROP_ACC_STATE;
+    unsigned int loadProp = PROP_CONTROL_TYPE | PROP_AUTOMATION_ID | PROP_ACC_STATE;
+    bool found = false;
 
-    iterateChildren(pWalk, pParent, [this, pWalk, loadProp, &result](IUIAutomationElement *pNode) -> bool {
+    iterateChildren(parent, [this, loadProp, &result, &found](Element node) -> bool {
         ElementProperties prop;
-        getElementProperties(pNode, prop, loadProp);
-        if (prop.controlType == UIA_PaneControlTypeId || prop.controlType == UIA_ToolBarControlTypeId) {
-            findActiveButton(pWalk, pNode, result); // NOTE: recursion here
-        } else if (prop.controlType == UIA_ButtonControlTypeId || prop.controlType == UIA_MenuItemControlTypeId) {
+        provider_->getElementProperties(node, prop, loadProp);
+        if (prop.controlType == CONTROL_TYPE_PANE || prop.controlType == CONTROL_TYPE_TOOL_BAR) {
+            found = findActiveButton(node, result); // NOTE: recursion here
+        } else if (prop.controlType == CONTROL_TYPE_BUTTON || prop.controlType == CONTROL_TYPE_MENU_ITEM) {
             if (prop.accState & STATE_SYSTEM_PRESSED) {
                 result = prop.automationId;
-
-                // stop
-                pNode->Release();
-                return true;
+                found = true;
             }
         }
-        return false; //continue
+        return found; // stop or continue
     });
+    return found;
 }
 
 //
 ButtonProperties UIAutomationHelperImpl::getTaskbarButton(int index) {
     ButtonProperties result;
 
-    //
-    // Process the running app buttons on the taskbar
-    //
-    auto toolbars = findRunningApplicationsToolBars();
-    assert(!toolbars.empty());
-
-    for (auto hWnd: toolbars) {
-        IUIAutomationElement *pElement = nullptr;
-        IUIAutomationTreeWalker *pWalk = nullptr;
-
-        HRESULT hr = uiaPtr_->ElementFromHandle(hWnd, &pElement);
-        if (SUCCEEDED(hr) && pElement) {
-            uiaPtr_->get_ControlViewWalker(&pWalk);
-            if (SUCCEEDED(hr) && pWalk) {
-                int buttonIdx = 0;
-                findButtons(pWalk, pElement,
-                            [this, index, &buttonIdx, &result](const ElementProperties& prop) {
-                                result.buttonIndex = buttonIdx;
-                                result.automationId = prop.automationId;
-                                result.name = prop.name;
-                                result.boundingRectangle = prop.boundingRectangle;
-
-                                buttonIdx++;
-
-                                if (result.buttonIndex == index) {
-                                    return true; // stop
-                                }
-                                return false; // continue
-                            });
-            } else {
-                assert(false);
-            }
-        } else {
-            assert(false);
-        }
+    scanToolBars([this, index, &result](Element root) {
+        int buttonIdx = 0;
+        findButtons(root, [index, &buttonIdx, &result](const ElementProperties& prop) {
+            result.buttonIndex = buttonIdx;
+            result.automationId = prop.automationId;
+            result.name = prop.name;
+            result.boundingRectangle = prop.boundingRectangle;
 
-        safeRelease(pWalk);
-        safeRelease(pElement);
-    }
+            buttonIdx++;
+
+            if (result.buttonIndex == index) {
+                return true; // stop
+            }
+            return false; // continue
+        });
+    });
 
     return result;
 }
@@ -166,202 +115,83 @@ ButtonProperties UIAutomationHelperImpl::findTaskbarButton(int propertyId,
                                                            const StringSet& searchValues, int searchOptions) {
     ButtonProperties result;
 
-    //
-    // Process the running app buttons on the taskbar
-    //
-    auto toolbars = findRunningApplicationsToolBars();
-    assert(!toolbars.empty());
-
-    for (auto hWnd: toolbars) {
-        IUIAutomationElement *pElement = nullptr;
-        IUIAutomationTreeWalker *pWalk = nullptr;
-
-        HRESULT hr = uiaPtr_->ElementFromHandle(hWnd, &pElement);
-        if (SUCCEEDED(hr) && pElement) {
-            uiaPtr_->get_ControlViewWalker(&pWalk);
-            if (SUCCEEDED(hr) && pWalk) {
-                int buttonIdx = 0;
-                findButtons(pWalk, pElement,
-                            [this, propertyId, &searchValues, searchOptions, &buttonIdx, &result](
-                                    const ElementProperties& prop) {
-                                std::wstring value;
-
-                                switch (propertyId) {
-                                    case PROP_NAME:
-                                        value = StringUtils::prepareSearchString(prop.name);
-                                        break;
-                                    case PROP_AUTOMATION_ID:
-                                        value = StringUtils::prepareSearchString(prop.automationId);
-                                        break;
-                                }
-
-                                if (value.empty()) {
-                                    return false; // continue
-                                }
-
-                                bool found = false;
-                                bool exactMatch = (searchOptions & EXACT_MATCH);
-                                bool startsWith = (searchOptions & STARTS_WITH);
-                                bool endsWith = (searchOptions & ENDS_WITH);
-
-                                for (const auto& searchValue: searchValues) {
-                                    if (searchValue.empty()) {
-                                        continue;
-                                    }
-                                    if (exactMatch && value == searchValue) {
-                                        found = true;
-                                        result.selPosition = 0;
-                                        result.selLength = value.size();
-                                        break;
-                                    }
-                                    if (startsWith && value.starts_with(searchValue)) {
-                                        found = true;
-                                        result.selPosition = 0;
-                                        result.selLength = searchValue.size();
-                                        break;
-                                    }
-                                    if (endsWith && value.ends_with(searchValue)) {
-                                        found = true;
-                                        result.selPosition = value.size() - searchValue.size();
-                                        result.selLength = searchValue.size();
-                                        break;
-                                    }
-                                }
-
-                                if (found) {
-                                    result.buttonIndex = buttonIdx;
-                                    result.automationId = prop.automationId;
-                                    result.name = prop.name;
-                                    result.boundingRectangle = prop.boundingRectangle;
-                                    return true; // stop
-                                }
-
-                                buttonIdx++;
-                                return false; // continue
-                            });
-            } else {
-                assert(false);
+    scanToolBars([this, propertyId, &searchValues, searchOptions, &result](Element root) {
+        int buttonIdx = 0;
+        findButtons(root, [propertyId, &searchValues, searchOptions, &buttonIdx, &result](
+                const ElementProperties& prop) {
+            std::wstring value;
+
+            switch (propertyId) {
+                case PROP_NAME:
+                    value = StringUtils::prepareSearchString(prop.name);
+                    break;
+                case PROP_AUTOMATION_ID:
+                    value = StringUtils::prepareSearchString(prop.automationId);
+                    break;
             }
-        } else {
-            assert(false);
-        }
-
-        safeRelease(pWalk);
-        safeRelease(pElement);
-    }
-
-    return result;
-}
 
-void UIAutomationHelperImpl::iterateChildren(IUIAutomationTreeWalker *pWalk,
-                                             IUIAutomationElement *pParent,
-                                             std::function<bool(IUIAutomationElement * )> func) {
-    assert(pWalk);
-    assert(pParent);
-
-    IUIAutomationElement *pNode = nullptr;
-    HRESULT hr = pWalk->GetFirstChildElement(pParent, &pNode);
-    if (SUCCEEDED(hr) && pNode) {
-        do {
-            if (func(pNode)) {
-                break;
+            if (value.empty()) {
+                return false; // continue
             }
 
-            IUIAutomationElement *pNext = nullptr;
-            hr = pWalk->GetNextSiblingElement(pNode, &pNext);
-            pNode->Release();
-            pNode = pNext;
-        } while (SUCCEEDED(hr) && pNode);
-    }
-}
-
-void UIAutomationHelperImpl::getElementProperties(IUIAutomationElement *pElement,
-                                                  ElementProperties& prop,
-                                                  unsigned int loadProp) {
-    BSTR str;
-    prop = {};
-
-    assert(pElement);
-    if (!pElement) {
-        return;
-    }
-
-    HRESULT hr;
-    if (loadProp & PROP_NAME) {
-        //
-        // Current Name
-        //
-        hr = pElement->get_CurrentName(&str);
-        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
-            prop.name = std::wstring(str, SysStringLen(str));
-            SysFreeString(str);
-        }
-    }
+            bool found = false;
+            bool exactMatch = (searchOptions & EXACT_MATCH);
+            bool startsWith = (searchOptions & STARTS_WITH);
+            bool endsWith = (searchOptions & ENDS_WITH);
+
+            for (const auto& searchValue: searchValues) {
+                if (searchValue.empty()) {
+                    continue;
+                }
+                if (exactMatch && value == searchValue) {
+                    found = true;
+                    result.selPosition = 0;
+                    result.selLength = value.size();
+                    break;
+                }
+                if (startsWith && value.starts_with(searchValue)) {
+                    found = true;
+                    result.selPosition = 0;
+                    result.selLength = searchValue.size();
+                    break;
+                }
+                if (endsWith && value.ends_with(searchValue)) {
+                    found = true;
+                    result.selPosition = value.size() - searchValue.size();
+                    result.selLength = searchValue.size();
+                    break;
+                }
+            }
 
-    if (loadProp & PROP_CLASS_NAME) {
-        //
-        // Current Class Name
-        //
-        hr = pElement->get_CurrentClassName(&str);
-        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
-            prop.className = std::wstring(str, SysStringLen(str));
-            SysFreeString(str);
-        }
-    }
+            if (found) {
+                result.buttonIndex = buttonIdx;
+                result.automationId = prop.automationId;
+                result.name = prop.name;
+                result.boundingRectangle = prop.boundingRectangle;
+                return true; // stop
+            }
 
-    if (loadProp & PROP_CONTROL_TYPE) {
-        //
-        // Current Control Type
-        //
-        CONTROLTYPEID typeId;
-        hr = pElement->get_CurrentControlType(&typeId);
-        if (SUCCEEDED(hr)) {
-            prop.controlType = typeId;
-        }
-    }
+            buttonIdx++;
+            return false; // continue
+        });
+    });
 
-    if (loadProp & PROP_BOUNDING_RECTANGLE) {
-        //
-        // Current Bounding Rectangle
-        //
-        RECT rc = {0};
-        hr = pElement->get_CurrentBoundingRectangle(&rc);
-        if (SUCCEEDED(hr)) {
-            prop.boundingRectangle = rc;
-        }
-    }
+    return result;
+}
 
-    if (loadProp & PROP_ACC_STATE) {
-        //
-        // Current LegacyIAccessibleState
-        //
-        VARIANT val;
-        hr = pElement->GetCurrentPropertyValue(UIA_LegacyIAccessibleStatePropertyId, &val);
-        if (SUCCEEDED(hr) && val.vt == VT_I4) {
-            prop.accState = val.lVal;
-        }
-    }
+void UIAutomationHelperImpl::iterateChildren(Element parent, const std::function<bool(Element)>& func) {
+    assert(parent);
 
-    if (loadProp & PROP_AUTOMATION_ID) {
-        //
-        // Current AutomationId
-        //
-        hr = pElement->get_CurrentAutomationId(&str);
-        if (SUCCEEDED(hr) && SysStringLen(str) > 0) {
-            prop.automationId = std::wstring(str, SysStringLen(str));
-            SysFreeString(str);
+    Element node = provider_->firstChild(parent);
+    while (node) {
+        if (func(node)) {
+            provider_->release(node);
+            break;
         }
-    }
 
-    if (loadProp & PROP_PROCESS_ID) {
-        //
-        // Current ProcessId
-        //
-        int val;
-        hr = pElement->get_CurrentProcessId(&val);
-        if (SUCCEEDED(hr)) {
-            prop.processId = val;
-        }
+        Element next = provider_->nextSibling(node);
+        provider_->release(node);
+        node = next;
     }
 }
 
@@ -369,69 +199,43 @@ void UIAutomationHelperImpl::findTaskbarButtons(const StringSet& appNames,
                                                 const StringSet& exeNames,
                                                 const StringSet& autoIds,
                                                 ButtonPropertiesList& result) {
-    //
-    // Process the running app buttons on the taskbar
-    //
-    auto toolbars = findRunningApplicationsToolBars();
-    assert(!toolbars.empty());
-
-    for (auto hWnd: toolbars) {
-        IUIAutomationElement *pElement = nullptr;
-        IUIAutomationTreeWalker *pWalk = nullptr;
-
-        HRESULT hr = uiaPtr_->ElementFromHandle(hWnd, &pElement);
-        if (SUCCEEDED(hr) && pElement) {
-            uiaPtr_->get_ControlViewWalker(&pWalk);
-            if (SUCCEEDED(hr) && pWalk) {
-                int buttonIdx = 0;
-                findButtons(pWalk, pElement,
-                            [this, &buttonIdx, &appNames, &exeNames, &autoIds, &result](const ElementProperties& prop) {
-                                if (isButtonAllowed(prop, appNames, exeNames, autoIds)) {
-                                    // adds a rectangle
-                                    ButtonProperties buttonProp(prop);
-                                    buttonProp.buttonIndex = buttonIdx;
-                                    result.push_back(buttonProp);
-                                }
-
-                                buttonIdx++;
-
-                                return false; // continue
-                            });
-            } else {
-                assert(false);
+    scanToolBars([this, &appNames, &exeNames, &autoIds, &result](Element root) {
+        int buttonIdx = 0;
+        findButtons(root, [this, &buttonIdx, &appNames, &exeNames, &autoIds, &result](const ElementProperties& prop) {
+            if (isButtonAllowed(prop, appNames, exeNames, autoIds)) {
+                // adds a rectangle
+                ButtonProperties buttonProp(prop);
+                buttonProp.buttonIndex = buttonIdx;
+                result.push_back(buttonProp);
             }
-        } else {
-            assert(false);
-        }
 
-        safeRelease(pWalk);
-        safeRelease(pElement);
-    }
+            buttonIdx++;
+
+            return false; // continue
+        });
+    });
 }
 
-void UIAutomationHelperImpl::findButtons(IUIAutomationTreeWalker *pWalk, IUIAutomationElement *pParent,
-                                         FindTaskbarButtonsCallback callbackFn) {
-    assert(pWalk);
-    assert(pParent);
-    if (pWalk == nullptr || pParent == nullptr) {
-        return;
+bool UIAutomationHelperImpl::findButtons(Element parent, const FindTaskbarButtonsCallback& callbackFn) {
+    assert(parent);
+    if (parent == nullptr) {
+        return false;
     }
 
     unsigned int loadProp = PROP_CONTROL_TYPE | PROP_NAME | PROP_BOUNDING_RECTANGLE | PROP_AUTOMATION_ID;
+    bool stopped = false;
 
-    iterateChildren(pWalk, pParent, [this, pWalk, loadProp, &callbackFn](IUIAutomationElement *pNode) -> bool {
+    iterateChildren(parent, [this, loadProp, &callbackFn, &stopped](Element node) -> bool {
         ElementProperties prop;
-        getElementProperties(pNode, prop, loadProp);
-        if (prop.controlType == UIA_PaneControlTypeId || prop.controlType == UIA_ToolBarControlTypeId) {
-            findButtons(pWalk, pNode, callbackFn); // NOTE: recursion here
-        } else if (prop.controlType == UIA_ButtonControlTypeId || prop.controlType == UIA_MenuItemControlTypeId) {
-            if (callbackFn(prop)) {
-                pNode->Release();
-                return true; // stop
-            }
+        provider_->getElementProperties(node, prop, loadProp);
+        if (prop.controlType == CONTROL_TYPE_PANE || prop.controlType == CONTROL_TYPE_TOOL_BAR) {
+            stopped = findButtons(node, callbackFn); // NOTE: recursion here
+        } else if (prop.controlType == CONTROL_TYPE_BUTTON || prop.controlType == CONTROL_TYPE_MENU_ITEM) {
+            stopped = callbackFn(prop);
         }
-        return false; //continue
+        return stopped; // stop or continue
     });
+    return stopped;
 }
 
 bool UIAutomationHelperImpl::isButtonAllowed(const ElementProperties& prop,
@@ -525,15 +329,4 @@ bool UIAutomationHelperImpl::endsWithDotExe(const std::wstring& str) const {
             (e3 == L'e' || e3 == L'E'));
 }
 
-std::vector<HWND> UIAutomationHelperImpl::findRunningApplicationsToolBars() const {
-    std::vector<HWND> wnds;
-
-    WindowUtils::findRunningApplicationsToolBars([&wnds](HWND hWnd) {
-        wnds.push_back(hWnd);
-    });
-    return wnds;
-}
-
 } // namespace litelockr
-
-#endif // __MINGW32__
@@ -20,12 +20,13 @@
 #ifndef UIAUTOMATION_HELPER_IMPL_H
 #define UIAUTOMATION_HELPER_IMPL_H
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
 #include "UIAutomationHelperTypes.h"
-
-#ifdef __MINGW32__
+#include "UIAutomationTreeProvider.h"
 
 namespace litelockr {
 
@@ -34,44 +35,10 @@ public:
     using StringSet = std::unordered_set<std::wstring>;
     using RectList = std::vector<RECT>;
     using ButtonPropertiesList = std::vector<ButtonProperties>;
+    using Element = UIAutomationTreeProvider::Element;
 
-    void initialize() {}
-
-    void dispose() {}
-
-    std::wstring getAutomationIdOfActiveButton() { return L""; }
-
-    ButtonProperties getTaskbarButton(int /*index*/) {
-        return {};
-    }
-
-    ButtonProperties findTaskbarButton(int /*propertyId*/, const StringSet& /*searchValues*/, int /*searchOptions*/) {
-        return {};
-    }
-
-    void findTaskbarButtons(const StringSet& appNames,
-                            const StringSet& exeNames,
-                            const StringSet& autoIds,
-                            ButtonPropertiesList& result) {}
-};
-} // namespace litelockr
-
-#else
-
-#include <functional>
-
-#include <UIAutomation.h>
-
-namespace litelockr {
-
-class UIAutomationHelperImpl {
-public:
-    using StringSet = std::unordered_set<std::wstring>;
-    using RectList = std::vector<RECT>;
-    using ButtonPropertiesList = std::vector<ButtonProperties>;
+    explicit UIAutomationHelperImpl(std::unique_ptr<UIAutomationTreeProvider> provider);
 
-    void initialize();
-    void dispose();
     std::wstring getAutomationIdOfActiveButton();
     ButtonProperties getTaskbarButton(int index);
     ButtonProperties findTaskbarButton(int propertyId, const StringSet& searchValues, int searchOptions);
@@ -80,21 +47,17 @@ public:
                             const StringSet& autoIds,
                             ButtonPropertiesList& result);
 
-protected:
-    IUIAutomation *uiaPtr_ = nullptr;
+    [[nodiscard]] const ScanStatistics& statistics() const { return provider_->statistics(); }
 
-    void iterateChildren(IUIAutomationTreeWalker *pWalk,
-                         IUIAutomationElement *pParent,
-                         std::function<bool(IUIAutomationElement * )> func);
+protected:
+    std::unique_ptr<UIAutomationTreeProvider> provider_;
 
-    void getElementProperties(IUIAutomationElement *pElement,
-                              ElementProperties& prop,
-                              unsigned int loadProp = PROP_ALL);
+    void iterateChildren(Element parent, const std::function<bool(Element)>& func);
 
     using FindTaskbarButtonsCallback = std::function<bool(const ElementProperties&)>;
 
-    void
-    findButtons(IUIAutomationTreeWalker *pWalk, IUIAutomationElement *pParent, FindTaskbarButtonsCallback callbackFn);
+    void scanToolBars(const std::function<void(Element)>& func);
+    bool findButtons(Element parent, const FindTaskbarButtonsCallback& callbackFn);
     bool isButtonAllowed(const ElementProperties& prop,
                          const StringSet& appNames,
                          const StringSet& exeNames,
@@ -103,13 +66,9 @@ protected:
     bool endsWith(const std::wstring& value, const StringSet& searchStrings) const;
     bool endsWithDotExe(const std::wstring& value) const;
 
-    void findActiveButton(IUIAutomationTreeWalker *pWalk, IUIAutomationElement *pParent, std::wstring& result);
-
-    std::vector<HWND> findRunningApplicationsToolBars() const;
+    bool findActiveButton(Element parent, std::wstring& result);
 };
 
 } // namespace litelockr
 
-#endif // __MINGW32__
-
 #endif // UIAUTOMATION_HELPER_IMPL_H
@@ -22,7 +22,7 @@
 
 #include <string>
 
-#include <windows.h>
+#include "sys/WinTypes.h"
 
 namespace litelockr {
 
@@ -37,6 +37,20 @@ enum ElementPropertyIds {
     PROP_PROCESS_ID = 0x40
 };
 
+//
+// The same values as UIA_*ControlTypeId
+//
+enum ElementControlTypeIds {
+    CONTROL_TYPE_BUTTON = 50000,
+    CONTROL_TYPE_MENU_ITEM = 50011,
+    CONTROL_TYPE_TOOL_BAR = 50021,
+    CONTROL_TYPE_PANE = 50033,
+};
+
+#ifndef _WIN32
+constexpr DWORD STATE_SYSTEM_PRESSED = 0x00000008; // the accessible state of winuser.h
+#endif
+
 struct ElementProperties {
     std::wstring name;
     std::wstring className;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UIAutomationMemoryProvider.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace litelockr {
+
+namespace {
+
+struct TaskbarApp {
+    const wchar_t *name;
+    const wchar_t *automationId; // the AppUserModelID, or the known folder and the path of the executable
+    DWORD processId;
+};
+
+constexpr TaskbarApp TASKBAR_APPS[] = {
+        {L"File Explorer", L"Microsoft.Windows.Explorer", 5216},
+        {L"Microsoft Edge", L"MSEdge", 11432},
+        {L"Google Chrome", L"Chrome", 9804},
+        {L"Mozilla Firefox", L"308046B0AF4A39CB", 14120},
+        {L"Visual Studio Code", L"Microsoft.VisualStudioCode", 7788},
+        {L"Windows Terminal", L"Microsoft.WindowsTerminal_8wekyb3d8bbwe!App", 13640},
+        {L"Notepad++", L"{6D809377-6AF0-444B-8957-A3773F02200E}\\Notepad++\\notepad++.exe", 3312},
+        {L"Microsoft Outlook", L"Microsoft.Office.OUTLOOK.EXE.15", 10560},
+        {L"Microsoft Excel", L"Microsoft.Office.EXCEL.EXE.15", 12884},
+        {L"Microsoft Teams", L"MSTeams_8wekyb3d8bbwe!MSTeams", 15092},
+        {L"Slack", L"com.squirrel.slack.slack", 8616},
+        {L"Task Manager", L"{1AC14E77-02E7-4E5D-B744-2EB1AE5198B7}\\Taskmgr.exe", 2956},
+        {L"Paint", L"{1AC14E77-02E7-4E5D-B744-2EB1AE5198B7}\\mspaint.exe", 6104},
+        {L"Steam", L"{7C5A40EF-A0FB-4BFC-874A-C0F2E0B9FA8E}\\Steam\\steam.exe", 4480},
+};
+
+} // namespace
+
+UIAutomationMemoryProvider::Node& UIAutomationMemoryProvider::addRoot(const ElementProperties& prop) {
+    auto& node = nodes_.emplace_back();
+    node.properties = prop;
+    roots_.push_back(&node);
+    return node;
+}
+
+UIAutomationMemoryProvider::Node& UIAutomationMemoryProvider::addChild(Node& parent, const ElementProperties& prop) {
+    auto& node = nodes_.emplace_back();
+    node.properties = prop;
+
+    if (parent.lastChild) {
+        parent.lastChild->nextSibling = &node;
+    } else {
+        parent.firstChild = &node;
+    }
+    parent.lastChild = &node;
+    return node;
+}
+
+void UIAutomationMemoryProvider::clear() {
+    roots_.clear();
+    nodes_.clear();
+}
+
+UIAutomationMemoryProvider::Node& UIAutomationMemoryProvider::createTaskbar(unsigned numButtons,
+                                                                            unsigned activeButton) {
+    constexpr long BUTTON_WIDTH = 48;
+    constexpr long TASKBAR_TOP = 1040;
+
+    ElementProperties toolBar;
+    toolBar.name = L"Running applications";
+    toolBar.className = L"MSTaskListWClass";
+    toolBar.controlType = CONTROL_TYPE_TOOL_BAR;
+    toolBar.boundingRectangle = {48, TASKBAR_TOP, 48 + BUTTON_WIDTH * static_cast<long>(numButtons), 1080};
+    toolBar.processId = TASKBAR_APPS[0].processId; // the taskbar belongs to the shell
+    auto& root = addRoot(toolBar);
+
+    //
+    // The buttons are not combined: the first window of an app is named after the app, the others after
+    // their documents. The windows of an app share its automation id.
+    //
+    constexpr unsigned NUM_APPS = std::size(TASKBAR_APPS);
+    for (unsigned i = 0; i < numButtons; i++) {
+        const auto& app = TASKBAR_APPS[i % NUM_APPS];
+        const unsigned window = i / NUM_APPS;
+
+        ElementProperties button;
+        button.name = window == 0 ? std::wstring(app.name) + L" - 1 running window"
+                                  : L"Document " + std::to_wstring(window) + L" - " + app.name;
+        button.controlType = CONTROL_TYPE_BUTTON;
+        const long left = toolBar.boundingRectangle.left + BUTTON_WIDTH * static_cast<long>(i);
+        button.boundingRectangle = {left, TASKBAR_TOP, left + BUTTON_WIDTH, 1080};
+        button.accState = i == activeButton ? STATE_SYSTEM_PRESSED : 0;
+        button.automationId = app.automationId;
+        button.processId = app.processId;
+        addChild(root, button);
+    }
+    return root;
+}
+
+UIAutomationTreeProvider::ElementList UIAutomationMemoryProvider::rootElements() {
+    return {roots_.begin(), roots_.end()};
+}
+
+UIAutomationTreeProvider::Element UIAutomationMemoryProvider::firstChild(Element parent) {
+    assert(parent);
+    auto child = static_cast<Node *>(parent)->firstChild;
+    if (child) {
+        statistics_.elementsVisited++;
+    }
+    return child;
+}
+
+UIAutomationTreeProvider::Element UIAutomationMemoryProvider::nextSibling(Element element) {
+    assert(element);
+    auto sibling = static_cast<Node *>(element)->nextSibling;
+    if (sibling) {
+        statistics_.elementsVisited++;
+    }
+    return sibling;
+}
+
+void UIAutomationMemoryProvider::getElementProperties(Element element, ElementProperties& prop, unsigned loadProp) {
+    prop = {};
+
+    assert(element);
+    if (!element) {
+        return;
+    }
+
+    const auto& src = static_cast<const Node *>(element)->properties;
+    statistics_.propertyReads++;
+
+    //
+    // Copies the requested properties only, the same way as the COM provider does
+    //
+    if ((loadProp & PROP_NAME) && !src.name.empty()) {
+        prop.name = src.name;
+        statistics_.stringAllocations++;
+    }
+    if ((loadProp & PROP_CLASS_NAME) && !src.className.empty()) {
+        prop.className = src.className;
+        statistics_.stringAllocations++;
+    }
+    if (loadProp & PROP_CONTROL_TYPE) {
+        prop.controlType = src.controlType;
+    }
+    if (loadProp & PROP_BOUNDING_RECTANGLE) {
+        prop.boundingRectangle = src.boundingRectangle;
+    }
+    if (loadProp & PROP_ACC_STATE) {
+        prop.accState = src.accState;
+    }
+    if ((loadProp & PROP_AUTOMATION_ID) && !src.automationId.empty()) {
+        prop.automationId = src.automationId;
+        statistics_.stringAllocations++;
+    }
+    if (loadProp & PROP_PROCESS_ID) {
+        prop.processId = src.processId;
+    }
+}
+
+} // namespace litelockr
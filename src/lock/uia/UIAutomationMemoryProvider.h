@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UIAUTOMATION_MEMORY_PROVIDER_H
+#define UIAUTOMATION_MEMORY_PROVIDER_H
+
+#include <deque>
+#include <string>
+
+#include "UIAutomationTreeProvider.h"
+
+namespace litelockr {
+
+//
+// In-memory element tree. Allows to run the taskbar scan without a live Windows shell.
+//
+class UIAutomationMemoryProvider: public UIAutomationTreeProvider {
+public:
+    struct Node {
+        ElementProperties properties;
+        Node *firstChild = nullptr;
+        Node *lastChild = nullptr;
+        Node *nextSibling = nullptr;
+    };
+
+    Node& addRoot(const ElementProperties& prop);
+    Node& addChild(Node& parent, const ElementProperties& prop);
+    void clear();
+
+    // the running applications toolbar of a Windows 10 taskbar with the app buttons, the active one is pressed
+    Node& createTaskbar(unsigned numButtons, unsigned activeButton = 0);
+
+    [[nodiscard]] size_t size() const { return nodes_.size(); }
+
+    ElementList rootElements() override;
+    Element firstChild(Element parent) override;
+    Element nextSibling(Element element) override;
+    void release(Element /*element*/) override {}
+    void getElementProperties(Element element, ElementProperties& prop, unsigned loadProp) override;
+
+private:
+    std::deque<Node> nodes_; // keeps node addresses stable
+    std::vector<Node *> roots_;
+};
+
+} // namespace litelockr
+
+#endif // UIAUTOMATION_MEMORY_PROVIDER_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UIAUTOMATION_TREE_PROVIDER_H
+#define UIAUTOMATION_TREE_PROVIDER_H
+
+#include <chrono>
+#include <vector>
+
+#include "UIAutomationHelperTypes.h"
+
+namespace litelockr {
+
+struct ScanStatistics {
+    unsigned elementsVisited = 0;
+    unsigned propertyReads = 0;
+    unsigned stringAllocations = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    void reset() { *this = {}; }
+};
+
+//
+// Gives access to the taskbar element tree.
+// Elements returned by rootElements(), firstChild() and nextSibling() must be released by the caller.
+//
+class UIAutomationTreeProvider {
+public:
+    using Element = void *;
+    using ElementList = std::vector<Element>;
+
+    virtual ~UIAutomationTreeProvider() = default;
+
+    virtual ElementList rootElements() = 0;
+    virtual Element firstChild(Element parent) = 0;
+    virtual Element nextSibling(Element element) = 0;
+    virtual void release(Element element) = 0;
+    virtual void getElementProperties(Element element, ElementProperties& prop, unsigned loadProp) = 0;
+
+    ScanStatistics& statistics() { return statistics_; }
+
+    [[nodiscard]] const ScanStatistics& statistics() const { return statistics_; }
+
+protected:
+    ScanStatistics statistics_;
+};
+
+} // namespace litelockr
+
+#endif // UIAUTOMATION_TREE_PROVIDER_H
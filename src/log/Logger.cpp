@@ -22,14 +22,25 @@
 #include <fstream>
 #include <filesystem>
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cstdarg>
+#include <cwchar>
+#include <vector>
+
+#define PLOG_ENABLE_WCHAR_INPUT 1
+#endif
 
 #define PLOG_OMIT_LOG_DEFINES
 
+#include <plog/Appenders/ConsoleAppender.h>
 #include <plog/Initializers/RollingFileInitializer.h>
 #include <plog/Log.h>
+#ifdef _WIN32
 #include "app/Version.h"
 #include "sys/Process.h"
+#endif
 
 
 namespace plog {
@@ -71,9 +82,44 @@ namespace fs = std::filesystem;
 constexpr static auto LOG_FILENAME = "LiteLockr.log";
 Log::Severity Log::maxSeverity_ = Log::Severity::None;
 
+#ifndef _WIN32
+// %s is a wide string and %hs is a narrow one in the Windows wide formats, %ls and %s elsewhere
+static std::wstring toPosixFormat(const wchar_t *format) {
+    std::wstring result;
+    for (const wchar_t *p = format; *p; ++p) {
+        result += *p;
+        if (*p != L'%') {
+            continue;
+        }
+        if (p[1] == L'%') {
+            result += *++p;
+            continue;
+        }
+        while (p[1] && !std::wcschr(L"diouxXeEfFgGaAcspn", p[1])) {
+            if (p[1] != L'h' || p[2] != L's') { // drops h of the narrow string
+                result += p[1];
+            }
+            ++p;
+        }
+        if (p[1] == L's' && p[0] != L'h' && p[0] != L'l') {
+            result += L'l';
+        }
+    }
+    return result;
+}
+#endif
+
 void Log::initialize(Log::Severity maxSeverity) {
     maxSeverity_ = maxSeverity;
 
+#ifndef _WIN32
+    // the tests and the benchmarks log to the console
+    if (maxSeverity > Log::Severity::None) {
+        static plog::ConsoleAppender<plog::CustomTxtFormatter> consoleAppender;
+        plog::init(static_cast<plog::Severity>(maxSeverity), &consoleAppender);
+    }
+#else
+
     if (maxSeverity > Log::Severity::None) {
         fs::path logPath = Process::modulePath();
         logPath /= LOG_FILENAME;
@@ -97,10 +143,12 @@ void Log::initialize(Log::Severity maxSeverity) {
 
         plog::init<plog::CustomTxtFormatter>(static_cast<plog::Severity>(maxSeverity), logPath.c_str(), 0, 0);
     }
+#endif
 }
 
 void Log::print(Severity severity, const wchar_t *format, ...) {
     if (maxSeverity_ >= severity) {
+#ifdef _WIN32
         wchar_t *str = nullptr;
         va_list ap;
 
@@ -111,6 +159,22 @@ void Log::print(Severity severity, const wchar_t *format, ...) {
 
         PLOG(static_cast<plog::Severity>(severity)) << str;
         free(str);
+#else
+        const std::wstring posixFormat = toPosixFormat(format);
+        std::vector<wchar_t> str(256);
+        for (;;) {
+            va_list ap;
+            va_start(ap, format);
+            int len = std::vswprintf(str.data(), str.size(), posixFormat.c_str(), ap);
+            va_end(ap);
+            if (len >= 0 || str.size() >= 65536) { // vswprintf does not tell the size it needs
+                break;
+            }
+            str.assign(str.size() * 2, 0);
+        }
+
+        PLOG(static_cast<plog::Severity>(severity)) << str.data();
+#endif
     }
 }
 
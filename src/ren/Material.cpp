@@ -21,12 +21,12 @@
 
 namespace litelockr {
 
-Material::Material(int resourceId) {
-    bitmap.loadPng(resourceId);
-}
-
 void Material::create(const Bitmap& img) {
     bitmap.clone(img);
 }
 
+void Material::create(const FrameSet& frames, unsigned frame) {
+    frames.frameView(frame, bitmap);
+}
+
 } // namespace litelockr
@@ -24,17 +24,20 @@
 #include <vector>
 
 #include "gfx/Bitmap.h"
+#include "gfx/FrameSet.h"
 
 namespace litelockr {
 
 struct Material {
     Bitmap bitmap;
     std::uint8_t alpha = 255;
+    int resourceId = 0; // the image to load into the bitmap, the images are loaded together
 
     Material() = default;
-    explicit Material(int resourceId);
+    explicit Material(int resourceId) : resourceId(resourceId) {}
 
     void create(const Bitmap& img);
+    void create(const FrameSet& frames, unsigned frame);
 };
 
 } // namespace litelockr
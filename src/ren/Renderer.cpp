@@ -19,12 +19,40 @@
 
 #include "Renderer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <ranges>
 
 #include "gfx/BitmapContext.h"
+#include "sys/Rectangle.h"
 
 namespace litelockr {
 
+namespace {
+
+BitmapContext::QuadDouble faceQuad(const BaseGeometry& geo, const Polygon& face) {
+    return {
+            geo.camera[face.a][0],
+            geo.camera[face.a][1],
+            geo.camera[face.b][0],
+            geo.camera[face.b][1],
+            geo.camera[face.c][0],
+            geo.camera[face.c][1],
+            geo.camera[face.d][0],
+            geo.camera[face.d][1],
+    };
+}
+
+// the cells of the rasterizer the quad covers, with a pixel to spare
+RECT quadBounds(const BitmapContext::QuadDouble& quad) {
+    auto [minX, maxX] = std::minmax({quad[0], quad[2], quad[4], quad[6]});
+    auto [minY, maxY] = std::minmax({quad[1], quad[3], quad[5], quad[7]});
+    return {static_cast<long>(std::floor(minX)) - 1, static_cast<long>(std::floor(minY)) - 1,
+            static_cast<long>(std::ceil(maxX)) + 1, static_cast<long>(std::ceil(maxY)) + 1};
+}
+
+} // namespace
+
 void SceneObjects::add(MeshObject& obj) {
     assert(checkParent(obj));
     objects.push_back(obj);
@@ -44,6 +72,11 @@ bool SceneObjects::checkParent(MeshObject& obj) const {
 }
 
 void Renderer::render(SceneObjects& scene) {
+    project(scene);
+    draw(scene);
+}
+
+void Renderer::project(SceneObjects& scene) const {
     for (MeshObject& object: scene.objects) {
         object.updateMg();
     }
@@ -51,6 +84,16 @@ void Renderer::render(SceneObjects& scene) {
     scene.camera.width = buffer_.width();
     scene.camera.height = buffer_.height();
     calculateCameraVertices(scene);
+}
+
+void Renderer::draw(const SceneObjects& scene, std::span<const RECT> clip) const {
+    auto isClipped = [clip](const BitmapContext::QuadDouble& quad) {
+        if (clip.empty()) {
+            return false;
+        }
+        RECT rc = quadBounds(quad);
+        return std::ranges::none_of(clip, [&rc](const RECT& c) { return Rectangle::intersects(c, rc); });
+    };
 
     //
     // Draws all polygons
@@ -68,17 +111,10 @@ void Renderer::render(SceneObjects& scene) {
                     if (mat.alpha > 0) {
                         assert(!mat.bitmap.isNull());
 
-                        BitmapContext::QuadDouble quad{
-                                geo.camera[face.a][0],
-                                geo.camera[face.a][1],
-                                geo.camera[face.b][0],
-                                geo.camera[face.b][1],
-                                geo.camera[face.c][0],
-                                geo.camera[face.c][1],
-                                geo.camera[face.d][0],
-                                geo.camera[face.d][1],
-                        };
-                        ctx.perspective(mat.bitmap, quad, mat.alpha);
+                        BitmapContext::QuadDouble quad = faceQuad(geo, face);
+                        if (!isClipped(quad)) {
+                            ctx.perspective(mat.bitmap, quad, mat.alpha);
+                        }
                     }
                 }
             }
@@ -86,6 +122,21 @@ void Renderer::render(SceneObjects& scene) {
     }
 }
 
+RECT Renderer::bounds(const MeshObject& object) {
+    RECT result{};
+    if (!object.visible) {
+        return result;
+    }
+    const auto& geo = object.geometry();
+    for (const auto& face: geo.faces) {
+        if (face.visible) {
+            RECT rc = quadBounds(faceQuad(geo, face));
+            result = Rectangle::empty(result) ? rc : Rectangle::unite(result, rc);
+        }
+    }
+    return result;
+}
+
 void Renderer::calculateCameraVertices(SceneObjects& scene) const {
     MeshObjectVec& objects = scene.objects;
     for (MeshObject& object: objects) {
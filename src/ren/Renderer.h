@@ -20,6 +20,8 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <span>
+
 #include "gfx/Bitmap.h"
 #include "ren/Camera.h"
 #include "ren/MeshObject.h"
@@ -43,6 +45,16 @@ public:
 
     void render(SceneObjects& scene);
 
+    //
+    // render() in two steps. The faces are drawn over the projected vertices; with the clip rectangles only
+    // those which may touch them are drawn, the pixels inside the rectangles are the same as of render().
+    //
+    void project(SceneObjects& scene) const;
+    void draw(const SceneObjects& scene, std::span<const RECT> clip = {}) const;
+
+    // the pixels the visible faces of the object may touch, empty if there are none
+    [[nodiscard]] static RECT bounds(const MeshObject& object);
+
 private:
     void calculateCameraVertices(SceneObjects& scene) const;
 
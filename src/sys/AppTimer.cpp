@@ -19,18 +19,45 @@
 
 #include "AppTimer.h"
 
+#include <algorithm>
 #include <cassert>
 
+#include "log/Logger.h"
+
+using namespace std::chrono_literals;
+
 namespace litelockr {
 
+std::atomic<bool> AppTimer::wakeUpRequested_{false};
 bool AppTimer::isAnimationActive_{false};
 AppClock::TimePoint AppTimer::animationExpiryTime_;
 
-void AppTimer::fireTimeout() const {
-    for (auto& pListener: listeners_) {
-        assert(pListener);
-        pListener->timeout();
+TimerWheel& AppTimer::wheel() {
+    static TimerWheel wheel_{std::chrono::milliseconds(8)};
+    return wheel_;
+}
+
+AppTimer::AppTimer() {
+    statisticsTimerId_ = schedule(1min, [this]() { logStatistics(); }, 1min);
+}
+
+AppTimer::~AppTimer() {
+    cancel(statisticsTimerId_);
+    for (auto& entry: listeners_) {
+        cancel(entry.timerId);
     }
+}
+
+void AppTimer::fireTimeout() {
+    wakeups_++;
+
+    if (wakeUpRequested_.exchange(false, std::memory_order_relaxed)) {
+        for (auto& entry: listeners_) {
+            scheduleListener(entry, AppClock::Duration::zero());
+        }
+    }
+
+    wheel().advance(AppClock::now());
 
     //
     // Reset isAnimationActive flag
@@ -40,14 +67,79 @@ void AppTimer::fireTimeout() const {
     }
 }
 
+std::optional<AppClock::TimePoint> AppTimer::nextDeadline() {
+    if (wakeUpRequested_.load(std::memory_order_relaxed)) {
+        return AppClock::now();
+    }
+    return wheel().nextDeadline();
+}
+
 void AppTimer::addListener(AppTimerListener& listener) {
     // does it already exist?
-    if (std::find(listeners_.begin(), listeners_.end(), &listener) != listeners_.end()) {
+    if (std::ranges::find(listeners_, &listener, &ListenerEntry::listener) != listeners_.end()) {
         assert(false);
         return;
     }
 
-    listeners_.push_back(&listener);
+    listeners_.push_back({&listener, TimerWheel::INVALID_ID});
+    scheduleListener(listeners_.back(), AppClock::Duration::zero());
+}
+
+void AppTimer::scheduleListener(ListenerEntry& entry, AppClock::Duration delay) {
+    cancel(entry.timerId);
+
+    AppTimerListener *listener = entry.listener;
+    entry.timerId = schedule(delay, [this, listener]() {
+        listenerCalls_++;
+        listener->timeout();
+
+        auto it = std::ranges::find(listeners_, listener, &ListenerEntry::listener);
+        assert(it != listeners_.end());
+        it->timerId = TimerWheel::INVALID_ID;
+
+        // the message loop fires the timers on the frame boundaries, which adds up to one frame
+        auto delay = listener->nextTimeout() - AppTimerListener::FRAME_PERIOD;
+        scheduleListener(*it, std::max(delay, AppClock::Duration::zero()));
+    });
+}
+
+TimerWheel::TimerId AppTimer::schedule(AppClock::Duration delay, TimerWheel::Callback&& callback,
+                                       AppClock::Duration period) {
+    return wheel().schedule(AppClock::now() + delay, std::move(callback), period);
+}
+
+void AppTimer::cancel(TimerWheel::TimerId id) {
+    if (id != TimerWheel::INVALID_ID) {
+        wheel().cancel(id);
+    }
+}
+
+void AppTimer::logStatistics() {
+    LOG_DEBUG(L"[AppTimer] Wakeups per minute: %u, listener calls: %u, timers: %zu",
+              wakeups_, listenerCalls_, wheel().size());
+    wakeups_ = 0;
+    listenerCalls_ = 0;
+}
+
+//
+// DelayTimer
+//
+void DelayTimer::setEnabled(bool enabled) {
+    AppTimer::cancel(timerId_);
+    timerId_ = TimerWheel::INVALID_ID;
+
+    if (enabled) {
+        timerId_ = AppTimer::schedule(delay_, [this]() {
+            timerId_ = TimerWheel::INVALID_ID;
+            callback_();
+        });
+    }
+}
+
+void DelayTimer::reset() {
+    if (enabled()) {
+        setEnabled(true);
+    }
 }
 
 } // namespace litelockr
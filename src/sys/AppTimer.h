@@ -20,15 +20,26 @@
 #ifndef APP_TIMER_H
 #define APP_TIMER_H
 
+#include <atomic>
+#include <functional>
+#include <optional>
 #include <vector>
 
 #include "sys/AppClock.h"
+#include "sys/TimerWheel.h"
 
 namespace litelockr {
 
 class AppTimerListener {
 public:
+    constexpr static auto FRAME_PERIOD = std::chrono::milliseconds(32);
+    constexpr static auto IDLE_PERIOD = std::chrono::seconds(1);
+
     virtual void timeout() = 0;
+
+    // the delay before the next timeout() call
+    [[nodiscard]] virtual AppClock::Duration nextTimeout() const { return FRAME_PERIOD; }
+
     virtual ~AppTimerListener() = default;
 };
 
@@ -39,6 +50,10 @@ public:
         instance_.tick();
     }
 
+    [[nodiscard]] AppClock::Duration nextTimeout() const override {
+        return instance_.nextTimeout();
+    }
+
     T& window() { return instance_; }
 
     const T& window() const { return instance_; }
@@ -47,12 +62,30 @@ private:
     T instance_;
 };
 
+//
+// The listeners and the timers are kept in a timer wheel and are invoked only when they are due
+//
 class AppTimer {
 public:
-    AppTimer() = default;
+    AppTimer();
+    AppTimer(const AppTimer&) = delete;
+    AppTimer& operator=(const AppTimer&) = delete;
+    ~AppTimer();
 
     void addListener(AppTimerListener& listener);
-    void fireTimeout() const;
+    void fireTimeout();
+
+    // the time at which the message loop has to call fireTimeout()
+    [[nodiscard]] static std::optional<AppClock::TimePoint> nextDeadline();
+
+    // makes all the listeners due, e.g. after a window message has changed their state
+    static void wakeUp() {
+        wakeUpRequested_.store(true, std::memory_order_relaxed);
+    }
+
+    static TimerWheel::TimerId schedule(AppClock::Duration delay, TimerWheel::Callback&& callback,
+                                        AppClock::Duration period = AppClock::Duration::zero());
+    static void cancel(TimerWheel::TimerId id);
 
     static void setAnimationActiveFor(int milliseconds) {
         isAnimationActive_ = true;
@@ -61,6 +94,7 @@ public:
         if (animationExpiryTime_ < expiryTime) {
             animationExpiryTime_ = expiryTime;
         }
+        wakeUp();
     }
 
     static bool isAnimationActive() {
@@ -68,13 +102,57 @@ public:
     }
 
 private:
-    using AppTimerListenerVec = std::vector<AppTimerListener *>;
-    AppTimerListenerVec listeners_;
+    struct ListenerEntry {
+        AppTimerListener *listener;
+        TimerWheel::TimerId timerId;
+    };
+
+    void scheduleListener(ListenerEntry& entry, AppClock::Duration delay);
+    void logStatistics();
+
+    std::vector<ListenerEntry> listeners_;
+
+    // wakeups per minute
+    unsigned int wakeups_ = 0;
+    unsigned int listenerCalls_ = 0;
+    TimerWheel::TimerId statisticsTimerId_ = TimerWheel::INVALID_ID;
+
+    static TimerWheel& wheel();
+    static std::atomic<bool> wakeUpRequested_;
 
     static bool isAnimationActive_;
     static AppClock::TimePoint animationExpiryTime_;
 };
 
+//
+// One-shot timer on the AppTimer wheel
+//
+class DelayTimer {
+public:
+    DelayTimer(AppClock::Duration delay, std::function<void()>&& callback)
+            : delay_(delay), callback_(std::move(callback)) {}
+
+    DelayTimer(const DelayTimer&) = delete;
+    DelayTimer& operator=(const DelayTimer&) = delete;
+
+    ~DelayTimer() {
+        setEnabled(false);
+    }
+
+    // starts the timer again or stops it
+    void setEnabled(bool enabled);
+
+    // starts the timer again if it is running
+    void reset();
+
+    [[nodiscard]] bool enabled() const { return timerId_ != TimerWheel::INVALID_ID; }
+
+private:
+    AppClock::Duration delay_;
+    std::function<void()> callback_;
+    TimerWheel::TimerId timerId_ = TimerWheel::INVALID_ID;
+};
+
 } // namespace litelockr
 
 #endif // APP_TIMER_H
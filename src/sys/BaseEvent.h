@@ -21,9 +21,14 @@
 #define BASE_EVENT_H
 
 #include <algorithm>
-#include <deque>
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <vector>
 
+#include "sys/AppClock.h"
 #include "sys/AppTimer.h"
 
 namespace litelockr {
@@ -37,61 +42,250 @@ public:
     bool operator==(const BaseEvent&) const = default;
 };
 
+//
+// Lock-free multiple producers, single consumer queue (D. Vyukov's intrusive MPSC queue).
+// Only the latest sent event with the same id is delivered: every push stamps the event with
+// the next sequence number of its id, and the consumer skips the events with an outdated number.
+// The nodes come from a pool with a lock-free free list, a burst larger than the pool allocates the rest.
+//
 template<class T>
 class EventQueue {
 public:
-    void push(T event) {
-        std::scoped_lock<std::mutex> lock(mtx_);
+    constexpr static int MAX_EVENT_ID = 64;
+    constexpr static uint32_t POOL_SIZE = 128;
 
-        queue_.erase(std::remove(queue_.begin(), queue_.end(), event), queue_.end());
+    struct Entry {
+        T event;
+        unsigned int sequence;
+        AppClock::TimePoint sentTime;
+    };
 
-        queue_.push_back(event);
+    EventQueue() {
+        for (uint32_t i = 0; i < POOL_SIZE; i++) {
+            pool_[i].pooled = true;
+            pool_[i].nextFree.store(i + 1 < POOL_SIZE ? i + 1 : NO_NODE, std::memory_order_relaxed);
+        }
+        freeHead_.store(freeLink(0, 0), std::memory_order_relaxed);
     }
 
-    T pop() {
-        std::scoped_lock<std::mutex> lock(mtx_);
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
 
-        T event = queue_.front();
-        queue_.pop_front();
-        return event;
+    ~EventQueue() {
+        while (NodeBase *node = popNode()) {
+            releaseNode(static_cast<Node *>(node));
+        }
     }
 
-    bool empty() const {
-        std::scoped_lock<std::mutex> lock(mtx_);
+    // can be called from any thread
+    void push(T event) {
+        assert(event.id >= 0 && event.id < MAX_EVENT_ID);
 
-        return queue_.empty();
+        auto sequence = sequence_[event.id].fetch_add(1, std::memory_order_acq_rel) + 1;
+        Node *node = acquireNode();
+        node->entry.emplace(Entry{event, sequence, AppClock::now()});
+        pushNode(node);
     }
 
+    // can be called from any thread, the pending events with the same id will be skipped
     void remove(T event) {
-        std::scoped_lock<std::mutex> lock(mtx_);
+        assert(event.id >= 0 && event.id < MAX_EVENT_ID);
+
+        sequence_[event.id].fetch_add(1, std::memory_order_acq_rel);
+    }
 
-        queue_.erase(std::remove(queue_.begin(), queue_.end(), event), queue_.end());
+    // the consumer thread only
+    std::optional<Entry> pop() {
+        NodeBase *base = popNode();
+        if (base == nullptr) {
+            return std::nullopt;
+        }
+
+        auto node = static_cast<Node *>(base);
+        Entry entry = *node->entry;
+        releaseNode(node);
+        return entry;
+    }
+
+    // false if the event has been removed or sent again after this entry
+    bool isCurrent(const Entry& entry) const {
+        return sequence_[entry.event.id].load(std::memory_order_acquire) == entry.sequence;
     }
 
+    // the nodes allocated because the pool was empty
+    [[nodiscard]] unsigned int poolMisses() const { return poolMisses_.load(std::memory_order_relaxed); }
+
 private:
-    std::deque<T> queue_;
-    mutable std::mutex mtx_;
+    struct NodeBase {
+        std::atomic<NodeBase *> next{nullptr};
+    };
+
+    struct Node: public NodeBase {
+        std::optional<Entry> entry; // the events are not default-constructible
+        std::atomic<uint32_t> nextFree{NO_NODE};
+        bool pooled = false;
+    };
+
+    constexpr static uint32_t NO_NODE = ~0u;
+
+    //
+    // The free list of the pool is a stack of node indices. Its head carries a counter changed by every
+    // update, so a producer that has read a stale next index fails its compare-exchange (the ABA problem).
+    //
+    constexpr static uint64_t freeLink(uint32_t index, uint32_t counter) {
+        return static_cast<uint64_t>(counter) << 32 | index;
+    }
+
+    // any thread
+    Node *acquireNode() {
+        uint64_t head = freeHead_.load(std::memory_order_acquire);
+        while (static_cast<uint32_t>(head) != NO_NODE) {
+            Node& node = pool_[static_cast<uint32_t>(head)];
+            const uint32_t next = node.nextFree.load(std::memory_order_relaxed);
+            if (freeHead_.compare_exchange_weak(head, freeLink(next, static_cast<uint32_t>(head >> 32) + 1),
+                                                std::memory_order_acquire, std::memory_order_acquire)) {
+                return &node;
+            }
+        }
+
+        poolMisses_.fetch_add(1, std::memory_order_relaxed);
+        return new Node;
+    }
+
+    // the consumer thread only
+    void releaseNode(Node *node) {
+        if (!node->pooled) {
+            delete node;
+            return;
+        }
+
+        node->entry.reset();
+        const auto index = static_cast<uint32_t>(node - pool_.data());
+        uint64_t head = freeHead_.load(std::memory_order_relaxed);
+        do {
+            node->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        } while (!freeHead_.compare_exchange_weak(head, freeLink(index, static_cast<uint32_t>(head >> 32) + 1),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void pushNode(NodeBase *node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        NodeBase *prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    NodeBase *popNode() {
+        NodeBase *tail = tail_;
+        NodeBase *next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr; // empty
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr; // a producer is in the middle of push, the node will be available on the next call
+        }
+
+        pushNode(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    NodeBase stub_;
+    std::atomic<NodeBase *> head_{&stub_};
+    NodeBase *tail_{&stub_};
+
+    std::array<std::atomic<unsigned int>, MAX_EVENT_ID> sequence_{};
+
+    std::array<Node, POOL_SIZE> pool_;
+    std::atomic<uint64_t> freeHead_{freeLink(NO_NODE, 0)};
+    std::atomic<unsigned int> poolMisses_{0};
 };
 
+struct EventStatistics {
+    unsigned int processed = 0;
+    unsigned int skipped = 0;
+    AppClock::Duration lastLatency{};
+    AppClock::Duration maxLatency{};
+};
 
 template<class T>
 class BaseEvents: public AppTimerListener {
 public:
+    //
+    // Processes the events that were pending at the beginning of the tick. The rest of them
+    // is left for the next tick if the processing takes longer than the time budget.
+    //
     void timeout() override {
-        if (!queue_.empty()) {
-            process(queue_.pop());
+        if (batchPos_ == batch_.size()) {
+            batch_.clear();
+            batchPos_ = 0;
+            while (auto entry = queue_.pop()) {
+                if (queue_.isCurrent(*entry)) {
+                    batch_.push_back(*entry);
+                } else {
+                    statistics_.skipped++;
+                }
+            }
+        }
+
+        auto deadline = AppClock::now() + PROCESSING_TIME_BUDGET;
+        while (batchPos_ < batch_.size()) {
+            auto entry = batch_[batchPos_++];
+            if (!queue_.isCurrent(entry)) {
+                statistics_.skipped++;
+                continue; // removed or sent again while processing the previous events
+            }
+
+            auto now = AppClock::now();
+            statistics_.processed++;
+            statistics_.lastLatency = now - entry.sentTime;
+            statistics_.maxLatency = std::max(statistics_.maxLatency, statistics_.lastLatency);
+
+            process(entry.event);
+            AppTimer::wakeUp(); // the event may change the state of the other listeners
+
+            if (AppClock::now() >= deadline) {
+                break;
+            }
         }
     }
 
+    [[nodiscard]] AppClock::Duration nextTimeout() const override {
+        return (batchPos_ < batch_.size()) ? FRAME_PERIOD : IDLE_PERIOD;
+    }
+
+    [[nodiscard]] const EventStatistics& statistics() const { return statistics_; }
+
 protected:
-    void sendEvent(T event) { queue_.push(event); }
+    void sendEvent(T event) {
+        queue_.push(event);
+        AppTimer::wakeUp();
+    }
 
     void removeEvent(T event) { queue_.remove(event); }
 
     virtual void process(T event) = 0;
 
+    constexpr static auto PROCESSING_TIME_BUDGET = std::chrono::milliseconds(8);
+
 private:
     EventQueue<T> queue_;
+    std::vector<typename EventQueue<T>::Entry> batch_;
+    size_t batchPos_ = 0;
+    EventStatistics statistics_;
 };
 
 } // namespace litelockr
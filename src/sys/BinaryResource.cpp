@@ -19,10 +19,14 @@
 
 #include "BinaryResource.h"
 
+#ifdef _WIN32
 #include "sys/Process.h"
+#endif
 
 namespace litelockr {
 
+#ifdef _WIN32
+
 unsigned char *Bin::data(int resourceId) {
     auto hInstance = Process::moduleInstance();
     auto hrSrc = FindResource(hInstance, MAKEINTRESOURCE(resourceId), RT_RCDATA);
@@ -43,5 +47,15 @@ unsigned long Bin::size(int resourceId) {
     }
     return 0;
 }
+#else
+// the resources are embedded by the Windows resource compiler only, the tests load the image files directly
+unsigned char *Bin::data(int /*resourceId*/) {
+    return nullptr;
+}
+
+unsigned long Bin::size(int /*resourceId*/) {
+    return 0;
+}
+#endif
 
 } // namespace litelockr
@@ -32,10 +32,6 @@
 
 namespace litelockr {
 
-std::wstring Executable::getFileName(std::wstring_view path) {
-    return std::wstring(path.substr(path.find_last_of(L"/\\") + 1));
-}
-
 #ifndef __MINGW32__
 std::wstring getShellPropStringFromPath(const std::wstring& path, PROPERTYKEY const& key) {
     IShellItem2 *pItem;
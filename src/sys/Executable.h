@@ -21,8 +21,9 @@
 #define EXECUTABLE_H
 
 #include <string>
+#include <string_view>
 
-#include <windows.h>
+#include "sys/WinTypes.h"
 
 namespace litelockr {
 
@@ -36,7 +37,10 @@ void safeRelease(T *& pT) {
 
 class Executable {
 public:
-    static std::wstring getFileName(std::wstring_view path);
+    // the name after the last slash or backslash
+    static std::wstring getFileName(std::wstring_view path) {
+        return std::wstring(path.substr(path.find_last_of(L"/\\") + 1));
+    }
 
     static std::wstring getFileDescription(const std::wstring& path);
     static std::wstring getInternalName(const std::wstring& path);
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <optional>
+
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+//
+// Computes when the message loop should wake up next. The timers are fired with the frame
+// period; without an animation the loop sleeps until a message arrives, a timer is due or
+// the idle period expires. The clock is a template parameter so the scheduler can run against
+// a fake clock.
+//
+template<class C>
+class BasicFrameScheduler {
+public:
+    using Clock = C;
+    using Duration = typename C::Duration;
+    using TimePoint = typename C::TimePoint;
+
+    BasicFrameScheduler(Duration framePeriod, Duration idlePeriod)
+            : framePeriod_(framePeriod), idlePeriod_(idlePeriod), lastTick_(Clock::now()) {
+        assert(framePeriod_ > Duration::zero());
+        assert(idlePeriod_ >= framePeriod_);
+    }
+
+    BasicFrameScheduler(const BasicFrameScheduler&) = delete;
+    BasicFrameScheduler& operator=(const BasicFrameScheduler&) = delete;
+
+    // true if the timers should be fired now
+    [[nodiscard]] bool tickDue() const {
+        return Clock::now() >= nextFrame();
+    }
+
+    // call it after the timers have been fired
+    void tickFired() {
+        TimePoint now = Clock::now();
+        TimePoint next = nextFrame() + framePeriod_;
+
+        // keeps the frame cadence unless the loop has fallen behind by more than a frame
+        lastTick_ = (next > now) ? nextFrame() : now;
+        ticks_++;
+    }
+
+    //
+    // How long the message loop may wait for messages. Without an animation it sleeps until
+    // the deadline of the timers, but not longer than the idle period.
+    //
+    [[nodiscard]] std::chrono::milliseconds waitTime(bool animationActive,
+                                                     std::optional<TimePoint> deadline = std::nullopt) const {
+        TimePoint wakeUpTime = nextFrame();
+        if (!animationActive) {
+            TimePoint idleTime = lastTick_ + idlePeriod_;
+            wakeUpTime = deadline ? std::clamp(*deadline, nextFrame(), idleTime) : idleTime;
+        }
+
+        Duration remaining = wakeUpTime - Clock::now();
+        if (remaining <= Duration::zero()) {
+            return std::chrono::milliseconds::zero();
+        }
+        return std::chrono::ceil<std::chrono::milliseconds>(remaining);
+    }
+
+    //
+    // The high timer resolution is needed only while an animation is running.
+    // Returns true if the state has changed.
+    //
+    bool updateHighResolution(bool animationActive) {
+        if (highResolution_ == animationActive) {
+            return false;
+        }
+        highResolution_ = animationActive;
+        return true;
+    }
+
+    [[nodiscard]] bool highResolution() const { return highResolution_; }
+
+    [[nodiscard]] unsigned long long ticks() const { return ticks_; }
+
+private:
+    [[nodiscard]] TimePoint nextFrame() const { return lastTick_ + framePeriod_; }
+
+    Duration framePeriod_;
+    Duration idlePeriod_;
+    TimePoint lastTick_;
+    bool highResolution_ = false;
+    unsigned long long ticks_ = 0;
+};
+
+using FrameScheduler = BasicFrameScheduler<AppClock>;
+
+} // namespace litelockr
+
+#endif // FRAME_SCHEDULER_H
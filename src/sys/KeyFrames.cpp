@@ -21,8 +21,6 @@
 
 #include <cassert>
 
-#include "sys/Comparison.h"
-
 namespace litelockr {
 
 void KeyFrames::addStopPoint(float offset, float value, Interpolator interpolator) {
@@ -41,21 +39,7 @@ float KeyFrames::interpolate(float value) const {
     assert(isFloatEquals(stopPoints_.front().offset, 0.0f));
     assert(isFloatEquals(stopPoints_.back().offset, 1.0f));
 
-    for (unsigned i = 0; i < stopPoints_.size() - 1; i++) {
-        auto& p0 = stopPoints_[i];
-        auto& p1 = stopPoints_[i + 1];
-
-        if (value < p1.offset) {
-            float len = p1.value - p0.value;
-            return p0.value + interpolate(p0.interpolator, 0, p1.offset - p0.offset, value - p0.offset) * len;
-        }
-    }
-
-    auto& last = stopPoints_.back();
-    if (isFloatEquals(value, last.offset)) {
-        return last.value;
-    }
-    return 0;
+    return interpolateStops(stopPoints_, value);
 }
 
 } // namespace litelockr
@@ -21,8 +21,11 @@
 #define KEY_FRAMES_H
 
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 
+#include "sys/Comparison.h"
+
 namespace litelockr {
 
 #define EASY_IN(x) (KeyFrames::interpolate(Interpolator::EASY_IN,0,1,x))
@@ -55,24 +58,66 @@ public:
         }
     }
 
+    struct StopPoint {
+        float offset = 0;
+        float value = 0;
+        Interpolator interpolator = Interpolator::LINEAR;
+    };
+
     void addStopPoint(float offset, float value, Interpolator interpolator = Interpolator::EASY_BOTH);
     void clear();
     [[nodiscard]] float interpolate(float value) const;
 
+    // the value between the stop points, which are sorted by the offsets from 0 to 1
+    template<class StopPoints>
+    constexpr static float interpolateStops(const StopPoints& stopPoints, float value) {
+        for (std::size_t i = 0; i < std::size(stopPoints) - 1; i++) {
+            auto& p0 = stopPoints[i];
+            auto& p1 = stopPoints[i + 1];
+
+            if (value < p1.offset) {
+                float len = p1.value - p0.value;
+                return p0.value + interpolate(p0.interpolator, 0, p1.offset - p0.offset, value - p0.offset) * len;
+            }
+        }
+
+        auto& last = stopPoints[std::size(stopPoints) - 1];
+        if (isFloatEquals(value, last.offset)) {
+            return last.value;
+        }
+        return 0;
+    }
+
 private:
     template<typename T>
     constexpr static T smoothStep(T t) {
         return t * t * (3 - 2 * t);
     }
 
-    struct StopPoint {
-        float offset = 0;
-        float value = 0;
-        Interpolator interpolator = Interpolator::LINEAR;
-    };
     std::vector<StopPoint> stopPoints_;
 };
 
+//
+// Key frames with a fixed number of stop points, which need no allocation and can be evaluated at compile time
+//
+template<std::size_t N>
+class StaticKeyFrames {
+public:
+    using StopPoint = KeyFrames::StopPoint;
+
+    constexpr explicit StaticKeyFrames(const StopPoint (&stopPoints)[N]) {
+        std::copy(std::begin(stopPoints), std::end(stopPoints), std::begin(stopPoints_));
+    }
+
+    [[nodiscard]] constexpr float interpolate(float value) const {
+        return KeyFrames::interpolateStops(stopPoints_, value);
+    }
+
+private:
+    static_assert(N >= 2);
+    StopPoint stopPoints_[N];
+};
+
 } // namespace litelockr
 
 #endif // KEY_FRAMES_H
@@ -20,9 +20,10 @@
 #ifndef RECTANGLE_H
 #define RECTANGLE_H
 
+#include <algorithm>
 #include <string>
 
-#include <windows.h>
+#include "sys/WinTypes.h"
 
 namespace litelockr {
 
@@ -74,6 +75,22 @@ public:
         return width(rc) <= 0 || height(rc) <= 0;
     }
 
+    static bool intersects(const RECT& a, const RECT& b) {
+        return a.left < b.right && b.left < a.right &&
+               a.top < b.bottom && b.top < a.bottom;
+    }
+
+    // empty if the rectangles do not intersect
+    static RECT intersect(const RECT& a, const RECT& b) {
+        return {std::max(a.left, b.left), std::max(a.top, b.top),
+                std::min(a.right, b.right), std::min(a.bottom, b.bottom)};
+    }
+
+    static RECT unite(const RECT& a, const RECT& b) {
+        return {std::min(a.left, b.left), std::min(a.top, b.top),
+                std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+    }
+
     static bool equals(const RECT& a, const RECT& b) {
         return a.left == b.left &&
                a.top == b.top &&
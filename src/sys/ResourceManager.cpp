@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceManager.h"
+
+#include <cassert>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+bool LazyResource::loadingAhead_ = false;
+
+void LazyResource::load(bool onDemand) {
+    if (loading_) {
+        return; // the loader draws with the resource it loads
+    }
+
+    if (!loaded_) {
+        assert(loader_);
+        bool loadingAhead = loadingAhead_;
+        loadingAhead_ = !onDemand;
+        loading_ = true;
+
+        auto start = AppClock::now();
+        loader_();
+        loadTime_ = AppClock::now() - start;
+
+        loading_ = false;
+        loadingAhead_ = loadingAhead;
+        loaded_ = true;
+        loadedOnDemand_ = onDemand;
+
+        LOG_VERBOSE(L"[ResourceManager] %s %s in %.2f ms", onDemand ? L"Loaded" : L"Warmed up", name_,
+                    std::chrono::duration<double, std::milli>(loadTime_).count());
+    }
+
+    if (onDemand) {
+        used_ = true;
+    }
+}
+
+void ResourceManager::add(LazyResource& resource, const wchar_t *name, LazyResource::Loader&& loader,
+                          bool warmUp /*= true*/) {
+    resource.name_ = name;
+    resource.loader_ = std::move(loader);
+    resources_.push_back({&resource, warmUp});
+}
+
+bool ResourceManager::warmUpNext() {
+    for (auto& entry: resources_) {
+        if (entry.warmUp && !entry.resource->loaded()) {
+            entry.resource->warmUp();
+            break;
+        }
+    }
+
+    for (auto& entry: resources_) {
+        if (entry.warmUp && !entry.resource->loaded()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceManager::logUsage() const {
+    unsigned loaded = 0, used = 0, onDemand = 0;
+    AppClock::Duration loadTime{};
+
+    for (auto& entry: resources_) {
+        const auto& res = *entry.resource;
+        if (res.loaded()) {
+            loaded++;
+            loadTime += res.loadTime();
+            if (res.loadedOnDemand()) {
+                onDemand++;
+            }
+        }
+        if (res.used()) {
+            used++;
+        }
+        LOG_DEBUG(L"[ResourceManager] %s: %s, %s", res.name(),
+                  !res.loaded() ? L"not loaded" : res.loadedOnDemand() ? L"loaded on demand" : L"warmed up",
+                  res.used() ? L"used" : L"not used");
+    }
+
+    LOG_DEBUG(L"[ResourceManager] %u of %zu resources loaded in %.2f ms (%u on demand), %u used",
+              loaded, resources_.size(), std::chrono::duration<double, std::milli>(loadTime).count(),
+              onDemand, used);
+}
+
+} // namespace litelockr
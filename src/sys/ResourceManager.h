@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <functional>
+#include <vector>
+
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+//
+// A resource which is loaded or rendered on its first use.
+// The resources are used from the UI thread only.
+//
+class LazyResource {
+public:
+    using Loader = std::function<void()>;
+
+    LazyResource() = default;
+    LazyResource(const LazyResource&) = delete;
+    LazyResource& operator=(const LazyResource&) = delete;
+
+    // loads the resource if needed and records its use
+    void require() { load(!loadingAhead_); }
+
+    // loads the resource ahead of its first use
+    void warmUp() { load(false); }
+
+    [[nodiscard]] bool loaded() const { return loaded_; }
+    [[nodiscard]] bool used() const { return used_; }
+    [[nodiscard]] bool loadedOnDemand() const { return loadedOnDemand_; }
+    [[nodiscard]] AppClock::Duration loadTime() const { return loadTime_; }
+    [[nodiscard]] const wchar_t *name() const { return name_; }
+
+private:
+    void load(bool onDemand);
+
+    const wchar_t *name_ = L"";
+    Loader loader_;
+    AppClock::Duration loadTime_{};
+    bool loaded_ = false;
+    bool loading_ = false;
+    bool loadedOnDemand_ = false;
+    bool used_ = false;
+
+    // the resources required while warming up are not used yet
+    static bool loadingAhead_;
+
+    friend class ResourceManager;
+};
+
+//
+// The object of the lazy resource, get() loads it
+//
+template<typename T>
+class Lazy: public LazyResource {
+public:
+    T& get() {
+        require();
+        return value_;
+    }
+
+    T& operator*() { return get(); }
+
+    T *operator->() { return &get(); }
+
+    // the object as it is, e.g. to set its properties before it has been loaded
+    T& peek() { return value_; }
+
+    const T& peek() const { return value_; }
+
+private:
+    T value_;
+};
+
+//
+// Keeps the lazy resources in the order they are warmed up, and reports which of them have been used
+//
+class ResourceManager {
+public:
+    void add(LazyResource& resource, const wchar_t *name, LazyResource::Loader&& loader, bool warmUp = true);
+
+    // loads the next resource which has not been loaded yet, returns false when nothing is left
+    bool warmUpNext();
+
+    void logUsage() const;
+
+private:
+    struct Entry {
+        LazyResource *resource;
+        bool warmUp;
+    };
+
+    std::vector<Entry> resources_;
+};
+
+} // namespace litelockr
+
+#endif // RESOURCE_MANAGER_H
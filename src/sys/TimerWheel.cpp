@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace litelockr {
+
+TimerWheel::TimerWheel(AppClock::Duration resolution, AppClock::TimePoint origin)
+        : resolution_(resolution), origin_(origin) {
+    assert(resolution_ > AppClock::Duration::zero());
+}
+
+TimerWheel::TimerId TimerWheel::schedule(AppClock::TimePoint deadline, Callback&& callback,
+                                         AppClock::Duration period) {
+    assert(callback);
+
+    TimerId id = ++lastId_;
+    if (id == INVALID_ID) {
+        id = ++lastId_;
+    }
+
+    // never fires before the deadline
+    uint64_t deadlineTick = std::max(toTick(deadline, true), currentTick_ + 1);
+    timers_.emplace(id, Timer{deadlineTick, period, std::move(callback)});
+    insert(id, deadlineTick);
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    // the slot entry is removed lazily
+    return timers_.erase(id) > 0;
+}
+
+size_t TimerWheel::advance(AppClock::TimePoint now) {
+    size_t fired = 0;
+    uint64_t targetTick = toTick(now, false);
+
+    while (currentTick_ < targetTick) {
+        if (timers_.empty()) {
+            currentTick_ = targetTick; // nothing to wait for
+            break;
+        }
+
+        currentTick_ = std::min(nextBusyTick(), targetTick);
+
+        for (int level = 1; level < LEVELS; level++) {
+            if ((currentTick_ & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        Slot due = takeSlot(0, currentTick_ & SLOT_MASK);
+
+        for (TimerId id: due) {
+            auto it = timers_.find(id);
+            if (it == timers_.end()) {
+                continue; // cancelled
+            }
+
+            auto& timer = it->second;
+            if (timer.deadlineTick > currentTick_) {
+                insert(id, timer.deadlineTick); // beyond the range of the top level
+                continue;
+            }
+
+            Callback callback;
+            if (timer.period > AppClock::Duration::zero()) {
+                callback = timer.callback;
+                timer.deadlineTick = std::max(toTick(toTime(currentTick_) + timer.period, true), currentTick_ + 1);
+                insert(id, timer.deadlineTick);
+            } else {
+                callback = std::move(timer.callback);
+                timers_.erase(it);
+            }
+
+            // the callback may schedule or cancel timers
+            callback();
+            fired++;
+        }
+    }
+    return fired;
+}
+
+std::optional<AppClock::TimePoint> TimerWheel::nextDeadline() const {
+    if (timers_.empty()) {
+        return std::nullopt;
+    }
+
+    //
+    // The slots of a level come in the order of their deadlines, from the slot after the current one.
+    // The top level keeps the far away timers in its last slot, so all its slots are searched.
+    //
+    uint64_t earliestTick = UINT64_MAX;
+    for (int level = 0; level < LEVELS; level++) {
+        const auto first = static_cast<int>(((currentTick_ >> (SLOT_BITS * level)) + 1) & SLOT_MASK);
+        uint64_t slots = std::rotr(occupied_[level], first);
+        bool found = false;
+
+        while (slots && !(found && level < LEVELS - 1)) {
+            const auto index = (first + std::countr_zero(slots)) & SLOT_MASK;
+            slots &= slots - 1;
+
+            for (TimerId id: wheel_[level][index]) {
+                if (auto it = timers_.find(id); it != timers_.end()) {
+                    earliestTick = std::min(earliestTick, it->second.deadlineTick);
+                    found = true;
+                }
+            }
+        }
+    }
+    if (earliestTick == UINT64_MAX) {
+        // called by a callback, the due timers are out of the wheel
+        auto it = std::ranges::min_element(timers_, {}, [](const auto& pair) { return pair.second.deadlineTick; });
+        earliestTick = it->second.deadlineTick;
+    }
+    return toTime(earliestTick);
+}
+
+uint64_t TimerWheel::nextBusyTick() const {
+    uint64_t result = UINT64_MAX;
+    for (int level = 0; level < LEVELS; level++) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+
+        // the slot of the first level is fired at its tick, the slot of an upper level is cascaded at its start
+        const int shift = SLOT_BITS * level;
+        const uint64_t next = (currentTick_ >> shift) + 1;
+        const int skipped = std::countr_zero(std::rotr(occupied_[level], static_cast<int>(next & SLOT_MASK)));
+        result = std::min(result, (next + skipped) << shift);
+    }
+    return result;
+}
+
+void TimerWheel::addToSlot(int level, uint64_t index, TimerId id) {
+    wheel_[level][index].push_back(id);
+    occupied_[level] |= uint64_t{1} << index;
+}
+
+TimerWheel::Slot TimerWheel::takeSlot(int level, uint64_t index) {
+    occupied_[level] &= ~(uint64_t{1} << index);
+    Slot slot;
+    slot.swap(wheel_[level][index]);
+    return slot;
+}
+
+uint64_t TimerWheel::toTick(AppClock::TimePoint time, bool roundUp) const {
+    if (time <= origin_) {
+        return 0;
+    }
+
+    auto ticks = (time - origin_) / resolution_;
+    if (roundUp && origin_ + ticks * resolution_ < time) {
+        ticks++;
+    }
+    return static_cast<uint64_t>(ticks);
+}
+
+AppClock::TimePoint TimerWheel::toTime(uint64_t tick) const {
+    return origin_ + static_cast<AppClock::Duration::rep>(tick) * resolution_;
+}
+
+void TimerWheel::insert(TimerId id, uint64_t deadlineTick) {
+    assert(deadlineTick > currentTick_);
+
+    uint64_t delta = deadlineTick - currentTick_;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    uint64_t tick = deadlineTick;
+    if (level == LEVELS - 1) {
+        // far away timers wait in the top level and are re-inserted when their slot comes
+        tick = std::min(deadlineTick, currentTick_ + (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1);
+    }
+    addToSlot(level, (tick >> (SLOT_BITS * level)) & SLOT_MASK, id);
+}
+
+void TimerWheel::cascade(int level) {
+    Slot slot = takeSlot(level, (currentTick_ >> (SLOT_BITS * level)) & SLOT_MASK);
+
+    for (TimerId id: slot) {
+        auto it = timers_.find(id);
+        if (it == timers_.end()) {
+            continue; // cancelled
+        }
+
+        if (it->second.deadlineTick <= currentTick_) {
+            // due at this tick
+            addToSlot(0, currentTick_ & SLOT_MASK, id);
+        } else {
+            insert(id, it->second.deadlineTick);
+        }
+    }
+}
+
+} // namespace litelockr
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+//
+// Hierarchical timer wheel. Every level has 64 slots, a slot of the first level is one
+// resolution tick long, a slot of every next level covers the whole previous level.
+// The timers of the upper levels are cascaded down when the lower level wraps around.
+// A bit by slot tells the occupied slots, so the wheel skips the ticks without any timers to fire or cascade.
+//
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = unsigned int;
+
+    constexpr static TimerId INVALID_ID = 0;
+
+    explicit TimerWheel(AppClock::Duration resolution, AppClock::TimePoint origin = AppClock::now());
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // schedules a one-shot timer, or a periodic one if the period is not zero
+    TimerId schedule(AppClock::TimePoint deadline, Callback&& callback,
+                     AppClock::Duration period = AppClock::Duration::zero());
+    bool cancel(TimerId id);
+
+    // fires the timers which are due, returns the number of fired timers
+    size_t advance(AppClock::TimePoint now);
+
+    // the time at which the earliest timer will be fired, only the first occupied slots are searched
+    [[nodiscard]] std::optional<AppClock::TimePoint> nextDeadline() const;
+
+    [[nodiscard]] size_t size() const { return timers_.size(); }
+
+private:
+    constexpr static int SLOT_BITS = 6;
+    constexpr static int SLOTS = 1 << SLOT_BITS;
+    constexpr static int LEVELS = 4;
+    constexpr static uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Timer {
+        uint64_t deadlineTick;
+        AppClock::Duration period;
+        Callback callback;
+    };
+
+    using Slot = std::vector<TimerId>;
+
+    [[nodiscard]] uint64_t toTick(AppClock::TimePoint time, bool roundUp) const;
+    [[nodiscard]] AppClock::TimePoint toTime(uint64_t tick) const;
+    void insert(TimerId id, uint64_t deadlineTick);
+    void cascade(int level);
+    // the next tick at which an occupied slot is fired or cascaded
+    [[nodiscard]] uint64_t nextBusyTick() const;
+    void addToSlot(int level, uint64_t index, TimerId id);
+    Slot takeSlot(int level, uint64_t index);
+
+    AppClock::Duration resolution_;
+    AppClock::TimePoint origin_;
+    uint64_t currentTick_ = 0;
+    TimerId lastId_ = INVALID_ID;
+
+    std::array<std::array<Slot, SLOTS>, LEVELS> wheel_;
+    std::array<uint64_t, LEVELS> occupied_{}; // by slot, the cancelled timers leave their bits set
+    std::unordered_map<TimerId, Timer> timers_;
+};
+
+} // namespace litelockr
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WIN_TYPES_H
+#define WIN_TYPES_H
+
+//
+// The geometry types and DWORD of the Windows API, defined off Windows for the portable code
+//
+#ifdef _WIN32
+#include <windows.h>
+#else
+using DWORD = unsigned long;
+
+struct POINT {
+    long x;
+    long y;
+};
+
+struct SIZE {
+    long cx;
+    long cy;
+};
+
+struct RECT {
+    long left;
+    long top;
+    long right;
+    long bottom;
+};
+#endif
+
+#endif // WIN_TYPES_H
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AudioEngine.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+AudioEngine::AudioEngine(std::unique_ptr<AudioOutput> output, const AudioFormat& format)
+        : output_(std::move(output)), format_(format) {
+    assert(output_);
+    assert(format_.channels >= 1 && format_.channels <= 2);
+}
+
+AudioEngine::~AudioEngine() {
+    stop();
+}
+
+bool AudioEngine::addSound(int soundId, const uint8_t *data, size_t size) {
+    assert(!thread_.joinable()); // the sounds are read by the worker without locking
+
+    auto sound = WavSound::parse(data, size, format_);
+    if (!sound) {
+        LOG_ERROR(L"[AudioEngine] Cannot parse the sound %d", soundId);
+        return false;
+    }
+    sounds_.insert_or_assign(soundId, std::move(*sound));
+    return true;
+}
+
+void AudioEngine::start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    exitFlag_ = false;
+    thread_ = std::thread(&AudioEngine::threadProc, this);
+}
+
+void AudioEngine::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        exitFlag_ = true;
+    }
+    condVar_.notify_one();
+    thread_.join();
+
+    auto stats = statistics();
+    LOG_DEBUG(L"[AudioEngine] Played: %u, cut: %u, dropped: %u, max latency: %lld us",
+              stats.played, stats.cut, stats.dropped,
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                      stats.maxLatency).count()));
+}
+
+bool AudioEngine::play(int soundId) {
+    auto it = sounds_.find(soundId);
+    if (it == sounds_.end()) {
+        LOG_ERROR(L"[AudioEngine] Unknown sound %d", soundId);
+        return false;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        if (requestCount_ == MAX_REQUESTS) {
+            ++stats_.dropped;
+            return false;
+        }
+        requests_[(requestHead_ + requestCount_) % MAX_REQUESTS] = {&it->second, AppClock::now()};
+        ++requestCount_;
+    }
+    condVar_.notify_one();
+    return true;
+}
+
+AudioStatistics AudioEngine::statistics() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+void AudioEngine::threadProc() {
+    for (;;) {
+        bool resetOutput;
+        {
+            std::unique_lock lock(mutex_);
+            if (!hasActiveVoice()) {
+                auto hasWork = [this] { return exitFlag_ || requestCount_ > 0; };
+                if (output_->isOpen()) {
+                    if (!condVar_.wait_for(lock, IDLE_CLOSE_TIME, hasWork)) {
+                        output_->close(); // releases the device while there is nothing to play
+                        continue;
+                    }
+                } else {
+                    condVar_.wait(lock, hasWork);
+                }
+            }
+            if (exitFlag_) {
+                break;
+            }
+            resetOutput = takeRequests();
+        }
+
+        if (!hasActiveVoice()) {
+            continue;
+        }
+        if (!output_->isOpen() && !output_->open(format_, BLOCK_FRAMES)) {
+            LOG_ERROR(L"[AudioEngine] Cannot open the audio output");
+            voices_.fill({});
+            continue;
+        }
+        if (resetOutput) {
+            output_->reset();
+        }
+
+        size_t frames = mixBlock();
+        if (frames > 0) {
+            output_->write(block_.data(), frames);
+        }
+    }
+
+    if (output_->isOpen()) {
+        output_->reset();
+        output_->close();
+    }
+}
+
+// returns true if a playing sound was cut, so the queued blocks have to be dropped
+bool AudioEngine::takeRequests() {
+    bool cut = false;
+
+    while (requestCount_ > 0) {
+        auto overlap = overlap_.load();
+        if (overlap == SoundOverlap::QUEUE && hasActiveVoice()) {
+            break; // waits until the playing sound has finished
+        }
+
+        Request request = requests_[requestHead_];
+        requestHead_ = (requestHead_ + 1) % MAX_REQUESTS;
+        --requestCount_;
+
+        Voice *voice = nullptr;
+        if (overlap == SoundOverlap::CUT) {
+            for (auto& v: voices_) {
+                if (v.sound) {
+                    v.sound = nullptr;
+                    ++stats_.cut;
+                    cut = true;
+                }
+            }
+            voice = &voices_[0];
+        } else {
+            auto freeVoice = std::find_if(voices_.begin(), voices_.end(), [](const Voice& v) {
+                return !v.sound;
+            });
+            if (freeVoice != voices_.end()) {
+                voice = &*freeVoice;
+            } else {
+                // replaces the sound which has played the longest
+                voice = &*std::max_element(voices_.begin(), voices_.end(), [](const Voice& a, const Voice& b) {
+                    return a.position < b.position;
+                });
+                ++stats_.cut;
+            }
+        }
+        startVoice(*voice, request);
+    }
+    return cut;
+}
+
+void AudioEngine::startVoice(Voice& voice, const Request& request) {
+    voice.sound = request.sound;
+    voice.position = 0;
+
+    auto latency = AppClock::now() - request.time;
+    stats_.lastLatency = latency;
+    stats_.maxLatency = std::max(stats_.maxLatency, latency);
+    ++stats_.played;
+}
+
+size_t AudioEngine::mixBlock() {
+    const size_t channels = format_.channels;
+    size_t frames = 0;
+
+    mixBuffer_.fill(0);
+    for (auto& voice: voices_) {
+        if (!voice.sound) {
+            continue;
+        }
+        size_t count = std::min(BLOCK_FRAMES, voice.sound->frames() - voice.position);
+        const int16_t *src = voice.sound->samples() + voice.position * channels;
+        for (size_t i = 0; i < count * channels; ++i) {
+            mixBuffer_[i] += src[i];
+        }
+
+        voice.position += count;
+        frames = std::max(frames, count);
+        if (voice.position >= voice.sound->frames()) {
+            voice.sound = nullptr;
+        }
+    }
+
+    constexpr int32_t minSample = std::numeric_limits<int16_t>::min();
+    constexpr int32_t maxSample = std::numeric_limits<int16_t>::max();
+    for (size_t i = 0; i < frames * channels; ++i) {
+        block_[i] = static_cast<int16_t>(std::clamp(mixBuffer_[i], minSample, maxSample));
+    }
+    return frames;
+}
+
+bool AudioEngine::hasActiveVoice() const {
+    return std::any_of(voices_.begin(), voices_.end(), [](const Voice& v) { return v.sound != nullptr; });
+}
+
+} // namespace litelockr
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "sys/AppClock.h"
+#include "sys/audio/AudioOutput.h"
+#include "sys/audio/WavSound.h"
+
+namespace litelockr {
+
+enum class SoundOverlap {
+    CUT = 0,    // a new sound stops the playing one
+    MIX = 1,    // the sounds are played together
+    QUEUE = 2,  // a new sound waits until the playing one has finished
+};
+
+struct AudioStatistics {
+    unsigned int played = 0;
+    unsigned int cut = 0;
+    unsigned int dropped = 0;
+    AppClock::Duration lastLatency{};
+    AppClock::Duration maxLatency{};
+};
+
+//
+// Plays the preparsed sounds on a single worker thread.
+// The sounds are mixed in short blocks, so a new sound starts with the next block.
+//
+class AudioEngine {
+public:
+    constexpr static AudioFormat DEFAULT_FORMAT{2, 44100};
+    constexpr static size_t BLOCK_FRAMES = 441;        // 10 ms at 44100 Hz
+    constexpr static size_t MAX_VOICES = 4;
+    constexpr static size_t MAX_REQUESTS = 16;
+    constexpr static auto IDLE_CLOSE_TIME = std::chrono::seconds(5);
+
+    explicit AudioEngine(std::unique_ptr<AudioOutput> output, const AudioFormat& format = DEFAULT_FORMAT);
+    ~AudioEngine();
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // the sounds must be added before the engine is started
+    bool addSound(int soundId, const uint8_t *data, size_t size);
+
+    void start();
+    void stop();
+
+    // non-blocking, returns false if the sound is unknown or the queue is full
+    bool play(int soundId);
+
+    void setOverlap(SoundOverlap overlap) { overlap_ = overlap; }
+    [[nodiscard]] SoundOverlap overlap() const { return overlap_; }
+
+    [[nodiscard]] AudioStatistics statistics() const;
+
+private:
+    struct Request {
+        const WavSound *sound;
+        AppClock::TimePoint time;
+    };
+
+    struct Voice {
+        const WavSound *sound = nullptr;
+        size_t position = 0;
+    };
+
+    void threadProc();
+    bool takeRequests();
+    void startVoice(Voice& voice, const Request& request);
+    size_t mixBlock();
+    [[nodiscard]] bool hasActiveVoice() const;
+
+    std::unique_ptr<AudioOutput> output_;
+    AudioFormat format_;
+    std::atomic<SoundOverlap> overlap_ = SoundOverlap::CUT;
+    std::unordered_map<int, WavSound> sounds_;
+
+    //
+    // Request queue (guarded by mutex_)
+    //
+    mutable std::mutex mutex_;
+    std::condition_variable condVar_;
+    std::array<Request, MAX_REQUESTS> requests_{};
+    size_t requestHead_ = 0;
+    size_t requestCount_ = 0;
+    bool exitFlag_ = false;
+    AudioStatistics stats_;
+
+    //
+    // Worker state
+    //
+    std::thread thread_;
+    std::array<Voice, MAX_VOICES> voices_{};
+    std::array<int32_t, BLOCK_FRAMES * 2> mixBuffer_{};
+    std::array<int16_t, BLOCK_FRAMES * 2> block_{};
+};
+
+} // namespace litelockr
+
+#endif // AUDIO_ENGINE_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AudioOutput.h"
+
+#include <cassert>
+#include <thread>
+
+namespace litelockr {
+
+bool NullAudioOutput::open(const AudioFormat& format, size_t blockFrames) {
+    assert(!open_);
+    assert(format.channels > 0 && format.sampleRate > 0);
+
+    format_ = format;
+    blockFrames_ = blockFrames;
+    startTime_ = AppClock::now();
+    queuedFrames_ = 0;
+    open_ = true;
+    return true;
+}
+
+void NullAudioOutput::close() {
+    open_ = false;
+}
+
+bool NullAudioOutput::write(const int16_t *samples, size_t frames) {
+    assert(open_);
+    assert(samples && frames <= blockFrames_);
+
+    auto now = AppClock::now();
+    if (playbackEnd() < now) {
+        // the device has run dry
+        startTime_ = now;
+        queuedFrames_ = 0;
+    }
+
+    // waits until one of the buffers has been played
+    auto bufferedTime = format_.duration(blockFrames_ * (bufferCount_ - 1));
+    auto freeTime = playbackEnd() - bufferedTime;
+    if (freeTime > now) {
+        std::this_thread::sleep_until(freeTime);
+    }
+
+    queuedFrames_ += frames;
+    framesWritten_ += frames;
+    ++blocksWritten_;
+    return true;
+}
+
+void NullAudioOutput::reset() {
+    startTime_ = AppClock::now();
+    queuedFrames_ = 0;
+    ++resets_;
+}
+
+AppClock::TimePoint NullAudioOutput::playbackEnd() const {
+    return startTime_ + format_.duration(queuedFrames_);
+}
+
+} // namespace litelockr
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIO_OUTPUT_H
+#define AUDIO_OUTPUT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sys/AppClock.h"
+
+namespace litelockr {
+
+struct AudioFormat {
+    unsigned int channels;
+    unsigned int sampleRate;
+
+    // 16-bit PCM samples only
+    constexpr static unsigned int BITS_PER_SAMPLE = 16;
+
+    [[nodiscard]] size_t frameSize() const { return channels * sizeof(int16_t); }
+
+    [[nodiscard]] AppClock::Duration duration(size_t frames) const {
+        return std::chrono::duration_cast<AppClock::Duration>(
+                std::chrono::microseconds(frames * 1'000'000 / sampleRate));
+    }
+
+    bool operator==(const AudioFormat&) const = default;
+};
+
+//
+// The device the audio engine writes the mixed blocks to
+//
+class AudioOutput {
+public:
+    // the blocks queued to the device, 60 ms of the 10 ms blocks of the engine ride out a late worker
+    constexpr static size_t BUFFER_COUNT = 6;
+
+    virtual ~AudioOutput() = default;
+
+    virtual bool open(const AudioFormat& format, size_t blockFrames) = 0;
+    virtual void close() = 0;
+    [[nodiscard]] virtual bool isOpen() const = 0;
+
+    // blocks until the device accepts the samples
+    virtual bool write(const int16_t *samples, size_t frames) = 0;
+
+    // drops the blocks which are not played yet
+    virtual void reset() = 0;
+};
+
+//
+// Discards the samples but consumes them in real time, like a device with the given number of buffers
+//
+class NullAudioOutput: public AudioOutput {
+public:
+    explicit NullAudioOutput(size_t bufferCount = BUFFER_COUNT) : bufferCount_(bufferCount) {}
+
+    bool open(const AudioFormat& format, size_t blockFrames) override;
+    void close() override;
+    [[nodiscard]] bool isOpen() const override { return open_; }
+
+    bool write(const int16_t *samples, size_t frames) override;
+    void reset() override;
+
+    [[nodiscard]] size_t framesWritten() const { return framesWritten_; }
+    [[nodiscard]] unsigned int blocksWritten() const { return blocksWritten_; }
+    [[nodiscard]] unsigned int resets() const { return resets_; }
+
+private:
+    [[nodiscard]] AppClock::TimePoint playbackEnd() const;
+
+    size_t bufferCount_;
+    bool open_ = false;
+    AudioFormat format_{};
+    size_t blockFrames_ = 0;
+
+    AppClock::TimePoint startTime_;
+    size_t queuedFrames_ = 0; // since startTime_
+    size_t framesWritten_ = 0;
+    unsigned int blocksWritten_ = 0;
+    unsigned int resets_ = 0;
+};
+
+} // namespace litelockr
+
+#endif // AUDIO_OUTPUT_H
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WavSound.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM_TAG = 1;
+
+uint32_t readU32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t readU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+} // namespace
+
+std::optional<WavSound> WavSound::parse(const uint8_t *data, size_t size, const AudioFormat& outputFormat) {
+    if (!data || size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        LOG_ERROR(L"[WavSound] Not a RIFF/WAVE file");
+        return std::nullopt;
+    }
+
+    const uint8_t *fmt = nullptr;
+    const uint8_t *pcm = nullptr;
+    size_t pcmSize = 0;
+
+    //
+    // Chunks
+    //
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = data + pos;
+        size_t chunkSize = readU32(chunk + 4);
+        size_t available = size - pos - 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && chunkSize <= available) {
+            fmt = chunk + 8;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = chunk + 8;
+            pcmSize = std::min(chunkSize, available);
+        }
+        pos += 8 + chunkSize + (chunkSize & 1); // chunks are word-aligned
+    }
+
+    if (!fmt || !pcm) {
+        LOG_ERROR(L"[WavSound] The fmt or data chunk is missing");
+        return std::nullopt;
+    }
+
+    uint16_t formatTag = readU16(fmt);
+    uint16_t channels = readU16(fmt + 2);
+    uint32_t sampleRate = readU32(fmt + 4);
+    uint16_t bitsPerSample = readU16(fmt + 14);
+
+    if (formatTag != WAVE_FORMAT_PCM_TAG || bitsPerSample != AudioFormat::BITS_PER_SAMPLE
+        || channels < 1 || channels > 2 || outputFormat.channels < 1 || outputFormat.channels > 2) {
+        LOG_ERROR(L"[WavSound] Unsupported format: tag=%u, channels=%u, bits=%u",
+                  formatTag, channels, bitsPerSample);
+        return std::nullopt;
+    }
+    if (sampleRate == 0 || outputFormat.sampleRate == 0) {
+        LOG_ERROR(L"[WavSound] Unsupported sample rate: %u Hz", sampleRate);
+        return std::nullopt;
+    }
+
+    WavSound sound;
+    sound.format_ = outputFormat;
+    sound.frames_ = pcmSize / (channels * sizeof(int16_t));
+    sound.samples_.resize(sound.frames_ * outputFormat.channels);
+
+    auto out = sound.samples_.data();
+    for (size_t i = 0; i < sound.frames_; ++i) {
+        const uint8_t *frame = pcm + i * channels * sizeof(int16_t);
+        auto left = static_cast<int16_t>(readU16(frame));
+        auto right = channels == 2 ? static_cast<int16_t>(readU16(frame + 2)) : left;
+
+        if (outputFormat.channels == 2) {
+            *out++ = left;
+            *out++ = right;
+        } else {
+            *out++ = static_cast<int16_t>((left + right) / 2);
+        }
+    }
+
+    if (sampleRate != outputFormat.sampleRate) {
+        LOG_DEBUG(L"[WavSound] Resampling from %u Hz to %u Hz", sampleRate, outputFormat.sampleRate);
+        sound.resample(sampleRate);
+    }
+    return sound;
+}
+
+// linear interpolation, enough for the short interface sounds
+void WavSound::resample(unsigned int sourceRate) {
+    const size_t channels = format_.channels;
+    const int64_t targetRate = format_.sampleRate;
+    const auto frames = static_cast<size_t>(static_cast<int64_t>(frames_) * targetRate / sourceRate);
+
+    std::vector<int16_t> samples(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        const int64_t position = static_cast<int64_t>(i) * sourceRate;
+        const auto first = static_cast<size_t>(position / targetRate);
+        const size_t second = std::min(first + 1, frames_ - 1);
+        const int64_t fraction = position % targetRate;
+
+        for (size_t c = 0; c < channels; ++c) {
+            const int64_t a = samples_[first * channels + c];
+            const int64_t b = samples_[second * channels + c];
+            samples[i * channels + c] = static_cast<int16_t>(a + (b - a) * fraction / targetRate);
+        }
+    }
+
+    frames_ = frames;
+    samples_ = std::move(samples);
+}
+
+} // namespace litelockr
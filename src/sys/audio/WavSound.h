@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAV_SOUND_H
+#define WAV_SOUND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sys/audio/AudioOutput.h"
+
+namespace litelockr {
+
+//
+// 16-bit PCM samples of a .WAV file, converted to the output channel count and sample rate
+//
+class WavSound {
+public:
+    static std::optional<WavSound> parse(const uint8_t *data, size_t size, const AudioFormat& outputFormat);
+
+    [[nodiscard]] const int16_t *samples() const { return samples_.data(); }
+    [[nodiscard]] size_t frames() const { return frames_; }
+    [[nodiscard]] const AudioFormat& format() const { return format_; }
+
+private:
+    void resample(unsigned int sourceRate);
+
+    AudioFormat format_{};
+    size_t frames_ = 0;
+    std::vector<int16_t> samples_;
+};
+
+} // namespace litelockr
+
+#endif // WAV_SOUND_H
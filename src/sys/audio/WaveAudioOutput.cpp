@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WaveAudioOutput.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "log/Logger.h"
+
+namespace litelockr {
+
+WaveAudioOutput::~WaveAudioOutput() {
+    close();
+}
+
+bool WaveAudioOutput::open(const AudioFormat& format, size_t blockFrames) {
+    assert(!waveOut_);
+
+    doneEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!doneEvent_) {
+        return false;
+    }
+
+    WAVEFORMATEX wfx = {};
+    wfx.wFormatTag = WAVE_FORMAT_PCM;
+    wfx.nChannels = static_cast<WORD>(format.channels);
+    wfx.nSamplesPerSec = format.sampleRate;
+    wfx.wBitsPerSample = AudioFormat::BITS_PER_SAMPLE;
+    wfx.nBlockAlign = static_cast<WORD>(format.frameSize());
+    wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
+
+    MMRESULT res = waveOutOpen(&waveOut_, WAVE_MAPPER, &wfx, reinterpret_cast<DWORD_PTR>(doneEvent_),
+                               0, CALLBACK_EVENT);
+    if (res != MMSYSERR_NOERROR) {
+        LOG_ERROR(L"[WaveAudioOutput] waveOutOpen failed: %u", res);
+        waveOut_ = nullptr;
+        CloseHandle(doneEvent_);
+        doneEvent_ = nullptr;
+        return false;
+    }
+
+    format_ = format;
+    blockFrames_ = blockFrames;
+    for (size_t i = 0; i < BUFFER_COUNT; ++i) {
+        buffers_[i].resize(blockFrames * format.channels);
+        headers_[i] = {};
+    }
+    nextBuffer_ = 0;
+    return true;
+}
+
+void WaveAudioOutput::close() {
+    if (waveOut_) {
+        waveOutReset(waveOut_);
+        for (auto& header: headers_) {
+            if (header.dwFlags & WHDR_PREPARED) {
+                waveOutUnprepareHeader(waveOut_, &header, sizeof(WAVEHDR));
+            }
+        }
+        waveOutClose(waveOut_);
+        waveOut_ = nullptr;
+    }
+    if (doneEvent_) {
+        CloseHandle(doneEvent_);
+        doneEvent_ = nullptr;
+    }
+}
+
+bool WaveAudioOutput::write(const int16_t *samples, size_t frames) {
+    assert(waveOut_);
+    assert(frames <= blockFrames_);
+
+    auto& header = headers_[nextBuffer_];
+    if (!waitForBuffer(header)) {
+        return false;
+    }
+
+    auto& buffer = buffers_[nextBuffer_];
+    std::memcpy(buffer.data(), samples, frames * format_.frameSize());
+
+    header = {};
+    header.lpData = reinterpret_cast<LPSTR>(buffer.data());
+    header.dwBufferLength = static_cast<DWORD>(frames * format_.frameSize());
+
+    if (waveOutPrepareHeader(waveOut_, &header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+        return false;
+    }
+    if (waveOutWrite(waveOut_, &header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+        waveOutUnprepareHeader(waveOut_, &header, sizeof(WAVEHDR));
+        return false;
+    }
+    nextBuffer_ = (nextBuffer_ + 1) % BUFFER_COUNT;
+    return true;
+}
+
+void WaveAudioOutput::reset() {
+    if (waveOut_) {
+        waveOutReset(waveOut_); // marks all the queued buffers as done
+    }
+}
+
+bool WaveAudioOutput::waitForBuffer(WAVEHDR& header) {
+    if (!(header.dwFlags & WHDR_PREPARED)) {
+        return true;
+    }
+    while (!(header.dwFlags & WHDR_DONE)) {
+        if (WaitForSingleObject(doneEvent_, WAIT_TIMEOUT_MS) == WAIT_TIMEOUT && !(header.dwFlags & WHDR_DONE)) {
+            LOG_WARNING(L"[WaveAudioOutput] The device does not respond");
+            return false;
+        }
+    }
+    waveOutUnprepareHeader(waveOut_, &header, sizeof(WAVEHDR));
+    return true;
+}
+
+} // namespace litelockr
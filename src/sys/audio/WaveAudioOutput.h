@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVE_AUDIO_OUTPUT_H
+#define WAVE_AUDIO_OUTPUT_H
+
+#include <array>
+#include <vector>
+
+#include <windows.h>
+#include "sys/audio/AudioOutput.h"
+
+namespace litelockr {
+
+//
+// waveOut device with a ring of buffers, a finished buffer signals the event
+//
+class WaveAudioOutput: public AudioOutput {
+public:
+    constexpr static DWORD WAIT_TIMEOUT_MS = 500;
+
+    WaveAudioOutput() = default;
+    ~WaveAudioOutput() override;
+
+    WaveAudioOutput(const WaveAudioOutput&) = delete;
+    WaveAudioOutput& operator=(const WaveAudioOutput&) = delete;
+
+    bool open(const AudioFormat& format, size_t blockFrames) override;
+    void close() override;
+    [[nodiscard]] bool isOpen() const override { return waveOut_ != nullptr; }
+
+    bool write(const int16_t *samples, size_t frames) override;
+    void reset() override;
+
+private:
+    bool waitForBuffer(WAVEHDR& header);
+
+    HWAVEOUT waveOut_ = nullptr;
+    HANDLE doneEvent_ = nullptr;
+    AudioFormat format_{};
+    size_t blockFrames_ = 0;
+
+    std::array<WAVEHDR, BUFFER_COUNT> headers_{};
+    std::array<std::vector<int16_t>, BUFFER_COUNT> buffers_;
+    size_t nextBuffer_ = 0;
+};
+
+} // namespace litelockr
+
+#endif // WAVE_AUDIO_OUTPUT_H
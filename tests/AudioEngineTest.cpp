@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sys/audio/AudioEngine.h"
+#include "Check.h"
+
+using namespace litelockr;
+using namespace std::chrono_literals;
+
+namespace {
+
+void putU16(std::vector<uint8_t>& data, unsigned value) {
+    data.push_back(static_cast<uint8_t>(value));
+    data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t>& data, uint32_t value) {
+    putU16(data, value & 0xFFFF);
+    putU16(data, value >> 16);
+}
+
+// a 16-bit PCM file, the samples are interleaved
+std::vector<uint8_t> makeWav(unsigned channels, unsigned sampleRate, const std::vector<int16_t>& samples) {
+    std::vector<uint8_t> data;
+    const auto pcmSize = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+    data.insert(data.end(), {'R', 'I', 'F', 'F'});
+    putU32(data, 36 + pcmSize);
+    data.insert(data.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    putU32(data, 16);
+    putU16(data, 1);
+    putU16(data, channels);
+    putU32(data, sampleRate);
+    putU32(data, sampleRate * channels * 2);
+    putU16(data, channels * 2);
+    putU16(data, 16);
+    data.insert(data.end(), {'d', 'a', 't', 'a'});
+    putU32(data, pcmSize);
+    for (auto sample: samples) {
+        putU16(data, static_cast<uint16_t>(sample));
+    }
+    return data;
+}
+
+std::vector<uint8_t> makeTone(AppClock::Duration duration) {
+    const auto frames = static_cast<size_t>(44100 * duration / 1s);
+    std::vector<int16_t> samples(frames * 2);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<int16_t>((i / 2) % 100 * 100 - 5000);
+    }
+    return makeWav(2, 44100, samples);
+}
+
+// the sounds embedded into the resources are played without conversion
+void testBundledSounds() {
+    for (const char *name: {"StartLocking", "FinishLocking", "Unlock", "Cancel", "Shake", "Wrong"}) {
+        std::ifstream file(std::string(RES_DIR) + "/sound/" + name + ".wav", std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CHECK(data.size() > 44);
+        CHECK(std::memcmp(data.data() + 22, "\x02\x00\x44\xAC\x00\x00", 6) == 0); // stereo, 44100 Hz
+
+        auto sound = WavSound::parse(data.data(), data.size(), AudioEngine::DEFAULT_FORMAT);
+        CHECK(sound && sound->frames() == (data.size() - 44) / 4);
+    }
+}
+
+void testResample() {
+    // a mono ramp at the half rate gets the samples in between
+    std::vector<int16_t> ramp;
+    for (int i = 0; i < 100; i++) {
+        ramp.push_back(static_cast<int16_t>(i * 100));
+    }
+    auto data = makeWav(1, 22050, ramp);
+    auto sound = WavSound::parse(data.data(), data.size(), AudioEngine::DEFAULT_FORMAT);
+    CHECK(sound && sound->frames() == 200);
+    CHECK(sound && sound->samples()[2 * 21] == 1050 && sound->samples()[2 * 21 + 1] == 1050);
+    CHECK(sound && sound->samples()[2 * 20] == 1000 && sound->samples()[2 * 22] == 1100);
+
+    // a stereo file at 48000 Hz keeps its length
+    std::vector<int16_t> stereo(48000 / 10 * 2, 1234);
+    data = makeWav(2, 48000, stereo);
+    sound = WavSound::parse(data.data(), data.size(), AudioEngine::DEFAULT_FORMAT);
+    CHECK(sound && sound->frames() == 4410);
+    CHECK(sound && sound->samples()[0] == 1234 && sound->samples()[4410 * 2 - 1] == 1234);
+
+    data = makeWav(2, 0, stereo);
+    CHECK(!WavSound::parse(data.data(), data.size(), AudioEngine::DEFAULT_FORMAT));
+}
+
+//
+// The null output consumes the blocks in real time, the counters are read after the worker has stopped
+//
+void testTiming() {
+    const auto tone = makeTone(300ms);
+    constexpr size_t TONE_FRAMES = 44100 * 3 / 10;
+    constexpr size_t TONE_BLOCKS = TONE_FRAMES / AudioEngine::BLOCK_FRAMES;
+
+    // the queue of the device is filled at once, the rest follows the playback
+    {
+        auto output = std::make_unique<NullAudioOutput>();
+        auto& null = *output;
+        AudioEngine engine(std::move(output));
+        CHECK(engine.addSound(1, tone.data(), tone.size()));
+        engine.start();
+        CHECK(engine.play(1));
+        std::this_thread::sleep_for(150ms);
+        engine.stop();
+
+        CHECK(null.blocksWritten() >= AudioOutput::BUFFER_COUNT);
+        CHECK(null.blocksWritten() < TONE_BLOCKS);
+    }
+
+    // a whole sound, then a cut one
+    {
+        auto output = std::make_unique<NullAudioOutput>();
+        auto& null = *output;
+        AudioEngine engine(std::move(output));
+        CHECK(engine.addSound(1, tone.data(), tone.size()));
+        CHECK(!engine.play(2));
+        engine.start();
+
+        CHECK(engine.play(1));
+        std::this_thread::sleep_for(400ms);
+        CHECK(engine.play(1));
+        std::this_thread::sleep_for(50ms);
+        CHECK(engine.play(1));
+        std::this_thread::sleep_for(400ms);
+        engine.stop();
+
+        const auto stats = engine.statistics();
+        CHECK(stats.played == 3 && stats.cut == 1 && stats.dropped == 0);
+        CHECK(stats.maxLatency < 100ms);
+        CHECK(null.resets() == 2); // the cut and the stop
+        CHECK(null.framesWritten() > 2 * TONE_FRAMES && null.framesWritten() < 3 * TONE_FRAMES);
+    }
+
+    // the mixed sounds take the time of one
+    {
+        auto output = std::make_unique<NullAudioOutput>();
+        auto& null = *output;
+        AudioEngine engine(std::move(output));
+        engine.setOverlap(SoundOverlap::MIX);
+        CHECK(engine.addSound(1, tone.data(), tone.size()));
+        engine.start();
+        CHECK(engine.play(1) && engine.play(1));
+        std::this_thread::sleep_for(400ms);
+        engine.stop();
+
+        const auto stats = engine.statistics();
+        CHECK(stats.played == 2 && stats.cut == 0);
+        CHECK(null.framesWritten() >= TONE_FRAMES && null.framesWritten() < 2 * TONE_FRAMES);
+        CHECK(null.resets() == 1); // the stop
+    }
+}
+
+} // namespace
+
+int main() {
+    testBundledSounds();
+    testResample();
+    testTiming();
+    return Check::result();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "app/FlyoutResources.h"
+#include "gfx/BakedImage.h"
+#include "gfx/BitmapUtils.h"
+#include "gfx/Lz4.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+//
+// The committed baked images against the PNG files they are baked from: an image changed without baking
+// it again fails here
+//
+namespace {
+
+const std::filesystem::path RES_PATH = RES_DIR;
+
+std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// returns the frames of the strip
+unsigned checkImage(const std::filesystem::path& pngPath) {
+    const auto bakedPath = RES_PATH / "baked" / pngPath.stem().replace_extension(".llbm");
+    const auto png = readFile(pngPath);
+    const auto baked = readFile(bakedPath);
+
+    Bitmap expected;
+    Bitmap actual;
+    unsigned numFrames = 0;
+    const bool same = expected.loadPng(png.data(), png.size()) &&
+                      BakedImage::load(actual, baked.data(), baked.size(), &numFrames) &&
+                      BitmapUtils::equals(actual, expected);
+    if (!same) {
+        std::fprintf(stderr, "%s: run tools/bake_images.py\n", bakedPath.string().c_str());
+    }
+    CHECK(same);
+    return numFrames;
+}
+
+void testImages() {
+    for (const auto& entry: std::filesystem::directory_iterator(RES_PATH / "png")) {
+        if (entry.path().extension() == ".png") {
+            CHECK(checkImage(entry.path()) == 1);
+        }
+    }
+
+    // the frames of the strips come from NumberOfFrames
+    struct {
+        const char *name;
+        int numFrames;
+    } strips[] = {
+            {"StartUp", NumberOfFrames::STARTUP},
+            {"OpenMenu", NumberOfFrames::OPEN_MENU},
+            {"CloseMenu", NumberOfFrames::CLOSE_MENU},
+            {"StartLocking", NumberOfFrames::START_LOCKING},
+            {"FinishLocking", NumberOfFrames::FINISH_LOCKING},
+            {"CannotUnlock", NumberOfFrames::CANNOT_UNLOCK},
+            {"Unlock", NumberOfFrames::UNLOCK},
+    };
+    for (const auto& strip: strips) {
+        const auto path = RES_PATH / "animation" / (std::string(strip.name) + ".png");
+        CHECK(checkImage(path) == static_cast<unsigned>(strip.numFrames));
+    }
+
+    const auto animations = std::filesystem::directory_iterator(RES_PATH / "animation");
+    CHECK(static_cast<size_t>(std::ranges::distance(animations)) == std::size(strips));
+}
+
+// the rows of a bottom-up bitmap, as on Windows, are unpacked from the last one with a negative stride
+void testBottomUpRows() {
+    const auto baked = readFile(RES_PATH / "baked" / "StartLocking.llbm");
+    BakedImage::Header header{};
+    CHECK(baked.size() > sizeof(header));
+    std::memcpy(&header, baked.data(), sizeof(header));
+    CHECK(header.flags & BakedImage::LZ4);
+
+    const uint8_t *data = baked.data() + sizeof(header);
+    std::vector<uint8_t> topDown(header.rawSize);
+    CHECK(Lz4::decompress(data, header.dataSize, topDown.data(), topDown.size()));
+
+    const size_t rowBytes = header.width * 4;
+    std::vector<uint8_t> bottomUp(header.rawSize);
+    uint8_t *lastRow = bottomUp.data() + (header.height - 1) * rowBytes;
+    CHECK(Lz4::decompress(data, header.dataSize, lastRow, -static_cast<ptrdiff_t>(rowBytes), rowBytes,
+                          header.height));
+
+    bool flipped = true;
+    for (size_t y = 0; y < header.height; y++) {
+        flipped = flipped && std::memcmp(topDown.data() + y * rowBytes,
+                                         bottomUp.data() + (header.height - 1 - y) * rowBytes, rowBytes) == 0;
+    }
+    CHECK(flipped);
+}
+
+// the resource script embeds the baked images only
+void testResourceScript() {
+    const auto script = readFile(RES_PATH / "Resources.rc");
+    const std::string text(script.begin(), script.end());
+    const std::regex image(R"(RCDATA\s+"(\w+)\\\\(\w+)\.(png|llbm)\")");
+
+    unsigned numImages = 0;
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), image); it != std::sregex_iterator(); ++it) {
+        const auto& match = *it;
+        CHECK(match[1] == "baked" && match[3] == "llbm");
+        CHECK(std::filesystem::exists(RES_PATH / "baked" / (match[2].str() + ".llbm")));
+        numImages++;
+    }
+    CHECK(numImages == 28);
+}
+
+} // namespace
+
+int main() {
+    testImages();
+    testBottomUpRows();
+    testResourceScript();
+    return Check::result();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "gfx/Bitmap.h"
+#include "gfx/BitmapStorage.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+uint32_t pixel(const Bitmap& bitmap, int x, int y) {
+    uint32_t value;
+    std::memcpy(&value, bitmap.pixFmt().pix_ptr(x, y), sizeof(value));
+    return value;
+}
+
+constexpr uint32_t bgra(uint8_t b, uint8_t g, uint8_t r, uint8_t a) {
+    return b | g << 8 | r << 16 | static_cast<uint32_t>(a) << 24;
+}
+
+void testHeapStorage() {
+    auto storage = HeapBitmapStorage::create(33, 7);
+    CHECK(storage);
+    CHECK(storage->width() == 33);
+    CHECK(storage->height() == 7);
+    // every row starts aligned
+    CHECK(storage->stride() == 192);
+    CHECK(reinterpret_cast<uintptr_t>(storage->bits()) % HeapBitmapStorage::ALIGNMENT == 0);
+
+    bool zeroed = true;
+    for (size_t i = 0; i < 192 * 7; i++) {
+        zeroed = zeroed && storage->bits()[i] == 0;
+    }
+    CHECK(zeroed);
+}
+
+void testFillAndBlend() {
+    Bitmap bitmap;
+    CHECK(bitmap.create(16, 8));
+    CHECK(bitmap.width() == 16 && bitmap.height() == 8);
+
+    bitmap.clear(Color(0, 0, 0, 0));
+    bitmap.fillRect(2, 1, 4, 3, Color(255, 0, 0, 255));
+    CHECK(pixel(bitmap, 2, 1) == bgra(0, 0, 255, 255));
+    CHECK(pixel(bitmap, 5, 3) == bgra(0, 0, 255, 255));
+    CHECK(pixel(bitmap, 6, 3) == 0);
+    CHECK(pixel(bitmap, 2, 4) == 0);
+
+    // straight colors are stored premultiplied
+    bitmap.fillRect(8, 0, 1, 1, Color(255, 255, 255, 128));
+    CHECK(pixel(bitmap, 8, 0) == bgra(128, 128, 128, 128));
+
+    Bitmap src;
+    CHECK(src.create(4, 4));
+    src.clear(Color(0, 0, 255, 255));
+    bitmap.blendFrom(src, 0, 4);
+    CHECK(pixel(bitmap, 3, 7) == bgra(255, 0, 0, 255));
+}
+
+void testSharing() {
+    Bitmap bitmap;
+    CHECK(bitmap.create(8, 6));
+    bitmap.clear(Color(0, 255, 0, 255));
+
+    const auto statsBefore = Bitmap::sharingStatistics();
+
+    Bitmap clone;
+    CHECK(clone.clone(bitmap));
+    CHECK(bitmap.isShared() && clone.isShared());
+    CHECK(std::as_const(clone).pixFmt().pix_ptr(0, 0) == std::as_const(bitmap).pixFmt().pix_ptr(0, 0));
+
+    Bitmap view;
+    CHECK(view.view(bitmap, 2, 3));
+    CHECK(view.width() == 8 && view.height() == 3);
+    CHECK(std::as_const(view).pixFmt().pix_ptr(0, 0) == std::as_const(bitmap).pixFmt().pix_ptr(0, 2));
+
+    // the writer gets its own copy, the others keep the pixels
+    view.fillRect(0, 0, 8, 1, Color(0, 0, 255, 255));
+    CHECK(!view.isShared());
+    CHECK(pixel(view, 0, 0) == bgra(255, 0, 0, 255));
+    CHECK(pixel(bitmap, 0, 2) == bgra(0, 255, 0, 255));
+    CHECK(pixel(clone, 0, 2) == bgra(0, 255, 0, 255));
+
+    const auto statsAfter = Bitmap::sharingStatistics();
+    CHECK(statsAfter.sharedBytes - statsBefore.sharedBytes == (8 * 6 + 8 * 3) * 4);
+    CHECK(statsAfter.copiedBytes - statsBefore.copiedBytes == 8 * 3 * 4);
+}
+
+} // namespace
+
+int main() {
+    testHeapStorage();
+    testFillAndBlend();
+    testSharing();
+    return Check::result();
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <cstdio>
+
+//
+// The assertions of the tests, a failed check is reported and the test goes on. The test returns
+// Check::result() from main().
+//
+namespace litelockr::Check {
+
+inline int failures = 0;
+
+inline void fail(const char *file, int line, const char *expression) {
+    std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, expression);
+    failures++;
+}
+
+inline int result() {
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+    }
+    return failures ? 1 : 0;
+}
+
+} // namespace litelockr::Check
+
+#define CHECK(expression) \
+    ((expression) ? static_cast<void>(0) : litelockr::Check::fail(__FILE__, __LINE__, #expression))
+
+#endif // TEST_CHECK_H
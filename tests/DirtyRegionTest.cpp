@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gfx/DirtyRegion.h"
+#include "sys/Rectangle.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+bool same(const RECT& a, const RECT& b) {
+    return Rectangle::equals(a, b);
+}
+
+void testEmpty() {
+    DirtyRegion region;
+    CHECK(region.empty());
+    CHECK(region.rects().empty());
+    CHECK(same(region.bounds(), {}));
+    CHECK(region.area() == 0);
+
+    // without a size everything is clipped away
+    region.add({0, 0, 10, 10});
+    region.addAll();
+    CHECK(region.empty());
+
+    region.setSize(100, 50);
+    region.clear();
+    region.add({20, 20, 20, 30}); // no width
+    region.add({20, 30, 25, 10}); // upside down
+    region.add({-10, 10, 0, 20}); // outside on the left
+    region.add({100, 0, 120, 50}); // outside on the right
+    CHECK(region.empty());
+    CHECK(region.area() == 0);
+}
+
+void testSize() {
+    DirtyRegion region;
+    region.setSize(100, 50);
+    // a new size invalidates the whole buffer
+    CHECK(region.rects().size() == 1);
+    CHECK(same(region.bounds(), {0, 0, 100, 50}));
+    CHECK(region.area() == 5000);
+
+    region.clear();
+    region.setSize(100, 50);
+    CHECK(region.empty());
+
+    region.add({-5, 40, 10, 70});
+    CHECK(same(region.bounds(), {0, 40, 10, 50}));
+
+    region.setSize(30, 30);
+    CHECK(same(region.bounds(), {0, 0, 30, 30}));
+}
+
+void testMerge() {
+    DirtyRegion region;
+    region.setSize(200, 200);
+    region.clear();
+
+    region.add({10, 10, 20, 20});
+    region.add({30, 10, 40, 20});
+    CHECK(region.rects().size() == 2);
+    CHECK(region.area() == 200);
+
+    // contained in a rectangle already there
+    region.add({12, 12, 18, 18});
+    CHECK(region.rects().size() == 2);
+
+    // touching is not overlapping
+    region.add({20, 10, 30, 20});
+    CHECK(region.rects().size() == 3);
+    CHECK(region.area() == 300);
+
+    // overlaps all three, they become one
+    region.add({15, 15, 35, 25});
+    CHECK(region.rects().size() == 1);
+    CHECK(same(region.rects().front(), {10, 10, 40, 25}));
+
+    // the union overlaps a rectangle the added one does not
+    region.clear();
+    region.add({0, 0, 10, 10});
+    region.add({50, 0, 60, 10});
+    region.add({5, 5, 52, 8});
+    CHECK(region.rects().size() == 1);
+    CHECK(same(region.rects().front(), {0, 0, 60, 10}));
+
+    region.clear();
+    region.add({0, 0, 10, 10});
+    region.add({100, 100, 110, 110});
+    region.add({8, 0, 30, 5});
+    region.add({20, 0, 102, 2});
+    CHECK(region.rects().size() == 2);
+    CHECK(same(region.bounds(), {0, 0, 110, 110}));
+    CHECK(same(region.rects().back(), {0, 0, 102, 10}));
+
+    // the rectangles never overlap, each pixel is drawn once
+    bool disjoint = true;
+    for (size_t i = 0; i < region.rects().size(); i++) {
+        for (size_t j = i + 1; j < region.rects().size(); j++) {
+            disjoint = disjoint && !Rectangle::intersects(region.rects()[i], region.rects()[j]);
+        }
+    }
+    CHECK(disjoint);
+}
+
+void testCollapse() {
+    DirtyRegion region;
+    region.setSize(1000, 100);
+    region.clear();
+
+    for (long i = 0; i < static_cast<long>(DirtyRegion::MAX_RECTS); i++) {
+        region.add({i * 100, 10, i * 100 + 10, 20});
+    }
+    CHECK(region.rects().size() == DirtyRegion::MAX_RECTS);
+    CHECK(region.area() == DirtyRegion::MAX_RECTS * 100);
+
+    // one more is collapsed with the others into the bounding box
+    region.add({950, 50, 960, 60});
+    CHECK(region.rects().size() == 1);
+    CHECK(same(region.rects().front(), {0, 10, 960, 60}));
+    CHECK(region.area() == 960 * 50);
+
+    // the box keeps merging
+    region.add({955, 55, 1200, 70});
+    CHECK(region.rects().size() == 1);
+    CHECK(same(region.bounds(), {0, 10, 1000, 70}));
+}
+
+} // namespace
+
+int main() {
+    testEmpty();
+    testSize();
+    testMerge();
+    testCollapse();
+    return Check::result();
+}
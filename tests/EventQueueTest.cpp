@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "sys/BaseEvent.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+struct TestEvent: public BaseEvent {
+    unsigned producer = 0;
+    unsigned count = 0;
+
+    explicit TestEvent(int id) : BaseEvent(id) {}
+
+    TestEvent(int id, unsigned producer, unsigned count) : BaseEvent(id), producer(producer), count(count) {}
+};
+
+using Queue = EventQueue<TestEvent>;
+
+void testPool() {
+    Queue queue;
+    for (uint32_t i = 0; i < Queue::POOL_SIZE; i++) {
+        queue.push(TestEvent(1, 0, i));
+    }
+    CHECK(queue.poolMisses() == 0);
+    queue.push(TestEvent(1, 0, Queue::POOL_SIZE));
+    CHECK(queue.poolMisses() == 1);
+
+    // in the order of the pushes, and only the last one is current
+    unsigned popped = 0;
+    unsigned current = 0;
+    bool ordered = true;
+    while (auto entry = queue.pop()) {
+        ordered = ordered && entry->event.count == popped;
+        current += queue.isCurrent(*entry);
+        popped++;
+    }
+    CHECK(ordered);
+    CHECK(popped == Queue::POOL_SIZE + 1);
+    CHECK(current == 1);
+
+    // the released nodes are taken again
+    for (uint32_t i = 0; i < Queue::POOL_SIZE; i++) {
+        queue.push(TestEvent(2, 0, i));
+    }
+    CHECK(queue.poolMisses() == 1);
+}
+
+void testRemove() {
+    Queue queue;
+    queue.push(TestEvent(3));
+    queue.push(TestEvent(4));
+    queue.remove(TestEvent(3));
+
+    auto first = queue.pop();
+    auto second = queue.pop();
+    CHECK(first && second && !queue.pop());
+    CHECK(first && !queue.isCurrent(*first));
+    CHECK(second && queue.isCurrent(*second));
+}
+
+//
+// The producers push the events with a few ids while the consumer pops them. Every event is popped once, the
+// events of a producer in their order, and the last event of every id is the current one.
+//
+void testProducers() {
+    constexpr unsigned NUM_PRODUCERS = 4;
+    constexpr unsigned NUM_EVENTS = 100000; // by producer
+    constexpr int NUM_IDS = 8;
+
+    Queue queue;
+    std::atomic<unsigned> running{NUM_PRODUCERS};
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < NUM_PRODUCERS; p++) {
+        producers.emplace_back([&queue, &running, p] {
+            for (unsigned i = 0; i < NUM_EVENTS; i++) {
+                queue.push(TestEvent(static_cast<int>((p + i) % NUM_IDS), p, i));
+            }
+            running--;
+        });
+    }
+
+    std::vector<unsigned> next(NUM_PRODUCERS, 0);
+    unsigned popped = 0;
+    bool ordered = true;
+    auto consume = [&] {
+        while (auto entry = queue.pop()) {
+            const auto& event = entry->event;
+            ordered = ordered && event.producer < NUM_PRODUCERS && event.count == next[event.producer];
+            next[event.producer] = event.count + 1;
+            popped++;
+        }
+    };
+    while (running > 0) {
+        consume();
+    }
+    for (auto& producer: producers) {
+        producer.join();
+    }
+    consume();
+
+    CHECK(ordered);
+    CHECK(popped == NUM_PRODUCERS * NUM_EVENTS);
+    CHECK(!queue.pop());
+
+    // a current entry is left for every id after it has been pushed again
+    for (int id = 0; id < NUM_IDS; id++) {
+        queue.push(TestEvent(id));
+    }
+    unsigned current = 0;
+    while (auto entry = queue.pop()) {
+        current += queue.isCurrent(*entry);
+    }
+    CHECK(current == NUM_IDS);
+}
+
+} // namespace
+
+int main() {
+    testPool();
+    testRemove();
+    testProducers();
+    return Check::result();
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gfx/FrameCache.h"
+#include "Check.h"
+#include "TestFrames.h"
+
+using namespace litelockr;
+using namespace litelockr::TestFrames;
+
+namespace {
+
+const std::filesystem::path CACHE_PATH = std::filesystem::temp_directory_path() / "LiteLockrFrameCacheTest.bin";
+
+void writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+std::vector<char> readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void writeFile(const std::filesystem::path& path, const std::vector<char>& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+bool sameFrames(const FrameSet& frames, const Bitmap& strip) {
+    bool same = frames.size() == NUM_FRAMES;
+    for (unsigned i = 0; same && i < NUM_FRAMES; i++) {
+        same = sameFrame(frames, i, strip);
+    }
+    return same;
+}
+
+void testKey() {
+    using Key = FrameCache::Key;
+    CHECK(Key().add(1).add(2).value() == Key().add(1).add(2).value());
+    CHECK(Key().add(1).add(2).value() != Key().add(2).add(1).value());
+    CHECK(Key().add(std::wstring_view(L"Unlock")).value() != Key().add(std::wstring_view(L"Unlocks")).value());
+    CHECK(Key().value() != Key().add(0).value());
+
+    // the file changes with its size
+    const auto path = std::filesystem::temp_directory_path() / "LiteLockrFrameCacheTest.key";
+    writeFile(path, "resources");
+    const auto before = Key().addFile(path.wstring()).value();
+    CHECK(Key().addFile(path.wstring()).value() == before);
+    writeFile(path, "other resources");
+    CHECK(Key().addFile(path.wstring()).value() != before);
+    std::filesystem::remove(path);
+}
+
+void testStoreAndLoad() {
+    constexpr uint64_t KEY = 42;
+    std::filesystem::remove(CACHE_PATH);
+
+    Bitmap strips[2];
+    makeStrip(strips[0], 1);
+    makeStrip(strips[1], 2);
+
+    {
+        FrameCache cache;
+        CHECK(!cache.open(CACHE_PATH.wstring(), KEY));
+        CHECK(cache.isOpen() && !cache.isMapped());
+
+        // the compressed frames and the strip are stored alike
+        FrameSet compressed;
+        compressed.createFromBitmap(strips[0], NUM_FRAMES);
+        compressed.compress();
+        FrameSet strip;
+        strip.createFromBitmap(strips[1], NUM_FRAMES);
+        cache.store(10, compressed);
+        cache.store(20, strip);
+        CHECK(cache.numStored() == 2);
+
+        FrameSet missing;
+        CHECK(!cache.load(10, missing)); // the frames come from the file only
+        CHECK(cache.save());
+        CHECK(std::filesystem::exists(CACHE_PATH));
+    }
+
+    FrameSet loaded[2];
+    {
+        FrameCache cache;
+        CHECK(cache.open(CACHE_PATH.wstring(), KEY));
+        CHECK(cache.isMapped());
+        CHECK(cache.load(10, loaded[0]) && cache.load(20, loaded[1]));
+        FrameSet unknown;
+        CHECK(!cache.load(30, unknown));
+
+        // the mapped file is up to date
+        cache.store(30, loaded[0]);
+        CHECK(!cache.save());
+    }
+
+    // the frames keep the file mapped
+    CHECK(loaded[0].isCompressed() && loaded[1].isCompressed());
+    CHECK(sameFrames(loaded[0], strips[0]));
+    CHECK(sameFrames(loaded[1], strips[1]));
+}
+
+void testInvalidation() {
+    constexpr uint64_t KEY = 42;
+    Bitmap strip;
+    makeStrip(strip, 3);
+    std::filesystem::remove(CACHE_PATH);
+
+    {
+        FrameCache cache;
+        CHECK(!cache.open(CACHE_PATH.wstring(), KEY));
+        FrameSet frames;
+        frames.createFromBitmap(strip, NUM_FRAMES);
+        cache.store(10, frames);
+        CHECK(cache.save());
+    }
+    const auto file = readFile(CACHE_PATH);
+    CHECK(file.size() > 24 + 32);
+
+    // another key, e.g. after the resources have changed
+    {
+        FrameCache cache;
+        CHECK(!cache.open(CACHE_PATH.wstring(), KEY + 1));
+        CHECK(!cache.isMapped());
+        FrameSet frames;
+        CHECK(!cache.load(10, frames));
+    }
+
+    // the format of another version
+    auto damaged = file;
+    damaged[4]++;
+    writeFile(CACHE_PATH, damaged);
+    CHECK(!FrameCache().open(CACHE_PATH.wstring(), KEY));
+
+    // truncated words, a header cut short, the entries past the end
+    writeFile(CACHE_PATH, std::vector<char>(file.begin(), file.end() - 4));
+    CHECK(!FrameCache().open(CACHE_PATH.wstring(), KEY));
+    writeFile(CACHE_PATH, std::vector<char>(file.begin(), file.begin() + 12));
+    CHECK(!FrameCache().open(CACHE_PATH.wstring(), KEY));
+    damaged = file;
+    damaged[16] = 100; // numEntries
+    writeFile(CACHE_PATH, damaged);
+    CHECK(!FrameCache().open(CACHE_PATH.wstring(), KEY));
+
+    // the box of the key frame past the frame: the words follow the header and the entry
+    damaged = file;
+    damaged[24 + 32 + 8] = static_cast<char>(WIDTH + 1);
+    writeFile(CACHE_PATH, damaged);
+    CHECK(!FrameCache().open(CACHE_PATH.wstring(), KEY));
+
+    // a stale file is replaced by the next save
+    {
+        FrameCache cache;
+        CHECK(!cache.open(CACHE_PATH.wstring(), KEY + 1));
+        FrameSet frames;
+        frames.createFromBitmap(strip, NUM_FRAMES);
+        cache.store(10, frames);
+        CHECK(cache.save());
+    }
+    FrameCache cache;
+    CHECK(cache.open(CACHE_PATH.wstring(), KEY + 1));
+    FrameSet frames;
+    CHECK(cache.load(10, frames));
+    CHECK(sameFrames(frames, strip));
+    CHECK(!std::filesystem::exists(CACHE_PATH.wstring() + L".tmp"));
+}
+
+} // namespace
+
+int main() {
+    testKey();
+    testStoreAndLoad();
+    testInvalidation();
+    std::filesystem::remove(CACHE_PATH);
+    return Check::result();
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gfx/BitmapUtils.h"
+#include "gfx/FrameCodec.h"
+#include "gfx/FrameSet.h"
+#include "Check.h"
+#include "TestFrames.h"
+
+using namespace litelockr;
+using namespace litelockr::TestFrames;
+
+namespace {
+
+// decodes the frames in order and compares them with the strip
+bool decodesStrip(const FrameCodec& codec, const Bitmap& strip) {
+    Bitmap frame;
+    frame.create(codec.width(), codec.height());
+    frame.clear({0, 0, 0, 0});
+
+    bool same = true;
+    for (unsigned i = 0; i < codec.size(); i++) {
+        codec.decode(i, frame);
+        Bitmap expected;
+        expected.view(strip, i * codec.height(), codec.height());
+        same = same && BitmapUtils::equals(frame, expected);
+    }
+    return same;
+}
+
+bool attach(FrameCodec& codec, const std::vector<uint32_t>& words, unsigned numFrames = NUM_FRAMES) {
+    return codec.attach(WIDTH, HEIGHT, numFrames, words.data(), words.size(), nullptr);
+}
+
+void testRoundTrip() {
+    Bitmap strip;
+    makeStrip(strip);
+
+    FrameCodec codec;
+    CHECK(codec.encode(strip, NUM_FRAMES));
+    CHECK(codec.width() == WIDTH && codec.height() == HEIGHT && codec.size() == NUM_FRAMES);
+    CHECK(codec.byteSize() < WIDTH * HEIGHT * NUM_FRAMES * 4);
+    CHECK(decodesStrip(codec, strip));
+
+    // the unchanged frame is the empty box
+    FrameCodec still;
+    Bitmap twice;
+    twice.create(WIDTH, HEIGHT * 2);
+    twice.copyFrom(strip, 0, 0, 0, 0, WIDTH, HEIGHT);
+    twice.copyFrom(strip, 0, HEIGHT, 0, 0, WIDTH, HEIGHT);
+    CHECK(still.encode(twice, 2));
+    CHECK(still.numWords() > 4);
+    CHECK(still.words()[still.numWords() - 4] == 0 && still.words()[still.numWords() - 1] == 0);
+    CHECK(decodesStrip(still, twice));
+
+    // the words of another codec, e.g. of a mapped file
+    const std::vector<uint32_t> words(codec.words(), codec.words() + codec.numWords());
+    auto storage = std::make_shared<std::vector<uint32_t>>(words);
+    FrameCodec attached;
+    CHECK(attached.attach(WIDTH, HEIGHT, NUM_FRAMES, storage->data(), storage->size(), storage));
+    CHECK(attached.words() == storage->data());
+    CHECK(storage.use_count() == 2);
+    CHECK(decodesStrip(attached, strip));
+}
+
+void testCorruptWords() {
+    Bitmap strip;
+    makeStrip(strip);
+    FrameCodec codec;
+    CHECK(codec.encode(strip, NUM_FRAMES));
+    const std::vector<uint32_t> words(codec.words(), codec.words() + codec.numWords());
+
+    FrameCodec attached;
+    CHECK(attach(attached, words));
+
+    // truncated, or words left over
+    CHECK(!attach(attached, std::vector<uint32_t>(words.begin(), words.end() - 1)));
+    CHECK(attached.size() == 0 && attached.words() == nullptr);
+    auto longer = words;
+    longer.push_back(0);
+    CHECK(!attach(attached, longer));
+    CHECK(!attach(attached, words, NUM_FRAMES + 1));
+    CHECK(!attach(attached, words, 0));
+    CHECK(!attach(attached, {}));
+
+    // the box of the key frame out of the frame, or upside down
+    auto corrupt = words;
+    corrupt[2] = WIDTH + 1;
+    CHECK(!attach(attached, corrupt));
+    corrupt = words;
+    corrupt[3] = HEIGHT + 1;
+    CHECK(!attach(attached, corrupt));
+    corrupt = words;
+    std::swap(corrupt[1], corrupt[3]);
+    CHECK(!attach(attached, corrupt));
+
+    // a run past the right of the box: the first run of the first row, after its count
+    corrupt = words;
+    corrupt[5] = WIDTH;
+    CHECK(!attach(attached, corrupt));
+    corrupt = words;
+    corrupt[6] = 0xffffffff;
+    CHECK(!attach(attached, corrupt));
+    corrupt = words;
+    corrupt[4] = 0xffffffff; // more runs than words
+    CHECK(!attach(attached, corrupt));
+
+    CHECK(attach(attached, words));
+    CHECK(decodesStrip(attached, strip));
+}
+
+void testFrameSet() {
+    Bitmap strip;
+    makeStrip(strip, 7);
+
+    FrameSet frames;
+    frames.createFromBitmap(strip, NUM_FRAMES);
+    frames.compress();
+    CHECK(frames.isCompressed());
+    CHECK(frames.residentBytes() < frames.rawBytes());
+
+    // in order, backwards and again from the start
+    bool same = true;
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        same = same && sameFrame(frames, i, strip);
+    }
+    for (unsigned i = NUM_FRAMES; i-- > 0;) {
+        same = same && sameFrame(frames, i, strip);
+    }
+    CHECK(same);
+
+    // the clone shares the words
+    FrameSet clone;
+    clone.clone(frames);
+    CHECK(clone.encodedFrames() == frames.encodedFrames());
+    CHECK(sameFrame(clone, NUM_FRAMES - 1, strip));
+    CHECK(BitmapUtils::equals(clone.bitmap(), strip));
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testCorruptWords();
+    testFrameSet();
+    return Check::result();
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include "sys/AppTimer.h"
+#include "sys/FrameScheduler.h"
+#include "sys/TimerWheel.h"
+#include "Check.h"
+
+using namespace litelockr;
+using namespace std::chrono_literals;
+
+namespace {
+
+// the time moves only when the test sleeps
+struct FakeClock {
+    using Duration = AppClock::Duration;
+    using TimePoint = AppClock::TimePoint;
+
+    static inline TimePoint time = TimePoint{} + 1h;
+
+    static TimePoint now() { return time; }
+
+    static void sleep(Duration duration) { time += duration; }
+};
+
+using Scheduler = BasicFrameScheduler<FakeClock>;
+
+constexpr auto FRAME_PERIOD = AppTimerListener::FRAME_PERIOD;
+constexpr auto IDLE_PERIOD = AppTimerListener::IDLE_PERIOD;
+
+//
+// Without an animation and a timer the loop sleeps for the idle period
+//
+void testIdle() {
+    Scheduler scheduler(FRAME_PERIOD, IDLE_PERIOD);
+    CHECK(!scheduler.tickDue());
+    CHECK(scheduler.waitTime(false) == IDLE_PERIOD);
+    CHECK(scheduler.waitTime(false, std::nullopt) == IDLE_PERIOD);
+
+    FakeClock::sleep(scheduler.waitTime(false));
+    CHECK(scheduler.tickDue());
+    scheduler.tickFired();
+    CHECK(scheduler.ticks() == 1);
+    CHECK(!scheduler.tickDue());
+    CHECK(scheduler.waitTime(false) == IDLE_PERIOD);
+
+    // woken up early by a message, the timers are fired and the rest of the idle period is left
+    FakeClock::sleep(300ms);
+    CHECK(scheduler.tickDue());
+    CHECK(scheduler.waitTime(false) == IDLE_PERIOD - 300ms);
+    CHECK(!scheduler.highResolution());
+}
+
+//
+// The deadline of the timers is kept between the next frame and the idle period, the animation frames
+// are not delayed by any deadline
+//
+void testDeadline() {
+    Scheduler scheduler(FRAME_PERIOD, IDLE_PERIOD);
+    const auto start = FakeClock::now();
+
+    CHECK(scheduler.waitTime(false, start + 250ms) == 250ms);
+    CHECK(scheduler.waitTime(false, start + 5s) == IDLE_PERIOD);
+    // a deadline before the next frame, or one which has passed, waits for the frame
+    CHECK(scheduler.waitTime(false, start + 3ms) == FRAME_PERIOD);
+    CHECK(scheduler.waitTime(false, start - 1s) == FRAME_PERIOD);
+    // the wait is rounded up, the loop does not wake up before the deadline
+    CHECK(scheduler.waitTime(false, start + 100ms + 250us) == 101ms);
+
+    CHECK(scheduler.waitTime(true) == FRAME_PERIOD);
+    CHECK(scheduler.waitTime(true, start + 250ms) == FRAME_PERIOD);
+    FakeClock::sleep(20ms);
+    CHECK(scheduler.waitTime(true, start + 250ms) == FRAME_PERIOD - 20ms);
+
+    // the frame is late, the loop does not wait
+    FakeClock::sleep(40ms);
+    CHECK(scheduler.tickDue());
+    CHECK(scheduler.waitTime(true) == 0ms);
+    CHECK(scheduler.waitTime(false, start + 50ms) == 0ms);
+}
+
+//
+// The frames keep their cadence when the timers are fired a bit late, and start anew when the loop has fallen
+// behind by more than a frame
+//
+void testCadence() {
+    Scheduler scheduler(FRAME_PERIOD, IDLE_PERIOD);
+    const auto start = FakeClock::now();
+
+    FakeClock::sleep(FRAME_PERIOD + 5ms);
+    scheduler.tickFired();
+    CHECK(scheduler.waitTime(true) == FRAME_PERIOD - 5ms);
+
+    FakeClock::time = start + 3 * FRAME_PERIOD + 10ms;
+    scheduler.tickFired();
+    CHECK(scheduler.waitTime(true) == FRAME_PERIOD);
+}
+
+//
+// The message loop of Main.cpp over a timer wheel with the listeners and the timers of the app, and an animation
+// in the middle. Every timer is fired on time, the loop wakes up only for them and for the frames, and the high
+// timer resolution is on only while the animation runs.
+//
+void testMessageLoop() {
+    const auto start = FakeClock::now();
+    Scheduler scheduler(FRAME_PERIOD, IDLE_PERIOD);
+    TimerWheel wheel(8ms, start);
+
+    struct Timer {
+        AppClock::Duration period;
+        std::vector<AppClock::TimePoint> fired;
+    };
+    // a listener polling the hook state, the flyout waiting to hide, a one-shot delay. The periods are
+    // multiples of the ticks of the wheel as those of the app are.
+    Timer timers[] = {{240ms, {}}, {720ms, {}}, {AppClock::Duration::zero(), {}}};
+    for (auto& timer: timers) {
+        auto delay = timer.period != AppClock::Duration::zero() ? timer.period : 1500ms;
+        wheel.schedule(start + delay, [&timer] { timer.fired.push_back(FakeClock::now()); }, timer.period);
+    }
+
+    const auto animationStart = start + 1100ms;
+    const auto animationEnd = start + 1400ms;
+    const auto end = start + 3s;
+
+    unsigned wakeups = 0;
+    unsigned frames = 0;
+    unsigned resolutionChanges = 0;
+    bool resolutionOk = true;
+    while (FakeClock::now() < end) {
+        wakeups++;
+        const bool animationActive = FakeClock::now() >= animationStart && FakeClock::now() < animationEnd;
+        if (scheduler.tickDue()) {
+            wheel.advance(FakeClock::now());
+            scheduler.tickFired();
+            frames += animationActive;
+        }
+        if (scheduler.updateHighResolution(animationActive)) {
+            resolutionChanges++;
+        }
+        resolutionOk = resolutionOk && scheduler.highResolution() == animationActive;
+
+        AppClock::Duration wait = scheduler.waitTime(animationActive, wheel.nextDeadline());
+        if (!animationActive && FakeClock::now() < animationStart) {
+            // the animation is started by a message
+            wait = std::min(wait, animationStart - FakeClock::now());
+        }
+        FakeClock::sleep(std::max<AppClock::Duration>(wait, 1ms));
+    }
+    CHECK(resolutionOk);
+    CHECK(resolutionChanges == 2);
+    CHECK(!scheduler.highResolution());
+
+    // about 300 ms of the frames
+    CHECK(frames >= 9 && frames <= 10);
+
+    // each timer is fired once per period and not before it is due. The timers are fired at most once a frame,
+    // so a timer waits for the next frame when the last one was fired less than a frame ago, otherwise it is
+    // fired by the next tick of the wheel.
+    auto firedOnTime = [&](const Timer& timer, AppClock::Duration first, size_t count) {
+        if (timer.fired.size() != count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const auto due = start + first + timer.period * static_cast<int>(i);
+            if (timer.fired[i] < due || timer.fired[i] > due + FRAME_PERIOD + 1ms) {
+                return false;
+            }
+        }
+        return true;
+    };
+    CHECK(firedOnTime(timers[0], 240ms, 12));
+    CHECK(firedOnTime(timers[1], 720ms, 4));
+    CHECK(firedOnTime(timers[2], 1500ms, 1));
+    CHECK(timers[0].fired.front() == start + 240ms);
+    CHECK(timers[2].fired.front() == start + 1504ms); // rounded up to the tick
+
+    // the loop has slept between the timers and the frames: the timers, the frames, the message
+    CHECK(wakeups <= 12 + 4 + 1 + frames + 2);
+}
+
+} // namespace
+
+int main() {
+    testIdle();
+    testDeadline();
+    testCadence();
+    testMessageLoop();
+    return Check::result();
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gfx/FrameSet.h"
+#include "gfx/FrameStream.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+constexpr unsigned WIDTH = 24;
+constexpr unsigned HEIGHT = 10;
+constexpr unsigned NUM_FRAMES = 12;
+
+Color frameColor(unsigned index) {
+    return {static_cast<uint8_t>(index * 20), 100, static_cast<uint8_t>(255 - index * 20), 255};
+}
+
+// every pixel of the frame has the color of the index
+bool isFrame(const Bitmap& frame, unsigned index) {
+    Bitmap expected;
+    expected.create(WIDTH, HEIGHT);
+    expected.clear(frameColor(index));
+    for (unsigned y = 0; y < HEIGHT; y++) {
+        if (std::memcmp(frame.pixFmt().row_ptr(static_cast<int>(y)), expected.pixFmt().row_ptr(static_cast<int>(y)),
+                        WIDTH * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Renders {
+    std::atomic<unsigned> count[NUM_FRAMES]{};
+    std::atomic<bool> cleared{true};
+
+    FrameStream::RenderFrame renderFrame(std::chrono::milliseconds delay = {}) {
+        return [this, delay](Bitmap& frame, unsigned index) {
+            // the frame is handed over cleared
+            uint32_t pixel;
+            std::memcpy(&pixel, frame.pixFmt().pix_ptr(WIDTH - 1, HEIGHT - 1), sizeof(pixel));
+            if (pixel != 0) {
+                cleared = false;
+            }
+            std::this_thread::sleep_for(delay);
+            frame.fillRect(0, 0, WIDTH, HEIGHT, frameColor(index));
+            count[index]++;
+        };
+    }
+};
+
+void testPlaying() {
+    Renders renders;
+    FrameStream stream(WIDTH, HEIGHT, NUM_FRAMES, renders.renderFrame(std::chrono::milliseconds(1)), 3);
+    CHECK(stream.byteSize() == 4 * WIDTH * HEIGHT * 4);
+
+    bool played = true;
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        played = played && isFrame(stream.frame(i), i);
+    }
+    CHECK(played);
+    CHECK(renders.cleared);
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        CHECK(renders.count[i] == 1);
+    }
+}
+
+void testSeeking() {
+    Renders renders;
+    FrameStream stream(WIDTH, HEIGHT, NUM_FRAMES, renders.renderFrame(), 2);
+
+    // ahead past the look-ahead, the frames between are dropped
+    CHECK(isFrame(stream.frame(1), 1));
+    CHECK(isFrame(stream.frame(9), 9));
+    CHECK(isFrame(stream.frame(10), 10));
+    CHECK(isFrame(stream.frame(NUM_FRAMES - 1), NUM_FRAMES - 1));
+
+    // playing again after the workers have left
+    bool replayed = true;
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        replayed = replayed && isFrame(stream.frame(i), i);
+    }
+    CHECK(replayed);
+    CHECK(renders.cleared);
+}
+
+// the frames of the set are streamed while it is drawn
+void testFrameSet() {
+    Renders renders;
+    FrameSet frames;
+    frames.stream(WIDTH, HEIGHT, NUM_FRAMES, renders.renderFrame());
+    CHECK(frames.size() == NUM_FRAMES && !frames.isCompressed());
+    CHECK(frames.encodedFrames() == nullptr);
+
+    Bitmap buffer;
+    buffer.create(WIDTH + 4, HEIGHT + 4);
+    frames.begin();
+    bool drawn = true;
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        buffer.clear({0, 0, 0, 0});
+        frames.drawFrame(buffer, 2, 2);
+        Bitmap drawnFrame;
+        drawnFrame.create(WIDTH, HEIGHT);
+        drawnFrame.copyFrom(buffer, 0, 0, 2, 2, WIDTH, HEIGHT);
+        drawn = drawn && isFrame(drawnFrame, i);
+        Bitmap frame;
+        drawn = drawn && frames.frameView(i, frame) && isFrame(frame, i);
+        frames.nextFrame();
+    }
+    CHECK(drawn);
+
+    // the strip is copied from the stream
+    const Bitmap& strip = frames.bitmap();
+    CHECK(strip.height() == HEIGHT * NUM_FRAMES);
+    Bitmap last;
+    last.view(strip, (NUM_FRAMES - 1) * HEIGHT, HEIGHT);
+    CHECK(isFrame(last, NUM_FRAMES - 1));
+}
+
+} // namespace
+
+int main() {
+    testPlaying();
+    testSeeking();
+    testFrameSet();
+    return Check::result();
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GOLDEN_SCENES_H
+#define GOLDEN_SCENES_H
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gfx/Bitmap.h"
+#include "gfx/BitmapContext.h"
+#include "gfx/BitmapUtils.h"
+
+//
+// The lock, the flyout and the unlock guard drawn the way the views compose them, with the real images.
+// Only the API the straight-alpha bitmaps had is used, so that the reference images could be rendered
+// by the same code before the bitmaps became premultiplied.
+//
+namespace litelockr::GoldenScenes {
+
+inline bool loadImage(Bitmap& bitmap, const std::string& resDir, const char *name) {
+    std::ifstream file(resDir + "/png/" + name, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return !data.empty() && bitmap.loadPng(data.data(), data.size());
+}
+
+// the lock turning in perspective over the body with the half-transparent keyboard and mouse icons
+inline bool lockScene(Bitmap& buffer, const std::string& resDir) {
+    Bitmap body;
+    Bitmap lock;
+    Bitmap keyboard;
+    Bitmap mouse;
+    if (!loadImage(body, resDir, "Body.png") || !loadImage(lock, resDir, "LockClosed.png") ||
+        !loadImage(keyboard, resDir, "KeyboardEnabled.png") || !loadImage(mouse, resDir, "MouseEnabled.png")) {
+        return false;
+    }
+
+    buffer.create(body.width(), body.height());
+    buffer.clear({0, 0, 0, 0});
+    buffer.blendFrom(body, 0, 0);
+
+    BitmapContext ctx(buffer);
+    ctx.perspective(lock, {30.5, 18.25, 109, 27.5, 103.75, 99, 34, 110.5}, 210);
+
+    buffer.blendFrom(keyboard, 18, 100, 0, 0, 160);
+    buffer.blendFrom(mouse, 94, 100, 0, 0, 90);
+    return true;
+}
+
+// the title and the body clipped to the rounded window shape, waving in as the show animation does
+inline bool flyoutScene(Bitmap& buffer, const std::string& resDir) {
+    Bitmap title;
+    Bitmap body;
+    Bitmap close;
+    Bitmap menu;
+    if (!loadImage(title, resDir, "Title.png") || !loadImage(body, resDir, "Body.png") ||
+        !loadImage(close, resDir, "Close.png") || !loadImage(menu, resDir, "Menu.png")) {
+        return false;
+    }
+
+    const unsigned width = body.width();
+    const unsigned height = title.height() + body.height();
+
+    Bitmap window;
+    window.create(width, height);
+    window.clear({0, 0, 0, 0});
+    window.copyFrom(title, 0, 0);
+    window.blendFrom(body, 0, static_cast<int>(title.height()));
+    window.blendFrom(menu, 4, 0, 0, 0, 220);
+    window.blendFrom(close, static_cast<int>(width - close.width()) - 4, 0, 0, 0, 180);
+
+    Bitmap mask;
+    mask.create(width, height);
+    BitmapContext maskCtx(mask);
+    maskCtx.clear({0, 0, 0, 255});
+    maskCtx.beginPath();
+    maskCtx.addRoundedRect(0.5, 0.5, width - 0.5, height - 0.5, 8);
+    maskCtx.fillColor = {255, 255, 255, 255};
+    maskCtx.fill();
+    BitmapUtils::applyMask(window, mask);
+
+    buffer.create(width, height);
+    buffer.clear({0, 0, 0, 0});
+    BitmapContext ctx(buffer);
+    ctx.wave<WaveDirection::MoveUp>(window, 0.35f, 180);
+    return true;
+}
+
+// the blurred desktop under the dark gradient and the masked text gradient of the guard
+inline bool guardScene(Bitmap& buffer, const std::string& resDir) {
+    Bitmap circle;
+    Bitmap lockedArea;
+    Bitmap gradientDark;
+    Bitmap gradientText;
+    if (!loadImage(circle, resDir, "Circle.png") || !loadImage(lockedArea, resDir, "LockedArea.png") ||
+        !loadImage(gradientDark, resDir, "GradientDark.png") || !loadImage(gradientText, resDir, "GradientText.png")) {
+        return false;
+    }
+
+    buffer.create(320, 200);
+    buffer.clear({55, 55, 55, 255}); // main background color
+    buffer.fillRect(0, 0, 320, 24, {30, 90, 160, 255});
+    buffer.fillRect(40, 60, 120, 90, {200, 200, 190, 255});
+    buffer.fillRect(180, 40, 110, 130, {90, 150, 60, 200});
+    buffer.blendFrom(circle, 20, 80, 0, 0, 230);
+    buffer.blendFrom(lockedArea, 170, 60);
+
+    BitmapContext ctx(buffer);
+    ctx.blur(6);
+
+    const int x = 91;
+    const int y = 32;
+    buffer.blendFrom(gradientDark, x, y);
+
+    // the text mask, the glyphs need the Windows font engine
+    Bitmap mask;
+    mask.createAs(gradientText);
+    BitmapContext maskCtx(mask);
+    maskCtx.clear({0, 0, 0, 255});
+    maskCtx.fillColor = {255, 255, 255, 255};
+    for (int i = 0; i < 4; i++) {
+        maskCtx.beginPath();
+        maskCtx.addRoundedRect(12 + i * 30, 50 + i % 2 * 6, 34 + i * 30, 86, 5);
+        maskCtx.fill();
+    }
+
+    Bitmap text;
+    text.createAs(gradientText);
+    text.copyFrom(gradientText, 0, 0);
+    BitmapUtils::applyMask(text, mask);
+    buffer.blendFrom(text, x, y, 0, 0, text.width(), text.height(), 200);
+    return true;
+}
+
+} // namespace litelockr::GoldenScenes
+
+#endif // GOLDEN_SCENES_H
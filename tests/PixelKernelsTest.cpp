@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gfx/AggAll.h"
+#include "gfx/Bitmap.h"
+#include "gfx/Color.h"
+#include "gfx/PixelKernels.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+using PixFmt = Bitmap::PixFmtType;
+
+// the pixels around the row, they are not written by the kernels
+constexpr unsigned GUARD = 9;
+constexpr unsigned MAX_WIDTH = 67;
+constexpr unsigned MAX_OFFSET = 7;
+constexpr unsigned ROW_SIZE = MAX_OFFSET + MAX_WIDTH + GUARD;
+
+std::mt19937 random(20260612);
+
+uint8_t randomByte() {
+    return static_cast<uint8_t>(random() & 0xff);
+}
+
+uint32_t randomPixel(uint8_t alpha) {
+    auto channel = [alpha] { return static_cast<uint32_t>(alpha ? randomByte() % (alpha + 1) : 0); };
+    uint32_t pixel = 0;
+    pixel |= channel() << ColorB * 8;
+    pixel |= channel() << ColorG * 8;
+    pixel |= channel() << ColorR * 8;
+    pixel |= static_cast<uint32_t>(alpha) << ColorA * 8;
+    return pixel;
+}
+
+// premultiplied pixels in runs of transparent, opaque and translucent ones, the SIMD kernels skip the blocks
+std::vector<uint32_t> randomRow() {
+    std::vector<uint32_t> row(ROW_SIZE);
+    for (unsigned i = 0; i < ROW_SIZE;) {
+        const unsigned kind = random() % 4;
+        const unsigned run = 1 + random() % 12;
+        for (unsigned k = 0; k < run && i < ROW_SIZE; k++, i++) {
+            const uint8_t alpha = kind == 0 ? 0 : kind == 1 ? 255 : randomByte();
+            row[i] = randomPixel(alpha);
+        }
+    }
+    return row;
+}
+
+PixFmt::color_type toColor(uint32_t pixel) {
+    auto p = reinterpret_cast<const uint8_t *>(&pixel);
+    return {p[ColorR], p[ColorG], p[ColorB], p[ColorA]};
+}
+
+struct Row {
+    std::vector<uint32_t> pixels;
+    agg::rendering_buffer buffer;
+    PixFmt pixFmt;
+
+    explicit Row(std::vector<uint32_t> from)
+            : pixels(std::move(from)),
+              buffer(reinterpret_cast<uint8_t *>(pixels.data()), ROW_SIZE, 1, ROW_SIZE * 4),
+              pixFmt(buffer) {}
+
+    Row(const Row& row) : Row(row.pixels) {}
+
+    uint8_t *at(unsigned x) {
+        return reinterpret_cast<uint8_t *>(pixels.data() + x);
+    }
+};
+
+bool same(const Row& actual, const Row& expected, const wchar_t *kernels, const char *name,
+          unsigned offset, unsigned width, uint8_t cover) {
+    for (unsigned i = 0; i < ROW_SIZE; i++) {
+        if (actual.pixels[i] != expected.pixels[i]) {
+            std::fprintf(stderr, "%ls %s: offset %u, width %u, cover %u: pixel %u is %08x, AGG %08x\n",
+                         kernels, name, offset, width, cover, i, actual.pixels[i], expected.pixels[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr uint8_t COVERS[] = {0, 255, 1, 127, 128, 254};
+
+void testBlendRow(const PixelKernelTable& kernels) {
+    bool ok = true;
+    for (unsigned width = 0; width <= MAX_WIDTH && ok; width++) {
+        for (unsigned offset = 0; offset <= MAX_OFFSET && ok; offset++) {
+            for (uint8_t cover: COVERS) {
+                Row src(randomRow());
+                Row expected(randomRow());
+                Row actual(expected);
+
+                if (width > 0) { // the loops of AGG run at least once
+                    expected.pixFmt.blend_from(src.pixFmt, static_cast<int>(offset), 0,
+                                               static_cast<int>(MAX_OFFSET - offset), 0, width, cover);
+                }
+                kernels.blendRow(actual.at(offset), src.at(MAX_OFFSET - offset), width, cover);
+                ok = same(actual, expected, kernels.name, "blendRow", offset, width, cover);
+                if (!ok) {
+                    break;
+                }
+            }
+        }
+    }
+    CHECK(ok);
+}
+
+void testFillRow(const PixelKernelTable& kernels) {
+    bool ok = true;
+    for (unsigned width = 0; width <= MAX_WIDTH && ok; width++) {
+        for (unsigned offset = 0; offset <= MAX_OFFSET && ok; offset++) {
+            const uint32_t pixel = randomPixel(randomByte());
+            Row expected(randomRow());
+            Row actual(expected);
+
+            if (width > 0) {
+                expected.pixFmt.copy_hline(static_cast<int>(offset), 0, width, toColor(pixel));
+            }
+            kernels.fillRow(actual.at(offset), width, pixel);
+            ok = same(actual, expected, kernels.name, "fillRow", offset, width, 255);
+        }
+    }
+    CHECK(ok);
+}
+
+void testBlendFillRow(const PixelKernelTable& kernels) {
+    bool ok = true;
+    for (unsigned width = 0; width <= MAX_WIDTH && ok; width++) {
+        for (unsigned offset = 0; offset <= MAX_OFFSET && ok; offset++) {
+            for (uint8_t alpha: {uint8_t(0), uint8_t(255), randomByte()}) {
+                for (uint8_t cover: COVERS) {
+                    const uint32_t pixel = randomPixel(alpha);
+                    Row expected(randomRow());
+                    Row actual(expected);
+
+                    if (width > 0) {
+                        expected.pixFmt.blend_hline(static_cast<int>(offset), 0, width, toColor(pixel), cover);
+                    }
+                    kernels.blendFillRow(actual.at(offset), width, pixel, cover);
+                    ok = same(actual, expected, kernels.name, "blendFillRow", offset, width, cover);
+                    if (!ok) {
+                        break;
+                    }
+                }
+                if (!ok) {
+                    break;
+                }
+            }
+        }
+    }
+    CHECK(ok);
+}
+
+// the kernels reached from the bitmap, a sub-rectangle of a padded bitmap has unaligned rows and tails
+void testBitmap() {
+    constexpr unsigned W = 37;
+    constexpr unsigned H = 5;
+
+    Bitmap src;
+    Bitmap dst;
+    CHECK(src.create(W, H));
+    CHECK(dst.create(W, H));
+
+    Bitmap expected;
+    CHECK(expected.create(W, H));
+    for (unsigned y = 0; y < H; y++) {
+        auto srcRow = randomRow();
+        auto dstRow = randomRow();
+        std::memcpy(src.pixFmt().pix_ptr(0, static_cast<int>(y)), srcRow.data(), W * 4);
+        std::memcpy(dst.pixFmt().pix_ptr(0, static_cast<int>(y)), dstRow.data(), W * 4);
+        std::memcpy(expected.pixFmt().pix_ptr(0, static_cast<int>(y)), dstRow.data(), W * 4);
+    }
+
+    dst.blendFrom(src, 3, 1, 1, 0, W - 5, H - 2, 200);
+    for (unsigned y = 0; y < H - 2; y++) {
+        expected.pixFmt().blend_from(src.pixFmt(), 3, static_cast<int>(y) + 1, 1, static_cast<int>(y), W - 5, 200);
+    }
+    dst.fillRect(1, 2, W - 3, 2, Color(250, 120, 10, 90), 77);
+    for (int y = 2; y < 4; y++) {
+        expected.pixFmt().blend_hline(1, y, W - 3, premultiplied(Color(250, 120, 10, 90)), 77);
+    }
+
+    bool ok = true;
+    for (unsigned y = 0; y < H; y++) {
+        ok = ok && std::memcmp(dst.pixFmt().pix_ptr(0, static_cast<int>(y)),
+                               expected.pixFmt().pix_ptr(0, static_cast<int>(y)), W * 4) == 0;
+    }
+    CHECK(ok);
+}
+
+} // namespace
+
+int main() {
+    const auto supported = PixelKernels::supported();
+    CHECK(!supported.empty() && supported.back() == &PixelKernels::instance());
+
+    for (const PixelKernelTable *kernels: supported) {
+        std::printf("%ls\n", kernels->name);
+        testBlendRow(*kernels);
+        testFillRow(*kernels);
+        testBlendFillRow(*kernels);
+    }
+    testBitmap();
+    return Check::result();
+}
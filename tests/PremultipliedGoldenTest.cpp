@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "lodepng/lodepng.h"
+#include "Check.h"
+#include "GoldenScenes.h"
+
+using namespace litelockr;
+
+//
+// The scenes are compared with the reference images rendered by the straight-alpha bitmaps, before they
+// became premultiplied. Both are compared premultiplied: the colors of the transparent pixels do not count
+// and the faint ones are not amplified by the division. The tolerance covers the rounding of the blenders
+// and of the bilinear filters, and the box blur that replaced the stack blur of the guard. A few edge pixels
+// of the resampled images differ by more: the straight colors were filtered without their alpha weights.
+//
+namespace {
+
+struct Tolerance {
+    int maxDifference;      // of a channel
+    double meanDifference;  // of all the channels
+    double offPixels;       // the share of the pixels with a channel off by more than ROUNDING
+};
+
+constexpr int ROUNDING = 2;
+
+bool matchesGolden(const Bitmap& bitmap, const char *name, Tolerance tolerance) {
+    std::vector<unsigned char> golden;
+    unsigned width;
+    unsigned height;
+    const std::string path = std::string(TEST_DATA_DIR) + "/golden/" + name;
+    if (lodepng::decode(golden, width, height, path) != 0) {
+        std::fprintf(stderr, "%s: could not load\n", path.c_str());
+        return false;
+    }
+    if (width != bitmap.width() || height != bitmap.height()) {
+        std::fprintf(stderr, "%s: %ux%u expected, %ux%u rendered\n", name, width, height, bitmap.width(),
+                     bitmap.height());
+        return false;
+    }
+
+    int maxDifference = 0;
+    uint64_t sumDifference = 0;
+    unsigned offPixels = 0;
+    for (unsigned y = 0; y < height; y++) {
+        const uint8_t *p = bitmap.pixFmt().pix_ptr(0, static_cast<int>(y));
+        const uint8_t *g = &golden[static_cast<size_t>(y) * width * 4];
+        for (unsigned x = 0; x < width; x++, p += 4, g += 4) {
+            const auto expected = Color(g[0], g[1], g[2], g[3]).premultiply(); // RGBA
+            const int differences[] = {
+                    std::abs(p[ColorR] - expected.r), std::abs(p[ColorG] - expected.g),
+                    std::abs(p[ColorB] - expected.b), std::abs(p[ColorA] - expected.a)};
+            const int difference = *std::max_element(std::begin(differences), std::end(differences));
+            maxDifference = std::max(maxDifference, difference);
+            offPixels += difference > ROUNDING;
+            for (int d: differences) {
+                sumDifference += d;
+            }
+        }
+    }
+
+    const double meanDifference = static_cast<double>(sumDifference) / (width * height * 4.0);
+    const double offShare = static_cast<double>(offPixels) / (width * height);
+    std::printf("%s: max difference %d, mean difference %.4f, off pixels %.2f%%\n", name, maxDifference,
+                meanDifference, offShare * 100);
+    return maxDifference <= tolerance.maxDifference && meanDifference <= tolerance.meanDifference &&
+           offShare <= tolerance.offPixels;
+}
+
+} // namespace
+
+int main() {
+    const std::string resDir = RES_DIR;
+
+    Bitmap lock;
+    CHECK(GoldenScenes::lockScene(lock, resDir));
+    CHECK(matchesGolden(lock, "LockScene.png", {20, 0.1, 0.01}));
+
+    Bitmap flyout;
+    CHECK(GoldenScenes::flyoutScene(flyout, resDir));
+    CHECK(matchesGolden(flyout, "FlyoutScene.png", {ROUNDING, 0.5, 0}));
+
+    Bitmap guard;
+    CHECK(GoldenScenes::guardScene(guard, resDir));
+    CHECK(matchesGolden(guard, "GuardScene.png", {8, 0.3, 0.02}));
+
+    return Check::result();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gfx/Bitmap.h"
+#include "ren/Material.h"
+#include "ren/MeshObject.h"
+#include "ren/Renderer.h"
+#include "sys/Rectangle.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+std::mt19937 random(20260902);
+
+void fillMaterial(Material& material, unsigned width, unsigned height) {
+    material.bitmap.create(width, height);
+    for (unsigned y = 0; y < height; y++) {
+        auto p = material.bitmap.pixFmt().pix_ptr(0, static_cast<int>(y));
+        for (unsigned x = 0; x < width * 4; x += 4) {
+            const auto alpha = static_cast<uint8_t>(random() % 2 ? 255 : random() & 0xff);
+            for (unsigned k = 0; k < 4; k++) {
+                p[x + k] = k == ColorA ? alpha : static_cast<uint8_t>(random() % (alpha + 1));
+            }
+        }
+    }
+}
+
+// overlapping planes turned as the flyout parts are while the menu opens
+struct Scene {
+    Bitmap buffer;
+    Renderer renderer{buffer};
+    SceneObjects objects;
+
+    NullObject nullObj;
+    PlaneGeometry geometries[4];
+    MeshObject meshes[4];
+    Material materials[4];
+
+    Scene() {
+        buffer.create(200, 160);
+        nullObj.setPosition0(100.0f, 80.5f);
+        objects.add(nullObj);
+
+        const float sizes[] = {101, 81, 26, 26};
+        const float positions[][2] = {{0, 0}, {4.5f, -3.2f}, {-50.5f, 37.8f}, {50.5f, 37.8f}};
+        for (int i = 0; i < 4; i++) {
+            fillMaterial(materials[i], static_cast<unsigned>(sizes[i]), static_cast<unsigned>(sizes[i]));
+            materials[i].alpha = i == 1 ? 200 : 255;
+            geometries[i].create(sizes[i], sizes[i]);
+            meshes[i].create(geometries[i], materials[i]);
+            meshes[i].setParent(nullObj);
+            meshes[i].setRotY(0.3f + 0.2f * static_cast<float>(i));
+            meshes[i].setPosition(positions[i][0], positions[i][1], -3.0f * static_cast<float>(i));
+        }
+        for (int i = 3; i >= 0; i--) {
+            objects.add(meshes[i]);
+        }
+    }
+};
+
+bool sameInside(const Bitmap& a, const Bitmap& b, const RECT& rc) {
+    for (long y = rc.top; y < rc.bottom; y++) {
+        if (std::memcmp(a.pixFmt().pix_ptr(rc.left, y), b.pixFmt().pix_ptr(rc.left, y),
+                        static_cast<size_t>(Rectangle::width(rc)) * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool blankOutside(const Bitmap& bitmap, const RECT& bounds) {
+    for (unsigned y = 0; y < bitmap.height(); y++) {
+        for (unsigned x = 0; x < bitmap.width(); x++) {
+            const POINT pt{static_cast<long>(x), static_cast<long>(y)};
+            uint32_t pixel;
+            std::memcpy(&pixel, bitmap.pixFmt().pix_ptr(pt.x, pt.y), sizeof(pixel));
+            if (pixel != 0 && !Rectangle::contains(bounds, pt)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//
+// The faces drawn with the clip rectangles give the same pixels inside them as the whole scene
+//
+void testClip() {
+    Scene scene;
+    scene.buffer.clear({0, 0, 0, 0});
+    scene.renderer.render(scene.objects);
+    Bitmap full;
+    full.create(scene.buffer.width(), scene.buffer.height());
+    full.copyFrom(scene.buffer, 0, 0);
+    CHECK(!blankOutside(full, {}));
+
+    const std::vector<RECT> clips[] = {
+            {{90, 70, 110, 90}},
+            {{0, 0, 30, 30}, {150, 100, 200, 160}},
+            {{40, 100, 60, 130}, {135, 105, 165, 125}},
+            {{0, 0, 200, 1}},
+    };
+    for (const auto& clip: clips) {
+        scene.buffer.clear({0, 0, 0, 0});
+        scene.renderer.project(scene.objects);
+        scene.renderer.draw(scene.objects, clip);
+        for (const auto& rc: clip) {
+            CHECK(sameInside(scene.buffer, full, rc));
+        }
+    }
+
+    // a clip far from every face draws nothing
+    scene.buffer.clear({0, 0, 0, 0});
+    const RECT corner[] = {{0, 150, 4, 160}};
+    scene.renderer.draw(scene.objects, corner);
+    CHECK(blankOutside(scene.buffer, {}));
+}
+
+// every pixel of an object is inside its bounds
+void testBounds() {
+    Scene scene;
+    scene.renderer.project(scene.objects);
+    for (auto& mesh: scene.meshes) {
+        const RECT bounds = Renderer::bounds(mesh);
+        CHECK(!Rectangle::empty(bounds));
+
+        SceneObjects single;
+        single.add(scene.nullObj);
+        single.add(mesh);
+        scene.buffer.clear({0, 0, 0, 0});
+        scene.renderer.draw(single);
+        CHECK(blankOutside(scene.buffer, bounds));
+    }
+
+    MeshObject hidden;
+    PlaneGeometry geometry;
+    geometry.create(10.0f, 10.0f);
+    hidden.create(geometry);
+    hidden.visible = false;
+    CHECK(Rectangle::empty(Renderer::bounds(hidden)));
+}
+
+} // namespace
+
+int main() {
+    testClip();
+    testBounds();
+    return Check::result();
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gfx/AggAll.h"
+#include "gfx/Bitmap.h"
+#include "gfx/BitmapContext.h"
+#include "gfx/PixelKernels.h"
+#include "gfx/SpanImageBilinear.h"
+#include "Check.h"
+
+using namespace litelockr;
+
+namespace {
+
+using PixFmt = Bitmap::PixFmtType;
+using Accessor = agg::image_accessor_clone<PixFmt>;
+using Interpolator = agg::span_interpolator_trans<agg::trans_perspective>;
+using ReferenceSpanGen = agg::span_image_filter_rgba_bilinear<Accessor, Interpolator>;
+
+std::mt19937 random(20260731);
+
+// premultiplied noise, the neighbouring pixels differ so every weight shows
+void fillImage(Bitmap& image) {
+    for (unsigned y = 0; y < image.height(); y++) {
+        auto p = image.pixFmt().pix_ptr(0, static_cast<int>(y));
+        for (unsigned x = 0; x < image.width(); x++, p += 4) {
+            const auto alpha = static_cast<uint8_t>(random() % 4 == 0 ? 255 : random() & 0xff);
+            for (int k = 0; k < 4; k++) {
+                p[k] = k == ColorA ? alpha : static_cast<uint8_t>(random() % (alpha + 1));
+            }
+        }
+    }
+}
+
+//
+// The spans of a quad, and of the area around it where the image coordinates are out of bounds and clamped,
+// against the AGG bilinear filter with SpanConvAlpha
+//
+bool sameSpans(const Bitmap& image, const BitmapContext::QuadDouble& quad, uint8_t alpha) {
+    double quadArr[8];
+    std::copy(quad.begin(), quad.end(), quadArr);
+    agg::trans_perspective tr(quadArr, 0, 0, image.width(), image.height());
+    CHECK(tr.is_valid());
+
+    Accessor accessor(image.pixFmt());
+    Interpolator interpolator(tr);
+    ReferenceSpanGen referenceGen(accessor, interpolator);
+    SpanConvAlpha<Accessor> conv(alpha);
+    SpanImageBilinear spanGen(image, tr, alpha);
+
+    constexpr unsigned LEN = 90;
+    agg::rgba8 expected[LEN];
+    agg::rgba8 actual[LEN];
+    for (int y = -12; y < 70; y++) {
+        for (int x: {-12, 3}) {
+            for (unsigned len: {LEN, 1u, 7u, 33u}) {
+                referenceGen.generate(expected, x, y, len);
+                conv.generate(expected, x, y, len);
+                spanGen.generate(actual, x, y, len);
+                if (std::memcmp(expected, actual, len * sizeof(agg::rgba8)) != 0) {
+                    std::fprintf(stderr, "quad %.2f,%.2f..., alpha %u: span %d,%d (%u) differs\n",
+                                 quad[0], quad[1], alpha, x, y, len);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void testSpans() {
+    Bitmap image;
+    CHECK(image.create(37, 23));
+    fillImage(image);
+
+    // the fractional offsets of a quad facing the camera, the scale is 1 and the filter weights are the offsets.
+    // The binary fractions give an affine transform, the others leave a perspective part of about 1e-18.
+    for (double offset: {0.0, 0.25, 0.5, 0.875, 0.73, 0.999}) {
+        const double x0 = 4 + offset;
+        const double y0 = 6 + offset / 2;
+        const BitmapContext::QuadDouble quad{x0, y0, x0 + 37, y0, x0 + 37, y0 + 23, x0, y0 + 23};
+        const bool binary = offset * 8 == std::floor(offset * 8);
+        CHECK(!binary || SpanImageBilinear::isAffine(agg::trans_perspective(quad.data(), 0, 0, 37, 23)));
+        CHECK(sameSpans(image, quad, 255));
+        CHECK(sameSpans(image, quad, 200));
+    }
+
+    // scaled up and down, rotated, and turned away as the lock is while the menu opens
+    const BitmapContext::QuadDouble quads[] = {
+            {2.5, 3.25, 80.5, 3.25, 80.5, 52.75, 2.5, 52.75},
+            {10.1, 10.2, 25.3, 10.2, 25.3, 18.9, 10.1, 18.9},
+            {20.0, 1.5, 55.7, 18.2, 38.4, 50.6, 2.9, 33.8},
+            {5.23, 4.16, 53.12, 7.79, 51.84, 55.51, 6.5, 60.13},
+            {0.0, 0.0, 60.0, 12.0, 60.0, 44.0, 0.0, 56.0},
+    };
+    for (const auto& quad: quads) {
+        CHECK(sameSpans(image, quad, 255));
+        CHECK(sameSpans(image, quad, 131));
+        CHECK(sameSpans(image, quad, 0));
+    }
+}
+
+// a single pixel image, every tap is clamped to it
+void testSinglePixel() {
+    Bitmap image;
+    CHECK(image.create(1, 1));
+    fillImage(image);
+    const BitmapContext::QuadDouble quad{3.3, 2.7, 9.1, 2.7, 9.1, 8.8, 3.3, 8.8};
+    CHECK(sameSpans(image, quad, 255));
+    CHECK(sameSpans(image, quad, 77));
+}
+
+// the SIMD kernels against the scalar ones, with the widths of their tails and the clamped taps at the edges
+void testKernels() {
+    constexpr unsigned MAX_WIDTH = 37;
+
+    Bitmap image;
+    CHECK(image.create(16, 16));
+    fillImage(image);
+
+    std::vector<BilinearSample> samples(MAX_WIDTH);
+    for (auto& s: samples) {
+        const int x = static_cast<int>(random() % 16);
+        const int y = static_cast<int>(random() % 15);
+        s.row0 = image.pixFmt().pix_ptr(x, y);
+        s.row1 = image.pixFmt().pix_ptr(x, random() % 4 ? y + 1 : y);
+        s.next = x < 15 && random() % 4 ? 4 : 0;
+        constexpr uint16_t EDGES[] = {0, 1, 128, 255};
+        s.fx = static_cast<uint16_t>(random() % 2 ? EDGES[random() % 4] : random() % 256);
+        s.fy = static_cast<uint16_t>(random() % 2 ? EDGES[random() % 4] : random() % 256);
+    }
+
+    for (const PixelKernelTable *kernels: PixelKernels::supported()) {
+        bool ok = true;
+        for (unsigned width = 0; width <= MAX_WIDTH && ok; width++) {
+            for (uint8_t alpha: {0, 1, 200, 255}) {
+                std::vector<uint8_t> expected((MAX_WIDTH + 1) * 4, 0xcd);
+                std::vector<uint8_t> actual(expected);
+                PixelKernels::sampleBilinearPixels(expected.data(), samples.data(), width, alpha);
+                kernels->sampleBilinearRow(actual.data(), samples.data(), width, alpha);
+                if (expected != actual) {
+                    std::fprintf(stderr, "%ls sampleBilinearRow: width %u, alpha %u differs\n",
+                                 kernels->name, width, alpha);
+                    ok = false;
+                    break;
+                }
+            }
+        }
+        CHECK(ok);
+    }
+}
+
+} // namespace
+
+int main() {
+    testSpans();
+    testSinglePixel();
+    testKernels();
+    return Check::result();
+}
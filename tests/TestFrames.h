@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_FRAMES_H
+#define TEST_FRAMES_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "gfx/Bitmap.h"
+#include "gfx/BitmapUtils.h"
+#include "gfx/FrameSet.h"
+
+//
+// A strip of frames like the lock animations: a key frame, then small changes, a frame without any change and
+// the pixels changed a few pixels apart
+//
+namespace litelockr::TestFrames {
+
+constexpr unsigned WIDTH = 37;
+constexpr unsigned HEIGHT = 23;
+constexpr unsigned NUM_FRAMES = 7;
+
+inline void makeStrip(Bitmap& strip, uint32_t seed = 1) {
+    auto random = [&seed](uint32_t limit) {
+        seed = seed * 1664525 + 1013904223;
+        return (seed >> 8) % limit;
+    };
+
+    Bitmap frame;
+    frame.create(WIDTH, HEIGHT);
+    frame.clear({0, 0, 0, 0});
+    frame.fillRect(5, 3, 20, 12, Color(200, 40, 40, 255));
+    frame.fillRect(10, 8, 9, 9, Color(40, 40, 200, 128));
+
+    strip.create(WIDTH, HEIGHT * NUM_FRAMES);
+    for (unsigned i = 0; i < NUM_FRAMES; i++) {
+        if (i == 3) {
+            // the same as the previous frame
+        } else if (i == 5) {
+            for (int x = 1; x < static_cast<int>(WIDTH); x += 2 + static_cast<int>(i)) {
+                frame.fillRect(x, 20, 1, 1, Color(255, 255, 255, 255));
+            }
+        } else if (i > 0) {
+            const unsigned x = random(WIDTH - 4);
+            const unsigned y = random(HEIGHT - 4);
+            const auto color = Color(random(256), random(256), random(256), 255);
+            frame.fillRect(static_cast<int>(x), static_cast<int>(y), std::min(WIDTH - x, 4 + random(10)),
+                           std::min(HEIGHT - y, 2 + random(6)), color);
+        }
+        strip.copyFrom(frame, 0, static_cast<int>(i * HEIGHT));
+    }
+}
+
+// the frame of the set has the pixels of the frame in the strip
+inline bool sameFrame(const FrameSet& frames, unsigned index, const Bitmap& strip) {
+    Bitmap expected;
+    Bitmap actual;
+    return expected.view(strip, index * frames.height(), frames.height()) && frames.frameView(index, actual) &&
+           BitmapUtils::equals(actual, expected);
+}
+
+} // namespace litelockr::TestFrames
+
+#endif // TEST_FRAMES_H
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+ *
+ * This file is part of LiteLockr.
+ *
+ * LiteLockr is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LiteLockr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "sys/TimerWheel.h"
+#include "Check.h"
+
+using namespace litelockr;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto RESOLUTION = 8ms;
+
+struct Fired {
+    unsigned timer;
+    AppClock::TimePoint time;
+
+    bool operator==(const Fired&) const = default;
+};
+
+uint32_t nextRandom(uint32_t& seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed >> 8;
+}
+
+//
+// Random timers of every level fired by long jumps, against the ticks they are due at
+//
+void testSkipAhead() {
+    constexpr uint64_t JUMP = 61; // ticks
+    constexpr uint64_t END = uint64_t{1} << 25;
+    const auto origin = AppClock::now();
+    TimerWheel wheel(RESOLUTION, origin);
+    AppClock::TimePoint now = origin;
+    std::vector<Fired> fired;
+
+    struct Expected {
+        uint64_t tick;
+        uint64_t period; // ticks
+    };
+    std::map<unsigned, Expected> expected;
+
+    uint32_t seed = 7;
+    std::vector<TimerWheel::TimerId> ids;
+    for (unsigned i = 0; i < 400; i++) {
+        // every level, the far away timers beyond the top level, some periodic ones
+        const int bits = 2 + static_cast<int>(nextRandom(seed) % 26);
+        const uint64_t tick = 1 + nextRandom(seed) % (uint64_t{1} << bits);
+        const uint64_t period = i % 10 == 0 ? 1 + nextRandom(seed) % 100000 : 0;
+        ids.push_back(wheel.schedule(origin + RESOLUTION * (tick - 1) + 1ms, [&, i] { fired.push_back({i, now}); },
+                                     RESOLUTION * period));
+        expected[i] = {tick, period};
+    }
+    for (unsigned i = 0; i < 400; i += 7) {
+        wheel.cancel(ids[i]); // the cancelled ids stay in their slots
+        expected.erase(i);
+    }
+
+    for (uint64_t tick = JUMP; tick <= END; tick += JUMP) {
+        now = origin + RESOLUTION * tick;
+        wheel.advance(now);
+    }
+
+    // the callbacks see the time of the jump which has passed the tick
+    std::vector<Fired> reference;
+    for (const auto& [timer, entry]: expected) {
+        for (uint64_t tick = entry.tick; tick <= END / JUMP * JUMP; tick += entry.period) {
+            reference.push_back({timer, origin + RESOLUTION * ((tick + JUMP - 1) / JUMP * JUMP)});
+            if (entry.period == 0) {
+                break;
+            }
+        }
+    }
+
+    auto byTime = [](const Fired& a, const Fired& b) {
+        return a.time != b.time ? a.time < b.time : a.timer < b.timer;
+    };
+    std::ranges::sort(fired, byTime);
+    std::ranges::sort(reference, byTime);
+    CHECK(reference.size() > 400);
+    CHECK(fired == reference);
+}
+
+void testFireTimes() {
+    const auto origin = AppClock::now();
+    TimerWheel wheel(RESOLUTION, origin);
+
+    AppClock::TimePoint now = origin;
+    std::vector<Fired> fired;
+    uint32_t seed = 3;
+    std::vector<AppClock::TimePoint> deadlines;
+    for (unsigned i = 0; i < 200; i++) {
+        const int bits = 1 + static_cast<int>(nextRandom(seed) % 22);
+        const auto deadline = origin + RESOLUTION * (nextRandom(seed) % (uint64_t{1} << bits)) + 3ms;
+        deadlines.push_back(deadline);
+        wheel.schedule(deadline, [&, i] { fired.push_back({i, now}); });
+    }
+
+    // the deadlines rounded up to the ticks, each one is the next deadline of the wheel
+    std::vector<AppClock::TimePoint> ticks;
+    for (auto deadline: deadlines) {
+        ticks.push_back(origin + (deadline - origin + RESOLUTION - 1ns) / RESOLUTION * RESOLUTION);
+    }
+    auto sorted = ticks;
+    std::ranges::sort(sorted);
+    sorted.erase(std::ranges::unique(sorted).begin(), sorted.end());
+
+    for (auto tick: sorted) {
+        const auto deadline = wheel.nextDeadline();
+        CHECK(deadline == tick);
+        now = tick;
+        wheel.advance(now);
+    }
+    CHECK(!wheel.nextDeadline());
+    CHECK(wheel.size() == 0);
+    CHECK(fired.size() == deadlines.size());
+
+    bool onTime = true;
+    for (const auto& entry: fired) {
+        onTime = onTime && entry.time == ticks[entry.timer] && entry.time >= deadlines[entry.timer];
+    }
+    CHECK(onTime);
+}
+
+void testCallbacks() {
+    const auto origin = AppClock::now();
+    TimerWheel wheel(RESOLUTION, origin);
+
+    // a callback schedules the next timer and cancels another one
+    unsigned count = 0;
+    TimerWheel::TimerId cancelled = wheel.schedule(origin + 1s, [&] { count += 100; });
+    wheel.schedule(origin + 10ms, [&] {
+        count++;
+        CHECK(wheel.nextDeadline() == origin + 1s);
+        wheel.cancel(cancelled);
+        wheel.schedule(origin + 2s, [&] { count++; });
+    });
+
+    CHECK(wheel.advance(origin + 1h) == 2);
+    CHECK(count == 2);
+    CHECK(wheel.size() == 0);
+
+    // a periodic timer is fired by every period the jump has passed
+    unsigned ticks = 0;
+    wheel.schedule(origin + 1h + 80ms, [&] { ticks++; }, 80ms);
+    wheel.advance(origin + 1h + 400ms);
+    CHECK(ticks == 5);
+    CHECK(wheel.nextDeadline() == origin + 1h + 480ms);
+}
+
+} // namespace
+
+int main() {
+    testSkipAhead();
+    testFireTimes();
+    testCallbacks();
+    return Check::result();
+}
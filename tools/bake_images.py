@@ -0,0 +1,347 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2020, 2022 Max Kolesnikov <maxklvd@gmail.com>
+#
+# This file is part of LiteLockr.
+#
+# LiteLockr is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# LiteLockr is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with LiteLockr.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Bakes the PNG image resources into premultiplied BGRA compressed with LZ4 (the block format), the format
+src/gfx/BakedImage.h reads. The application copies the pixels instead of inflating and unfiltering them.
+
+Usage: bake_images.py <res dir> [<output dir>]
+
+Only the images that changed since the last run are baked again. The baked images are committed, so the
+application builds without Python; run this after changing an image and commit the output with it.
+"""
+
+import os
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = b'LLBM'
+VERSION = 1
+FLAG_PREMULTIPLIED = 1
+FLAG_LZ4 = 2
+
+IMAGE_DIRS = ['png', 'animation']
+
+# the frames of the strips are NumberOfFrames of the application
+FRAMES_HEADER = os.path.join('..', 'app', 'FlyoutResources.h')
+RESOURCE_SCRIPT = 'Resources.rc'
+
+
+#
+# The frames of the strips by the file name: IDB_ANIM_<NAME> of the resource script is NumberOfFrames::<NAME>
+#
+def read_strip_frames(res_dir):
+    with open(os.path.join(res_dir, FRAMES_HEADER)) as f:
+        numbers = re.search(r'struct NumberOfFrames \{(.*?)\};', f.read(), re.S)
+    if not numbers:
+        raise ValueError('%s: NumberOfFrames is not found' % FRAMES_HEADER)
+    counts = {name: int(value) for name, value in re.findall(r'(\w+) = (\d+);', numbers.group(1))}
+
+    frames = {}
+    with open(os.path.join(res_dir, RESOURCE_SCRIPT)) as f:
+        for name, image in re.findall(r'^IDB_ANIM_(\w+)\s+RCDATA\s+"baked\\\\(\w+)\.llbm"', f.read(), re.M):
+            if name not in counts:
+                raise ValueError('IDB_ANIM_%s has no NumberOfFrames::%s' % (name, name))
+            frames[image + '.png'] = counts[name]
+    if not frames:
+        raise ValueError('%s: no IDB_ANIM_ resources' % RESOURCE_SCRIPT)
+    return frames
+
+
+#
+# PNG decoding, 8 bits per channel, not interlaced
+#
+def read_png(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('not a PNG file')
+
+    pos = 8
+    idat = bytearray()
+    palette = None
+    transparency = None
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, bit_depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'PLTE':
+            palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+        elif kind == b'tRNS':
+            transparency = chunk
+        elif kind == b'IDAT':
+            idat += chunk
+        elif kind == b'IEND':
+            break
+
+    if bit_depth != 8 or interlace != 0:
+        raise ValueError('only 8-bit non-interlaced images are supported')
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    rows = unfilter(zlib.decompress(bytes(idat)), width, height, channels)
+    return width, height, to_rgba(rows, width, height, color_type, palette, transparency)
+
+
+def unfilter(raw, width, height, bpp):
+    stride = width * bpp
+    prev = bytearray(stride)
+    out = bytearray()
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        row = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        if kind == 1:
+            for i in range(bpp, stride):
+                row[i] = (row[i] + row[i - bpp]) & 0xFF
+        elif kind == 2:
+            for i in range(stride):
+                row[i] = (row[i] + prev[i]) & 0xFF
+        elif kind == 3:
+            for i in range(stride):
+                left = row[i - bpp] if i >= bpp else 0
+                row[i] = (row[i] + ((left + prev[i]) >> 1)) & 0xFF
+        elif kind == 4:
+            for i in range(stride):
+                a = row[i - bpp] if i >= bpp else 0
+                b = prev[i]
+                c = prev[i - bpp] if i >= bpp else 0
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                predictor = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                row[i] = (row[i] + predictor) & 0xFF
+        elif kind != 0:
+            raise ValueError('unknown filter type %d' % kind)
+        out += row
+        prev = row
+    return out
+
+
+def to_rgba(rows, width, height, color_type, palette, transparency):
+    if color_type == 6:
+        return rows
+
+    rgba = bytearray(width * height * 4)
+    for i in range(width * height):
+        if color_type == 2:
+            r, g, b = rows[i * 3:i * 3 + 3]
+            a = 255
+            if transparency and (r, g, b) == struct.unpack('>HHH', transparency):
+                a = 0
+        elif color_type == 3:
+            index = rows[i]
+            r, g, b = palette[index]
+            a = transparency[index] if transparency and index < len(transparency) else 255
+        elif color_type == 0:
+            r = g = b = rows[i]
+            a = 0 if transparency and r == struct.unpack('>H', transparency)[0] else 255
+        else:
+            r = g = b = rows[i * 2]
+            a = rows[i * 2 + 1]
+        rgba[i * 4:i * 4 + 4] = bytes((r, g, b, a))
+    return rgba
+
+
+#
+# RGBA to premultiplied BGRA, rounded as agg::rgba8::multiply()
+#
+def to_premultiplied_bgra(rgba):
+    def multiply(c, a):
+        t = c * a + 128
+        return ((t >> 8) + t) >> 8
+
+    bgra = bytearray(len(rgba))
+    for i in range(0, len(rgba), 4):
+        r, g, b, a = rgba[i:i + 4]
+        if a != 255:
+            r, g, b = multiply(r, a), multiply(g, a), multiply(b, a)
+        bgra[i:i + 4] = bytes((b, g, r, a))
+    return bgra
+
+
+#
+# LZ4 block format. The matches are searched along the chains of the earlier positions with the same
+# 4 bytes, like the HC levels of the reference encoder: the decoder is the same, the data is about half
+# as large as with the first match of a hash table.
+#
+MAX_DISTANCE = 0xFFFF
+CHAIN_DEPTH = 256
+GOOD_LENGTH = 1024  # a match as long as this is taken without searching further
+
+
+def match_length(src, ref, pos, limit):
+    # doubles the length while the slices are equal, then halves the last step, the slices are compared in C
+    if src[ref:ref + 4] != src[pos:pos + 4]:
+        return 0
+    low = high = 4
+    while high < limit:
+        high = min(high * 2, limit)
+        if src[ref + low:ref + high] != src[pos + low:pos + high]:
+            break
+        low = high
+    else:
+        return low
+    while high - low > 1:
+        middle = (low + high) // 2
+        if src[ref + low:ref + middle] == src[pos + low:pos + middle]:
+            low = middle
+        else:
+            high = middle
+    return low
+
+
+def lz4_compress(src):
+    n = len(src)
+    out = bytearray()
+    head = {}
+    chain = [-1] * n
+    inserted = 0
+    anchor = 0
+    pos = 0
+    match_limit = n - 12  # the last match starts at least 12 bytes before the end
+    end_literals = n - 5  # and the last 5 bytes are literals
+
+    def write_length(length):
+        while length >= 255:
+            out.append(255)
+            length -= 255
+        out.append(length)
+
+    def find_match(pos):
+        nonlocal inserted
+        while inserted < pos:
+            key = src[inserted:inserted + 4]
+            chain[inserted] = head.get(key, -1)
+            head[key] = inserted
+            inserted += 1
+
+        best_length = best_ref = 0
+        max_length = end_literals - pos
+        ref = head.get(src[pos:pos + 4], -1)
+        depth = CHAIN_DEPTH
+        while ref >= 0 and pos - ref <= MAX_DISTANCE and depth:
+            # a longer match agrees on the byte after the best one
+            if best_length == 0 or src[ref + best_length] == src[pos + best_length]:
+                length = match_length(src, ref, pos, max_length)
+                if length > best_length:
+                    best_length, best_ref = length, ref
+                    if length >= GOOD_LENGTH or length == max_length:
+                        break
+            ref = chain[ref]
+            depth -= 1
+        return best_length, best_ref
+
+    while pos < match_limit:
+        length, ref = find_match(pos)
+        if length < 4:
+            pos += 1
+            continue
+
+        # lazy matching: the literal is worth it if the next position has a longer match
+        if pos + 1 < match_limit:
+            next_length, next_ref = find_match(pos + 1)
+            if next_length > length + 1:
+                pos += 1
+                length, ref = next_length, next_ref
+
+        literals = pos - anchor
+        out.append((min(literals, 15) << 4) | min(length - 4, 15))
+        if literals >= 15:
+            write_length(literals - 15)
+        out += src[anchor:pos]
+        out += struct.pack('<H', pos - ref)
+        if length - 4 >= 15:
+            write_length(length - 4 - 15)
+
+        pos += length
+        anchor = pos
+
+    literals = n - anchor
+    out.append(min(literals, 15) << 4)
+    if literals >= 15:
+        write_length(literals - 15)
+    out += src[anchor:]
+    return out
+
+
+def bake(src_path, dst_path, frames):
+    width, height, rgba = read_png(src_path)
+    if height % frames != 0:
+        raise ValueError('the height %d is not a multiple of %d frames' % (height, frames))
+
+    pixels = bytes(to_premultiplied_bgra(rgba))
+    flags = FLAG_PREMULTIPLIED
+    data = lz4_compress(pixels)
+    if len(data) < len(pixels):
+        flags |= FLAG_LZ4
+    else:
+        data = pixels
+
+    header = struct.pack('<4sHHIIIII', MAGIC, VERSION, flags, width, height, frames, len(pixels), len(data))
+    with open(dst_path, 'wb') as f:
+        f.write(header)
+        f.write(data)
+    return len(pixels), len(data)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+
+    res_dir = sys.argv[1]
+    out_dir = sys.argv[2] if len(sys.argv) > 2 else os.path.join(res_dir, 'baked')
+    os.makedirs(out_dir, exist_ok=True)
+
+    try:
+        strip_frames = read_strip_frames(res_dir)
+    except (OSError, ValueError) as e:
+        print(e, file=sys.stderr)
+        return 1
+    # the frames are in the header too
+    inputs_time = max(os.path.getmtime(path) for path in [__file__, os.path.join(res_dir, FRAMES_HEADER),
+                                                           os.path.join(res_dir, RESOURCE_SCRIPT)])
+
+    for image_dir in IMAGE_DIRS:
+        src_dir = os.path.join(res_dir, image_dir)
+        for name in sorted(os.listdir(src_dir)):
+            if not name.lower().endswith('.png'):
+                continue
+            src_path = os.path.join(src_dir, name)
+            dst_path = os.path.join(out_dir, os.path.splitext(name)[0] + '.llbm')
+            if os.path.exists(dst_path) and os.path.getmtime(dst_path) >= max(os.path.getmtime(src_path),
+                                                                                inputs_time):
+                continue
+
+            try:
+                raw_size, data_size = bake(src_path, dst_path, strip_frames.get(name, 1))
+            except (ValueError, KeyError, zlib.error) as e:
+                print('%s: %s' % (src_path, e), file=sys.stderr)
+                return 1
+            print('%s: %d -> %d bytes' % (name, raw_size, data_size))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())